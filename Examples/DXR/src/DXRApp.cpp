@@ -4,6 +4,7 @@
 #include <fw/Common.h>
 #include <fw/API.h>
 #include <fw/Macros.h>
+#include <fw/Profiler.h>
 #include <fw/Transformation.h>
 #include <GLFW/glfw3.h>
 
@@ -19,7 +20,6 @@ namespace
 const D3D12_HEAP_PROPERTIES c_defaultHeapProps = {D3D12_HEAP_TYPE_DEFAULT, D3D12_CPU_PAGE_PROPERTY_UNKNOWN, D3D12_MEMORY_POOL_UNKNOWN, 0, 0};
 const D3D12_HEAP_PROPERTIES c_uploadHeapProps = {D3D12_HEAP_TYPE_UPLOAD, D3D12_CPU_PAGE_PROPERTY_UNKNOWN, D3D12_MEMORY_POOL_UNKNOWN, 0, 0};
 const uint32_t c_cameraBufferSize = 2 * sizeof(DirectX::XMMATRIX);
-constexpr uint32_t c_alignedCameraBufferSize = fw::roundUpByteSize(c_cameraBufferSize);
 
 bool hasDXRSupport()
 {
@@ -31,6 +31,7 @@ bool hasDXRSupport()
 
 IDxcBlob* compileDXRShader(LPCWSTR fileName)
 {
+    FW_PROFILE_FUNCTION();
     static IDxcCompiler* compiler = nullptr;
     static IDxcLibrary* library = nullptr;
     static IDxcIncludeHandler* dxcIncludeHandler = nullptr;
@@ -105,6 +106,7 @@ void serializeAndCreateRootSignature(const D3D12_ROOT_SIGNATURE_DESC& desc, Micr
 
 bool DXRApp::initialize()
 {
+    FW_PROFILE_FUNCTION();
     bool status = true;
 
     status = status && hasDXRSupport();
@@ -114,9 +116,10 @@ bool DXRApp::initialize()
     loadModel(model);
 
     Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList4> commandList = fw::API::getCommandList();
-    std::vector<VertexUploadBuffers> vertexUploadBuffers;
-    createVertexBuffers(model, commandList, vertexUploadBuffers);
+    createVertexBuffers(model, commandList);
     createConstantBuffers();
+    // The acceleration structures are built from the buffers in the same command list
+    fw::API::getBufferHeap().finishUploads(commandList.Get());
     createBLASs(commandList);
     createTLAS(commandList);
     createShaders();
@@ -126,8 +129,7 @@ bool DXRApp::initialize()
     createGlobalRootSignature();
     createStateObject();
     createOutputBuffer();
-    createCameraBuffer();
-    createDescriptorHeap();
+    createViews();
     createShaderBindingTable();
 
     int windowWidth = fw::API::getWindowWidth();
@@ -162,11 +164,7 @@ void DXRApp::update()
         DirectX::XMMatrixInverse(nullptr, m_camera.getViewMatrix()),
         DirectX::XMMatrixInverse(nullptr, m_camera.getProjectionMatrix())};
 
-    int frameIndex = fw::API::getCurrentFrameIndex();
-    char* mappedData = nullptr;
-    CHECK(m_cameraBuffer->Map(0, nullptr, reinterpret_cast<void**>(&mappedData)));
-    memcpy(&mappedData[frameIndex * c_alignedCameraBufferSize], matrices.data(), c_cameraBufferSize);
-    m_cameraBuffer->Unmap(0, nullptr);
+    m_cameraBufferAddress = fw::API::getFrameAllocator().allocate(matrices.data(), c_cameraBufferSize).gpuAddress;
 
     if (fw::API::isKeyReleased(GLFW_KEY_ESCAPE))
     {
@@ -186,7 +184,7 @@ void DXRApp::fillCommandList()
     commandList->RSSetViewports(1, &m_viewport);
     commandList->RSSetScissorRects(1, &m_scissorRect);
 
-    std::vector<ID3D12DescriptorHeap*> heaps = {m_srvUavHeap.Get()};
+    std::vector<ID3D12DescriptorHeap*> heaps = {fw::API::getDescriptorHeap().getHeap()};
     commandList->SetDescriptorHeaps(static_cast<UINT>(heaps.size()), heaps.data());
 
     D3D12_DISPATCH_RAYS_DESC dispatchRaysDesc{};
@@ -209,10 +207,8 @@ void DXRApp::fillCommandList()
     dispatchRaysDesc.Height = fw::API::getWindowHeight();
     dispatchRaysDesc.Depth = 1;
 
-    int frameIndex = fw::API::getCurrentFrameIndex();
     commandList->SetComputeRootSignature(m_globalRootSignature.Get());
-    auto cbvAddress = m_cameraBuffer->GetGPUVirtualAddress() + frameIndex * c_alignedCameraBufferSize;
-    commandList->SetComputeRootConstantBufferView(0, cbvAddress);
+    commandList->SetComputeRootConstantBufferView(0, m_cameraBufferAddress);
     commandList->SetComputeRootShaderResourceView(1, m_tlasBuffer->GetGPUVirtualAddress());
 
     commandList->SetPipelineState1(m_stateObject.Get());
@@ -257,39 +253,39 @@ void DXRApp::loadModel(fw::Model& model)
 }
 
 void DXRApp::createVertexBuffers(const fw::Model& model,
-                                 Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList4>& commandList,
-                                 std::vector<VertexUploadBuffers>& vertexUploadBuffers)
+                                 Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList4>& commandList)
 {
-    Microsoft::WRL::ComPtr<ID3D12Device5> d3dDevice = fw::API::getD3dDevice();
     fw::Model::Meshes meshes = model.getMeshes();
     meshes.push_back(getDebugTriangleMeshYPlane());
 
     const size_t numMeshes = meshes.size();
-    vertexUploadBuffers.resize(numMeshes);
     m_renderObjects.resize(numMeshes);
 
     for (size_t i = 0; i < numMeshes; ++i)
     {
         RenderObject& ro = m_renderObjects[i];
         const fw::Mesh& mesh = meshes[i];
-        std::vector<fw::Mesh::Vertex> vertices = mesh.getVertices();
-        const size_t vertexBufferSize = vertices.size() * sizeof(fw::Mesh::Vertex);
+        fw::Span<const fw::Mesh::Vertex> vertices = mesh.getInterleavedVertices();
+        const size_t vertexBufferSize = vertices.sizeInBytes();
 
-        std::vector<uint32_t> indices32(mesh.indices.size());
-        for (size_t j = 0; j < mesh.indices.size(); ++j)
+        // Only the most detailed level is used for ray tracing
+        const fw::MeshLod lod = mesh.getLod(0);
+        std::vector<uint32_t> indices32(lod.indexCount);
+        for (size_t j = 0; j < indices32.size(); ++j)
         {
-            indices32[j] = static_cast<uint32_t>(mesh.indices[j]);
+            indices32[j] = mesh.getIndex(lod.indexOffset + j);
         }
         const size_t indexBufferSize = indices32.size() * sizeof(indices32[0]);
 
-        ro.vertexBuffer = fw::createGPUBuffer(d3dDevice.Get(), commandList.Get(), vertices.data(), vertexBufferSize, vertexUploadBuffers[i].vertexUploadBuffer);
-        ro.indexBuffer = fw::createGPUBuffer(d3dDevice.Get(), commandList.Get(), indices32.data(), indexBufferSize, vertexUploadBuffers[i].indexUploadBuffer);
+        // The hit shaders view the vertices as a structured buffer that starts at the buffer
+        ro.vertexBuffer = fw::createGPUBuffer(commandList.Get(), vertices.data(), vertexBufferSize, sizeof(fw::Mesh::Vertex), fw::API::getUploadRing(), fw::API::getBufferHeap());
+        ro.indexBuffer = fw::createGPUBuffer(commandList.Get(), indices32.data(), indexBufferSize, fw::API::getUploadRing(), fw::API::getBufferHeap());
 
-        ro.vertexBufferView.BufferLocation = ro.vertexBuffer->GetGPUVirtualAddress();
+        ro.vertexBufferView.BufferLocation = ro.vertexBuffer.gpuAddress;
         ro.vertexBufferView.StrideInBytes = sizeof(fw::Mesh::Vertex);
         ro.vertexBufferView.SizeInBytes = (UINT)vertexBufferSize;
 
-        ro.indexBufferView.BufferLocation = ro.indexBuffer->GetGPUVirtualAddress();
+        ro.indexBufferView.BufferLocation = ro.indexBuffer.gpuAddress;
         ro.indexBufferView.Format = DXGI_FORMAT_R32_UINT;
         ro.indexBufferView.SizeInBytes = (UINT)indexBufferSize;
 
@@ -300,28 +296,16 @@ void DXRApp::createVertexBuffers(const fw::Model& model,
 
 fw::Mesh DXRApp::getDebugTriangleMeshYPlane()
 {
-    fw::Mesh mesh;
-    mesh.positions = {
-        {-1000.0f, 0.0, -1000.0f},
-        {0.0f, 0.0, 1000.0f},
-        {1000.0f, 0.0, -1000.0f}};
-
-    mesh.normals = {
-        {0.0f, 1.0, 0.0f},
-        {0.0f, 1.0, 0.0f},
-        {0.0f, 1.0, 0.0f}};
-
-    mesh.uvs = {
-        {0.0f, 0.0},
-        {0.0f, 0.0},
-        {0.0f, 0.0}};
+    static const fw::Mesh::Vertex vertices[] = {
+        {{-1000.0f, 0.0f, -1000.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, 0.0f}, {0.0f, 0.0f}},
+        {{0.0f, 0.0f, 1000.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, 0.0f}, {0.0f, 0.0f}},
+        {{1000.0f, 0.0f, -1000.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, 0.0f}, {0.0f, 0.0f}}};
 
-    mesh.tangents = {
-        {0.0f, 0.0, 0.0f},
-        {0.0f, 0.0, 0.0f},
-        {0.0f, 0.0, 0.0f}};
+    static const uint16_t indices[] = {0, 1, 2};
 
-    mesh.indices = {0, 1, 2};
+    fw::Mesh mesh;
+    mesh.setVertices(vertices);
+    mesh.indices16 = indices;
 
     return mesh;
 }
@@ -856,45 +840,16 @@ void DXRApp::createOutputBuffer()
     CHECK(device->CreateCommittedResource(&c_defaultHeapProps, D3D12_HEAP_FLAG_NONE, &resourceDesc, D3D12_RESOURCE_STATE_UNORDERED_ACCESS, nullptr, IID_PPV_ARGS(&m_outputBuffer)));
 }
 
-void DXRApp::createCameraBuffer()
-{
-    D3D12_RESOURCE_DESC bufferDesc{};
-    bufferDesc.Alignment = 0;
-    bufferDesc.DepthOrArraySize = 1;
-    bufferDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
-    bufferDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
-    bufferDesc.Format = DXGI_FORMAT_UNKNOWN;
-    bufferDesc.Height = 1;
-    bufferDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
-    bufferDesc.MipLevels = 1;
-    bufferDesc.SampleDesc.Count = 1;
-    bufferDesc.SampleDesc.Quality = 0;
-    bufferDesc.Width = fw::API::getSwapChainBufferCount() * c_alignedCameraBufferSize;
-
-    Microsoft::WRL::ComPtr<ID3D12Device5> device = fw::API::getD3dDevice();
-
-    CHECK(device->CreateCommittedResource(&c_uploadHeapProps,
-                                          D3D12_HEAP_FLAG_NONE,
-                                          &bufferDesc,
-                                          D3D12_RESOURCE_STATE_GENERIC_READ,
-                                          nullptr,
-                                          IID_PPV_ARGS(&m_cameraBuffer)));
-}
-
-void DXRApp::createDescriptorHeap()
+void DXRApp::createViews()
 {
-    const UINT incSize = fw::API::getCbvSrvUavDescriptorIncrementSize();
-
-    D3D12_DESCRIPTOR_HEAP_DESC heapDesc{};
-    heapDesc.NumDescriptors = 1 + static_cast<UINT>(m_renderObjects.size()) * 3;
-    heapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
-    heapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
+    fw::DescriptorHeap& descriptorHeap = fw::API::getDescriptorHeap();
+    m_srvUavViews = descriptorHeap.allocate(1 + static_cast<uint32_t>(m_renderObjects.size()) * 3);
+    const UINT incSize = descriptorHeap.getIncrementSize();
 
     Microsoft::WRL::ComPtr<ID3D12Device5> device = fw::API::getD3dDevice();
-    CHECK(device->CreateDescriptorHeap(&heapDesc, IID_PPV_ARGS(&m_srvUavHeap)));
 
     // Add output buffer as SRV
-    D3D12_CPU_DESCRIPTOR_HANDLE srvHandle = m_srvUavHeap->GetCPUDescriptorHandleForHeapStart();
+    D3D12_CPU_DESCRIPTOR_HANDLE srvHandle = descriptorHeap.getCpuHandle(m_srvUavViews, 0);
 
     D3D12_UNORDERED_ACCESS_VIEW_DESC uavDesc{};
     uavDesc.ViewDimension = D3D12_UAV_DIMENSION_TEXTURE2D;
@@ -909,15 +864,16 @@ void DXRApp::createDescriptorHeap()
         srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
         srvDesc.Format = DXGI_FORMAT_UNKNOWN;
         srvDesc.ViewDimension = D3D12_SRV_DIMENSION_BUFFER;
-        srvDesc.Buffer.FirstElement = 0;
+        srvDesc.Buffer.FirstElement = ro.indexBuffer.offset / sizeof(uint32_t);
         srvDesc.Buffer.NumElements = ro.indexCount;
         srvDesc.Buffer.StructureByteStride = sizeof(uint32_t);
-        device->CreateShaderResourceView(ro.indexBuffer.Get(), &srvDesc, srvHandle);
+        device->CreateShaderResourceView(ro.indexBuffer.resource, &srvDesc, srvHandle);
         srvHandle.ptr += incSize;
 
+        srvDesc.Buffer.FirstElement = ro.vertexBuffer.offset / sizeof(fw::Mesh::Vertex);
         srvDesc.Buffer.NumElements = ro.vertexCount;
         UINT t = srvDesc.Buffer.StructureByteStride = sizeof(fw::Mesh::Vertex);
-        device->CreateShaderResourceView(ro.vertexBuffer.Get(), &srvDesc, srvHandle);
+        device->CreateShaderResourceView(ro.vertexBuffer.resource, &srvDesc, srvHandle);
         srvHandle.ptr += incSize;
 
         D3D12_SHADER_RESOURCE_VIEW_DESC cbvDesc{};
@@ -986,7 +942,9 @@ void DXRApp::createShaderBindingTable()
     uint8_t* mappedData;
     CHECK(m_sbtBuffer->Map(0, nullptr, reinterpret_cast<void**>(&mappedData)));
 
-    CD3DX12_CPU_DESCRIPTOR_HANDLE handle = CD3DX12_CPU_DESCRIPTOR_HANDLE(m_srvUavHeap->GetCPUDescriptorHandleForHeapStart());
+    // The root tables of the shaders point to their views in the shader visible heap
+    const fw::DescriptorHeap& descriptorHeap = fw::API::getDescriptorHeap();
+    CD3DX12_GPU_DESCRIPTOR_HANDLE handle = CD3DX12_GPU_DESCRIPTOR_HANDLE(descriptorHeap.getGpuHandle(m_srvUavViews, 0));
     UINT64* heapPointer = reinterpret_cast<UINT64*>(handle.ptr);
 
     struct SBTEntry
@@ -1000,7 +958,7 @@ void DXRApp::createShaderBindingTable()
     std::vector<SBTEntry> hitGroups1;
     SBTEntry reflection{L"HitGroupReflection", {}};
 
-    const UINT incSize = fw::API::getCbvSrvUavDescriptorIncrementSize();
+    const UINT incSize = descriptorHeap.getIncrementSize();
     handle.Offset(1, incSize);
 
     for (size_t i = 0; i < m_renderObjects.size() - 1; ++i)
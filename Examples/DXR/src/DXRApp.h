@@ -1,9 +1,11 @@
 #pragma once
 
 #include <fw/Application.h>
+#include <fw/BufferHeap.h>
 #include <fw/Model.h>
 #include <fw/Camera.h>
 #include <fw/CameraController.h>
+#include <fw/DescriptorHeap.h>
 
 #include <wrl.h>
 #include "d3dx12.h"
@@ -26,20 +28,14 @@ public:
 private:
     struct RenderObject
     {
-        Microsoft::WRL::ComPtr<ID3D12Resource> vertexBuffer;
-        Microsoft::WRL::ComPtr<ID3D12Resource> indexBuffer;
+        fw::BufferHeap::Buffer vertexBuffer;
+        fw::BufferHeap::Buffer indexBuffer;
         D3D12_VERTEX_BUFFER_VIEW vertexBufferView;
         D3D12_INDEX_BUFFER_VIEW indexBufferView;
         UINT vertexCount;
         UINT indexCount;
     };
 
-    struct VertexUploadBuffers
-    {
-        Microsoft::WRL::ComPtr<ID3D12Resource> vertexUploadBuffer;
-        Microsoft::WRL::ComPtr<ID3D12Resource> indexUploadBuffer;
-    };
-
     std::vector<RenderObject> m_renderObjects;
     std::vector<Microsoft::WRL::ComPtr<ID3D12Resource>> m_blasBuffers;
     Microsoft::WRL::ComPtr<ID3D12Resource> m_tlasBuffer;
@@ -58,8 +54,9 @@ private:
     Microsoft::WRL::ComPtr<ID3D12StateObject> m_stateObject;
 
     Microsoft::WRL::ComPtr<ID3D12Resource> m_outputBuffer;
-    Microsoft::WRL::ComPtr<ID3D12Resource> m_cameraBuffer;
-    Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> m_srvUavHeap;
+    D3D12_GPU_VIRTUAL_ADDRESS m_cameraBufferAddress = 0;
+    // Output buffer UAV followed by the index buffer, vertex buffer and color views of each object
+    fw::DescriptorHeap::Range m_srvUavViews;
     Microsoft::WRL::ComPtr<ID3D12Resource> m_sbtBuffer;
 
     std::vector<Microsoft::WRL::ComPtr<ID3D12Resource>> m_constBuffers;
@@ -78,7 +75,7 @@ private:
     fw::CameraController m_cameraController;
 
     void loadModel(fw::Model& model);
-    void createVertexBuffers(const fw::Model& model, Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList4>& commandList, std::vector<VertexUploadBuffers>& vertexUploadBuffers);
+    void createVertexBuffers(const fw::Model& model, Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList4>& commandList);
     fw::Mesh getDebugTriangleMeshYPlane();
     void createConstantBuffers();
     void createBLASs(Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList4>& commandList);
@@ -91,7 +88,6 @@ private:
     void createGlobalRootSignature();
     void createStateObject();
     void createOutputBuffer();
-    void createCameraBuffer();
-    void createDescriptorHeap();
+    void createViews();
     void createShaderBindingTable();
 };
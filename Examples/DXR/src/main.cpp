@@ -3,5 +3,5 @@
 
 int main(int argc, char** argv)
 {
-    return fw::runApplication<DXRApp>();
+    return fw::runApplication<DXRApp>(argc, argv);
 }
@@ -14,7 +14,8 @@ struct VertexOut
 
 cbuffer cbPerObject : register(b0)
 {
-    uint index;
+    uint meshIndex;
+    uint firstInstance;
 };
 
 struct Matrix
@@ -26,10 +27,10 @@ StructuredBuffer<Matrix> worldViewProjs : register(t0);
 Texture2D textures[] : register(t1);
 SamplerState pointSampler : register(s0);
 
-VertexOut VS(VertexIn vertexIn)
+VertexOut VS(VertexIn vertexIn, uint instanceId : SV_InstanceID)
 {
     VertexOut vertexOut;
-    vertexOut.position = mul(float4(vertexIn.position, 1.0f), worldViewProjs[index].wvp);
+    vertexOut.position = mul(float4(vertexIn.position, 1.0f), worldViewProjs[firstInstance + instanceId].wvp);
     vertexOut.uv = vertexIn.uv;
     return vertexOut;
 }
@@ -37,5 +38,5 @@ VertexOut VS(VertexIn vertexIn)
 float4 PS(VertexOut vertexOut) :
     SV_Target
 {
-    return textures[index].Sample(pointSampler, vertexOut.uv);
+    return textures[meshIndex].Sample(pointSampler, vertexOut.uv);
 }
@@ -4,12 +4,11 @@
 #include <fw/Common.h>
 #include <fw/API.h>
 #include <fw/Macros.h>
+#include <fw/Profiler.h>
 #include <fw/Transformation.h>
 
 #include <DirectXMath.h>
 
-#define STB_IMAGE_IMPLEMENTATION
-#include <stb_image.h>
 #include <GLFW/glfw3.h>
 
 #include <vector>
@@ -28,21 +27,17 @@ const int c_rootParameterCount = 3;
 
 bool DynamicIndexingApp::initialize()
 {
+    FW_PROFILE_FUNCTION();
     Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> commandList = fw::API::getCommandList();
 
     fw::Model model;
     loadModel(model);
     m_objectCount = static_cast<int>(model.getMeshes().size());
-    m_textureHeapOffset = 0;
-    for (int i = 0; i < fw::API::getSwapChainBufferCount(); ++i)
+    for (const fw::MeshInstance& instance : model.getInstances())
     {
-        m_matrixHeapOffsets.push_back(m_objectCount + i);
+        m_instanceTransforms.push_back(instance.transform);
     }
-    // Textures + matrix buffers
-    m_descriptorCount = m_objectCount + fw::API::getSwapChainBufferCount();
-
-    createDescriptorHeap();
-    createConstantBuffer();
+    m_instanceCount = static_cast<int>(m_instanceTransforms.size());
     createTextures(model, commandList);
     createVertexBuffers(model, commandList);
 
@@ -54,8 +49,6 @@ bool DynamicIndexingApp::initialize()
     // Execute and wait initialization commands
     CHECK(commandList->Close());
     fw::API::completeInitialization();
-    m_textureUploadBuffers.clear();
-    m_vertexUploadBuffers.clear();
 
     // Camera
     m_cameraController.setCamera(&m_camera);
@@ -89,16 +82,15 @@ void DynamicIndexingApp::update()
     m_camera.updateViewMatrix();
 
     DirectX::XMMATRIX worldViewProj = transformation.getWorldMatrix() * m_camera.getViewMatrix() * m_camera.getProjectionMatrix();
-    DirectX::XMMATRIX wvp = DirectX::XMMatrixTranspose(worldViewProj);
 
-    int currentFrameIndex = fw::API::getCurrentFrameIndex();
-    DirectX::XMMATRIX* mappedData = nullptr;
-    CHECK(m_constantBuffers[currentFrameIndex]->Map(0, nullptr, reinterpret_cast<void**>(&mappedData)));
-    for (size_t i = 0; i < m_objectCount; ++i)
+    fw::FrameAllocator::Allocation matrices = fw::API::getFrameAllocator().allocate(m_instanceCount * sizeof(DirectX::XMMATRIX));
+    DirectX::XMMATRIX* mappedData = reinterpret_cast<DirectX::XMMATRIX*>(matrices.data);
+    for (int i = 0; i < m_instanceCount; ++i)
     {
+        DirectX::XMMATRIX wvp = DirectX::XMMatrixTranspose(DirectX::XMLoadFloat4x4(&m_instanceTransforms[i]) * worldViewProj);
         memcpy(&mappedData[i], &wvp, sizeof(DirectX::XMMATRIX));
     }
-    m_constantBuffers[currentFrameIndex]->Unmap(0, nullptr);
+    m_matrixBufferAddress = matrices.gpuAddress;
 
     if (fw::API::isKeyReleased(GLFW_KEY_ESCAPE))
     {
@@ -133,25 +125,21 @@ void DynamicIndexingApp::fillCommandList()
 
     commandList->SetGraphicsRootSignature(m_rootSignature.Get());
 
-    std::vector<ID3D12DescriptorHeap*> descriptorHeaps{m_descriptorHeap.Get()};
+    const fw::DescriptorHeap& descriptorHeap = fw::API::getDescriptorHeap();
+    std::vector<ID3D12DescriptorHeap*> descriptorHeaps{descriptorHeap.getHeap()};
     commandList->SetDescriptorHeaps((UINT)descriptorHeaps.size(), descriptorHeaps.data());
 
-    const D3D12_GPU_DESCRIPTOR_HANDLE heapStart = m_descriptorHeap->GetGPUDescriptorHandleForHeapStart();
-    const int incSize = fw::API::getCbvSrvUavDescriptorIncrementSize();
-    const int frameIndex = fw::API::getCurrentFrameIndex();
-
-    const auto matrixHandle = CD3DX12_GPU_DESCRIPTOR_HANDLE(heapStart, m_matrixHeapOffsets[frameIndex], incSize);
-    commandList->SetGraphicsRootDescriptorTable(0, matrixHandle);
-    const auto textureHandle = CD3DX12_GPU_DESCRIPTOR_HANDLE(heapStart, m_textureHeapOffset, incSize);
-    commandList->SetGraphicsRootDescriptorTable(1, textureHandle);
+    commandList->SetGraphicsRootShaderResourceView(0, m_matrixBufferAddress);
+    commandList->SetGraphicsRootDescriptorTable(1, descriptorHeap.getGpuHandle(m_textureViews, 0));
 
     for (size_t i = 0; i < m_renderObjects.size(); ++i)
     {
         const RenderObject& ro = m_renderObjects[i];
         commandList->SetGraphicsRoot32BitConstant(2, static_cast<UINT>(i), 0);
+        commandList->SetGraphicsRoot32BitConstant(2, ro.firstInstance, 1);
         commandList->IASetVertexBuffers(0, 1, &ro.vertexBufferView);
         commandList->IASetIndexBuffer(&ro.indexBufferView);
-        commandList->DrawIndexedInstanced(ro.numIndices, 1, 0, 0, 0);
+        commandList->DrawIndexedInstanced(ro.numIndices, ro.instanceCount, 0, 0, 0);
     }
 
     commandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(currentBackBuffer, D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_PRESENT));
@@ -173,130 +161,46 @@ void DynamicIndexingApp::loadModel(fw::Model& model)
     m_renderObjects.resize(numMeshes);
 }
 
-void DynamicIndexingApp::createDescriptorHeap()
-{
-    D3D12_DESCRIPTOR_HEAP_DESC descriptorHeapDesc;
-    descriptorHeapDesc.NumDescriptors = m_descriptorCount;
-    descriptorHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
-    descriptorHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
-    descriptorHeapDesc.NodeMask = 0;
-
-    Microsoft::WRL::ComPtr<ID3D12Device> d3dDevice = fw::API::getD3dDevice();
-    CHECK(d3dDevice->CreateDescriptorHeap(&descriptorHeapDesc, IID_PPV_ARGS(&m_descriptorHeap)));
-}
-
-void DynamicIndexingApp::createConstantBuffer()
-{
-    Microsoft::WRL::ComPtr<ID3D12Device> d3dDevice = fw::API::getD3dDevice();
-
-    uint32_t constantBufferSize = fw::roundUpByteSize(sizeof(DirectX::XMFLOAT4X4) * m_objectCount);
-    m_constantBuffers.resize(fw::API::getSwapChainBufferCount());
-
-    CD3DX12_CPU_DESCRIPTOR_HANDLE handle = CD3DX12_CPU_DESCRIPTOR_HANDLE(m_descriptorHeap->GetCPUDescriptorHandleForHeapStart());
-    handle.Offset(m_matrixHeapOffsets[0], fw::API::getCbvSrvUavDescriptorIncrementSize());
-
-    for (int i = 0; i < m_constantBuffers.size(); ++i)
-    {
-        Microsoft::WRL::ComPtr<ID3D12Resource>& constantBuffer = m_constantBuffers[i];
-        CHECK(d3dDevice->CreateCommittedResource(&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
-                                                 D3D12_HEAP_FLAG_NONE,
-                                                 &CD3DX12_RESOURCE_DESC::Buffer(constantBufferSize),
-                                                 D3D12_RESOURCE_STATE_GENERIC_READ,
-                                                 nullptr,
-                                                 IID_PPV_ARGS(&constantBuffer)));
-
-        D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc{};
-        srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
-        srvDesc.Format = DXGI_FORMAT_UNKNOWN;
-        srvDesc.ViewDimension = D3D12_SRV_DIMENSION_BUFFER;
-        srvDesc.Buffer.FirstElement = 0;
-        srvDesc.Buffer.NumElements = m_objectCount;
-        srvDesc.Buffer.StructureByteStride = sizeof(DirectX::XMFLOAT4X4);
-
-        d3dDevice->CreateShaderResourceView(constantBuffer.Get(), &srvDesc, handle);
-        handle.Offset(1, fw::API::getCbvSrvUavDescriptorIncrementSize());
-    }
-}
-
 void DynamicIndexingApp::createTextures(const fw::Model& model, Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList>& commandList)
 {
-    Microsoft::WRL::ComPtr<ID3D12Device> d3dDevice = fw::API::getD3dDevice();
-
-    D3D12_RESOURCE_DESC textureDesc{};
-    textureDesc.MipLevels = 1;
-    textureDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
-    textureDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
-    textureDesc.Width = 0;
-    textureDesc.Height = 0;
-    textureDesc.DepthOrArraySize = 1;
-    textureDesc.SampleDesc.Count = 1;
-    textureDesc.SampleDesc.Quality = 0;
-    textureDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
-
-    const fw::Model::Meshes& meshes = model.getMeshes();
-    size_t numMeshes = meshes.size();
-    m_textureUploadBuffers.resize(numMeshes);
-
-    CD3DX12_CPU_DESCRIPTOR_HANDLE handle = CD3DX12_CPU_DESCRIPTOR_HANDLE(m_descriptorHeap->GetCPUDescriptorHandleForHeapStart());
-    handle.Offset(m_textureHeapOffset, fw::API::getCbvSrvUavDescriptorIncrementSize());
+    // The textures are one table that is indexed by the mesh index
+    fw::DescriptorHeap& descriptorHeap = fw::API::getDescriptorHeap();
+    m_textureViews = descriptorHeap.allocate(static_cast<uint32_t>(model.getMeshes().size()));
 
-    for (size_t i = 0; i < numMeshes; ++i)
+    std::vector<Microsoft::WRL::ComPtr<ID3D12Resource>> textures = fw::createAlbedoTextures(fw::API::getD3dDevice().Get(), commandList.Get(), model, ASSET_PATH, fw::API::getConfig().textureQuality, descriptorHeap, m_textureViews, fw::API::getUploadRing(), fw::API::getTextureHeap());
+    for (size_t i = 0; i < textures.size(); ++i)
     {
-        std::string textureName = meshes[i].getFirstTextureOfType(aiTextureType::aiTextureType_DIFFUSE);
-        std::string filepath = ASSET_PATH;
-        filepath += textureName;
-        int texWidth, texHeight, texChannels;
-        stbi_uc* pixels = stbi_load(filepath.c_str(), &texWidth, &texHeight, &texChannels, 4);
-        assert(pixels != nullptr);
-
-        textureDesc.Width = texWidth;
-        textureDesc.Height = texHeight;
-        const int numBytes = texWidth * texHeight * texChannels;
-
-        RenderObject& ro = m_renderObjects[i];
-        ro.texture = fw::createGPUTexture(d3dDevice.Get(), commandList.Get(), pixels, numBytes, textureDesc, 4, m_textureUploadBuffers[i]);
-
-        stbi_image_free(pixels);
-
-        D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc{};
-        srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
-        srvDesc.Format = textureDesc.Format;
-        srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
-        srvDesc.Texture2D.MipLevels = 1;
-        d3dDevice->CreateShaderResourceView(ro.texture.Get(), &srvDesc, handle);
-
-        handle.Offset(1, fw::API::getCbvSrvUavDescriptorIncrementSize());
+        m_renderObjects[i].texture = textures[i];
     }
 }
 
 void DynamicIndexingApp::createVertexBuffers(const fw::Model& model, Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList>& commandList)
 {
-    Microsoft::WRL::ComPtr<ID3D12Device> d3dDevice = fw::API::getD3dDevice();
-
     const fw::Model::Meshes& meshes = model.getMeshes();
     size_t numMeshes = meshes.size();
-    m_vertexUploadBuffers.resize(numMeshes);
 
     for (size_t i = 0; i < numMeshes; ++i)
     {
         RenderObject& ro = m_renderObjects[i];
         const fw::Mesh& mesh = meshes[i];
-        std::vector<fw::Mesh::Vertex> vertices = mesh.getVertices();
-        const size_t vertexBufferSize = vertices.size() * sizeof(fw::Mesh::Vertex);
-        const size_t indexBufferSize = mesh.indices.size() * sizeof(uint16_t);
+        fw::Span<const fw::Mesh::Vertex> vertices = mesh.getInterleavedVertices();
+        const size_t vertexBufferSize = vertices.sizeInBytes();
+        const size_t indexBufferSize = mesh.getIndexDataSize();
 
-        ro.vertexBuffer = fw::createGPUBuffer(d3dDevice.Get(), commandList.Get(), vertices.data(), vertexBufferSize, m_vertexUploadBuffers[i].vertexUploadBuffer);
-        ro.indexBuffer = fw::createGPUBuffer(d3dDevice.Get(), commandList.Get(), mesh.indices.data(), indexBufferSize, m_vertexUploadBuffers[i].indexUploadBuffer);
+        ro.vertexBuffer = fw::createGPUBuffer(commandList.Get(), vertices.data(), vertexBufferSize, fw::API::getUploadRing(), fw::API::getBufferHeap());
+        ro.indexBuffer = fw::createGPUBuffer(commandList.Get(), mesh.getIndexData(), indexBufferSize, fw::API::getUploadRing(), fw::API::getBufferHeap());
 
-        ro.vertexBufferView.BufferLocation = ro.vertexBuffer->GetGPUVirtualAddress();
+        ro.vertexBufferView.BufferLocation = ro.vertexBuffer.gpuAddress;
         ro.vertexBufferView.StrideInBytes = sizeof(fw::Mesh::Vertex);
         ro.vertexBufferView.SizeInBytes = (UINT)vertexBufferSize;
 
-        ro.indexBufferView.BufferLocation = ro.indexBuffer->GetGPUVirtualAddress();
-        ro.indexBufferView.Format = DXGI_FORMAT_R16_UINT;
+        ro.indexBufferView.BufferLocation = ro.indexBuffer.gpuAddress;
+        ro.indexBufferView.Format = fw::getIndexFormat(mesh);
         ro.indexBufferView.SizeInBytes = (UINT)indexBufferSize;
 
-        ro.numIndices = static_cast<UINT>(mesh.indices.size());
+        ro.numIndices = mesh.getLod(0).indexCount;
+        ro.firstInstance = mesh.firstInstance;
+        ro.instanceCount = static_cast<UINT>(mesh.instances.size());
     }
 }
 
@@ -310,14 +214,14 @@ void DynamicIndexingApp::createShaders()
 
 void DynamicIndexingApp::createRootSignature()
 {
-    CD3DX12_DESCRIPTOR_RANGE ranges[2];
-    ranges[0].Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, m_objectCount, 0);
-    ranges[1].Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, m_objectCount, 1);
+    CD3DX12_DESCRIPTOR_RANGE textureRange;
+    textureRange.Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, m_objectCount, 1);
 
+    // The matrices are written to the frame allocator every frame and bound as a root view
     CD3DX12_ROOT_PARAMETER rootParameters[c_rootParameterCount];
-    rootParameters[0].InitAsDescriptorTable(1, &ranges[0], D3D12_SHADER_VISIBILITY_VERTEX);
-    rootParameters[1].InitAsDescriptorTable(1, &ranges[1], D3D12_SHADER_VISIBILITY_PIXEL);
-    rootParameters[2].InitAsConstants(1, 0);
+    rootParameters[0].InitAsShaderResourceView(0, 0, D3D12_SHADER_VISIBILITY_VERTEX);
+    rootParameters[1].InitAsDescriptorTable(1, &textureRange, D3D12_SHADER_VISIBILITY_PIXEL);
+    rootParameters[2].InitAsConstants(2, 0);
 
     CD3DX12_ROOT_SIGNATURE_DESC rootSignatureDesc;
     rootSignatureDesc.Init(_countof(rootParameters), rootParameters, 0, nullptr, D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT);
@@ -1,13 +1,16 @@
 #pragma once
 
 #include <fw/Application.h>
+#include <fw/BufferHeap.h>
 #include <fw/Camera.h>
 #include <fw/CameraController.h>
+#include <fw/DescriptorHeap.h>
 #include <fw/Model.h>
 
 #include "d3dx12.h"
 #include <wrl.h>
 #include <d3d12.h>
+#include <DirectXMath.h>
 
 #include <vector>
 #include <cstdint>
@@ -26,18 +29,14 @@ public:
 private:
     struct RenderObject
     {
-        Microsoft::WRL::ComPtr<ID3D12Resource> vertexBuffer;
-        Microsoft::WRL::ComPtr<ID3D12Resource> indexBuffer;
+        fw::BufferHeap::Buffer vertexBuffer;
+        fw::BufferHeap::Buffer indexBuffer;
         D3D12_VERTEX_BUFFER_VIEW vertexBufferView;
         D3D12_INDEX_BUFFER_VIEW indexBufferView;
         Microsoft::WRL::ComPtr<ID3D12Resource> texture;
         UINT numIndices;
-    };
-
-    struct VertexUploadBuffers
-    {
-        Microsoft::WRL::ComPtr<ID3D12Resource> vertexUploadBuffer;
-        Microsoft::WRL::ComPtr<ID3D12Resource> indexUploadBuffer;
+        UINT firstInstance;
+        UINT instanceCount;
     };
 
     D3D12_VIEWPORT m_screenViewport;
@@ -45,20 +44,17 @@ private:
 
     Microsoft::WRL::ComPtr<ID3D12RootSignature> m_rootSignature = nullptr;
 
-    Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> m_descriptorHeap = nullptr;
-    std::vector<Microsoft::WRL::ComPtr<ID3D12Resource>> m_constantBuffers;
-
-    std::vector<Microsoft::WRL::ComPtr<ID3D12Resource>> m_textureUploadBuffers;
-    std::vector<VertexUploadBuffers> m_vertexUploadBuffers;
+    fw::DescriptorHeap::Range m_textureViews;
+    D3D12_GPU_VIRTUAL_ADDRESS m_matrixBufferAddress = 0;
 
     Microsoft::WRL::ComPtr<ID3DBlob> m_vertexShader = nullptr;
     Microsoft::WRL::ComPtr<ID3DBlob> m_pixelShader = nullptr;
 
     std::vector<RenderObject> m_renderObjects;
     int m_objectCount = -1;
-    int m_textureHeapOffset = -1;
-    std::vector<int> m_matrixHeapOffsets;
-    int m_descriptorCount = -1;
+    // Transforms of the mesh instances, the matrix buffer holds one matrix per instance
+    std::vector<DirectX::XMFLOAT4X4> m_instanceTransforms;
+    int m_instanceCount = -1;
 
     Microsoft::WRL::ComPtr<ID3D12PipelineState> m_renderPSO = nullptr;
 
@@ -66,8 +62,6 @@ private:
     fw::CameraController m_cameraController;
 
     void loadModel(fw::Model& model);
-    void createDescriptorHeap();
-    void createConstantBuffer();
     void createTextures(const fw::Model& model, Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList>& commandList);
     void createVertexBuffers(const fw::Model& model, Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList>& commandList);
     void createShaders();
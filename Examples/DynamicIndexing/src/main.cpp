@@ -3,5 +3,5 @@
 
 int main(int argc, char** argv)
 {
-    return fw::runApplication<DynamicIndexingApp>();
+    return fw::runApplication<DynamicIndexingApp>(argc, argv);
 }
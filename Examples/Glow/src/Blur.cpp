@@ -13,28 +13,12 @@ bool Blur::initialize(Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList>& command
     return true;
 }
 
-void Blur::postInitialize()
-{
-    m_vertexUploadBuffer.Reset();
-    m_indexUploadBuffer.Reset();
-}
-
-void Blur::render(Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList>& commandList, ID3D12DescriptorHeap* srvHeap, int srvHeapOffset)
+void Blur::render(Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList>& commandList, D3D12_GPU_DESCRIPTOR_HANDLE singleColorTexture)
 {
     commandList->SetPipelineState(m_PSO.Get());
 
-    std::vector<ID3D12DescriptorHeap*> descriptorHeaps{srvHeap};
-    commandList->SetDescriptorHeaps((UINT)descriptorHeaps.size(), descriptorHeaps.data());
-
     commandList->SetGraphicsRootSignature(m_rootSignature.Get());
-
-    UINT cbvSrvIncrementSize = fw::API::getCbvSrvUavDescriptorIncrementSize();
-    CD3DX12_GPU_DESCRIPTOR_HANDLE cbvSrvHandleBegin = CD3DX12_GPU_DESCRIPTOR_HANDLE(srvHeap->GetGPUDescriptorHandleForHeapStart());
-
-    CD3DX12_GPU_DESCRIPTOR_HANDLE singleColorTextureHandle = cbvSrvHandleBegin;
-    int currentFrameIndex = fw::API::getCurrentFrameIndex();
-    singleColorTextureHandle.Offset(srvHeapOffset + currentFrameIndex, cbvSrvIncrementSize);
-    commandList->SetGraphicsRootDescriptorTable(0, singleColorTextureHandle);
+    commandList->SetGraphicsRootDescriptorTable(0, singleColorTexture);
 
     commandList->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 
@@ -45,19 +29,17 @@ void Blur::render(Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList>& commandList
 
 void Blur::createVertexBuffer(Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList>& commandList)
 {
-    Microsoft::WRL::ComPtr<ID3D12Device> d3dDevice = fw::API::getD3dDevice();
-
     const size_t vertexBufferSize = c_fullscreenTriangle.size() * sizeof(float);
     const size_t indexBufferSize = c_fullscreenTriangleIndices.size() * sizeof(uint16_t);
 
-    m_vertexBuffer = fw::createGPUBuffer(d3dDevice.Get(), commandList.Get(), c_fullscreenTriangle.data(), vertexBufferSize, m_vertexUploadBuffer);
-    m_indexBuffer = fw::createGPUBuffer(d3dDevice.Get(), commandList.Get(), c_fullscreenTriangleIndices.data(), indexBufferSize, m_indexUploadBuffer);
+    m_vertexBuffer = fw::createGPUBuffer(commandList.Get(), c_fullscreenTriangle.data(), vertexBufferSize, fw::API::getUploadRing(), fw::API::getBufferHeap());
+    m_indexBuffer = fw::createGPUBuffer(commandList.Get(), c_fullscreenTriangleIndices.data(), indexBufferSize, fw::API::getUploadRing(), fw::API::getBufferHeap());
 
-    m_vertexBufferView.BufferLocation = m_vertexBuffer->GetGPUVirtualAddress();
+    m_vertexBufferView.BufferLocation = m_vertexBuffer.gpuAddress;
     m_vertexBufferView.StrideInBytes = sizeof(float) * 5;
     m_vertexBufferView.SizeInBytes = (UINT)vertexBufferSize;
 
-    m_indexBufferView.BufferLocation = m_indexBuffer->GetGPUVirtualAddress();
+    m_indexBufferView.BufferLocation = m_indexBuffer.gpuAddress;
     m_indexBufferView.Format = DXGI_FORMAT_R16_UINT;
     m_indexBufferView.SizeInBytes = (UINT)indexBufferSize;
 }
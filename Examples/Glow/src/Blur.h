@@ -1,5 +1,7 @@
 #pragma once
 
+#include <fw/BufferHeap.h>
+
 #include <wrl.h>
 #include <d3d12.h>
 
@@ -12,15 +14,11 @@ public:
     ~Blur(){};
 
     bool initialize(Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList>& commandList);
-    void postInitialize();
-    void render(Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList>& commandList, ID3D12DescriptorHeap* srvHeap, int srvHeapOffset);
+    void render(Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList>& commandList, D3D12_GPU_DESCRIPTOR_HANDLE singleColorTexture);
 
 private:
-    Microsoft::WRL::ComPtr<ID3D12Resource> m_vertexUploadBuffer;
-    Microsoft::WRL::ComPtr<ID3D12Resource> m_indexUploadBuffer;
-
-    Microsoft::WRL::ComPtr<ID3D12Resource> m_vertexBuffer;
-    Microsoft::WRL::ComPtr<ID3D12Resource> m_indexBuffer;
+    fw::BufferHeap::Buffer m_vertexBuffer;
+    fw::BufferHeap::Buffer m_indexBuffer;
     D3D12_VERTEX_BUFFER_VIEW m_vertexBufferView;
     D3D12_INDEX_BUFFER_VIEW m_indexBufferView;
 
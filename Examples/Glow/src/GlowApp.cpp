@@ -1,15 +1,15 @@
 #include "GlowApp.h"
 
 #include <fw/Framework.h>
+#include <fw/GpuProfiler.h>
 #include <fw/Common.h>
 #include <fw/API.h>
 #include <fw/Macros.h>
+#include <fw/Profiler.h>
 #include <fw/Transformation.h>
 
 #include <DirectXMath.h>
 
-#define STB_IMAGE_IMPLEMENTATION
-#include <stb_image.h>
 #include <GLFW/glfw3.h>
 
 #include <vector>
@@ -17,17 +17,12 @@
 
 bool GlowApp::initialize()
 {
+    FW_PROFILE_FUNCTION();
     Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> commandList = fw::API::getCommandList();
 
     fw::Model model;
     loadModel(model);
 
-    m_constantBufferOffset = 0;
-    m_albedoTextureOffset = fw::API::getSwapChainBufferCount();
-    m_singleColorTextureOffset = fw::API::getSwapChainBufferCount() + static_cast<int>(m_renderObjects.size());
-
-    createDescriptorHeap();
-    createConstantBuffer();
     createTextures(model, commandList);
     createVertexBuffers(model, commandList);
 
@@ -36,15 +31,12 @@ bool GlowApp::initialize()
 
     createRenderPSO();
 
-    m_singleColorRenderer.initialize(&m_renderObjects, m_cbvSrvDescriptorHeap.Get(), m_singleColorTextureOffset);
+    m_singleColorRenderer.initialize(&m_renderObjects);
     m_blurRenderer.initialize(commandList);
 
     // Execute and wait initialization commands
     CHECK(commandList->Close());
     fw::API::completeInitialization();
-    m_textureUploadBuffers.clear();
-    m_vertexUploadBuffers.clear();
-    m_blurRenderer.postInitialize();
 
     // Camera
     m_cameraController.setCamera(&m_camera);
@@ -80,18 +72,17 @@ void GlowApp::update()
     DirectX::XMMATRIX worldViewProj = transformation.getWorldMatrix() * m_camera.getViewMatrix() * m_camera.getProjectionMatrix();
     DirectX::XMMATRIX wvp = DirectX::XMMatrixTranspose(worldViewProj);
 
-    int currentFrameIndex = fw::API::getCurrentFrameIndex();
-    char* mappedData = nullptr;
-    CHECK(m_constantBuffers[currentFrameIndex]->Map(0, nullptr, reinterpret_cast<void**>(&mappedData)));
-    memcpy(&mappedData[0], &wvp, sizeof(DirectX::XMMATRIX));
-    m_constantBuffers[currentFrameIndex]->Unmap(0, nullptr);
+    m_constantBufferAddress = fw::API::getFrameAllocator().allocate(&wvp, sizeof(DirectX::XMMATRIX)).gpuAddress;
 
     if (fw::API::isKeyReleased(GLFW_KEY_ESCAPE))
     {
         fw::API::quit();
     }
 
-    std::cout << fw::API::getTimeDelta() << "\n";
+    if (fw::API::isKeyReleased(GLFW_KEY_T))
+    {
+        fw::API::printFrameTimes();
+    }
 }
 
 void GlowApp::fillCommandList()
@@ -102,12 +93,20 @@ void GlowApp::fillCommandList()
     CHECK(commandAllocator->Reset());
     CHECK(commandList->Reset(commandAllocator.Get(), nullptr));
 
+    fw::DescriptorHeap& descriptorHeap = fw::API::getDescriptorHeap();
+    std::vector<ID3D12DescriptorHeap*> descriptorHeaps{descriptorHeap.getHeap()};
+    commandList->SetDescriptorHeaps((UINT)descriptorHeaps.size(), descriptorHeaps.data());
+
     ID3D12Resource* currentBackBuffer = fw::API::getCurrentBackBuffer();
     commandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(currentBackBuffer, D3D12_RESOURCE_STATE_PRESENT, D3D12_RESOURCE_STATE_RENDER_TARGET));
 
     commandList->RSSetScissorRects(1, &m_scissorRect);
 
-    m_singleColorRenderer.render(commandList, m_cbvSrvDescriptorHeap.Get());
+    fw::GpuProfiler& gpuProfiler = fw::API::getGpuProfiler();
+    {
+        FW_GPU_PROFILE_SCOPE(gpuProfiler, commandList.Get(), "Single color");
+        m_singleColorRenderer.render(commandList, m_constantBufferAddress);
+    }
 
     CD3DX12_CPU_DESCRIPTOR_HANDLE currentBackBufferView = fw::API::getCurrentBackBufferView();
     const static float clearColor[4] = {0.2f, 0.4f, 0.6f, 1.0f};
@@ -119,36 +118,30 @@ void GlowApp::fillCommandList()
     commandList->RSSetViewports(1, &m_screenViewport);
     commandList->OMSetRenderTargets(1, &currentBackBufferView, true, &depthStencilView);
 
-    m_blurRenderer.render(commandList, m_cbvSrvDescriptorHeap.Get(), m_singleColorTextureOffset);
-
-    commandList->SetPipelineState(m_finalRenderPSO.Get());
-
-    std::vector<ID3D12DescriptorHeap*> descriptorHeaps{m_cbvSrvDescriptorHeap.Get()};
-    commandList->SetDescriptorHeaps((UINT)descriptorHeaps.size(), descriptorHeaps.data());
-
-    commandList->SetGraphicsRootSignature(m_rootSignature.Get());
+    {
+        FW_GPU_PROFILE_SCOPE(gpuProfiler, commandList.Get(), "Blur");
+        m_blurRenderer.render(commandList, m_singleColorRenderer.getTextureView(fw::API::getCurrentFrameIndex()));
+    }
 
-    int currentFrameIndex = fw::API::getCurrentFrameIndex();
-    UINT cbvSrvIncrementSize = fw::API::getCbvSrvUavDescriptorIncrementSize();
-    CD3DX12_GPU_DESCRIPTOR_HANDLE cbvSrvHandleBegin = CD3DX12_GPU_DESCRIPTOR_HANDLE(m_cbvSrvDescriptorHeap->GetGPUDescriptorHandleForHeapStart());
+    {
+        FW_GPU_PROFILE_SCOPE(gpuProfiler, commandList.Get(), "Final");
+        commandList->SetPipelineState(m_finalRenderPSO.Get());
 
-    CD3DX12_GPU_DESCRIPTOR_HANDLE constantBufferHandle = cbvSrvHandleBegin;
-    constantBufferHandle.Offset(m_constantBufferOffset + currentFrameIndex, cbvSrvIncrementSize);
-    commandList->SetGraphicsRootDescriptorTable(0, constantBufferHandle);
+        commandList->SetGraphicsRootSignature(m_rootSignature.Get());
 
-    commandList->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+        commandList->SetGraphicsRootConstantBufferView(0, m_constantBufferAddress);
 
-    CD3DX12_GPU_DESCRIPTOR_HANDLE textureHandle = cbvSrvHandleBegin;
-    textureHandle.Offset(m_albedoTextureOffset, cbvSrvIncrementSize);
+        commandList->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 
-    for (const RenderObject& ro : m_renderObjects)
-    {
-        commandList->SetGraphicsRootDescriptorTable(1, textureHandle);
-        textureHandle.Offset(1, fw::API::getCbvSrvUavDescriptorIncrementSize());
+        for (size_t i = 0; i < m_renderObjects.size(); ++i)
+        {
+            const RenderObject& ro = m_renderObjects[i];
+            commandList->SetGraphicsRootDescriptorTable(1, descriptorHeap.getGpuHandle(m_albedoTextureViews, static_cast<uint32_t>(i)));
 
-        commandList->IASetVertexBuffers(0, 1, &ro.vertexBufferView);
-        commandList->IASetIndexBuffer(&ro.indexBufferView);
-        commandList->DrawIndexedInstanced(ro.numIndices, 1, 0, 0, 0);
+            commandList->IASetVertexBuffers(0, 1, &ro.vertexBufferView);
+            commandList->IASetIndexBuffer(&ro.indexBufferView);
+            commandList->DrawIndexedInstanced(ro.numIndices, 1, 0, 0, 0);
+        }
     }
 
     commandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(currentBackBuffer, D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_PRESENT));
@@ -170,129 +163,43 @@ void GlowApp::loadModel(fw::Model& model)
     m_renderObjects.resize(numMeshes);
 }
 
-void GlowApp::createDescriptorHeap()
-{
-    D3D12_DESCRIPTOR_HEAP_DESC descriptorHeapDesc;
-    size_t numMeshes = m_renderObjects.size();
-    int numDescriptors = (2 * fw::API::getSwapChainBufferCount()) + static_cast<int>(numMeshes);
-    // 0-1: CBV
-    // 2-3: Albedo
-    // 4-5: Single color input
-    descriptorHeapDesc.NumDescriptors = numDescriptors;
-    descriptorHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
-    descriptorHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
-    descriptorHeapDesc.NodeMask = 0;
-
-    Microsoft::WRL::ComPtr<ID3D12Device> d3dDevice = fw::API::getD3dDevice();
-    CHECK(d3dDevice->CreateDescriptorHeap(&descriptorHeapDesc, IID_PPV_ARGS(&m_cbvSrvDescriptorHeap)));
-}
-
-void GlowApp::createConstantBuffer()
-{
-    Microsoft::WRL::ComPtr<ID3D12Device> d3dDevice = fw::API::getD3dDevice();
-
-    uint32_t constantBufferSize = fw::roundUpByteSize(sizeof(DirectX::XMFLOAT4X4));
-    m_constantBuffers.resize(fw::API::getSwapChainBufferCount());
-
-    CD3DX12_CPU_DESCRIPTOR_HANDLE handle = CD3DX12_CPU_DESCRIPTOR_HANDLE(m_cbvSrvDescriptorHeap->GetCPUDescriptorHandleForHeapStart());
-    for (int i = 0; i < m_constantBuffers.size(); ++i)
-    {
-        Microsoft::WRL::ComPtr<ID3D12Resource>& constantBuffer = m_constantBuffers[i];
-        CHECK(d3dDevice->CreateCommittedResource(&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
-                                                 D3D12_HEAP_FLAG_NONE,
-                                                 &CD3DX12_RESOURCE_DESC::Buffer(constantBufferSize),
-                                                 D3D12_RESOURCE_STATE_GENERIC_READ,
-                                                 nullptr,
-                                                 IID_PPV_ARGS(&constantBuffer)));
-
-        D3D12_CONSTANT_BUFFER_VIEW_DESC cbvDesc;
-        cbvDesc.BufferLocation = constantBuffer->GetGPUVirtualAddress();
-        cbvDesc.SizeInBytes = constantBufferSize;
-
-        d3dDevice->CreateConstantBufferView(&cbvDesc, handle);
-        handle.Offset(1, fw::API::getCbvSrvUavDescriptorIncrementSize());
-    }
-}
-
 void GlowApp::createTextures(const fw::Model& model, Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList>& commandList)
 {
-    Microsoft::WRL::ComPtr<ID3D12Device> d3dDevice = fw::API::getD3dDevice();
-
-    D3D12_RESOURCE_DESC textureDesc{};
-    textureDesc.MipLevels = 1;
-    textureDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
-    textureDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
-    textureDesc.Width = 0;
-    textureDesc.Height = 0;
-    textureDesc.DepthOrArraySize = 1;
-    textureDesc.SampleDesc.Count = 1;
-    textureDesc.SampleDesc.Quality = 0;
-    textureDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
-
-    const fw::Model::Meshes& meshes = model.getMeshes();
-    size_t numMeshes = meshes.size();
-    m_textureUploadBuffers.resize(numMeshes);
+    fw::DescriptorHeap& descriptorHeap = fw::API::getDescriptorHeap();
+    m_albedoTextureViews = descriptorHeap.allocate(static_cast<uint32_t>(model.getMeshes().size()));
 
-    CD3DX12_CPU_DESCRIPTOR_HANDLE handle = CD3DX12_CPU_DESCRIPTOR_HANDLE(m_cbvSrvDescriptorHeap->GetCPUDescriptorHandleForHeapStart());
-    handle.Offset(fw::API::getSwapChainBufferCount(), fw::API::getCbvSrvUavDescriptorIncrementSize());
-
-    for (size_t i = 0; i < numMeshes; ++i)
+    std::vector<Microsoft::WRL::ComPtr<ID3D12Resource>> textures = fw::createAlbedoTextures(fw::API::getD3dDevice().Get(), commandList.Get(), model, ASSET_PATH, fw::API::getConfig().textureQuality, descriptorHeap, m_albedoTextureViews, fw::API::getUploadRing(), fw::API::getTextureHeap());
+    for (size_t i = 0; i < textures.size(); ++i)
     {
-        std::string textureName = meshes[i].getFirstTextureOfType(aiTextureType::aiTextureType_DIFFUSE);
-        std::string filepath = ASSET_PATH;
-        filepath += textureName;
-        int texWidth, texHeight, texChannels;
-        stbi_uc* pixels = stbi_load(filepath.c_str(), &texWidth, &texHeight, &texChannels, 4);
-        assert(pixels != nullptr);
-
-        textureDesc.Width = texWidth;
-        textureDesc.Height = texHeight;
-        const int numBytes = texWidth * texHeight * texChannels;
-
-        RenderObject& ro = m_renderObjects[i];
-        ro.texture = fw::createGPUTexture(d3dDevice.Get(), commandList.Get(), pixels, numBytes, textureDesc, 4, m_textureUploadBuffers[i]);
-
-        stbi_image_free(pixels);
-
-        D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc{};
-        srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
-        srvDesc.Format = textureDesc.Format;
-        srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
-        srvDesc.Texture2D.MipLevels = 1;
-        d3dDevice->CreateShaderResourceView(ro.texture.Get(), &srvDesc, handle);
-
-        handle.Offset(1, fw::API::getCbvSrvUavDescriptorIncrementSize());
+        m_renderObjects[i].texture = textures[i];
     }
 }
 
 void GlowApp::createVertexBuffers(const fw::Model& model, Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList>& commandList)
 {
-    Microsoft::WRL::ComPtr<ID3D12Device> d3dDevice = fw::API::getD3dDevice();
-
     const fw::Model::Meshes& meshes = model.getMeshes();
     size_t numMeshes = meshes.size();
-    m_vertexUploadBuffers.resize(numMeshes);
 
     for (size_t i = 0; i < numMeshes; ++i)
     {
         RenderObject& ro = m_renderObjects[i];
         const fw::Mesh& mesh = meshes[i];
-        std::vector<fw::Mesh::Vertex> vertices = mesh.getVertices();
-        const size_t vertexBufferSize = vertices.size() * sizeof(fw::Mesh::Vertex);
-        const size_t indexBufferSize = mesh.indices.size() * sizeof(uint16_t);
+        fw::Span<const fw::Mesh::Vertex> vertices = mesh.getInterleavedVertices();
+        const size_t vertexBufferSize = vertices.sizeInBytes();
+        const size_t indexBufferSize = mesh.getIndexDataSize();
 
-        ro.vertexBuffer = fw::createGPUBuffer(d3dDevice.Get(), commandList.Get(), vertices.data(), vertexBufferSize, m_vertexUploadBuffers[i].vertexUploadBuffer);
-        ro.indexBuffer = fw::createGPUBuffer(d3dDevice.Get(), commandList.Get(), mesh.indices.data(), indexBufferSize, m_vertexUploadBuffers[i].indexUploadBuffer);
+        ro.vertexBuffer = fw::createGPUBuffer(commandList.Get(), vertices.data(), vertexBufferSize, fw::API::getUploadRing(), fw::API::getBufferHeap());
+        ro.indexBuffer = fw::createGPUBuffer(commandList.Get(), mesh.getIndexData(), indexBufferSize, fw::API::getUploadRing(), fw::API::getBufferHeap());
 
-        ro.vertexBufferView.BufferLocation = ro.vertexBuffer->GetGPUVirtualAddress();
+        ro.vertexBufferView.BufferLocation = ro.vertexBuffer.gpuAddress;
         ro.vertexBufferView.StrideInBytes = sizeof(fw::Mesh::Vertex);
         ro.vertexBufferView.SizeInBytes = (UINT)vertexBufferSize;
 
-        ro.indexBufferView.BufferLocation = ro.indexBuffer->GetGPUVirtualAddress();
-        ro.indexBufferView.Format = DXGI_FORMAT_R16_UINT;
+        ro.indexBufferView.BufferLocation = ro.indexBuffer.gpuAddress;
+        ro.indexBufferView.Format = fw::getIndexFormat(mesh);
         ro.indexBufferView.SizeInBytes = (UINT)indexBufferSize;
 
-        ro.numIndices = static_cast<UINT>(mesh.indices.size());
+        ro.numIndices = mesh.getLod(0).indexCount;
     }
 }
 
@@ -310,9 +217,7 @@ void GlowApp::createRootSignature()
 {
     std::vector<CD3DX12_ROOT_PARAMETER> rootParameters(2);
 
-    std::vector<CD3DX12_DESCRIPTOR_RANGE> cbvDescriptorRanges(1);
-    cbvDescriptorRanges[0].Init(D3D12_DESCRIPTOR_RANGE_TYPE_CBV, 1, 0);
-    rootParameters[0].InitAsDescriptorTable(fw::uintSize(cbvDescriptorRanges), cbvDescriptorRanges.data());
+    rootParameters[0].InitAsConstantBufferView(0);
 
     std::vector<CD3DX12_DESCRIPTOR_RANGE> albedoTexture(1);
     albedoTexture[0].Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 1, 0);
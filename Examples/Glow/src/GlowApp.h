@@ -7,6 +7,7 @@
 #include <fw/Application.h>
 #include <fw/Camera.h>
 #include <fw/CameraController.h>
+#include <fw/DescriptorHeap.h>
 #include <fw/Model.h>
 
 #include "d3dx12.h"
@@ -28,12 +29,6 @@ public:
     virtual void onGUI() final;
 
 private:
-    struct VertexUploadBuffers
-    {
-        Microsoft::WRL::ComPtr<ID3D12Resource> vertexUploadBuffer;
-        Microsoft::WRL::ComPtr<ID3D12Resource> indexUploadBuffer;
-    };
-
     struct Shaders
     {
         Microsoft::WRL::ComPtr<ID3DBlob> vertexShader = nullptr;
@@ -45,21 +40,14 @@ private:
     D3D12_VIEWPORT m_screenViewport;
     D3D12_RECT m_scissorRect;
 
-    Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> m_cbvSrvDescriptorHeap = nullptr;
-    std::vector<Microsoft::WRL::ComPtr<ID3D12Resource>> m_constantBuffers;
-
-    std::vector<Microsoft::WRL::ComPtr<ID3D12Resource>> m_textureUploadBuffers;
-    std::vector<VertexUploadBuffers> m_vertexUploadBuffers;
+    fw::DescriptorHeap::Range m_albedoTextureViews;
+    D3D12_GPU_VIRTUAL_ADDRESS m_constantBufferAddress = 0;
 
     Shaders m_finalRenderShaders;
 
     Microsoft::WRL::ComPtr<ID3D12RootSignature> m_rootSignature = nullptr;
     Microsoft::WRL::ComPtr<ID3D12PipelineState> m_finalRenderPSO = nullptr;
 
-    int m_constantBufferOffset = 0;
-    int m_albedoTextureOffset = 0;
-    int m_singleColorTextureOffset = 0;
-
     SingleColor m_singleColorRenderer;
     Blur m_blurRenderer;
 
@@ -67,8 +55,6 @@ private:
     fw::CameraController m_cameraController;
 
     void loadModel(fw::Model& model);
-    void createDescriptorHeap();
-    void createConstantBuffer();
     void createTextures(const fw::Model& model, Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList>& commandList);
     void createVertexBuffers(const fw::Model& model, Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList>& commandList);
     void createShaders();
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <fw/BufferHeap.h>
+
 #include "d3dx12.h"
 #include <wrl.h>
 
@@ -13,8 +15,8 @@ const std::vector<D3D12_INPUT_ELEMENT_DESC> c_vertexInputLayout = {
 
 struct RenderObject
 {
-    Microsoft::WRL::ComPtr<ID3D12Resource> vertexBuffer;
-    Microsoft::WRL::ComPtr<ID3D12Resource> indexBuffer;
+    fw::BufferHeap::Buffer vertexBuffer;
+    fw::BufferHeap::Buffer indexBuffer;
     D3D12_VERTEX_BUFFER_VIEW vertexBufferView;
     D3D12_INDEX_BUFFER_VIEW indexBufferView;
     Microsoft::WRL::ComPtr<ID3D12Resource> texture;
@@ -3,7 +3,7 @@
 #include <fw/API.h>
 #include <fw/Common.h>
 
-bool SingleColor::initialize(const std::vector<RenderObject>* renderObjects, ID3D12DescriptorHeap* srvHeap, int srvHeapOffset)
+bool SingleColor::initialize(const std::vector<RenderObject>* renderObjects)
 {
     m_renderObjects = renderObjects;
 
@@ -18,7 +18,7 @@ bool SingleColor::initialize(const std::vector<RenderObject>* renderObjects, ID3
     m_screenViewport.MinDepth = 0.0f;
     m_screenViewport.MaxDepth = 1.0f;
 
-    createRenderTarget(srvHeap, srvHeapOffset);
+    createRenderTarget();
     createShaders();
     createRootSignature();
     createSingleColorPSO();
@@ -26,7 +26,7 @@ bool SingleColor::initialize(const std::vector<RenderObject>* renderObjects, ID3
     return true;
 }
 
-void SingleColor::render(Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList>& commandList, ID3D12DescriptorHeap* constantBufferHeap)
+void SingleColor::render(Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList>& commandList, D3D12_GPU_VIRTUAL_ADDRESS constantBufferAddress)
 {
     commandList->RSSetViewports(1, &m_screenViewport);
 
@@ -42,14 +42,8 @@ void SingleColor::render(Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList>& comm
 
     commandList->OMSetRenderTargets(1, &rtvHandle, true, nullptr);
 
-    std::vector<ID3D12DescriptorHeap*> descriptorHeaps{constantBufferHeap};
-    commandList->SetDescriptorHeaps((UINT)descriptorHeaps.size(), descriptorHeaps.data());
-
     commandList->SetGraphicsRootSignature(m_rootSignature.Get());
-
-    CD3DX12_GPU_DESCRIPTOR_HANDLE constantBufferHandle = CD3DX12_GPU_DESCRIPTOR_HANDLE(constantBufferHeap->GetGPUDescriptorHandleForHeapStart());
-    constantBufferHandle.Offset(currentFrameIndex, fw::API::getCbvSrvUavDescriptorIncrementSize());
-    commandList->SetGraphicsRootDescriptorTable(0, constantBufferHandle);
+    commandList->SetGraphicsRootConstantBufferView(0, constantBufferAddress);
 
     commandList->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 
@@ -63,10 +57,15 @@ void SingleColor::render(Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList>& comm
     commandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(m_singleColorTextures[currentFrameIndex].Get(), D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE));
 }
 
-void SingleColor::createRenderTarget(ID3D12DescriptorHeap* srvHeap, int srvHeapOffset)
+D3D12_GPU_DESCRIPTOR_HANDLE SingleColor::getTextureView(int frameIndex) const
+{
+    return fw::API::getDescriptorHeap().getGpuHandle(m_textureViews, frameIndex);
+}
+
+void SingleColor::createRenderTarget()
 {
     Microsoft::WRL::ComPtr<ID3D12Device> d3dDevice = fw::API::getD3dDevice();
-    int swapChainSize = fw::API::getSwapChainBufferCount();
+    int frameCount = fw::API::getFrameCount();
 
     // Create texture resources
     D3D12_RESOURCE_DESC resourceDesc{};
@@ -92,9 +91,9 @@ void SingleColor::createRenderTarget(ID3D12DescriptorHeap* srvHeap, int srvHeapO
     clearValue.Format = fw::API::getBackBufferFormat();
 
     CD3DX12_HEAP_PROPERTIES heapProperty(D3D12_HEAP_TYPE_DEFAULT);
-    m_singleColorTextures.resize(swapChainSize);
+    m_singleColorTextures.resize(frameCount);
 
-    for (int i = 0; i < swapChainSize; ++i)
+    for (int i = 0; i < frameCount; ++i)
     {
         CHECK(d3dDevice->CreateCommittedResource(&heapProperty,
                                                  D3D12_HEAP_FLAG_NONE,
@@ -106,7 +105,7 @@ void SingleColor::createRenderTarget(ID3D12DescriptorHeap* srvHeap, int srvHeapO
 
     // Create RTV heap and render target views
     D3D12_DESCRIPTOR_HEAP_DESC rtvDescriptorHeapDesc{};
-    rtvDescriptorHeapDesc.NumDescriptors = swapChainSize;
+    rtvDescriptorHeapDesc.NumDescriptors = frameCount;
     rtvDescriptorHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_RTV;
     rtvDescriptorHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
     rtvDescriptorHeapDesc.NodeMask = 0;
@@ -121,7 +120,7 @@ void SingleColor::createRenderTarget(ID3D12DescriptorHeap* srvHeap, int srvHeapO
 
     CD3DX12_CPU_DESCRIPTOR_HANDLE rtvHandle = CD3DX12_CPU_DESCRIPTOR_HANDLE(m_rtvHeap->GetCPUDescriptorHandleForHeapStart());
 
-    for (int i = 0; i < swapChainSize; ++i)
+    for (int i = 0; i < frameCount; ++i)
     {
         d3dDevice->CreateRenderTargetView(m_singleColorTextures[i].Get(), &renderTargetViewDesc, rtvHandle);
         rtvHandle.Offset(1, fw::API::getRtvDescriptorIncrementSize());
@@ -136,13 +135,12 @@ void SingleColor::createRenderTarget(ID3D12DescriptorHeap* srvHeap, int srvHeapO
     srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
     srvDesc.Format = fw::API::getBackBufferFormat();
 
-    CD3DX12_CPU_DESCRIPTOR_HANDLE srvHandle = CD3DX12_CPU_DESCRIPTOR_HANDLE(srvHeap->GetCPUDescriptorHandleForHeapStart());
-    srvHandle.Offset(srvHeapOffset, fw::API::getCbvSrvUavDescriptorIncrementSize());
+    fw::DescriptorHeap& descriptorHeap = fw::API::getDescriptorHeap();
+    m_textureViews = descriptorHeap.allocate(frameCount);
 
-    for (int i = 0; i < swapChainSize; ++i)
+    for (int i = 0; i < frameCount; ++i)
     {
-        d3dDevice->CreateShaderResourceView(m_singleColorTextures[i].Get(), &srvDesc, srvHandle);
-        srvHandle.Offset(1, fw::API::getCbvSrvUavDescriptorIncrementSize());
+        d3dDevice->CreateShaderResourceView(m_singleColorTextures[i].Get(), &srvDesc, descriptorHeap.getCpuHandle(m_textureViews, i));
     }
 }
 
@@ -160,9 +158,7 @@ void SingleColor::createRootSignature()
 {
     std::vector<CD3DX12_ROOT_PARAMETER> rootParameters(1);
 
-    std::vector<CD3DX12_DESCRIPTOR_RANGE> cbvDescriptorRanges(1);
-    cbvDescriptorRanges[0].Init(D3D12_DESCRIPTOR_RANGE_TYPE_CBV, 1, 0);
-    rootParameters[0].InitAsDescriptorTable(fw::uintSize(cbvDescriptorRanges), cbvDescriptorRanges.data());
+    rootParameters[0].InitAsConstantBufferView(0);
 
     CD3DX12_ROOT_SIGNATURE_DESC rootSigDesc(fw::uintSize(rootParameters), rootParameters.data(), 0, nullptr, D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT);
 
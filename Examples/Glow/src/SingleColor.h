@@ -2,6 +2,8 @@
 
 #include "Shared.h"
 
+#include <fw/DescriptorHeap.h>
+
 #include <wrl.h>
 #include <d3d12.h>
 
@@ -13,8 +15,11 @@ public:
     SingleColor(){};
     ~SingleColor(){};
 
-    bool initialize(const std::vector<RenderObject>* renderObjects, ID3D12DescriptorHeap* srvHeap, int srvHeapOffset);
-    void render(Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList>& commandList, ID3D12DescriptorHeap* constantBufferHeap);
+    bool initialize(const std::vector<RenderObject>* renderObjects);
+    void render(Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList>& commandList, D3D12_GPU_VIRTUAL_ADDRESS constantBufferAddress);
+
+    // Shader resource view of the frame's single color texture
+    D3D12_GPU_DESCRIPTOR_HANDLE getTextureView(int frameIndex) const;
 
 private:
     D3D12_VIEWPORT m_screenViewport;
@@ -26,6 +31,7 @@ private:
 
     std::vector<Microsoft::WRL::ComPtr<ID3D12Resource>> m_singleColorTextures;
     Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> m_rtvHeap = nullptr;
+    fw::DescriptorHeap::Range m_textureViews;
 
     Microsoft::WRL::ComPtr<ID3DBlob> m_vertexShader = nullptr;
     Microsoft::WRL::ComPtr<ID3DBlob> m_pixelShader = nullptr;
@@ -34,7 +40,7 @@ private:
 
     Microsoft::WRL::ComPtr<ID3D12PipelineState> m_PSO = nullptr;
 
-    void createRenderTarget(ID3D12DescriptorHeap* srvHeap, int srvHeapOffset);
+    void createRenderTarget();
     void createShaders();
     void createRootSignature();
     void createSingleColorPSO();
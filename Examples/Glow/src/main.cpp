@@ -3,5 +3,5 @@
 
 int main(int argc, char** argv)
 {
-    return fw::runApplication<GlowApp>();
+    return fw::runApplication<GlowApp>(argc, argv);
 }
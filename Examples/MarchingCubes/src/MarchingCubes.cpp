@@ -1,6 +1,8 @@
 ﻿#include "MarchingCubes.h"
 #include "FastNoise.h"
 
+#include <fw/Profiler.h>
+
 #include <DirectXMath.h>
 
 #include <functional>
@@ -325,6 +327,7 @@ const std::vector<MarchingCubes::IndexType>& MarchingCubes::getIndices() const
 
 void MarchingCubes::generateData(size_t size)
 {
+    FW_PROFILE_FUNCTION();
     FastNoise fastNoise;
     fastNoise.SetFrequency(0.04f);
     fastNoise.SetInterp(FastNoise::Quintic);
@@ -347,6 +350,7 @@ void MarchingCubes::generateData(size_t size)
 
 void MarchingCubes::generateMesh()
 {
+    FW_PROFILE_FUNCTION();
     const size_t size = m_dataSet.size() - 1;
     m_cubeData.resize(size);
     for (size_t z = 0; z < size; ++z)
@@ -427,6 +431,7 @@ void MarchingCubes::generateCubeTriangles(CubeInfo& cubeInfo, size_t x, size_t y
 
 void MarchingCubes::generateIndicesAndShadingNormals()
 {
+    FW_PROFILE_FUNCTION();
     int indexCounter = 0;
     const int size = static_cast<int>(m_cubeData.size());
     for (int z = 0; z < size; ++z)
@@ -521,6 +526,7 @@ void MarchingCubes::mergeVertices(CubeInfo& c1, CubeInfo& c2, int i1, const std:
 
 void MarchingCubes::generateVertexDataForRendering()
 {
+    FW_PROFILE_FUNCTION();
     const size_t size = m_cubeData.size();
     int indexCounter = 0;
     for (size_t z = 0; z < size; ++z)
@@ -4,12 +4,11 @@
 #include <fw/Common.h>
 #include <fw/API.h>
 #include <fw/Macros.h>
+#include <fw/Profiler.h>
 #include <fw/Transformation.h>
 
 #include <DirectXMath.h>
 
-#define STB_IMAGE_IMPLEMENTATION
-#include <stb_image.h>
 #include <GLFW/glfw3.h>
 
 #include <vector>
@@ -26,14 +25,13 @@ std::chrono::steady_clock::time_point s_begin;
 
 bool MarchingCubesApp::initialize()
 {
+    FW_PROFILE_FUNCTION();
     s_begin = std::chrono::steady_clock::now();
 
     m_marchingCubes.generateVertices(256);
 
     Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> commandList = fw::API::getCommandList();
 
-    createDescriptorHeap();
-    createConstantBuffer();
     createVertexBuffers(commandList);
 
     createShaders();
@@ -44,8 +42,6 @@ bool MarchingCubesApp::initialize()
     // Execute and wait initialization commands
     CHECK(commandList->Close());
     fw::API::completeInitialization();
-    m_textureUploadBuffers.clear();
-    m_vertexUploadBuffers.clear();
 
     // Camera
     m_camera.setFarClipDistance(1000.0f);
@@ -91,13 +87,12 @@ void MarchingCubesApp::update()
     const DirectX::XMVECTOR& pos = m_camera.getTransformation().position;
     const DirectX::XMVECTOR posAndTime = DirectX::XMVectorSetW(pos, timeInSeconds);
 
-    int currentFrameIndex = fw::API::getCurrentFrameIndex();
-    DirectX::XMMATRIX* mappedData = nullptr;
-    CHECK(m_constantBuffers[currentFrameIndex]->Map(0, nullptr, reinterpret_cast<void**>(&mappedData)));
+    fw::FrameAllocator::Allocation constants = fw::API::getFrameAllocator().allocate(2 * sizeof(DirectX::XMMATRIX) + sizeof(DirectX::XMVECTOR));
+    DirectX::XMMATRIX* mappedData = reinterpret_cast<DirectX::XMMATRIX*>(constants.data);
     memcpy(&mappedData[0], &world, sizeof(DirectX::XMMATRIX));
     memcpy(&mappedData[1], &wvp, sizeof(DirectX::XMMATRIX));
     memcpy(&mappedData[2], &posAndTime, sizeof(DirectX::XMVECTOR));
-    m_constantBuffers[currentFrameIndex]->Unmap(0, nullptr);
+    m_constantBufferAddress = constants.gpuAddress;
 
     if (fw::API::isKeyReleased(GLFW_KEY_ESCAPE))
     {
@@ -131,9 +126,9 @@ void MarchingCubesApp::fillCommandList()
     commandList->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 
     commandList->SetGraphicsRootSignature(m_rootSignature.Get());
-    commandList->SetGraphicsRootConstantBufferView(0, m_constantBuffers[fw::API::getCurrentFrameIndex()]->GetGPUVirtualAddress());
+    commandList->SetGraphicsRootConstantBufferView(0, m_constantBufferAddress);
 
-    std::vector<ID3D12DescriptorHeap*> descriptorHeaps{m_descriptorHeap.Get()};
+    std::vector<ID3D12DescriptorHeap*> descriptorHeaps{fw::API::getDescriptorHeap().getHeap()};
     commandList->SetDescriptorHeaps((UINT)descriptorHeaps.size(), descriptorHeaps.data());
 
     commandList->IASetVertexBuffers(0, 1, &m_renderObject.vertexBufferView);
@@ -149,43 +144,8 @@ void MarchingCubesApp::onGUI()
 {
 }
 
-void MarchingCubesApp::createDescriptorHeap()
-{
-    D3D12_DESCRIPTOR_HEAP_DESC descriptorHeapDesc;
-    size_t numMeshes = 1;
-    descriptorHeapDesc.NumDescriptors = static_cast<int>(numMeshes);
-    descriptorHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
-    descriptorHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
-    descriptorHeapDesc.NodeMask = 0;
-
-    Microsoft::WRL::ComPtr<ID3D12Device> d3dDevice = fw::API::getD3dDevice();
-    CHECK(d3dDevice->CreateDescriptorHeap(&descriptorHeapDesc, IID_PPV_ARGS(&m_descriptorHeap)));
-}
-
-void MarchingCubesApp::createConstantBuffer()
-{
-    Microsoft::WRL::ComPtr<ID3D12Device> d3dDevice = fw::API::getD3dDevice();
-
-    uint32_t constantBufferSize = fw::roundUpByteSize(2 * sizeof(DirectX::XMFLOAT4X4) + sizeof(DirectX::XMVECTOR));
-    m_constantBuffers.resize(fw::API::getSwapChainBufferCount());
-
-    for (int i = 0; i < m_constantBuffers.size(); ++i)
-    {
-        Microsoft::WRL::ComPtr<ID3D12Resource>& constantBuffer = m_constantBuffers[i];
-        CHECK(d3dDevice->CreateCommittedResource(&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
-                                                 D3D12_HEAP_FLAG_NONE,
-                                                 &CD3DX12_RESOURCE_DESC::Buffer(constantBufferSize),
-                                                 D3D12_RESOURCE_STATE_GENERIC_READ,
-                                                 nullptr,
-                                                 IID_PPV_ARGS(&constantBuffer)));
-    }
-}
-
 void MarchingCubesApp::createVertexBuffers(Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList>& commandList)
 {
-    Microsoft::WRL::ComPtr<ID3D12Device> d3dDevice = fw::API::getD3dDevice();
-
-    m_vertexUploadBuffers.resize(1);
     RenderObject& ro = m_renderObject;
 
     const std::vector<MarchingCubes::Vertex>& vertices = m_marchingCubes.getVertices();
@@ -194,14 +154,14 @@ void MarchingCubesApp::createVertexBuffers(Microsoft::WRL::ComPtr<ID3D12Graphics
     const std::vector<MarchingCubes::IndexType>& indices = m_marchingCubes.getIndices();
     const size_t indexBufferSize = indices.size() * sizeof(MarchingCubes::IndexType);
 
-    ro.vertexBuffer = fw::createGPUBuffer(d3dDevice.Get(), commandList.Get(), vertices.data(), vertexBufferSize, m_vertexUploadBuffers[0].vertexUploadBuffer);
-    ro.indexBuffer = fw::createGPUBuffer(d3dDevice.Get(), commandList.Get(), indices.data(), indexBufferSize, m_vertexUploadBuffers[0].indexUploadBuffer);
+    ro.vertexBuffer = fw::createGPUBuffer(commandList.Get(), vertices.data(), vertexBufferSize, fw::API::getUploadRing(), fw::API::getBufferHeap());
+    ro.indexBuffer = fw::createGPUBuffer(commandList.Get(), indices.data(), indexBufferSize, fw::API::getUploadRing(), fw::API::getBufferHeap());
 
-    ro.vertexBufferView.BufferLocation = ro.vertexBuffer->GetGPUVirtualAddress();
+    ro.vertexBufferView.BufferLocation = ro.vertexBuffer.gpuAddress;
     ro.vertexBufferView.StrideInBytes = sizeof(MarchingCubes::Vertex);
     ro.vertexBufferView.SizeInBytes = (UINT)vertexBufferSize;
 
-    ro.indexBufferView.BufferLocation = ro.indexBuffer->GetGPUVirtualAddress();
+    ro.indexBufferView.BufferLocation = ro.indexBuffer.gpuAddress;
     ro.indexBufferView.Format = DXGI_FORMAT_R32_UINT;
     ro.indexBufferView.SizeInBytes = (UINT)indexBufferSize;
 
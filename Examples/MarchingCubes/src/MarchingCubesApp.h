@@ -3,6 +3,7 @@
 #include "MarchingCubes.h"
 
 #include <fw/Application.h>
+#include <fw/BufferHeap.h>
 #include <fw/Camera.h>
 #include <fw/CameraController.h>
 
@@ -27,19 +28,13 @@ public:
 private:
     struct RenderObject
     {
-        Microsoft::WRL::ComPtr<ID3D12Resource> vertexBuffer;
-        Microsoft::WRL::ComPtr<ID3D12Resource> indexBuffer;
+        fw::BufferHeap::Buffer vertexBuffer;
+        fw::BufferHeap::Buffer indexBuffer;
         D3D12_VERTEX_BUFFER_VIEW vertexBufferView;
         D3D12_INDEX_BUFFER_VIEW indexBufferView;
         UINT indexCount;
     };
 
-    struct VertexUploadBuffers
-    {
-        Microsoft::WRL::ComPtr<ID3D12Resource> vertexUploadBuffer;
-        Microsoft::WRL::ComPtr<ID3D12Resource> indexUploadBuffer;
-    };
-
     MarchingCubes m_marchingCubes;
 
     D3D12_VIEWPORT m_screenViewport;
@@ -47,11 +42,7 @@ private:
 
     Microsoft::WRL::ComPtr<ID3D12RootSignature> m_rootSignature = nullptr;
 
-    Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> m_descriptorHeap = nullptr;
-    std::vector<Microsoft::WRL::ComPtr<ID3D12Resource>> m_constantBuffers;
-
-    std::vector<Microsoft::WRL::ComPtr<ID3D12Resource>> m_textureUploadBuffers;
-    std::vector<VertexUploadBuffers> m_vertexUploadBuffers;
+    D3D12_GPU_VIRTUAL_ADDRESS m_constantBufferAddress = 0;
 
     Microsoft::WRL::ComPtr<ID3DBlob> m_vertexShader = nullptr;
     Microsoft::WRL::ComPtr<ID3DBlob> m_pixelShader = nullptr;
@@ -63,8 +54,6 @@ private:
     fw::Camera m_camera;
     fw::CameraController m_cameraController;
 
-    void createDescriptorHeap();
-    void createConstantBuffer();
     void createVertexBuffers(Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList>& commandList);
     void createShaders();
     void createRootSignature();
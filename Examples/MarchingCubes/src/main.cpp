@@ -3,5 +3,5 @@
 
 int main(int argc, char** argv)
 {
-    return fw::runApplication<MarchingCubesApp>();
+    return fw::runApplication<MarchingCubesApp>(argc, argv);
 }
@@ -4,12 +4,11 @@
 #include <fw/Common.h>
 #include <fw/API.h>
 #include <fw/Macros.h>
+#include <fw/Profiler.h>
 #include <fw/Transformation.h>
 
 #include <DirectXMath.h>
 
-#define STB_IMAGE_IMPLEMENTATION
-#include <stb_image.h>
 #include <GLFW/glfw3.h>
 
 #include <vector>
@@ -26,26 +25,28 @@ const std::vector<D3D12_INPUT_ELEMENT_DESC> c_vertexInputLayout = {
 
 bool MinimalApp::initialize()
 {
+    FW_PROFILE_FUNCTION();
     Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> commandList = fw::API::getCommandList();
 
+    // The model is imported in the background while the pipeline is created
+    std::string modelFilepath = ASSET_PATH;
+    modelFilepath += "attack_droid.obj";
     fw::Model model;
-    loadModel(model);
-
-    createDescriptorHeap();
-    createConstantBuffer();
-    createTextures(model, commandList);
-    createVertexBuffers(model, commandList);
+    fw::Model::LoadHandle modelLoad = model.loadAsync(modelFilepath);
 
     createShaders();
     createRootSignature();
 
     createRenderPSO();
 
+    loadModel(model, modelLoad);
+
+    createTextures(model, commandList);
+    createVertexBuffers(model, commandList);
+
     // Execute and wait initialization commands
     CHECK(commandList->Close());
     fw::API::completeInitialization();
-    m_textureUploadBuffers.clear();
-    m_vertexUploadBuffers.clear();
 
     // Camera
     m_cameraController.setCamera(&m_camera);
@@ -81,11 +82,7 @@ void MinimalApp::update()
     DirectX::XMMATRIX worldViewProj = transformation.getWorldMatrix() * m_camera.getViewMatrix() * m_camera.getProjectionMatrix();
     DirectX::XMMATRIX wvp = DirectX::XMMatrixTranspose(worldViewProj);
 
-    int currentFrameIndex = fw::API::getCurrentFrameIndex();
-    char* mappedData = nullptr;
-    CHECK(m_constantBuffers[currentFrameIndex]->Map(0, nullptr, reinterpret_cast<void**>(&mappedData)));
-    memcpy(&mappedData[0], &wvp, sizeof(DirectX::XMMATRIX));
-    m_constantBuffers[currentFrameIndex]->Unmap(0, nullptr);
+    m_constantBufferAddress = fw::API::getFrameAllocator().allocate(&wvp, sizeof(DirectX::XMMATRIX)).gpuAddress;
 
     if (fw::API::isKeyReleased(GLFW_KEY_ESCAPE))
     {
@@ -119,17 +116,16 @@ void MinimalApp::fillCommandList()
     commandList->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 
     commandList->SetGraphicsRootSignature(m_rootSignature.Get());
-    commandList->SetGraphicsRootConstantBufferView(0, m_constantBuffers[fw::API::getCurrentFrameIndex()]->GetGPUVirtualAddress());
+    commandList->SetGraphicsRootConstantBufferView(0, m_constantBufferAddress);
 
-    std::vector<ID3D12DescriptorHeap*> descriptorHeaps{m_descriptorHeap.Get()};
+    fw::DescriptorHeap& descriptorHeap = fw::API::getDescriptorHeap();
+    std::vector<ID3D12DescriptorHeap*> descriptorHeaps{descriptorHeap.getHeap()};
     commandList->SetDescriptorHeaps((UINT)descriptorHeaps.size(), descriptorHeaps.data());
 
-    CD3DX12_GPU_DESCRIPTOR_HANDLE textureHandle = CD3DX12_GPU_DESCRIPTOR_HANDLE(m_descriptorHeap->GetGPUDescriptorHandleForHeapStart());
-
-    for (const RenderObject& ro : m_renderObjects)
+    for (size_t i = 0; i < m_renderObjects.size(); ++i)
     {
-        commandList->SetGraphicsRootDescriptorTable(1, textureHandle);
-        textureHandle.Offset(1, fw::API::getCbvSrvUavDescriptorIncrementSize());
+        const RenderObject& ro = m_renderObjects[i];
+        commandList->SetGraphicsRootDescriptorTable(1, descriptorHeap.getGpuHandle(m_textureViews, static_cast<uint32_t>(i)));
 
         commandList->IASetVertexBuffers(0, 1, &ro.vertexBufferView);
         commandList->IASetIndexBuffer(&ro.indexBufferView);
@@ -145,126 +141,51 @@ void MinimalApp::onGUI()
 {
 }
 
-void MinimalApp::loadModel(fw::Model& model)
+void MinimalApp::loadModel(fw::Model& model, const fw::Model::LoadHandle& modelLoad)
 {
-    std::string modelFilepath = ASSET_PATH;
-    modelFilepath += "attack_droid.obj";
-    bool modelLoaded = model.loadModel(modelFilepath);
+    bool modelLoaded = modelLoad.get();
     assert(modelLoaded);
     const size_t numMeshes = model.getMeshes().size();
     m_renderObjects.resize(numMeshes);
 }
 
-void MinimalApp::createDescriptorHeap()
-{
-    D3D12_DESCRIPTOR_HEAP_DESC descriptorHeapDesc;
-    size_t numMeshes = m_renderObjects.size();
-    descriptorHeapDesc.NumDescriptors = static_cast<int>(numMeshes);
-    descriptorHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
-    descriptorHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
-    descriptorHeapDesc.NodeMask = 0;
-
-    Microsoft::WRL::ComPtr<ID3D12Device> d3dDevice = fw::API::getD3dDevice();
-    CHECK(d3dDevice->CreateDescriptorHeap(&descriptorHeapDesc, IID_PPV_ARGS(&m_descriptorHeap)));
-}
-
-void MinimalApp::createConstantBuffer()
-{
-    Microsoft::WRL::ComPtr<ID3D12Device> d3dDevice = fw::API::getD3dDevice();
-
-    uint32_t constantBufferSize = fw::roundUpByteSize(sizeof(DirectX::XMFLOAT4X4));
-    m_constantBuffers.resize(fw::API::getSwapChainBufferCount());
-
-    for (int i = 0; i < m_constantBuffers.size(); ++i)
-    {
-        Microsoft::WRL::ComPtr<ID3D12Resource>& constantBuffer = m_constantBuffers[i];
-        CHECK(d3dDevice->CreateCommittedResource(&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
-                                                 D3D12_HEAP_FLAG_NONE,
-                                                 &CD3DX12_RESOURCE_DESC::Buffer(constantBufferSize),
-                                                 D3D12_RESOURCE_STATE_GENERIC_READ,
-                                                 nullptr,
-                                                 IID_PPV_ARGS(&constantBuffer)));
-    }
-}
-
 void MinimalApp::createTextures(const fw::Model& model, Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList>& commandList)
 {
-    Microsoft::WRL::ComPtr<ID3D12Device> d3dDevice = fw::API::getD3dDevice();
-
-    D3D12_RESOURCE_DESC textureDesc{};
-    textureDesc.MipLevels = 1;
-    textureDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
-    textureDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
-    textureDesc.Width = 0;
-    textureDesc.Height = 0;
-    textureDesc.DepthOrArraySize = 1;
-    textureDesc.SampleDesc.Count = 1;
-    textureDesc.SampleDesc.Quality = 0;
-    textureDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
-
-    const fw::Model::Meshes& meshes = model.getMeshes();
-    size_t numMeshes = meshes.size();
-    m_textureUploadBuffers.resize(numMeshes);
+    fw::DescriptorHeap& descriptorHeap = fw::API::getDescriptorHeap();
+    m_textureViews = descriptorHeap.allocate(static_cast<uint32_t>(model.getMeshes().size()));
 
-    CD3DX12_CPU_DESCRIPTOR_HANDLE handle = CD3DX12_CPU_DESCRIPTOR_HANDLE(m_descriptorHeap->GetCPUDescriptorHandleForHeapStart());
-
-    for (size_t i = 0; i < numMeshes; ++i)
+    std::vector<Microsoft::WRL::ComPtr<ID3D12Resource>> textures = fw::createAlbedoTextures(fw::API::getD3dDevice().Get(), commandList.Get(), model, ASSET_PATH, fw::API::getConfig().textureQuality, descriptorHeap, m_textureViews, fw::API::getUploadRing(), fw::API::getTextureHeap());
+    for (size_t i = 0; i < textures.size(); ++i)
     {
-        std::string textureName = meshes[i].getFirstTextureOfType(aiTextureType::aiTextureType_DIFFUSE);
-        std::string filepath = ASSET_PATH;
-        filepath += textureName;
-        int texWidth, texHeight, texChannels;
-        stbi_uc* pixels = stbi_load(filepath.c_str(), &texWidth, &texHeight, &texChannels, 4);
-        assert(pixels != nullptr);
-
-        textureDesc.Width = texWidth;
-        textureDesc.Height = texHeight;
-        const int numBytes = texWidth * texHeight * texChannels;
-
-        RenderObject& ro = m_renderObjects[i];
-        ro.texture = fw::createGPUTexture(d3dDevice.Get(), commandList.Get(), pixels, numBytes, textureDesc, 4, m_textureUploadBuffers[i]);
-
-        stbi_image_free(pixels);
-
-        D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc{};
-        srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
-        srvDesc.Format = textureDesc.Format;
-        srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
-        srvDesc.Texture2D.MipLevels = 1;
-        d3dDevice->CreateShaderResourceView(ro.texture.Get(), &srvDesc, handle);
-
-        handle.Offset(1, fw::API::getCbvSrvUavDescriptorIncrementSize());
+        m_renderObjects[i].texture = textures[i];
     }
 }
 
 void MinimalApp::createVertexBuffers(const fw::Model& model, Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList>& commandList)
 {
-    Microsoft::WRL::ComPtr<ID3D12Device> d3dDevice = fw::API::getD3dDevice();
-
     const fw::Model::Meshes& meshes = model.getMeshes();
     size_t numMeshes = meshes.size();
-    m_vertexUploadBuffers.resize(numMeshes);
 
     for (size_t i = 0; i < numMeshes; ++i)
     {
         RenderObject& ro = m_renderObjects[i];
         const fw::Mesh& mesh = meshes[i];
-        std::vector<fw::Mesh::Vertex> vertices = mesh.getVertices();
-        const size_t vertexBufferSize = vertices.size() * sizeof(fw::Mesh::Vertex);
-        const size_t indexBufferSize = mesh.indices.size() * sizeof(uint16_t);
+        fw::Span<const fw::Mesh::Vertex> vertices = mesh.getInterleavedVertices();
+        const size_t vertexBufferSize = vertices.sizeInBytes();
+        const size_t indexBufferSize = mesh.getIndexDataSize();
 
-        ro.vertexBuffer = fw::createGPUBuffer(d3dDevice.Get(), commandList.Get(), vertices.data(), vertexBufferSize, m_vertexUploadBuffers[i].vertexUploadBuffer);
-        ro.indexBuffer = fw::createGPUBuffer(d3dDevice.Get(), commandList.Get(), mesh.indices.data(), indexBufferSize, m_vertexUploadBuffers[i].indexUploadBuffer);
+        ro.vertexBuffer = fw::createGPUBuffer(commandList.Get(), vertices.data(), vertexBufferSize, fw::API::getUploadRing(), fw::API::getBufferHeap());
+        ro.indexBuffer = fw::createGPUBuffer(commandList.Get(), mesh.getIndexData(), indexBufferSize, fw::API::getUploadRing(), fw::API::getBufferHeap());
 
-        ro.vertexBufferView.BufferLocation = ro.vertexBuffer->GetGPUVirtualAddress();
+        ro.vertexBufferView.BufferLocation = ro.vertexBuffer.gpuAddress;
         ro.vertexBufferView.StrideInBytes = sizeof(fw::Mesh::Vertex);
         ro.vertexBufferView.SizeInBytes = (UINT)vertexBufferSize;
 
-        ro.indexBufferView.BufferLocation = ro.indexBuffer->GetGPUVirtualAddress();
-        ro.indexBufferView.Format = DXGI_FORMAT_R16_UINT;
+        ro.indexBufferView.BufferLocation = ro.indexBuffer.gpuAddress;
+        ro.indexBufferView.Format = fw::getIndexFormat(mesh);
         ro.indexBufferView.SizeInBytes = (UINT)indexBufferSize;
 
-        ro.numIndices = static_cast<UINT>(mesh.indices.size());
+        ro.numIndices = mesh.getLod(0).indexCount;
     }
 }
 
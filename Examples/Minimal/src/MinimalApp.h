@@ -1,8 +1,10 @@
 #pragma once
 
 #include <fw/Application.h>
+#include <fw/BufferHeap.h>
 #include <fw/Camera.h>
 #include <fw/CameraController.h>
+#include <fw/DescriptorHeap.h>
 #include <fw/Model.h>
 
 #include "d3dx12.h"
@@ -26,30 +28,21 @@ public:
 private:
     struct RenderObject
     {
-        Microsoft::WRL::ComPtr<ID3D12Resource> vertexBuffer;
-        Microsoft::WRL::ComPtr<ID3D12Resource> indexBuffer;
+        fw::BufferHeap::Buffer vertexBuffer;
+        fw::BufferHeap::Buffer indexBuffer;
         D3D12_VERTEX_BUFFER_VIEW vertexBufferView;
         D3D12_INDEX_BUFFER_VIEW indexBufferView;
         Microsoft::WRL::ComPtr<ID3D12Resource> texture;
         UINT numIndices;
     };
 
-    struct VertexUploadBuffers
-    {
-        Microsoft::WRL::ComPtr<ID3D12Resource> vertexUploadBuffer;
-        Microsoft::WRL::ComPtr<ID3D12Resource> indexUploadBuffer;
-    };
-
     D3D12_VIEWPORT m_screenViewport;
     D3D12_RECT m_scissorRect;
 
     Microsoft::WRL::ComPtr<ID3D12RootSignature> m_rootSignature = nullptr;
 
-    Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> m_descriptorHeap = nullptr;
-    std::vector<Microsoft::WRL::ComPtr<ID3D12Resource>> m_constantBuffers;
-
-    std::vector<Microsoft::WRL::ComPtr<ID3D12Resource>> m_textureUploadBuffers;
-    std::vector<VertexUploadBuffers> m_vertexUploadBuffers;
+    fw::DescriptorHeap::Range m_textureViews;
+    D3D12_GPU_VIRTUAL_ADDRESS m_constantBufferAddress = 0;
 
     Microsoft::WRL::ComPtr<ID3DBlob> m_vertexShader = nullptr;
     Microsoft::WRL::ComPtr<ID3DBlob> m_pixelShader = nullptr;
@@ -61,9 +54,7 @@ private:
     fw::Camera m_camera;
     fw::CameraController m_cameraController;
 
-    void loadModel(fw::Model& model);
-    void createDescriptorHeap();
-    void createConstantBuffer();
+    void loadModel(fw::Model& model, const fw::Model::LoadHandle& modelLoad);
     void createTextures(const fw::Model& model, Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList>& commandList);
     void createVertexBuffers(const fw::Model& model, Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList>& commandList);
     void createShaders();
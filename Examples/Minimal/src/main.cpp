@@ -3,5 +3,5 @@
 
 int main(int argc, char** argv)
 {
-    return fw::runApplication<MinimalApp>();
+    return fw::runApplication<MinimalApp>(argc, argv);
 }
@@ -2,9 +2,11 @@
 #include "Shared.h"
 
 #include <fw/Framework.h>
+#include <fw/GpuProfiler.h>
 #include <fw/Common.h>
 #include <fw/API.h>
 #include <fw/Macros.h>
+#include <fw/Profiler.h>
 #include <fw/Transformation.h>
 
 #include <DirectXMath.h>
@@ -16,20 +18,15 @@
 
 namespace
 {
-const int c_descriptorHeapSize = 2048;
-const int c_albedoTextureOffset = 0;
-const int c_renderTextureOffset = 512;
-const int c_renderDepthOffset = 513;
-const int c_motionVectorTextureOffset = 1024;
 const float c_clearColor[4] = {0.0f, 0.0f, 1.0f, 1.0f};
 
 } // namespace
 
 bool MotionBlurApp::initialize()
 {
+    FW_PROFILE_FUNCTION();
     Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> commandList = fw::API::getCommandList();
 
-    createDescriptorHeap();
     createVertexBuffers(commandList);
 
     createShaders();
@@ -37,16 +34,12 @@ bool MotionBlurApp::initialize()
 
     createRenderPSO();
 
-    m_objectRender.initialize(commandList, m_descriptorHeap.Get(), c_albedoTextureOffset, c_renderTextureOffset, c_renderDepthOffset);
-    m_motionVector.initialize(commandList, m_descriptorHeap.Get(), c_motionVectorTextureOffset);
+    m_objectRender.initialize(commandList);
+    m_motionVector.initialize(commandList);
 
     // Execute and wait initialization commands
     CHECK(commandList->Close());
     fw::API::completeInitialization();
-    m_vertexUploadBuffer.Reset();
-    m_indexUploadBuffer.Reset();
-    m_objectRender.postInitialize();
-    m_motionVector.postInitialize();
 
     // Camera
     m_camera.getTransformation().setPosition(0.0f, 10.0f, -50.0f);
@@ -99,11 +92,21 @@ void MotionBlurApp::fillCommandList()
     CHECK(commandAllocator->Reset());
     CHECK(commandList->Reset(commandAllocator.Get(), nullptr));
 
+    std::vector<ID3D12DescriptorHeap*> descriptorHeaps{fw::API::getDescriptorHeap().getHeap()};
+    commandList->SetDescriptorHeaps((UINT)descriptorHeaps.size(), descriptorHeaps.data());
+
     commandList->RSSetViewports(1, &m_screenViewport);
     commandList->RSSetScissorRects(1, &m_scissorRect);
 
-    m_objectRender.render(commandList);
-    m_motionVector.render(commandList, m_descriptorHeap.Get(), c_renderDepthOffset);
+    fw::GpuProfiler& gpuProfiler = fw::API::getGpuProfiler();
+    {
+        FW_GPU_PROFILE_SCOPE(gpuProfiler, commandList.Get(), "Objects");
+        m_objectRender.render(commandList);
+    }
+    {
+        FW_GPU_PROFILE_SCOPE(gpuProfiler, commandList.Get(), "Motion vectors");
+        m_motionVector.render(commandList, m_objectRender.getRenderDepthView());
+    }
 
     commandList->SetPipelineState(m_PSO.Get());
 
@@ -121,22 +124,15 @@ void MotionBlurApp::fillCommandList()
 
     commandList->SetGraphicsRootSignature(m_rootSignature.Get());
 
-    std::vector<ID3D12DescriptorHeap*> descriptorHeaps{m_descriptorHeap.Get()};
-    commandList->SetDescriptorHeaps((UINT)descriptorHeaps.size(), descriptorHeaps.data());
-
-    CD3DX12_GPU_DESCRIPTOR_HANDLE objectTextureHandle = CD3DX12_GPU_DESCRIPTOR_HANDLE(m_descriptorHeap->GetGPUDescriptorHandleForHeapStart());
-    objectTextureHandle.Offset(c_renderTextureOffset, fw::API::getCbvSrvUavDescriptorIncrementSize());
-
-    commandList->SetGraphicsRootDescriptorTable(0, objectTextureHandle);
-
-    CD3DX12_GPU_DESCRIPTOR_HANDLE motionVectorTextureHandle = CD3DX12_GPU_DESCRIPTOR_HANDLE(m_descriptorHeap->GetGPUDescriptorHandleForHeapStart());
-    motionVectorTextureHandle.Offset(c_motionVectorTextureOffset, fw::API::getCbvSrvUavDescriptorIncrementSize());
+    commandList->SetGraphicsRootDescriptorTable(0, m_objectRender.getRenderTextureView());
+    commandList->SetGraphicsRootDescriptorTable(1, m_motionVector.getTextureView());
 
-    commandList->SetGraphicsRootDescriptorTable(1, motionVectorTextureHandle);
-
-    commandList->IASetVertexBuffers(0, 1, &m_vertexBufferView);
-    commandList->IASetIndexBuffer(&m_indexBufferView);
-    commandList->DrawIndexedInstanced(fw::uintSize(c_fullscreenTriangleIndices), 1, 0, 0, 0);
+    {
+        FW_GPU_PROFILE_SCOPE(gpuProfiler, commandList.Get(), "Blur");
+        commandList->IASetVertexBuffers(0, 1, &m_vertexBufferView);
+        commandList->IASetIndexBuffer(&m_indexBufferView);
+        commandList->DrawIndexedInstanced(fw::uintSize(c_fullscreenTriangleIndices), 1, 0, 0, 0);
+    }
 
     commandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(currentBackBuffer, D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_PRESENT));
 
@@ -147,33 +143,19 @@ void MotionBlurApp::onGUI()
 {
 }
 
-void MotionBlurApp::createDescriptorHeap()
-{
-    D3D12_DESCRIPTOR_HEAP_DESC descriptorHeapDesc;
-    descriptorHeapDesc.NumDescriptors = c_descriptorHeapSize;
-    descriptorHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
-    descriptorHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
-    descriptorHeapDesc.NodeMask = 0;
-
-    Microsoft::WRL::ComPtr<ID3D12Device> d3dDevice = fw::API::getD3dDevice();
-    CHECK(d3dDevice->CreateDescriptorHeap(&descriptorHeapDesc, IID_PPV_ARGS(&m_descriptorHeap)));
-}
-
 void MotionBlurApp::createVertexBuffers(Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList>& commandList)
 {
-    Microsoft::WRL::ComPtr<ID3D12Device> d3dDevice = fw::API::getD3dDevice();
-
     const size_t vertexBufferSize = c_fullscreenTriangle.size() * sizeof(float);
     const size_t indexBufferSize = c_fullscreenTriangleIndices.size() * sizeof(uint16_t);
 
-    m_vertexBuffer = fw::createGPUBuffer(d3dDevice.Get(), commandList.Get(), c_fullscreenTriangle.data(), vertexBufferSize, m_vertexUploadBuffer);
-    m_indexBuffer = fw::createGPUBuffer(d3dDevice.Get(), commandList.Get(), c_fullscreenTriangleIndices.data(), indexBufferSize, m_indexUploadBuffer);
+    m_vertexBuffer = fw::createGPUBuffer(commandList.Get(), c_fullscreenTriangle.data(), vertexBufferSize, fw::API::getUploadRing(), fw::API::getBufferHeap());
+    m_indexBuffer = fw::createGPUBuffer(commandList.Get(), c_fullscreenTriangleIndices.data(), indexBufferSize, fw::API::getUploadRing(), fw::API::getBufferHeap());
 
-    m_vertexBufferView.BufferLocation = m_vertexBuffer->GetGPUVirtualAddress();
+    m_vertexBufferView.BufferLocation = m_vertexBuffer.gpuAddress;
     m_vertexBufferView.StrideInBytes = sizeof(float) * 5;
     m_vertexBufferView.SizeInBytes = (UINT)vertexBufferSize;
 
-    m_indexBufferView.BufferLocation = m_indexBuffer->GetGPUVirtualAddress();
+    m_indexBufferView.BufferLocation = m_indexBuffer.gpuAddress;
     m_indexBufferView.Format = DXGI_FORMAT_R16_UINT;
     m_indexBufferView.SizeInBytes = (UINT)indexBufferSize;
 }
@@ -31,13 +31,8 @@ private:
 
     Microsoft::WRL::ComPtr<ID3D12RootSignature> m_rootSignature = nullptr;
 
-    Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> m_descriptorHeap = nullptr;
-
-    Microsoft::WRL::ComPtr<ID3D12Resource> m_vertexUploadBuffer;
-    Microsoft::WRL::ComPtr<ID3D12Resource> m_indexUploadBuffer;
-
-    Microsoft::WRL::ComPtr<ID3D12Resource> m_vertexBuffer;
-    Microsoft::WRL::ComPtr<ID3D12Resource> m_indexBuffer;
+    fw::BufferHeap::Buffer m_vertexBuffer;
+    fw::BufferHeap::Buffer m_indexBuffer;
     D3D12_VERTEX_BUFFER_VIEW m_vertexBufferView;
     D3D12_INDEX_BUFFER_VIEW m_indexBufferView;
 
@@ -51,7 +46,6 @@ private:
 
     fw::Camera m_camera;
 
-    void createDescriptorHeap();
     void createVertexBuffers(Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList>& commandList);
     void createShaders();
     void createRootSignature();
@@ -10,25 +10,16 @@ const float c_clearColor[4] = {1.0f, 0.0f, 0.0f, 0.0f};
 const DXGI_FORMAT c_renderFormat = DXGI_FORMAT_R16G16_FLOAT;
 } // namespace
 
-bool MotionVector::initialize(Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList>& commandList,
-                              ID3D12DescriptorHeap* srvHeap,
-                              int srvOffset)
+bool MotionVector::initialize(Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList>& commandList)
 {
-    createConstantBuffer();
     createVertexBuffer(commandList);
-    createRenderTarget(srvHeap, srvOffset);
+    createRenderTarget();
     createShaders();
     createRootSignature();
     createMotionVectorPSO();
     return true;
 }
 
-void MotionVector::postInitialize()
-{
-    m_vertexUploadBuffer.Reset();
-    m_indexUploadBuffer.Reset();
-}
-
 void MotionVector::update(const fw::Camera& camera)
 {
     DirectX::XMMATRIX view = camera.getViewMatrix();
@@ -38,18 +29,16 @@ void MotionVector::update(const fw::Camera& camera)
 
     DirectX::XMMATRIX inverseViewProjection = DirectX::XMMatrixInverse(nullptr, vp);
 
-    int currentFrameIndex = fw::API::getCurrentFrameIndex();
-    char* mappedData = nullptr;
     int matrixSize = sizeof(DirectX::XMMATRIX);
-    CHECK(m_constantBuffers[currentFrameIndex]->Map(0, nullptr, reinterpret_cast<void**>(&mappedData)));
-    memcpy(&mappedData[0 * matrixSize], &m_previousVPMatrix, matrixSize);
-    memcpy(&mappedData[1 * matrixSize], &inverseViewProjection, matrixSize);
-    m_constantBuffers[currentFrameIndex]->Unmap(0, nullptr);
+    fw::FrameAllocator::Allocation constants = fw::API::getFrameAllocator().allocate(2 * matrixSize);
+    memcpy(&constants.data[0 * matrixSize], &m_previousVPMatrix, matrixSize);
+    memcpy(&constants.data[1 * matrixSize], &inverseViewProjection, matrixSize);
+    m_constantBufferAddress = constants.gpuAddress;
 
     m_previousVPMatrix = vp;
 }
 
-void MotionVector::render(Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList>& commandList, ID3D12DescriptorHeap* srvHeap, int depthOffset)
+void MotionVector::render(Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList>& commandList, D3D12_GPU_DESCRIPTOR_HANDLE depthTexture)
 {
     commandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(m_motionVectorRenderTexture.Get(), D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE, D3D12_RESOURCE_STATE_RENDER_TARGET));
 
@@ -62,16 +51,9 @@ void MotionVector::render(Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList>& com
     commandList->OMSetRenderTargets(1, &rtvHandle, true, nullptr);
 
     commandList->SetGraphicsRootSignature(m_rootSignature.Get());
-    int currentFrameIndex = fw::API::getCurrentFrameIndex();
-    commandList->SetGraphicsRootConstantBufferView(0, m_constantBuffers[currentFrameIndex]->GetGPUVirtualAddress());
-
-    std::vector<ID3D12DescriptorHeap*> descriptorHeaps{srvHeap};
-    commandList->SetDescriptorHeaps((UINT)descriptorHeaps.size(), descriptorHeaps.data());
-
-    CD3DX12_GPU_DESCRIPTOR_HANDLE depthTextureHandle = CD3DX12_GPU_DESCRIPTOR_HANDLE(srvHeap->GetGPUDescriptorHandleForHeapStart());
-    depthTextureHandle.Offset(depthOffset, fw::API::getCbvSrvUavDescriptorIncrementSize());
+    commandList->SetGraphicsRootConstantBufferView(0, m_constantBufferAddress);
 
-    commandList->SetGraphicsRootDescriptorTable(1, depthTextureHandle);
+    commandList->SetGraphicsRootDescriptorTable(1, depthTexture);
 
     commandList->IASetVertexBuffers(0, 1, &m_vertexBufferView);
     commandList->IASetIndexBuffer(&m_indexBufferView);
@@ -80,45 +62,29 @@ void MotionVector::render(Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList>& com
     commandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(m_motionVectorRenderTexture.Get(), D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE));
 }
 
-void MotionVector::createConstantBuffer()
-{
-    Microsoft::WRL::ComPtr<ID3D12Device> d3dDevice = fw::API::getD3dDevice();
-
-    uint32_t constantBufferSize = fw::roundUpByteSize(2 * sizeof(DirectX::XMMATRIX));
-    m_constantBuffers.resize(fw::API::getSwapChainBufferCount());
-
-    for (int i = 0; i < m_constantBuffers.size(); ++i)
-    {
-        Microsoft::WRL::ComPtr<ID3D12Resource>& constantBuffer = m_constantBuffers[i];
-        CHECK(d3dDevice->CreateCommittedResource(&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
-                                                 D3D12_HEAP_FLAG_NONE,
-                                                 &CD3DX12_RESOURCE_DESC::Buffer(constantBufferSize),
-                                                 D3D12_RESOURCE_STATE_GENERIC_READ,
-                                                 nullptr,
-                                                 IID_PPV_ARGS(&constantBuffer)));
-    }
-}
-
 void MotionVector::createVertexBuffer(Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList>& commandList)
 {
-    Microsoft::WRL::ComPtr<ID3D12Device> d3dDevice = fw::API::getD3dDevice();
-
     const size_t vertexBufferSize = c_fullscreenTriangle.size() * sizeof(float);
     const size_t indexBufferSize = c_fullscreenTriangleIndices.size() * sizeof(uint16_t);
 
-    m_vertexBuffer = fw::createGPUBuffer(d3dDevice.Get(), commandList.Get(), c_fullscreenTriangle.data(), vertexBufferSize, m_vertexUploadBuffer);
-    m_indexBuffer = fw::createGPUBuffer(d3dDevice.Get(), commandList.Get(), c_fullscreenTriangleIndices.data(), indexBufferSize, m_indexUploadBuffer);
+    m_vertexBuffer = fw::createGPUBuffer(commandList.Get(), c_fullscreenTriangle.data(), vertexBufferSize, fw::API::getUploadRing(), fw::API::getBufferHeap());
+    m_indexBuffer = fw::createGPUBuffer(commandList.Get(), c_fullscreenTriangleIndices.data(), indexBufferSize, fw::API::getUploadRing(), fw::API::getBufferHeap());
 
-    m_vertexBufferView.BufferLocation = m_vertexBuffer->GetGPUVirtualAddress();
+    m_vertexBufferView.BufferLocation = m_vertexBuffer.gpuAddress;
     m_vertexBufferView.StrideInBytes = sizeof(float) * 5;
     m_vertexBufferView.SizeInBytes = (UINT)vertexBufferSize;
 
-    m_indexBufferView.BufferLocation = m_indexBuffer->GetGPUVirtualAddress();
+    m_indexBufferView.BufferLocation = m_indexBuffer.gpuAddress;
     m_indexBufferView.Format = DXGI_FORMAT_R16_UINT;
     m_indexBufferView.SizeInBytes = (UINT)indexBufferSize;
 }
 
-void MotionVector::createRenderTarget(ID3D12DescriptorHeap* srvHeap, int srvOffset)
+D3D12_GPU_DESCRIPTOR_HANDLE MotionVector::getTextureView() const
+{
+    return fw::API::getDescriptorHeap().getGpuHandle(m_textureView, 0);
+}
+
+void MotionVector::createRenderTarget()
 {
     Microsoft::WRL::ComPtr<ID3D12Device> d3dDevice = fw::API::getD3dDevice();
 
@@ -182,10 +148,9 @@ void MotionVector::createRenderTarget(ID3D12DescriptorHeap* srvHeap, int srvOffs
     srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
     srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
 
-    CD3DX12_CPU_DESCRIPTOR_HANDLE srvHandle = CD3DX12_CPU_DESCRIPTOR_HANDLE(srvHeap->GetCPUDescriptorHandleForHeapStart());
-    srvHandle.Offset(srvOffset, fw::API::getCbvSrvUavDescriptorIncrementSize());
-
-    d3dDevice->CreateShaderResourceView(m_motionVectorRenderTexture.Get(), &srvDesc, srvHandle);
+    fw::DescriptorHeap& descriptorHeap = fw::API::getDescriptorHeap();
+    m_textureView = descriptorHeap.allocate(1);
+    d3dDevice->CreateShaderResourceView(m_motionVectorRenderTexture.Get(), &srvDesc, descriptorHeap.getCpuHandle(m_textureView, 0));
 }
 
 void MotionVector::createShaders()
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <fw/BufferHeap.h>
 #include <fw/Camera.h>
+#include <fw/DescriptorHeap.h>
 
 #include <DirectXMath.h>
 #include <wrl.h>
@@ -14,26 +16,23 @@ public:
     MotionVector(){};
     ~MotionVector(){};
 
-    bool initialize(Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList>& commandList,
-                    ID3D12DescriptorHeap* srvHeap,
-                    int srvOffset);
-    void postInitialize();
+    bool initialize(Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList>& commandList);
     void update(const fw::Camera& camera);
-    void render(Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList>& commandList, ID3D12DescriptorHeap* srvHeap, int depthOffset);
+    void render(Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList>& commandList, D3D12_GPU_DESCRIPTOR_HANDLE depthTexture);
 
-private:
-    std::vector<Microsoft::WRL::ComPtr<ID3D12Resource>> m_constantBuffers;
+    D3D12_GPU_DESCRIPTOR_HANDLE getTextureView() const;
 
-    Microsoft::WRL::ComPtr<ID3D12Resource> m_vertexUploadBuffer;
-    Microsoft::WRL::ComPtr<ID3D12Resource> m_indexUploadBuffer;
+private:
+    D3D12_GPU_VIRTUAL_ADDRESS m_constantBufferAddress = 0;
 
-    Microsoft::WRL::ComPtr<ID3D12Resource> m_vertexBuffer;
-    Microsoft::WRL::ComPtr<ID3D12Resource> m_indexBuffer;
+    fw::BufferHeap::Buffer m_vertexBuffer;
+    fw::BufferHeap::Buffer m_indexBuffer;
     D3D12_VERTEX_BUFFER_VIEW m_vertexBufferView;
     D3D12_INDEX_BUFFER_VIEW m_indexBufferView;
 
     Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> m_rtvHeap = nullptr;
     Microsoft::WRL::ComPtr<ID3D12Resource> m_motionVectorRenderTexture;
+    fw::DescriptorHeap::Range m_textureView;
 
     Microsoft::WRL::ComPtr<ID3DBlob> m_vertexShader = nullptr;
     Microsoft::WRL::ComPtr<ID3DBlob> m_pixelShader = nullptr;
@@ -44,9 +43,8 @@ private:
 
     DirectX::XMMATRIX m_previousVPMatrix;
 
-    void createConstantBuffer();
     void createVertexBuffer(Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList>& commandList);
-    void createRenderTarget(ID3D12DescriptorHeap* srvHeap, int srvOffset);
+    void createRenderTarget();
     void createShaders();
     void createRootSignature();
     void createMotionVectorPSO();
@@ -4,32 +4,21 @@
 #include <fw/API.h>
 #include <fw/Common.h>
 
-#define STB_IMAGE_IMPLEMENTATION
-#include <stb_image.h>
-
 namespace
 {
 const float c_clearColor[4] = {0.0f, 0.0f, 0.0f, 1.0f};
 const DXGI_FORMAT c_depthFormat = DXGI_FORMAT_D32_FLOAT;
 } // namespace
 
-bool ObjectRender::initialize(Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList>& commandList,
-                              ID3D12DescriptorHeap* srvHeap,
-                              int textureOffset,
-                              int renderTextureOffset,
-                              int renderDepthOffset)
+bool ObjectRender::initialize(Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList>& commandList)
 {
-    m_srvHeap = srvHeap;
-    m_textureOffset = textureOffset;
-
     fw::Model model;
     loadModel(model);
 
-    createConstantBuffer();
-    createTextures(model, commandList, srvHeap, textureOffset);
+    createTextures(model, commandList);
     createVertexBuffers(model, commandList);
 
-    createRenderTarget(srvHeap, renderTextureOffset, renderDepthOffset);
+    createRenderTarget();
     createShaders();
     createRootSignature();
     createObjectRenderPSO();
@@ -37,12 +26,6 @@ bool ObjectRender::initialize(Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList>&
     return true;
 }
 
-void ObjectRender::postInitialize()
-{
-    m_textureUploadBuffers.clear();
-    m_vertexUploadBuffers.clear();
-}
-
 void ObjectRender::update(const fw::Camera& camera)
 {
     static fw::Transformation transformation;
@@ -52,17 +35,12 @@ void ObjectRender::update(const fw::Camera& camera)
     DirectX::XMMATRIX worldViewProj = transformation.getWorldMatrix() * camera.getViewMatrix() * camera.getProjectionMatrix();
     DirectX::XMMATRIX wvp = DirectX::XMMatrixTranspose(worldViewProj);
 
-    int currentFrameIndex = fw::API::getCurrentFrameIndex();
-    char* mappedData = nullptr;
-    CHECK(m_constantBuffers[currentFrameIndex]->Map(0, nullptr, reinterpret_cast<void**>(&mappedData)));
-    memcpy(&mappedData[0], &wvp, sizeof(DirectX::XMMATRIX));
-    m_constantBuffers[currentFrameIndex]->Unmap(0, nullptr);
+    m_constantBufferAddress = fw::API::getFrameAllocator().allocate(&wvp, sizeof(DirectX::XMMATRIX)).gpuAddress;
 }
 
 void ObjectRender::render(Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList>& commandList)
 {
     commandList->SetPipelineState(m_PSO.Get());
-    int currentFrameIndex = fw::API::getCurrentFrameIndex();
 
     commandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(m_objectRenderTexture.Get(), D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE, D3D12_RESOURCE_STATE_RENDER_TARGET));
     commandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(m_depthStencilTexture.Get(), D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE, D3D12_RESOURCE_STATE_DEPTH_WRITE));
@@ -77,18 +55,13 @@ void ObjectRender::render(Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList>& com
     commandList->OMSetRenderTargets(1, &rtvHandle, true, &dsvHandle);
 
     commandList->SetGraphicsRootSignature(m_rootSignature.Get());
-    commandList->SetGraphicsRootConstantBufferView(0, m_constantBuffers[fw::API::getCurrentFrameIndex()]->GetGPUVirtualAddress());
+    commandList->SetGraphicsRootConstantBufferView(0, m_constantBufferAddress);
 
-    std::vector<ID3D12DescriptorHeap*> descriptorHeaps{m_srvHeap};
-    commandList->SetDescriptorHeaps((UINT)descriptorHeaps.size(), descriptorHeaps.data());
-
-    CD3DX12_GPU_DESCRIPTOR_HANDLE textureHandle = CD3DX12_GPU_DESCRIPTOR_HANDLE(m_srvHeap->GetGPUDescriptorHandleForHeapStart());
-    textureHandle.Offset(m_textureOffset, fw::API::getCbvSrvUavDescriptorIncrementSize());
-
-    for (const RenderObject& ro : m_renderObjects)
+    const fw::DescriptorHeap& descriptorHeap = fw::API::getDescriptorHeap();
+    for (size_t i = 0; i < m_renderObjects.size(); ++i)
     {
-        commandList->SetGraphicsRootDescriptorTable(1, textureHandle);
-        textureHandle.Offset(1, fw::API::getCbvSrvUavDescriptorIncrementSize());
+        const RenderObject& ro = m_renderObjects[i];
+        commandList->SetGraphicsRootDescriptorTable(1, descriptorHeap.getGpuHandle(m_textureViews, static_cast<uint32_t>(i)));
 
         commandList->IASetVertexBuffers(0, 1, &ro.vertexBufferView);
         commandList->IASetIndexBuffer(&ro.indexBufferView);
@@ -99,6 +72,16 @@ void ObjectRender::render(Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList>& com
     commandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(m_depthStencilTexture.Get(), D3D12_RESOURCE_STATE_DEPTH_WRITE, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE));
 }
 
+D3D12_GPU_DESCRIPTOR_HANDLE ObjectRender::getRenderTextureView() const
+{
+    return fw::API::getDescriptorHeap().getGpuHandle(m_renderTargetViews, 0);
+}
+
+D3D12_GPU_DESCRIPTOR_HANDLE ObjectRender::getRenderDepthView() const
+{
+    return fw::API::getDescriptorHeap().getGpuHandle(m_renderTargetViews, 1);
+}
+
 void ObjectRender::loadModel(fw::Model& model)
 {
     std::string modelFilepath = ASSET_PATH;
@@ -109,108 +92,47 @@ void ObjectRender::loadModel(fw::Model& model)
     m_renderObjects.resize(numMeshes);
 }
 
-void ObjectRender::createConstantBuffer()
-{
-    Microsoft::WRL::ComPtr<ID3D12Device> d3dDevice = fw::API::getD3dDevice();
-
-    uint32_t constantBufferSize = fw::roundUpByteSize(sizeof(DirectX::XMFLOAT4X4));
-    m_constantBuffers.resize(fw::API::getSwapChainBufferCount());
-
-    for (int i = 0; i < m_constantBuffers.size(); ++i)
-    {
-        Microsoft::WRL::ComPtr<ID3D12Resource>& constantBuffer = m_constantBuffers[i];
-        CHECK(d3dDevice->CreateCommittedResource(&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
-                                                 D3D12_HEAP_FLAG_NONE,
-                                                 &CD3DX12_RESOURCE_DESC::Buffer(constantBufferSize),
-                                                 D3D12_RESOURCE_STATE_GENERIC_READ,
-                                                 nullptr,
-                                                 IID_PPV_ARGS(&constantBuffer)));
-    }
-}
-
-void ObjectRender::createTextures(const fw::Model& model, Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList>& commandList, ID3D12DescriptorHeap* srvHeap, int textureOffset)
+void ObjectRender::createTextures(const fw::Model& model, Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList>& commandList)
 {
-    Microsoft::WRL::ComPtr<ID3D12Device> d3dDevice = fw::API::getD3dDevice();
-
-    D3D12_RESOURCE_DESC textureDesc{};
-    textureDesc.MipLevels = 1;
-    textureDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
-    textureDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
-    textureDesc.Width = 0;
-    textureDesc.Height = 0;
-    textureDesc.DepthOrArraySize = 1;
-    textureDesc.SampleDesc.Count = 1;
-    textureDesc.SampleDesc.Quality = 0;
-    textureDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
-
-    const fw::Model::Meshes& meshes = model.getMeshes();
-    size_t numMeshes = meshes.size();
-    m_textureUploadBuffers.resize(numMeshes);
-
-    CD3DX12_CPU_DESCRIPTOR_HANDLE handle = CD3DX12_CPU_DESCRIPTOR_HANDLE(srvHeap->GetCPUDescriptorHandleForHeapStart());
-    handle.Offset(textureOffset, fw::API::getCbvSrvUavDescriptorIncrementSize());
+    fw::DescriptorHeap& descriptorHeap = fw::API::getDescriptorHeap();
+    m_textureViews = descriptorHeap.allocate(static_cast<uint32_t>(model.getMeshes().size()));
 
-    for (size_t i = 0; i < numMeshes; ++i)
+    std::vector<Microsoft::WRL::ComPtr<ID3D12Resource>> textures = fw::createAlbedoTextures(fw::API::getD3dDevice().Get(), commandList.Get(), model, ASSET_PATH, fw::API::getConfig().textureQuality, descriptorHeap, m_textureViews, fw::API::getUploadRing(), fw::API::getTextureHeap());
+    for (size_t i = 0; i < textures.size(); ++i)
     {
-        std::string textureName = meshes[i].getFirstTextureOfType(aiTextureType::aiTextureType_DIFFUSE);
-        std::string filepath = ASSET_PATH;
-        filepath += textureName;
-        int texWidth, texHeight, texChannels;
-        stbi_uc* pixels = stbi_load(filepath.c_str(), &texWidth, &texHeight, &texChannels, 4);
-        assert(pixels != nullptr);
-
-        textureDesc.Width = texWidth;
-        textureDesc.Height = texHeight;
-        const int numBytes = texWidth * texHeight * texChannels;
-
-        RenderObject& ro = m_renderObjects[i];
-        ro.texture = fw::createGPUTexture(d3dDevice.Get(), commandList.Get(), pixels, numBytes, textureDesc, 4, m_textureUploadBuffers[i]);
-
-        stbi_image_free(pixels);
-
-        D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc{};
-        srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
-        srvDesc.Format = textureDesc.Format;
-        srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
-        srvDesc.Texture2D.MipLevels = 1;
-        d3dDevice->CreateShaderResourceView(ro.texture.Get(), &srvDesc, handle);
-
-        handle.Offset(1, fw::API::getCbvSrvUavDescriptorIncrementSize());
+        m_renderObjects[i].texture = textures[i];
     }
 }
 
 void ObjectRender::createVertexBuffers(const fw::Model& model, Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList>& commandList)
 {
-    Microsoft::WRL::ComPtr<ID3D12Device> d3dDevice = fw::API::getD3dDevice();
-
     const fw::Model::Meshes& meshes = model.getMeshes();
     size_t numMeshes = meshes.size();
-    m_vertexUploadBuffers.resize(numMeshes);
 
     for (size_t i = 0; i < numMeshes; ++i)
     {
         RenderObject& ro = m_renderObjects[i];
         const fw::Mesh& mesh = meshes[i];
-        std::vector<fw::Mesh::Vertex> vertices = mesh.getVertices();
-        const size_t vertexBufferSize = vertices.size() * sizeof(fw::Mesh::Vertex);
-        const size_t indexBufferSize = mesh.indices.size() * sizeof(uint16_t);
+        fw::Span<const fw::Mesh::Vertex> vertices = mesh.getInterleavedVertices();
+        const size_t vertexBufferSize = vertices.sizeInBytes();
+        const size_t indexBufferSize = mesh.getIndexDataSize();
 
-        ro.vertexBuffer = fw::createGPUBuffer(d3dDevice.Get(), commandList.Get(), vertices.data(), vertexBufferSize, m_vertexUploadBuffers[i].vertexUploadBuffer);
-        ro.indexBuffer = fw::createGPUBuffer(d3dDevice.Get(), commandList.Get(), mesh.indices.data(), indexBufferSize, m_vertexUploadBuffers[i].indexUploadBuffer);
+        ro.vertexBuffer = fw::createGPUBuffer(commandList.Get(), vertices.data(), vertexBufferSize, fw::API::getUploadRing(), fw::API::getBufferHeap());
+        ro.indexBuffer = fw::createGPUBuffer(commandList.Get(), mesh.getIndexData(), indexBufferSize, fw::API::getUploadRing(), fw::API::getBufferHeap());
 
-        ro.vertexBufferView.BufferLocation = ro.vertexBuffer->GetGPUVirtualAddress();
+        ro.vertexBufferView.BufferLocation = ro.vertexBuffer.gpuAddress;
         ro.vertexBufferView.StrideInBytes = sizeof(fw::Mesh::Vertex);
         ro.vertexBufferView.SizeInBytes = (UINT)vertexBufferSize;
 
-        ro.indexBufferView.BufferLocation = ro.indexBuffer->GetGPUVirtualAddress();
-        ro.indexBufferView.Format = DXGI_FORMAT_R16_UINT;
+        ro.indexBufferView.BufferLocation = ro.indexBuffer.gpuAddress;
+        ro.indexBufferView.Format = fw::getIndexFormat(mesh);
         ro.indexBufferView.SizeInBytes = (UINT)indexBufferSize;
 
-        ro.numIndices = static_cast<UINT>(mesh.indices.size());
+        ro.numIndices = mesh.getLod(0).indexCount;
     }
 }
 
-void ObjectRender::createRenderTarget(ID3D12DescriptorHeap* srvHeap, int renderTextureOffset, int renderDepthOffset)
+void ObjectRender::createRenderTarget()
 {
     Microsoft::WRL::ComPtr<ID3D12Device> d3dDevice = fw::API::getD3dDevice();
 
@@ -305,15 +227,13 @@ void ObjectRender::createRenderTarget(ID3D12DescriptorHeap* srvHeap, int renderT
     srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
     srvDesc.Format = fw::API::getBackBufferFormat();
 
-    CD3DX12_CPU_DESCRIPTOR_HANDLE renderTextureHandle = CD3DX12_CPU_DESCRIPTOR_HANDLE(srvHeap->GetCPUDescriptorHandleForHeapStart());
-    renderTextureHandle.Offset(renderTextureOffset, fw::API::getCbvSrvUavDescriptorIncrementSize());
-    d3dDevice->CreateShaderResourceView(m_objectRenderTexture.Get(), &srvDesc, renderTextureHandle);
+    fw::DescriptorHeap& descriptorHeap = fw::API::getDescriptorHeap();
+    m_renderTargetViews = descriptorHeap.allocate(2);
+    d3dDevice->CreateShaderResourceView(m_objectRenderTexture.Get(), &srvDesc, descriptorHeap.getCpuHandle(m_renderTargetViews, 0));
 
     srvDesc.Format = DXGI_FORMAT_R32_FLOAT;
 
-    CD3DX12_CPU_DESCRIPTOR_HANDLE renderDepthHandle = CD3DX12_CPU_DESCRIPTOR_HANDLE(srvHeap->GetCPUDescriptorHandleForHeapStart());
-    renderDepthHandle.Offset(renderDepthOffset, fw::API::getCbvSrvUavDescriptorIncrementSize());
-    d3dDevice->CreateShaderResourceView(m_depthStencilTexture.Get(), &srvDesc, renderDepthHandle);
+    d3dDevice->CreateShaderResourceView(m_depthStencilTexture.Get(), &srvDesc, descriptorHeap.getCpuHandle(m_renderTargetViews, 1));
 }
 
 void ObjectRender::createShaders()
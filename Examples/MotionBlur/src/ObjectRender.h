@@ -2,7 +2,9 @@
 
 #include "Shared.h"
 
+#include <fw/BufferHeap.h>
 #include <fw/Camera.h>
+#include <fw/DescriptorHeap.h>
 #include <fw/Model.h>
 
 #include <wrl.h>
@@ -16,41 +18,31 @@ public:
     ObjectRender(){};
     ~ObjectRender(){};
 
-    bool initialize(Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList>& commandList,
-                    ID3D12DescriptorHeap* srvHeap,
-                    int textureOffset,
-                    int renderTextureOffset,
-                    int renderDepthOffset);
-    void postInitialize();
+    bool initialize(Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList>& commandList);
     void update(const fw::Camera& camera);
     void render(Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList>& commandList);
 
+    D3D12_GPU_DESCRIPTOR_HANDLE getRenderTextureView() const;
+    D3D12_GPU_DESCRIPTOR_HANDLE getRenderDepthView() const;
+
 private:
     struct RenderObject
     {
-        Microsoft::WRL::ComPtr<ID3D12Resource> vertexBuffer;
-        Microsoft::WRL::ComPtr<ID3D12Resource> indexBuffer;
+        fw::BufferHeap::Buffer vertexBuffer;
+        fw::BufferHeap::Buffer indexBuffer;
         D3D12_VERTEX_BUFFER_VIEW vertexBufferView;
         D3D12_INDEX_BUFFER_VIEW indexBufferView;
         Microsoft::WRL::ComPtr<ID3D12Resource> texture;
         UINT numIndices;
     };
 
-    struct VertexUploadBuffers
-    {
-        Microsoft::WRL::ComPtr<ID3D12Resource> vertexUploadBuffer;
-        Microsoft::WRL::ComPtr<ID3D12Resource> indexUploadBuffer;
-    };
-
     std::vector<RenderObject> m_renderObjects;
 
-    std::vector<Microsoft::WRL::ComPtr<ID3D12Resource>> m_constantBuffers;
-
-    ID3D12DescriptorHeap* m_srvHeap = nullptr;
-    int m_textureOffset = -1;
+    D3D12_GPU_VIRTUAL_ADDRESS m_constantBufferAddress = 0;
 
-    std::vector<Microsoft::WRL::ComPtr<ID3D12Resource>> m_textureUploadBuffers;
-    std::vector<VertexUploadBuffers> m_vertexUploadBuffers;
+    fw::DescriptorHeap::Range m_textureViews;
+    // Views of the render texture and the depth texture
+    fw::DescriptorHeap::Range m_renderTargetViews;
 
     Microsoft::WRL::ComPtr<ID3D12Resource> m_objectRenderTexture;
     Microsoft::WRL::ComPtr<ID3D12Resource> m_depthStencilTexture;
@@ -66,10 +58,9 @@ private:
     Microsoft::WRL::ComPtr<ID3D12PipelineState> m_PSO = nullptr;
 
     void loadModel(fw::Model& model);
-    void createConstantBuffer();
-    void createTextures(const fw::Model& model, Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList>& commandList, ID3D12DescriptorHeap* srvHeap, int textureOffset);
+    void createTextures(const fw::Model& model, Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList>& commandList);
     void createVertexBuffers(const fw::Model& model, Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList>& commandList);
-    void createRenderTarget(ID3D12DescriptorHeap* srvHeap, int renderTextureOffset, int renderDepthOffset);
+    void createRenderTarget();
     void createShaders();
     void createRootSignature();
     void createObjectRenderPSO();
@@ -3,5 +3,5 @@
 
 int main(int argc, char** argv)
 {
-    return fw::runApplication<MotionBlurApp>();
+    return fw::runApplication<MotionBlurApp>(argc, argv);
 }
@@ -4,12 +4,11 @@
 #include <fw/Common.h>
 #include <fw/API.h>
 #include <fw/Macros.h>
+#include <fw/Profiler.h>
 #include <fw/Transformation.h>
 
 #include <DirectXMath.h>
 
-#define STB_IMAGE_IMPLEMENTATION
-#include <stb_image.h>
 #include <GLFW/glfw3.h>
 
 #include <vector>
@@ -34,13 +33,12 @@ const std::vector<uint16_t> c_fullscreenTriangleIndices = {0, 1, 2};
 
 bool RWTextureApp::initialize()
 {
+    FW_PROFILE_FUNCTION();
     Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> commandList = fw::API::getCommandList();
 
     fw::Model model;
     loadModel(model);
 
-    createDescriptorHeap();
-    createConstantBuffer();
     createTextures(model, commandList);
     createVertexBuffers(model, commandList);
 
@@ -59,8 +57,6 @@ bool RWTextureApp::initialize()
     // Execute and wait initialization commands
     CHECK(commandList->Close());
     fw::API::completeInitialization();
-    m_textureUploadBuffers.clear();
-    m_vertexUploadBuffers.clear();
 
     // Camera
     m_cameraController.setCamera(&m_camera);
@@ -96,11 +92,7 @@ void RWTextureApp::update()
     DirectX::XMMATRIX worldViewProj = transformation.getWorldMatrix() * m_camera.getViewMatrix() * m_camera.getProjectionMatrix();
     DirectX::XMMATRIX wvp = DirectX::XMMatrixTranspose(worldViewProj);
 
-    int currentFrameIndex = fw::API::getCurrentFrameIndex();
-    char* mappedData = nullptr;
-    CHECK(m_constantBuffers[currentFrameIndex]->Map(0, nullptr, reinterpret_cast<void**>(&mappedData)));
-    memcpy(&mappedData[0], &wvp, sizeof(DirectX::XMMATRIX));
-    m_constantBuffers[currentFrameIndex]->Unmap(0, nullptr);
+    m_constantBufferAddress = fw::API::getFrameAllocator().allocate(&wvp, sizeof(DirectX::XMMATRIX)).gpuAddress;
 
     if (fw::API::isKeyReleased(GLFW_KEY_ESCAPE))
     {
@@ -111,8 +103,6 @@ void RWTextureApp::update()
 void RWTextureApp::fillCommandList()
 {
     const int currentFrameIndex = fw::API::getCurrentFrameIndex();
-    const int swapchainLength = fw::API::getSwapChainBufferCount();
-    const int renderObjectCount = static_cast<int>(m_renderObjects.size());
 
     Microsoft::WRL::ComPtr<ID3D12CommandAllocator> commandAllocator = fw::API::getCurrentFrameCommandAllocator();
     Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> cl = fw::API::getCommandList();
@@ -120,6 +110,10 @@ void RWTextureApp::fillCommandList()
     CHECK(commandAllocator->Reset());
     CHECK(cl->Reset(commandAllocator.Get(), m_renderPSO.Get()));
 
+    const fw::DescriptorHeap& descriptorHeap = fw::API::getDescriptorHeap();
+    std::vector<ID3D12DescriptorHeap*> descriptorHeaps{descriptorHeap.getHeap()};
+    cl->SetDescriptorHeaps((UINT)descriptorHeaps.size(), descriptorHeaps.data());
+
     cl->RSSetViewports(1, &m_screenViewport);
     cl->RSSetScissorRects(1, &m_scissorRect);
 
@@ -140,17 +134,12 @@ void RWTextureApp::fillCommandList()
         cl->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 
         cl->SetGraphicsRootSignature(m_rootSignature.Get());
-        cl->SetGraphicsRootConstantBufferView(0, m_constantBuffers[fw::API::getCurrentFrameIndex()]->GetGPUVirtualAddress());
-
-        std::vector<ID3D12DescriptorHeap*> descriptorHeaps{m_srvHeap.Get()};
-        cl->SetDescriptorHeaps((UINT)descriptorHeaps.size(), descriptorHeaps.data());
-
-        CD3DX12_GPU_DESCRIPTOR_HANDLE srvHandle = CD3DX12_GPU_DESCRIPTOR_HANDLE(m_srvHeap->GetGPUDescriptorHandleForHeapStart());
+        cl->SetGraphicsRootConstantBufferView(0, m_constantBufferAddress);
 
-        for (const RenderObject& ro : m_renderObjects)
+        for (size_t i = 0; i < m_renderObjects.size(); ++i)
         {
-            cl->SetGraphicsRootDescriptorTable(1, srvHandle);
-            srvHandle.Offset(1, fw::API::getCbvSrvUavDescriptorIncrementSize());
+            const RenderObject& ro = m_renderObjects[i];
+            cl->SetGraphicsRootDescriptorTable(1, descriptorHeap.getGpuHandle(m_textureViews, static_cast<uint32_t>(i)));
 
             cl->IASetVertexBuffers(0, 1, &ro.vertexBufferView);
             cl->IASetIndexBuffer(&ro.indexBufferView);
@@ -166,10 +155,7 @@ void RWTextureApp::fillCommandList()
 
         cl->SetPipelineState(m_computePSO.Get());
         cl->SetComputeRootSignature(m_computeRootSignature.Get());
-        CD3DX12_GPU_DESCRIPTOR_HANDLE srvHandle = CD3DX12_GPU_DESCRIPTOR_HANDLE(m_srvHeap->GetGPUDescriptorHandleForHeapStart());
-        srvHandle.Offset(renderObjectCount + swapchainLength + currentFrameIndex, fw::API::getCbvSrvUavDescriptorIncrementSize());
-
-        cl->SetComputeRootDescriptorTable(0, srvHandle);
+        cl->SetComputeRootDescriptorTable(0, descriptorHeap.getGpuHandle(m_renderTextureUavs, currentFrameIndex));
         cl->Dispatch(fw::API::getWindowWidth() / 8, fw::API::getWindowHeight() / 8, 1);
     }
 
@@ -197,9 +183,7 @@ void RWTextureApp::fillCommandList()
         cl->SetPipelineState(m_blitPSO.Get());
         cl->SetGraphicsRootSignature(m_rootSignature.Get());
 
-        CD3DX12_GPU_DESCRIPTOR_HANDLE srvHandle = CD3DX12_GPU_DESCRIPTOR_HANDLE(m_srvHeap->GetGPUDescriptorHandleForHeapStart());
-        srvHandle.Offset(renderObjectCount + currentFrameIndex, fw::API::getCbvSrvUavDescriptorIncrementSize());
-        cl->SetGraphicsRootDescriptorTable(1, srvHandle);
+        cl->SetGraphicsRootDescriptorTable(1, descriptorHeap.getGpuHandle(m_renderTextureViews, currentFrameIndex));
 
         cl->IASetVertexBuffers(0, 1, &m_fullscreenTriangle.vertexBufferView);
         cl->IASetIndexBuffer(&m_fullscreenTriangle.indexBufferView);
@@ -230,116 +214,43 @@ void RWTextureApp::loadModel(fw::Model& model)
     m_renderObjects.resize(numMeshes);
 }
 
-void RWTextureApp::createDescriptorHeap()
-{
-    D3D12_DESCRIPTOR_HEAP_DESC descriptorHeapDesc;
-    size_t numMeshes = m_renderObjects.size() + (2 * fw::API::getSwapChainBufferCount());
-    descriptorHeapDesc.NumDescriptors = static_cast<int>(numMeshes);
-    descriptorHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
-    descriptorHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
-    descriptorHeapDesc.NodeMask = 0;
-
-    Microsoft::WRL::ComPtr<ID3D12Device> d3dDevice = fw::API::getD3dDevice();
-    CHECK(d3dDevice->CreateDescriptorHeap(&descriptorHeapDesc, IID_PPV_ARGS(&m_srvHeap)));
-}
-
-void RWTextureApp::createConstantBuffer()
-{
-    Microsoft::WRL::ComPtr<ID3D12Device> d3dDevice = fw::API::getD3dDevice();
-
-    uint32_t constantBufferSize = fw::roundUpByteSize(sizeof(DirectX::XMFLOAT4X4));
-    m_constantBuffers.resize(fw::API::getSwapChainBufferCount());
-
-    for (int i = 0; i < m_constantBuffers.size(); ++i)
-    {
-        Microsoft::WRL::ComPtr<ID3D12Resource>& constantBuffer = m_constantBuffers[i];
-        CHECK(d3dDevice->CreateCommittedResource(&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
-                                                 D3D12_HEAP_FLAG_NONE,
-                                                 &CD3DX12_RESOURCE_DESC::Buffer(constantBufferSize),
-                                                 D3D12_RESOURCE_STATE_GENERIC_READ,
-                                                 nullptr,
-                                                 IID_PPV_ARGS(&constantBuffer)));
-    }
-}
-
 void RWTextureApp::createTextures(const fw::Model& model, Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList>& cl)
 {
-    Microsoft::WRL::ComPtr<ID3D12Device> d3dDevice = fw::API::getD3dDevice();
-
-    D3D12_RESOURCE_DESC textureDesc{};
-    textureDesc.MipLevels = 1;
-    textureDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
-    textureDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
-    textureDesc.Width = 0;
-    textureDesc.Height = 0;
-    textureDesc.DepthOrArraySize = 1;
-    textureDesc.SampleDesc.Count = 1;
-    textureDesc.SampleDesc.Quality = 0;
-    textureDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+    fw::DescriptorHeap& descriptorHeap = fw::API::getDescriptorHeap();
+    m_textureViews = descriptorHeap.allocate(static_cast<uint32_t>(model.getMeshes().size()));
 
-    const fw::Model::Meshes& meshes = model.getMeshes();
-    size_t numMeshes = meshes.size();
-    m_textureUploadBuffers.resize(numMeshes);
-
-    CD3DX12_CPU_DESCRIPTOR_HANDLE handle = CD3DX12_CPU_DESCRIPTOR_HANDLE(m_srvHeap->GetCPUDescriptorHandleForHeapStart());
-
-    for (size_t i = 0; i < numMeshes; ++i)
+    std::vector<Microsoft::WRL::ComPtr<ID3D12Resource>> textures = fw::createAlbedoTextures(fw::API::getD3dDevice().Get(), cl.Get(), model, ASSET_PATH, fw::API::getConfig().textureQuality, descriptorHeap, m_textureViews, fw::API::getUploadRing(), fw::API::getTextureHeap());
+    for (size_t i = 0; i < textures.size(); ++i)
     {
-        std::string textureName = meshes[i].getFirstTextureOfType(aiTextureType::aiTextureType_DIFFUSE);
-        std::string filepath = ASSET_PATH;
-        filepath += textureName;
-        int texWidth, texHeight, texChannels;
-        stbi_uc* pixels = stbi_load(filepath.c_str(), &texWidth, &texHeight, &texChannels, 4);
-        assert(pixels != nullptr);
-
-        textureDesc.Width = texWidth;
-        textureDesc.Height = texHeight;
-        const int numBytes = texWidth * texHeight * texChannels;
-
-        RenderObject& ro = m_renderObjects[i];
-        ro.texture = fw::createGPUTexture(d3dDevice.Get(), cl.Get(), pixels, numBytes, textureDesc, 4, m_textureUploadBuffers[i]);
-
-        stbi_image_free(pixels);
-
-        D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc{};
-        srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
-        srvDesc.Format = textureDesc.Format;
-        srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
-        srvDesc.Texture2D.MipLevels = 1;
-        d3dDevice->CreateShaderResourceView(ro.texture.Get(), &srvDesc, handle);
-
-        handle.Offset(1, fw::API::getCbvSrvUavDescriptorIncrementSize());
+        m_renderObjects[i].texture = textures[i];
     }
 }
 
 void RWTextureApp::createVertexBuffers(const fw::Model& model, Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList>& cl)
 {
-    Microsoft::WRL::ComPtr<ID3D12Device> d3dDevice = fw::API::getD3dDevice();
-
     const fw::Model::Meshes& meshes = model.getMeshes();
     size_t numMeshes = meshes.size();
-    m_vertexUploadBuffers.resize(numMeshes);
 
     for (size_t i = 0; i < numMeshes; ++i)
     {
         RenderObject& ro = m_renderObjects[i];
         const fw::Mesh& mesh = meshes[i];
-        std::vector<fw::Mesh::Vertex> vertices = mesh.getVertices();
-        const size_t vertexBufferSize = vertices.size() * sizeof(fw::Mesh::Vertex);
-        const size_t indexBufferSize = mesh.indices.size() * sizeof(uint16_t);
+        fw::Span<const fw::Mesh::Vertex> vertices = mesh.getInterleavedVertices();
+        const size_t vertexBufferSize = vertices.sizeInBytes();
+        const size_t indexBufferSize = mesh.getIndexDataSize();
 
-        ro.vertexBuffer = fw::createGPUBuffer(d3dDevice.Get(), cl.Get(), vertices.data(), vertexBufferSize, m_vertexUploadBuffers[i].vertexUploadBuffer);
-        ro.indexBuffer = fw::createGPUBuffer(d3dDevice.Get(), cl.Get(), mesh.indices.data(), indexBufferSize, m_vertexUploadBuffers[i].indexUploadBuffer);
+        ro.vertexBuffer = fw::createGPUBuffer(cl.Get(), vertices.data(), vertexBufferSize, fw::API::getUploadRing(), fw::API::getBufferHeap());
+        ro.indexBuffer = fw::createGPUBuffer(cl.Get(), mesh.getIndexData(), indexBufferSize, fw::API::getUploadRing(), fw::API::getBufferHeap());
 
-        ro.vertexBufferView.BufferLocation = ro.vertexBuffer->GetGPUVirtualAddress();
+        ro.vertexBufferView.BufferLocation = ro.vertexBuffer.gpuAddress;
         ro.vertexBufferView.StrideInBytes = sizeof(fw::Mesh::Vertex);
         ro.vertexBufferView.SizeInBytes = (UINT)vertexBufferSize;
 
-        ro.indexBufferView.BufferLocation = ro.indexBuffer->GetGPUVirtualAddress();
-        ro.indexBufferView.Format = DXGI_FORMAT_R16_UINT;
+        ro.indexBufferView.BufferLocation = ro.indexBuffer.gpuAddress;
+        ro.indexBufferView.Format = fw::getIndexFormat(mesh);
         ro.indexBufferView.SizeInBytes = (UINT)indexBufferSize;
 
-        ro.numIndices = static_cast<UINT>(mesh.indices.size());
+        ro.numIndices = mesh.getLod(0).indexCount;
     }
 }
 
@@ -475,7 +386,7 @@ void RWTextureApp::createBlitPSO()
 void RWTextureApp::createRenderTexture(Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList>& cl)
 {
     Microsoft::WRL::ComPtr<ID3D12Device> d3dDevice = fw::API::getD3dDevice();
-    const int swapChainSize = fw::API::getSwapChainBufferCount();
+    const int frameCount = fw::API::getFrameCount();
 
     // Create texture resources
     D3D12_RESOURCE_DESC resourceDesc{};
@@ -500,9 +411,9 @@ void RWTextureApp::createRenderTexture(Microsoft::WRL::ComPtr<ID3D12GraphicsComm
         clearValue.Format = resourceDesc.Format;
 
         CD3DX12_HEAP_PROPERTIES heapProperty(D3D12_HEAP_TYPE_DEFAULT);
-        m_renderTextures.resize(swapChainSize);
+        m_renderTextures.resize(frameCount);
 
-        for (int i = 0; i < swapChainSize; ++i)
+        for (int i = 0; i < frameCount; ++i)
         {
             CHECK(d3dDevice->CreateCommittedResource(&heapProperty,
                                                      D3D12_HEAP_FLAG_NONE,
@@ -516,7 +427,7 @@ void RWTextureApp::createRenderTexture(Microsoft::WRL::ComPtr<ID3D12GraphicsComm
     // Create RTV heap and render target views
     {
         D3D12_DESCRIPTOR_HEAP_DESC rtvDescriptorHeapDesc{};
-        rtvDescriptorHeapDesc.NumDescriptors = swapChainSize;
+        rtvDescriptorHeapDesc.NumDescriptors = frameCount;
         rtvDescriptorHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_RTV;
         rtvDescriptorHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
         rtvDescriptorHeapDesc.NodeMask = 0;
@@ -531,7 +442,7 @@ void RWTextureApp::createRenderTexture(Microsoft::WRL::ComPtr<ID3D12GraphicsComm
 
         CD3DX12_CPU_DESCRIPTOR_HANDLE rtvHandle = CD3DX12_CPU_DESCRIPTOR_HANDLE(m_rtvHeap->GetCPUDescriptorHandleForHeapStart());
 
-        for (int i = 0; i < swapChainSize; ++i)
+        for (int i = 0; i < frameCount; ++i)
         {
             d3dDevice->CreateRenderTargetView(m_renderTextures[i].Get(), &renderTargetViewDesc, rtvHandle);
             rtvHandle.Offset(1, fw::API::getRtvDescriptorIncrementSize());
@@ -547,14 +458,13 @@ void RWTextureApp::createRenderTexture(Microsoft::WRL::ComPtr<ID3D12GraphicsComm
         srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
         srvDesc.Format = resourceDesc.Format;
 
-        const int offset = static_cast<int>(m_renderObjects.size());
-        CD3DX12_CPU_DESCRIPTOR_HANDLE srvHandle = CD3DX12_CPU_DESCRIPTOR_HANDLE(m_srvHeap->GetCPUDescriptorHandleForHeapStart());
-        srvHandle.Offset(offset, fw::API::getCbvSrvUavDescriptorIncrementSize());
+        fw::DescriptorHeap& descriptorHeap = fw::API::getDescriptorHeap();
+        m_renderTextureViews = descriptorHeap.allocate(frameCount);
+        m_renderTextureUavs = descriptorHeap.allocate(frameCount);
 
-        for (int i = 0; i < swapChainSize; ++i)
+        for (int i = 0; i < frameCount; ++i)
         {
-            d3dDevice->CreateShaderResourceView(m_renderTextures[i].Get(), &srvDesc, srvHandle);
-            srvHandle.Offset(1, fw::API::getCbvSrvUavDescriptorIncrementSize());
+            d3dDevice->CreateShaderResourceView(m_renderTextures[i].Get(), &srvDesc, descriptorHeap.getCpuHandle(m_renderTextureViews, i));
         }
 
         D3D12_UNORDERED_ACCESS_VIEW_DESC uavDesc{};
@@ -563,10 +473,9 @@ void RWTextureApp::createRenderTexture(Microsoft::WRL::ComPtr<ID3D12GraphicsComm
         uavDesc.ViewDimension = D3D12_UAV_DIMENSION_TEXTURE2D;
         uavDesc.Format = resourceDesc.Format;
 
-        for (int i = 0; i < swapChainSize; ++i)
+        for (int i = 0; i < frameCount; ++i)
         {
-            d3dDevice->CreateUnorderedAccessView(m_renderTextures[i].Get(), nullptr, &uavDesc, srvHandle);
-            srvHandle.Offset(1, fw::API::getCbvSrvUavDescriptorIncrementSize());
+            d3dDevice->CreateUnorderedAccessView(m_renderTextures[i].Get(), nullptr, &uavDesc, descriptorHeap.getCpuHandle(m_renderTextureUavs, i));
         }
     }
 
@@ -590,8 +499,8 @@ void RWTextureApp::createRenderTexture(Microsoft::WRL::ComPtr<ID3D12GraphicsComm
         optClear.DepthStencil.Depth = 1.0f;
         optClear.DepthStencil.Stencil = 0;
 
-        m_depthStencilBuffers.resize(swapChainSize);
-        for (int i = 0; i < swapChainSize; ++i)
+        m_depthStencilBuffers.resize(frameCount);
+        for (int i = 0; i < frameCount; ++i)
         {
             CHECK(d3dDevice->CreateCommittedResource(&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT),
                                                      D3D12_HEAP_FLAG_NONE,
@@ -605,7 +514,7 @@ void RWTextureApp::createRenderTexture(Microsoft::WRL::ComPtr<ID3D12GraphicsComm
     // Create dsv heap
     {
         D3D12_DESCRIPTOR_HEAP_DESC dsvHeapDesc;
-        dsvHeapDesc.NumDescriptors = swapChainSize;
+        dsvHeapDesc.NumDescriptors = frameCount;
         dsvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_DSV;
         dsvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
         dsvHeapDesc.NodeMask = 0;
@@ -622,7 +531,7 @@ void RWTextureApp::createRenderTexture(Microsoft::WRL::ComPtr<ID3D12GraphicsComm
 
         CD3DX12_CPU_DESCRIPTOR_HANDLE dsvHandle = CD3DX12_CPU_DESCRIPTOR_HANDLE(m_dsvHeap->GetCPUDescriptorHandleForHeapStart());
 
-        for (int i = 0; i < swapChainSize; ++i)
+        for (int i = 0; i < frameCount; ++i)
         {
             d3dDevice->CreateDepthStencilView(m_depthStencilBuffers[i].Get(), &dsvDesc, dsvHandle);
             dsvHandle.Offset(1, fw::API::getDsvDescriptorIncrementSize());
@@ -633,24 +542,18 @@ void RWTextureApp::createRenderTexture(Microsoft::WRL::ComPtr<ID3D12GraphicsComm
 
 void RWTextureApp::createFullscreenTriangleVertexBuffer(Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList>& cl)
 {
-    Microsoft::WRL::ComPtr<ID3D12Device> d3dDevice = fw::API::getD3dDevice();
-
     const size_t vertexBufferSize = c_fullscreenTriangleVertices.size() * sizeof(float);
     const size_t indexBufferSize = c_fullscreenTriangleIndices.size() * sizeof(uint16_t);
 
-    m_vertexUploadBuffers.resize(m_vertexUploadBuffers.size() + 1);
-    VertexUploadBuffers& uploadBuffer = m_vertexUploadBuffers.back();
-    ID3D12Device* device = d3dDevice.Get();
-
     RenderObject& fst = m_fullscreenTriangle;
-    fst.vertexBuffer = fw::createGPUBuffer(device, cl.Get(), c_fullscreenTriangleVertices.data(), vertexBufferSize, uploadBuffer.vertexUploadBuffer);
-    fst.indexBuffer = fw::createGPUBuffer(device, cl.Get(), c_fullscreenTriangleIndices.data(), indexBufferSize, uploadBuffer.indexUploadBuffer);
+    fst.vertexBuffer = fw::createGPUBuffer(cl.Get(), c_fullscreenTriangleVertices.data(), vertexBufferSize, fw::API::getUploadRing(), fw::API::getBufferHeap());
+    fst.indexBuffer = fw::createGPUBuffer(cl.Get(), c_fullscreenTriangleIndices.data(), indexBufferSize, fw::API::getUploadRing(), fw::API::getBufferHeap());
 
-    fst.vertexBufferView.BufferLocation = fst.vertexBuffer->GetGPUVirtualAddress();
+    fst.vertexBufferView.BufferLocation = fst.vertexBuffer.gpuAddress;
     fst.vertexBufferView.StrideInBytes = sizeof(float) * 5;
     fst.vertexBufferView.SizeInBytes = (UINT)vertexBufferSize;
 
-    fst.indexBufferView.BufferLocation = fst.indexBuffer->GetGPUVirtualAddress();
+    fst.indexBufferView.BufferLocation = fst.indexBuffer.gpuAddress;
     fst.indexBufferView.Format = DXGI_FORMAT_R16_UINT;
     fst.indexBufferView.SizeInBytes = (UINT)indexBufferSize;
 
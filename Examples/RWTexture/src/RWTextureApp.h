@@ -1,8 +1,10 @@
 ﻿#pragma once
 
 #include <fw/Application.h>
+#include <fw/BufferHeap.h>
 #include <fw/Camera.h>
 #include <fw/CameraController.h>
+#include <fw/DescriptorHeap.h>
 #include <fw/Model.h>
 
 #include "d3dx12.h"
@@ -26,20 +28,14 @@ public:
 private:
     struct RenderObject
     {
-        Microsoft::WRL::ComPtr<ID3D12Resource> vertexBuffer;
-        Microsoft::WRL::ComPtr<ID3D12Resource> indexBuffer;
+        fw::BufferHeap::Buffer vertexBuffer;
+        fw::BufferHeap::Buffer indexBuffer;
         D3D12_VERTEX_BUFFER_VIEW vertexBufferView;
         D3D12_INDEX_BUFFER_VIEW indexBufferView;
         Microsoft::WRL::ComPtr<ID3D12Resource> texture;
         UINT numIndices;
     };
 
-    struct VertexUploadBuffers
-    {
-        Microsoft::WRL::ComPtr<ID3D12Resource> vertexUploadBuffer;
-        Microsoft::WRL::ComPtr<ID3D12Resource> indexUploadBuffer;
-    };
-
     struct Shaders
     {
         Microsoft::WRL::ComPtr<ID3DBlob> vertex;
@@ -52,11 +48,8 @@ private:
     Microsoft::WRL::ComPtr<ID3D12RootSignature> m_rootSignature;
     Microsoft::WRL::ComPtr<ID3D12RootSignature> m_computeRootSignature;
 
-    Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> m_srvHeap;
-    std::vector<Microsoft::WRL::ComPtr<ID3D12Resource>> m_constantBuffers;
-
-    std::vector<Microsoft::WRL::ComPtr<ID3D12Resource>> m_textureUploadBuffers;
-    std::vector<VertexUploadBuffers> m_vertexUploadBuffers;
+    fw::DescriptorHeap::Range m_textureViews;
+    D3D12_GPU_VIRTUAL_ADDRESS m_constantBufferAddress = 0;
 
     Shaders m_renderShaders;
     Shaders m_blitShaders;
@@ -73,13 +66,14 @@ private:
     fw::CameraController m_cameraController;
 
     std::vector<Microsoft::WRL::ComPtr<ID3D12Resource>> m_renderTextures;
+    // Shader resource and unordered access views of the render textures, one of each per frame
+    fw::DescriptorHeap::Range m_renderTextureViews;
+    fw::DescriptorHeap::Range m_renderTextureUavs;
     std::vector<Microsoft::WRL::ComPtr<ID3D12Resource>> m_depthStencilBuffers;
     Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> m_rtvHeap;
     Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> m_dsvHeap;
 
     void loadModel(fw::Model& model);
-    void createDescriptorHeap();
-    void createConstantBuffer();
     void createTextures(const fw::Model& model, Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList>& cl);
     void createVertexBuffers(const fw::Model& model, Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList>& cl);
     void createRenderShaders();
@@ -3,5 +3,5 @@
 
 int main(int argc, char** argv)
 {
-    return fw::runApplication<RWTextureApp>();
+    return fw::runApplication<RWTextureApp>(argc, argv);
 }
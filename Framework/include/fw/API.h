@@ -28,9 +28,19 @@ public:
     static Microsoft::WRL::ComPtr<ID3D12CommandAllocator> getCommandAllocator();
     static Microsoft::WRL::ComPtr<ID3D12CommandAllocator> getCurrentFrameCommandAllocator();
     static Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList4> getCommandList();
+    static UploadRing& getUploadRing();
+    static FrameAllocator& getFrameAllocator();
+    static BufferHeap& getBufferHeap();
+    static TextureHeap& getTextureHeap();
+    static TextureHeap& getRenderTargetHeap();
+    static DescriptorHeap& getDescriptorHeap();
 
+    // Per frame resources are indexed by the frame index, the frame count can differ from the swap chain length
     static int getCurrentFrameIndex();
+    static int getFrameCount();
     static int getSwapChainBufferCount();
+    // Does not block, the GPU is done with the resources of a completed frame
+    static bool isFrameComplete(int frameIndex);
 
     static UINT getCbvSrvUavDescriptorIncrementSize();
     static UINT getRtvDescriptorIncrementSize();
@@ -50,6 +60,11 @@ public:
     static float getMouseDeltaY();
 
     static float getTimeDelta();
+    static const Config& getConfig();
+    static const FrameTimer& getFrameTimer();
+    // Stage percentiles of the frame timer and the latest GPU passes
+    static void printFrameTimes();
+    static GpuProfiler& getGpuProfiler();
 
 private:
     static Framework* s_framework;
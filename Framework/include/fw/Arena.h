@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+namespace fw
+{
+// Bump allocator that releases all its allocations at once. Destructors are never run so only
+// trivially destructible types can be allocated.
+class Arena
+{
+public:
+    static const size_t c_defaultBlockSize = 64 * 1024;
+
+    explicit Arena(size_t blockSize = c_defaultBlockSize);
+    Arena(const Arena&) = delete;
+    Arena(Arena&&) = delete;
+    Arena& operator=(const Arena&) = delete;
+    Arena& operator=(Arena&&) = delete;
+
+    void* allocate(size_t size, size_t alignment);
+
+    template<typename T>
+    T* allocateArray(size_t count);
+
+    // Keeps the first block for reuse
+    void reset();
+
+    // Bytes handed out and bytes reserved from the heap
+    size_t getUsedSize() const;
+    size_t getReservedSize() const;
+
+private:
+    struct Block
+    {
+        std::unique_ptr<unsigned char[]> data;
+        size_t size;
+    };
+
+    std::vector<Block> m_blocks;
+    size_t m_blockSize;
+    size_t m_offset = 0;
+    size_t m_usedSize = 0;
+};
+
+template<typename T>
+T* Arena::allocateArray(size_t count)
+{
+    static_assert(std::is_trivially_destructible<T>::value, "Arena does not run destructors");
+    T* data = static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+    for (size_t i = 0; i < count; ++i)
+    {
+        new (data + i) T();
+    }
+    return data;
+}
+
+} // namespace fw
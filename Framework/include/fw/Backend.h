@@ -0,0 +1,48 @@
+#pragma once
+
+#include "Config.h"
+
+#include <d3d12.h>
+#include <wrl.h>
+
+#include <cstdint>
+
+namespace fw
+{
+// Creates the device, the command queue and the command lists of the framework. The other objects come from the
+// device, so a backend whose device does not execute anything runs the frame loop and the applications unchanged.
+class Backend
+{
+public:
+    // What a backend that executes nothing has recorded since its device was created
+    struct Counters
+    {
+        // Committed, placed and reserved resources
+        uint64_t resourceCount = 0;
+        uint64_t heapCount = 0;
+        // Bytes of the heaps and the committed resources
+        uint64_t allocatedSize = 0;
+        uint64_t barrierCallCount = 0;
+        uint64_t barrierCount = 0;
+        uint64_t drawCount = 0;
+        uint64_t dispatchCount = 0;
+        uint64_t executedCommandListCount = 0;
+    };
+
+    Backend(){};
+    virtual ~Backend(){};
+    Backend(const Backend&) = delete;
+    Backend(Backend&&) = delete;
+    Backend& operator=(const Backend&) = delete;
+    Backend& operator=(Backend&&) = delete;
+
+    virtual bool createDevice(const Config& config, Microsoft::WRL::ComPtr<ID3D12Device5>& device) = 0;
+    // A direct queue
+    virtual bool createCommandQueue(ID3D12Device5* device, Microsoft::WRL::ComPtr<ID3D12CommandQueue>& commandQueue) = 0;
+    // A direct command list that is open for recording into the allocator
+    virtual bool createCommandList(ID3D12Device5* device, ID3D12CommandAllocator* commandAllocator, Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList4>& commandList) = 0;
+    // Returns false if the commands are executed and not counted
+    virtual bool getCounters(Counters& counters) const = 0;
+};
+
+} // namespace fw
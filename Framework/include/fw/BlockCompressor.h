@@ -0,0 +1,71 @@
+#pragma once
+
+#include "MipGenerator.h"
+#include "Span.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace fw
+{
+// Encodes RGBA8 mip chains into GPU block compressed formats on the CPU. Every block holds 4x4 pixels.
+class BlockCompressor
+{
+public:
+    static const uint32_t c_blockDimension = 4;
+
+    enum class Format : uint32_t
+    {
+        BC1, // RGB, 8 bytes per block, for opaque albedo
+        BC3, // RGBA, 16 bytes per block, for albedo with alpha
+        BC5, // RG, 16 bytes per block, for tangent space normal maps
+        BC7  // RGBA, 16 bytes per block, higher quality than BC1 and BC3
+    };
+
+    enum class Quality : uint32_t
+    {
+        Fast, // BC1 and BC3 for colors
+        High  // BC7 for colors, takes longer to encode and twice the memory of BC1
+    };
+
+    // Rows are rows of blocks and are tightly packed
+    struct Level
+    {
+        uint32_t width;
+        uint32_t height;
+        size_t offset;
+
+        uint32_t getBlockColumnCount() const;
+        uint32_t getBlockRowCount() const;
+    };
+
+    struct Texture
+    {
+        Format format = Format::BC1;
+        std::vector<Level> levels;
+        std::vector<unsigned char> blocks;
+        // Peak signal to noise ratio of the first level in decibels over the channels the format stores
+        float psnr = 0.0f;
+
+        size_t getRowPitch(size_t level) const;
+        Span<const unsigned char> getLevelData(size_t level) const;
+    };
+
+    BlockCompressor() = delete;
+
+    static size_t getBlockSize(Format format);
+    static const char* getFormatName(Format format);
+    // BC5 for normal maps, whose file names contain "_normal". Other images are BC7 with the high quality, and BC3 if
+    // they have transparent pixels or BC1 otherwise with the fast quality.
+    static Format selectFormat(const std::string& file, const unsigned char* pixels, uint32_t width, uint32_t height, Quality quality);
+
+    // Blocks of a level are encoded in parallel on the default thread pool
+    static void compress(const MipGenerator::Chain& chain, Format format, Texture& texture);
+    // Decodes a level to RGBA8, channels the format does not store are 0 except alpha which is 255
+    static void decompress(const Texture& texture, size_t level, std::vector<unsigned char>& pixels);
+    static float computePsnr(const MipGenerator::Chain& chain, const Texture& texture);
+};
+
+} // namespace fw
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "Span.h"
+
+#include <DirectXCollision.h>
+#include <DirectXMath.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace fw
+{
+// Node of a binary bounding volume hierarchy, node 0 is the root
+struct BoundsNode
+{
+    DirectX::BoundingBox box;
+    uint32_t firstChild; // The second child follows the first one, unused for leaves
+    uint32_t firstItem;  // First element of the item index array
+    uint32_t itemCount;  // Zero for inner nodes
+    uint32_t reserved;
+};
+
+class Bounds
+{
+public:
+    static const uint32_t c_maxLeafItems = 2;
+
+    Bounds() = delete;
+
+    // Min and max reductions of DirectXMath, which use SIMD
+    static void compute(StridedSpan<const DirectX::XMFLOAT3> positions, DirectX::BoundingBox& box, DirectX::BoundingSphere& sphere);
+
+    // Bounds of the transformed volume, the matrix must be affine
+    static DirectX::BoundingBox transform(const DirectX::BoundingBox& box, const DirectX::XMFLOAT4X4& matrix);
+    static DirectX::BoundingSphere transform(const DirectX::BoundingSphere& sphere, const DirectX::XMFLOAT4X4& matrix);
+
+    // Splits the items at the median of the longest axis of their centers. itemIndices maps the item
+    // ranges of the leaves to indices to boxes.
+    static void buildHierarchy(const std::vector<DirectX::BoundingBox>& boxes,
+                               std::vector<BoundsNode>& nodes,
+                               std::vector<uint32_t>& itemIndices);
+};
+
+} // namespace fw
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+namespace fw
+{
+// Buddy allocator of offsets in a range whose size is a power of two. Blocks are powers of two and aligned to
+// their size, a freed block is merged with its buddy when both are free. It only hands out offsets so it can
+// be used without a device.
+class BuddyAllocator
+{
+public:
+    static const uint64_t c_invalidOffset = ~0ull;
+
+    BuddyAllocator(){};
+    BuddyAllocator(const BuddyAllocator&) = delete;
+    BuddyAllocator(BuddyAllocator&&) = delete;
+    BuddyAllocator& operator=(const BuddyAllocator&) = delete;
+    BuddyAllocator& operator=(BuddyAllocator&&) = delete;
+
+    // Releases everything. Both sizes must be powers of two and the size at least the block size.
+    void initialize(uint64_t size, uint64_t minBlockSize);
+
+    // Returns c_invalidOffset if there is no free block of the size. The alignment must be a power of two.
+    uint64_t allocate(uint64_t size, uint64_t alignment);
+    void free(uint64_t offset);
+
+    // Size of the block that would be allocated for the size and the alignment
+    uint64_t getBlockSize(uint64_t size, uint64_t alignment) const;
+    uint64_t getSize() const;
+    uint64_t getMinBlockSize() const;
+    // Size of the allocated blocks, including rounding up to the block size
+    uint64_t getAllocatedSize() const;
+    uint64_t getLargestFreeBlock() const;
+    uint32_t getAllocationCount() const;
+
+private:
+    uint64_t m_size = 0;
+    uint64_t m_minBlockSize = 0;
+    uint64_t m_allocatedSize = 0;
+    // Free block offsets per level, level 0 has the smallest blocks
+    std::vector<std::set<uint64_t>> m_freeBlocks;
+    // Level of each allocated block
+    std::unordered_map<uint64_t, uint32_t> m_allocations;
+
+    uint32_t getLevel(uint64_t blockSize) const;
+    uint64_t getLevelSize(uint32_t level) const;
+};
+
+} // namespace fw
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "HeapSuballocator.h"
+
+#include <d3d12.h>
+#include <wrl.h>
+
+#include <memory>
+#include <vector>
+
+namespace fw
+{
+// Default heap memory for buffers. Every heap is covered by one placed buffer and buffers are ranges of it, so
+// small buffers do not waste the 64 KB alignment of a resource. Small buffers are slots of size classes and
+// larger ones blocks of a buddy allocator, a full heap adds another one.
+class BufferHeap
+{
+    struct Heap;
+
+public:
+    // Owns its range of the heap, which is freed when the buffer is destroyed or assigned. The GPU must be done with
+    // the buffer by then.
+    class Buffer
+    {
+    public:
+        Buffer(){};
+        ~Buffer();
+        Buffer(const Buffer&) = delete;
+        Buffer(Buffer&& other);
+        Buffer& operator=(const Buffer&) = delete;
+        Buffer& operator=(Buffer&& other);
+
+        ID3D12Resource* resource = nullptr;
+        UINT64 offset = 0;
+        UINT64 size = 0;
+        D3D12_GPU_VIRTUAL_ADDRESS gpuAddress = 0;
+
+    private:
+        friend class BufferHeap;
+
+        // Offset of the allocation, it is before the offset when the alignment was not a power of two
+        UINT64 m_allocationOffset = 0;
+        // Buffers that outlive the heap have nothing to free
+        std::weak_ptr<Heap> m_heap;
+
+        void release();
+    };
+
+    BufferHeap(){};
+    BufferHeap(const BufferHeap&) = delete;
+    BufferHeap(BufferHeap&&) = delete;
+    BufferHeap& operator=(const BufferHeap&) = delete;
+    BufferHeap& operator=(BufferHeap&&) = delete;
+
+    void initialize(ID3D12Device* device, UINT64 heapSize);
+
+    // The alignment does not need to be a power of two, e.g. the stride of a structured buffer that is viewed from
+    // the start of the range
+    Buffer allocate(UINT64 size, UINT64 alignment);
+
+    // Buffers share the resource of their heap so its state is tracked here, a barrier is only recorded when the
+    // state changes. Buffers of a heap are in the same state.
+    void transition(ID3D12GraphicsCommandList* cmdList, const Buffer& buffer, D3D12_RESOURCE_STATES state);
+    // Uploads leave their heap in COPY_DEST so that a batch of them needs no barriers in between. Finishing them
+    // transitions those heaps to GENERIC_READ, which the framework records after the initialization command list.
+    // Buffers that are read in the command list they are uploaded in need it to be called before.
+    bool hasUnfinishedUploads() const;
+    void finishUploads(ID3D12GraphicsCommandList* cmdList);
+    // Buffers are only uploaded during initialization. An upload during a frame would put every buffer of its heap,
+    // also the ones that the frame draws from, into COPY_DEST, so after this a transition to COPY_DEST asserts.
+    void endUploads();
+
+    HeapSuballocator::Stats getStats() const;
+
+private:
+    struct Heap
+    {
+        Microsoft::WRL::ComPtr<ID3D12Heap> heap;
+        Microsoft::WRL::ComPtr<ID3D12Resource> buffer;
+        D3D12_RESOURCE_STATES state = D3D12_RESOURCE_STATE_COMMON;
+        HeapSuballocator allocator;
+    };
+
+    Microsoft::WRL::ComPtr<ID3D12Device> m_device;
+    UINT64 m_heapSize = 0;
+    std::vector<std::shared_ptr<Heap>> m_heaps;
+    bool m_uploadsEnded = false;
+
+    std::shared_ptr<Heap> createHeap(UINT64 size);
+};
+
+} // namespace fw
@@ -1,6 +1,15 @@
 ﻿#pragma once
 
+#include "BlockCompressor.h"
+#include "BufferHeap.h"
+#include "DescriptorHeap.h"
 #include "Macros.h"
+#include "Mesh.h"
+#include "MipGenerator.h"
+#include "Model.h"
+#include "TextureFile.h"
+#include "TextureHeap.h"
+#include "UploadRing.h"
 
 #include <d3d12.h>
 #include <d3dcompiler.h>
@@ -10,6 +19,7 @@
 
 #include <cstdint>
 #include <string>
+#include <vector>
 
 namespace fw
 {
@@ -26,11 +36,21 @@ Microsoft::WRL::ComPtr<ID3DBlob> compileShader(const std::wstring& filename,
 
 std::wstring stringToWstring(const std::string& str);
 
-Microsoft::WRL::ComPtr<ID3D12Resource> createGPUBuffer(ID3D12Device* device,
-                                                       ID3D12GraphicsCommandList* cmdList,
-                                                       const void* initData,
-                                                       UINT64 byteSize,
-                                                       Microsoft::WRL::ComPtr<ID3D12Resource>& uploadBuffer);
+// Only during initialization, before API::completeInitialization. The buffer can be read once the uploads of the
+// buffer heap are finished, see BufferHeap::finishUploads.
+BufferHeap::Buffer createGPUBuffer(ID3D12GraphicsCommandList* cmdList,
+                                   const void* initData,
+                                   UINT64 byteSize,
+                                   UploadRing& uploadRing,
+                                   BufferHeap& bufferHeap);
+
+// The buffer starts at a multiple of the alignment, which can be the stride of a structured buffer
+BufferHeap::Buffer createGPUBuffer(ID3D12GraphicsCommandList* cmdList,
+                                   const void* initData,
+                                   UINT64 byteSize,
+                                   UINT64 alignment,
+                                   UploadRing& uploadRing,
+                                   BufferHeap& bufferHeap);
 
 Microsoft::WRL::ComPtr<ID3D12Resource> createGPUTexture(ID3D12Device* device,
                                                         ID3D12GraphicsCommandList* cmdList,
@@ -38,9 +58,45 @@ Microsoft::WRL::ComPtr<ID3D12Resource> createGPUTexture(ID3D12Device* device,
                                                         UINT64 size,
                                                         const D3D12_RESOURCE_DESC& textureDesc,
                                                         int pixelSize,
-                                                        Microsoft::WRL::ComPtr<ID3D12Resource>& uploadBuffer,
+                                                        UploadRing& uploadRing,
+                                                        TextureHeap& textureHeap,
                                                         std::wstring name = L"Texture");
 
+// Uploads every level of the chain, textureDesc must have the size and the level count of the chain
+Microsoft::WRL::ComPtr<ID3D12Resource> createGPUTexture(ID3D12Device* device,
+                                                        ID3D12GraphicsCommandList* cmdList,
+                                                        const MipGenerator::Chain& mipChain,
+                                                        const D3D12_RESOURCE_DESC& textureDesc,
+                                                        UploadRing& uploadRing,
+                                                        TextureHeap& textureHeap,
+                                                        std::wstring name = L"Texture");
+
+// Copies every level of the cooked texture into the upload ring without conversion, textureDesc must have the
+// size, the level count and the format of the texture
+Microsoft::WRL::ComPtr<ID3D12Resource> createGPUTexture(ID3D12Device* device,
+                                                        ID3D12GraphicsCommandList* cmdList,
+                                                        const TextureFile& textureFile,
+                                                        const D3D12_RESOURCE_DESC& textureDesc,
+                                                        UploadRing& uploadRing,
+                                                        TextureHeap& textureHeap,
+                                                        std::wstring name = L"Texture");
+
+// Loads the first diffuse texture of every mesh from the directory, compressed with the quality, and creates its shader
+// resource view at the mesh index of views. Albedo textures are sRGB encoded even though they are sampled as UNORM. Textures are compressed and
+// cooked once and mapped from the cooked files afterwards.
+std::vector<Microsoft::WRL::ComPtr<ID3D12Resource>> createAlbedoTextures(ID3D12Device* device,
+                                                                         ID3D12GraphicsCommandList* cmdList,
+                                                                         const Model& model,
+                                                                         const std::string& directory,
+                                                                         BlockCompressor::Quality quality,
+                                                                         DescriptorHeap& descriptorHeap,
+                                                                         const DescriptorHeap::Range& views,
+                                                                         UploadRing& uploadRing,
+                                                                         TextureHeap& textureHeap);
+
+DXGI_FORMAT getIndexFormat(const Mesh& mesh);
+DXGI_FORMAT getTextureFormat(BlockCompressor::Format format);
+
 void serializeAndCreateRootSignature(ID3D12Device* device, const D3D12_ROOT_SIGNATURE_DESC& desc, Microsoft::WRL::ComPtr<ID3D12RootSignature>& rootSig);
 
 template<typename T>
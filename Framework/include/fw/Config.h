@@ -0,0 +1,63 @@
+#pragma once
+
+#include "BlockCompressor.h"
+
+#include <string>
+
+namespace fw
+{
+// Settings of the framework that are chosen at run time. Every option can be given on the command line as
+// --name=value or in the environment as FW_NAME with the dashes as underscores, the command line wins.
+//   --backend=windowed|offscreen|null
+//   --validation=none|debug|gpu
+//   --frames-in-flight=<count>
+//   --vsync=on|off
+//   --resolution=<width>x<height>
+//   --frame-limit=<count>, required by the backends without a window
+//   --texture-quality=fast|high
+struct Config
+{
+    enum class Backend
+    {
+        // Presents to the swap chain of a window
+        Windowed,
+        // WARP/offscreen: no window and no swap chain, renders into back buffers of its own on the WARP software
+        // device. Needs Windows and the D3D12 runtime but no display or GPU.
+        Offscreen,
+        // No window, the device executes nothing and counts the resources, the allocations, the barriers, the draws
+        // and the dispatches instead
+        Null
+    };
+
+    enum class Validation
+    {
+        None,
+        DebugLayer,
+        // Validates descriptor and resource accesses of shaders, slows rendering down by an order of magnitude
+        GpuBased
+    };
+
+    Backend backend = Backend::Windowed;
+#if defined(DEBUG) || defined(_DEBUG)
+    Validation validation = Validation::DebugLayer;
+#else
+    Validation validation = Validation::None;
+#endif
+    // Frames the CPU may record ahead of the GPU. One frame has the lowest latency, more frames let the CPU and the
+    // GPU overlap at the cost of latency. Every frame has its own command allocator, fence value and transient memory.
+    int framesInFlight = 2;
+    bool vsync = true;
+    int width = 1200;
+    int height = 960;
+    // Frames to run, a negative limit runs until the window is closed or the application quits. A run without a
+    // window has nothing else that ends it, so parse rejects it without a limit.
+    int frameLimit = -1;
+    // Textures are cooked again when the quality changes
+    BlockCompressor::Quality textureQuality = BlockCompressor::Quality::Fast;
+
+    // Reads the environment and then the command line. Returns false on an unknown option or an invalid value.
+    bool parse(int argc, char** argv);
+    bool set(const std::string& name, const std::string& value);
+};
+
+} // namespace fw
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "Backend.h"
+
+namespace fw
+{
+// Executes on the GPU, or on the WARP software device for the offscreen backend
+class D3d12Backend : public Backend
+{
+public:
+    D3d12Backend(){};
+
+    bool createDevice(const Config& config, Microsoft::WRL::ComPtr<ID3D12Device5>& device) override;
+    bool createCommandQueue(ID3D12Device5* device, Microsoft::WRL::ComPtr<ID3D12CommandQueue>& commandQueue) override;
+    bool createCommandList(ID3D12Device5* device, ID3D12CommandAllocator* commandAllocator, Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList4>& commandList) override;
+    bool getCounters(Counters& counters) const override;
+};
+
+} // namespace fw
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <unordered_map>
+
+namespace fw
+{
+// Bookkeeping of the descriptors of a heap. The start of the heap is persistent and handed out from a free list
+// whose neighbouring free ranges are merged. The end is split into a transient part for each frame in flight,
+// which is allocated linearly and reset when the frame is started again. It only hands out indices so it can be
+// used without a device.
+class DescriptorAllocator
+{
+public:
+    static const uint32_t c_invalidIndex = ~0u;
+
+    DescriptorAllocator(){};
+    DescriptorAllocator(const DescriptorAllocator&) = delete;
+    DescriptorAllocator(DescriptorAllocator&&) = delete;
+    DescriptorAllocator& operator=(const DescriptorAllocator&) = delete;
+    DescriptorAllocator& operator=(DescriptorAllocator&&) = delete;
+
+    // Releases everything
+    void initialize(uint32_t persistentCount, uint32_t transientCount, uint32_t frameCount);
+
+    // Returns c_invalidIndex if there is no contiguous free range of the count
+    uint32_t allocate(uint32_t count);
+    void free(uint32_t index);
+
+    // Releases the transient descriptors of the frame, the GPU must be done with its previous use
+    void beginFrame(uint32_t frameIndex);
+    // Returns c_invalidIndex if the transient part of the current frame is full
+    uint32_t allocateTransient(uint32_t count);
+
+    // Persistent and transient descriptors of all frames
+    uint32_t getCount() const;
+    uint32_t getPersistentCount() const;
+    uint32_t getAllocatedCount() const;
+    uint32_t getLargestFreeRange() const;
+    uint32_t getTransientCount() const;
+    // Transient descriptors used by the current frame
+    uint32_t getUsedTransientCount() const;
+
+private:
+    uint32_t m_persistentCount = 0;
+    uint32_t m_transientCount = 0;
+    uint32_t m_frameCount = 0;
+    uint32_t m_allocatedCount = 0;
+    // Count of each free range by its start
+    std::map<uint32_t, uint32_t> m_freeRanges;
+    // Count of each allocation by its start
+    std::unordered_map<uint32_t, uint32_t> m_allocations;
+    uint32_t m_transientStart = 0; // Start of the current frame's transient part
+    uint32_t m_transientOffset = 0;
+};
+
+} // namespace fw
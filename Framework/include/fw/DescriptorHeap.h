@@ -0,0 +1,83 @@
+#pragma once
+
+#include "DescriptorAllocator.h"
+
+#include <d3d12.h>
+#include <wrl.h>
+
+#include <vector>
+
+namespace fw
+{
+// Shader visible descriptor heap shared by everything that is rendered, so the heap is set once per command list.
+// Persistent descriptors, like the views of loaded textures, are ranges from a free list. Descriptor tables that
+// change every frame are transient ranges that are valid until the frame is started again. Descriptors that are
+// written once and copied to tables later are created in a staging heap that is only visible to the CPU.
+class DescriptorHeap
+{
+public:
+    struct Range
+    {
+        uint32_t index = DescriptorAllocator::c_invalidIndex;
+        uint32_t count = 0;
+        D3D12_CPU_DESCRIPTOR_HANDLE cpuHandle{};
+        D3D12_GPU_DESCRIPTOR_HANDLE gpuHandle{}; // Zero for staging ranges
+    };
+
+    DescriptorHeap(){};
+    DescriptorHeap(const DescriptorHeap&) = delete;
+    DescriptorHeap(DescriptorHeap&&) = delete;
+    DescriptorHeap& operator=(const DescriptorHeap&) = delete;
+    DescriptorHeap& operator=(DescriptorHeap&&) = delete;
+
+    // The transient count is per frame
+    void initialize(ID3D12Device* device,
+                    D3D12_DESCRIPTOR_HEAP_TYPE type,
+                    uint32_t persistentCount,
+                    uint32_t transientCount,
+                    int frameCount,
+                    uint32_t stagingCount);
+
+    Range allocate(uint32_t count);
+    // The GPU must be done with the descriptors
+    void free(const Range& range);
+
+    // The GPU must be done with the previous use of the frame
+    void beginFrame(int frameIndex);
+    Range allocateTransient(uint32_t count);
+
+    Range allocateStaging(uint32_t count);
+    void freeStaging(const Range& range);
+
+    // Copies descriptors, usually from the staging heap, to a range of the shader visible heap. The copies are
+    // batched into one CopyDescriptors call when they are flushed, which the framework does before it executes
+    // the command list.
+    void copy(const Range& destination, uint32_t destinationOffset, D3D12_CPU_DESCRIPTOR_HANDLE source, uint32_t count);
+    void flushCopies();
+
+    D3D12_CPU_DESCRIPTOR_HANDLE getCpuHandle(const Range& range, uint32_t offset) const;
+    D3D12_GPU_DESCRIPTOR_HANDLE getGpuHandle(const Range& range, uint32_t offset) const;
+    ID3D12DescriptorHeap* getHeap() const;
+    UINT getIncrementSize() const;
+
+    const DescriptorAllocator& getAllocator() const;
+    const DescriptorAllocator& getStagingAllocator() const;
+
+private:
+    Microsoft::WRL::ComPtr<ID3D12Device> m_device;
+    D3D12_DESCRIPTOR_HEAP_TYPE m_type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
+    UINT m_incrementSize = 0;
+
+    Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> m_heap;
+    DescriptorAllocator m_allocator;
+    Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> m_stagingHeap;
+    DescriptorAllocator m_stagingAllocator;
+
+    std::vector<D3D12_CPU_DESCRIPTOR_HANDLE> m_copyDestinations;
+    std::vector<D3D12_CPU_DESCRIPTOR_HANDLE> m_copySources;
+    std::vector<UINT> m_copySizes;
+
+    Range getRange(uint32_t index, uint32_t count) const;
+};
+
+} // namespace fw
@@ -5,11 +5,11 @@
 namespace fw
 {
 template<typename T>
-int runApplication()
+int runApplication(const Config& config)
 {
     fw::Framework fw;
     int status = 1;
-    if (fw.initialize())
+    if (fw.initialize(config))
     {
         T app;
         if (app.initialize())
@@ -23,4 +23,22 @@ int runApplication()
     return status;
 }
 
+template<typename T>
+int runApplication()
+{
+    return runApplication<T>(Config());
+}
+
+// The configuration is read from the environment and the command line
+template<typename T>
+int runApplication(int argc, char** argv)
+{
+    Config config;
+    if (!config.parse(argc, argv))
+    {
+        return 1;
+    }
+    return runApplication<T>(config);
+}
+
 } // namespace fw
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <d3d12.h>
+#include <wrl.h>
+
+#include <vector>
+
+namespace fw
+{
+// Persistently mapped upload buffer for data that is written every frame, like constants. Each frame in flight
+// has a part of the buffer that allocations are bumped from, and the part is reset when the frame is started
+// again, which happens after the fence of its previous use has been passed.
+class FrameAllocator
+{
+public:
+    struct Allocation
+    {
+        unsigned char* data = nullptr;
+        D3D12_GPU_VIRTUAL_ADDRESS gpuAddress = 0;
+    };
+
+    FrameAllocator(){};
+    ~FrameAllocator();
+    FrameAllocator(const FrameAllocator&) = delete;
+    FrameAllocator(FrameAllocator&&) = delete;
+    FrameAllocator& operator=(const FrameAllocator&) = delete;
+    FrameAllocator& operator=(FrameAllocator&&) = delete;
+
+    void initialize(ID3D12Device* device, UINT64 frameSize, int frameCount);
+
+    // The GPU must be done with the previous use of the frame
+    void beginFrame(int frameIndex);
+
+    // Allocations are aligned to 256 bytes, so they can be bound as constant buffers. The data is valid until
+    // the frame is started again.
+    Allocation allocate(UINT64 size);
+    Allocation allocate(const void* data, UINT64 size);
+
+    UINT64 getFrameSize() const;
+    // Used size of the current frame
+    UINT64 getUsedSize() const;
+
+private:
+    Microsoft::WRL::ComPtr<ID3D12Resource> m_buffer;
+    unsigned char* m_data = nullptr;
+    D3D12_GPU_VIRTUAL_ADDRESS m_gpuAddress = 0;
+    UINT64 m_frameSize = 0;
+    UINT64 m_frameOffset = 0; // Start of the current frame's part
+    UINT64 m_offset = 0;      // Where the next allocation starts in the current frame's part
+};
+
+} // namespace fw
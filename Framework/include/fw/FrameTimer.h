@@ -0,0 +1,80 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+namespace fw
+{
+// Durations of the stages of the frames, kept in a ring of the latest frames that percentiles are computed from.
+// The clock can be replaced, e.g. with one that is advanced by hand to get the same timings every time. Frames are
+// timed from one thread, other threads can read the ring without locks. A reader that falls behind by the whole
+// history can mix stages of different frames, but every value is a duration that was measured.
+class FrameTimer
+{
+public:
+    enum class Stage
+    {
+        Events, // Window events and input
+        FenceWait, // Waiting for the GPU to finish the previous use of the frame
+        Update,
+        Record, // Filling the command list
+        Present, // Executing the command list and presenting
+        Frame, // From the beginning to the end of the frame
+        Count
+    };
+
+    struct Percentiles
+    {
+        // Milliseconds
+        float p50 = 0.0f;
+        float p95 = 0.0f;
+        float p99 = 0.0f;
+    };
+
+    using Clock = std::function<std::chrono::steady_clock::time_point()>;
+
+    FrameTimer(){};
+    FrameTimer(const FrameTimer&) = delete;
+    FrameTimer(FrameTimer&&) = delete;
+    FrameTimer& operator=(const FrameTimer&) = delete;
+    FrameTimer& operator=(FrameTimer&&) = delete;
+
+    // Uses the steady clock
+    void initialize(size_t historySize);
+    void initialize(size_t historySize, Clock clock);
+
+    void beginFrame();
+    // The stage lasts from the end of the previous stage, or the beginning of the frame, until now. Stages that
+    // are not ended during a frame are zero.
+    void endStage(Stage stage);
+    void endFrame();
+
+    // Number of frames in the history
+    size_t getFrameCount() const;
+    // Milliseconds of the latest frame
+    float getLatest(Stage stage) const;
+    // Nearest rank percentiles over the frames in the history
+    Percentiles getPercentiles(Stage stage) const;
+
+    static const char* getStageName(Stage stage);
+
+private:
+    static const size_t c_stageCount = static_cast<size_t>(Stage::Count);
+
+    Clock m_clock;
+    size_t m_historySize = 0;
+    // Milliseconds of the stages of each frame in the history
+    std::unique_ptr<std::atomic<float>[]> m_durations;
+    // Frames ended so far, published after the durations of the frame are written
+    std::atomic<uint64_t> m_endedFrameCount{0};
+
+    std::chrono::steady_clock::time_point m_frameBegin;
+    std::chrono::steady_clock::time_point m_stageBegin;
+    float m_currentDurations[c_stageCount]{};
+};
+
+} // namespace fw
@@ -2,6 +2,15 @@
 
 #include "API.h"
 #include "Application.h"
+#include "Backend.h"
+#include "BufferHeap.h"
+#include "Config.h"
+#include "DescriptorHeap.h"
+#include "FrameAllocator.h"
+#include "FrameTimer.h"
+#include "GpuProfiler.h"
+#include "TextureHeap.h"
+#include "UploadRing.h"
 #include "Window.h"
 
 #include <wrl.h>
@@ -12,6 +21,8 @@
 
 #include <vector>
 #include <chrono>
+#include <memory>
+#include <string>
 
 namespace fw
 {
@@ -27,24 +38,54 @@ public:
     Framework& operator=(const Framework&) = delete;
     Framework& operator=(Framework&&) = delete;
 
+    // Uses the default configuration
     bool initialize();
+    bool initialize(const Config& config);
     void setApplication(Application* application);
+    // Runs until the window is closed or the application quits, or at most the frame count if it is not negative.
+    // Without a frame count the frame limit of the configuration is used. A run without a window prints the frame
+    // timings and the memory use at the end, and the null backend also what its device has counted.
     void execute();
+    void execute(int frameCount);
 
 private:
+    static constexpr float c_fixedTimeDelta = 1.0f / 60.0f;
+
     DXGI_FORMAT m_backBufferFormat = DXGI_FORMAT_R8G8B8A8_UNORM;
     DXGI_FORMAT m_depthStencilFormat = DXGI_FORMAT_D24_UNORM_S8_UINT;
     int m_swapChainBufferCount = 2;
-
+    UINT64 m_uploadRingSize = 64 * 1024 * 1024;
+    UINT64 m_frameAllocatorSize = 4 * 1024 * 1024;
+    UINT64 m_bufferHeapSize = 64 * 1024 * 1024;
+    UINT64 m_textureHeapSize = 128 * 1024 * 1024;
+    UINT64 m_renderTargetHeapSize = 64 * 1024 * 1024;
+    uint32_t m_persistentDescriptorCount = 4096;
+    uint32_t m_transientDescriptorCount = 1024;
+    uint32_t m_stagingDescriptorCount = 1024;
+    size_t m_frameTimingHistory = 1024;
+    uint32_t m_gpuPassesPerFrame = 64;
+    // Written on exit when the profiler is enabled
+    std::string m_traceFilepath = "trace.json";
+
+    Config m_config;
     Window m_window;
     Application* m_app = nullptr;
 
-    Microsoft::WRL::ComPtr<IDXGIFactory4> m_dxgiFactory;
+    std::unique_ptr<Backend> m_backend;
     Microsoft::WRL::ComPtr<ID3D12Device5> m_d3dDevice;
 
     Microsoft::WRL::ComPtr<ID3D12Fence> m_fence;
     UINT64 m_currentFenceId = 100;
     std::vector<UINT64> m_fenceIds;
+    // Events are reused for every wait of their frame instead of creating one per wait
+    std::vector<HANDLE> m_frameEvents;
+
+    UploadRing m_uploadRing;
+    FrameAllocator m_frameAllocator;
+    BufferHeap m_bufferHeap;
+    TextureHeap m_textureHeap;
+    TextureHeap m_renderTargetHeap;
+    DescriptorHeap m_descriptorHeap;
 
     UINT m_rtvDescriptorIncrementSize;
     UINT m_dsvDescriptorIncrementSize;
@@ -54,6 +95,8 @@ private:
     Microsoft::WRL::ComPtr<ID3D12CommandAllocator> m_commandAllocator;
     std::vector<Microsoft::WRL::ComPtr<ID3D12CommandAllocator>> m_frameCommandAllocators;
     Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList4> m_commandList;
+    // Finishes the buffer uploads that were recorded into the command list
+    Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList4> m_uploadCommandList;
 
     Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> m_rtvHeap;
     Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> m_dsvHeap;
@@ -63,16 +106,26 @@ private:
     D3D12_CPU_DESCRIPTOR_HANDLE m_depthStencilView;
 
     int m_currentFrameIndex = 0;
+    int m_currentBackBufferIndex = 0;
 
     std::chrono::steady_clock::time_point m_timeFromBegin;
     std::chrono::steady_clock::time_point m_timeLastUpdate;
     float m_timeDelta = 0.0f;
+    FrameTimer m_frameTimer;
+    GpuProfiler m_gpuProfiler;
 
     bool m_running = true;
 
     void completeInitialization();
     void waitForFrame(int frameIndex);
+    bool isFrameComplete(int frameIndex) const;
+    void waitForFence(UINT64 fenceId, HANDLE eventHandle);
     void render();
+    // Returns nullptr if there are no buffer uploads to finish
+    ID3D12CommandList* finishUploads(ID3D12CommandAllocator* commandAllocator);
+    void createSwapChain();
+    void printFrameTimes() const;
+    void printSummary() const;
     ID3D12Resource* getCurrentBackBuffer();
     CD3DX12_CPU_DESCRIPTOR_HANDLE getCurrentBackBufferView();
 };
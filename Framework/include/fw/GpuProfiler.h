@@ -0,0 +1,87 @@
+#pragma once
+
+#include "GpuTimestampQueries.h"
+#include "Profiler.h"
+
+#include <d3d12.h>
+#include <wrl.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace fw
+{
+// Times GPU passes with timestamp queries written into the command list. The timings are read back when the frame
+// is recorded the next time, frame count frames later, and are placed on a GPU timeline of the CPU profiler trace.
+class GpuProfiler
+{
+public:
+    struct PassTiming
+    {
+        const char* name;
+        float milliseconds;
+    };
+
+    GpuProfiler(){};
+    GpuProfiler(const GpuProfiler&) = delete;
+    GpuProfiler(GpuProfiler&&) = delete;
+    GpuProfiler& operator=(const GpuProfiler&) = delete;
+    GpuProfiler& operator=(GpuProfiler&&) = delete;
+
+    void initialize(ID3D12Device* device, ID3D12CommandQueue* commandQueue, uint32_t passesPerFrame, int frameCount);
+
+    // The GPU must be done with the previous use of the frame
+    void beginFrame(int frameIndex);
+    void beginPass(ID3D12GraphicsCommandList* commandList, const Profiler::Site* site);
+    void endPass(ID3D12GraphicsCommandList* commandList);
+    // Returns a command list that resolves the queries of the frame, executed after the frame, or nullptr if the
+    // frame has no passes
+    ID3D12CommandList* endFrame();
+
+    // Passes of the latest frame that was read back
+    const std::vector<PassTiming>& getLatest() const;
+
+private:
+    Microsoft::WRL::ComPtr<ID3D12CommandQueue> m_commandQueue;
+    Microsoft::WRL::ComPtr<ID3D12QueryHeap> m_queryHeap;
+    Microsoft::WRL::ComPtr<ID3D12Resource> m_readbackBuffer;
+    uint64_t* m_timestamps = nullptr;
+    std::vector<Microsoft::WRL::ComPtr<ID3D12CommandAllocator>> m_commandAllocators;
+    Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> m_commandList;
+
+    GpuTimestampQueries m_queries;
+    UINT64 m_timestampFrequency = 1;
+    int m_currentFrameIndex = 0;
+    uint32_t m_timeline = 0;
+    std::vector<PassTiming> m_latest;
+};
+
+class GpuProfileScope
+{
+public:
+    GpuProfileScope(GpuProfiler& profiler, ID3D12GraphicsCommandList* commandList, const Profiler::Site* site) :
+        m_profiler(profiler),
+        m_commandList(commandList)
+    {
+        m_profiler.beginPass(m_commandList, site);
+    }
+    ~GpuProfileScope()
+    {
+        m_profiler.endPass(m_commandList);
+    }
+    GpuProfileScope(const GpuProfileScope&) = delete;
+    GpuProfileScope(GpuProfileScope&&) = delete;
+    GpuProfileScope& operator=(const GpuProfileScope&) = delete;
+    GpuProfileScope& operator=(GpuProfileScope&&) = delete;
+
+private:
+    GpuProfiler& m_profiler;
+    ID3D12GraphicsCommandList* m_commandList;
+};
+
+} // namespace fw
+
+// GPU passes are timed also without FW_PROFILER_ENABLED, they are only added to the trace with it
+#define FW_GPU_PROFILE_SCOPE(profiler, commandList, name)                                                           \
+    static constexpr fw::Profiler::Site FW_PROFILE_CONCAT(s_gpuProfileSite, __LINE__){name, __FILE__, __LINE__}; \
+    fw::GpuProfileScope FW_PROFILE_CONCAT(gpuProfileScope, __LINE__)(profiler, commandList, &FW_PROFILE_CONCAT(s_gpuProfileSite, __LINE__))
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "Profiler.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace fw
+{
+// Schedules the timestamp queries of GPU passes. Every frame in flight owns a range of the queries and of the
+// readback, the range is resolved at the end of the frame and read when the frame is recorded the next time, so
+// reading never waits for the GPU. The queries are written through an interface so that the scheduling can be run
+// with a mock command list.
+class GpuTimestampQueries
+{
+public:
+    class CommandList
+    {
+    public:
+        virtual ~CommandList(){};
+        virtual void writeTimestamp(uint32_t query) = 0;
+        // Copies the timestamps to the same indices in the readback
+        virtual void resolve(uint32_t firstQuery, uint32_t queryCount) = 0;
+    };
+
+    struct Pass
+    {
+        const Profiler::Site* site;
+        // GPU ticks
+        uint64_t begin;
+        uint64_t end;
+    };
+
+    GpuTimestampQueries(){};
+    GpuTimestampQueries(const GpuTimestampQueries&) = delete;
+    GpuTimestampQueries(GpuTimestampQueries&&) = delete;
+    GpuTimestampQueries& operator=(const GpuTimestampQueries&) = delete;
+    GpuTimestampQueries& operator=(GpuTimestampQueries&&) = delete;
+
+    void initialize(uint32_t passesPerFrame, int frameCount);
+    // Queries in the query heap and timestamps in the readback
+    uint32_t getQueryCount() const;
+
+    // The GPU must be done with the previous use of the frame. Returns the passes of that use, the timestamps are
+    // the readback of all the queries.
+    const std::vector<Pass>& beginFrame(int frameIndex, const uint64_t* timestamps);
+    // Passes can nest. A pass that does not fit into the queries of the frame is not timed.
+    void beginPass(CommandList& commandList, const Profiler::Site* site);
+    void endPass(CommandList& commandList);
+    // Whether the frame has queries to resolve
+    bool hasQueries() const;
+    void endFrame(CommandList& commandList);
+
+private:
+    static constexpr uint32_t c_untimedPass = ~0u;
+
+    struct PendingPass
+    {
+        const Profiler::Site* site;
+        uint32_t beginQuery;
+        uint32_t endQuery;
+    };
+
+    struct Frame
+    {
+        std::vector<PendingPass> passes;
+        uint32_t queryCount = 0;
+        bool resolved = false;
+    };
+
+    uint32_t m_queriesPerFrame = 0;
+    std::vector<Frame> m_frames;
+    int m_currentFrameIndex = 0;
+    // Indices to the passes of the current frame, c_untimedPass for passes that are not timed
+    std::vector<uint32_t> m_openPasses;
+    std::vector<Pass> m_readPasses;
+};
+
+} // namespace fw
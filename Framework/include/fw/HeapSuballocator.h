@@ -0,0 +1,82 @@
+#pragma once
+
+#include "BuddyAllocator.h"
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace fw
+{
+// Suballocates a heap. Small allocations are slots of power of two size classes that are carved out of pages,
+// larger allocations are blocks of a buddy allocator that also hands out the pages. Offsets are aligned to
+// their slot or block size. It only hands out offsets so it can be used without a device.
+class HeapSuballocator
+{
+public:
+    static const uint64_t c_invalidOffset = BuddyAllocator::c_invalidOffset;
+
+    struct Stats
+    {
+        uint32_t heapCount = 0;
+        uint32_t allocationCount = 0;
+        uint64_t size = 0;
+        // Size of the slots and blocks in use, including rounding up to their size
+        uint64_t allocatedSize = 0;
+        uint64_t requestedSize = 0;
+        // Size of the free blocks, free slots of pages in use are not included
+        uint64_t freeSize = 0;
+        uint64_t largestFreeBlock = 0;
+
+        void add(const Stats& stats);
+        // Share of the heaps that was requested
+        float getUtilization() const;
+        // Share of the allocated size lost to rounding up
+        float getInternalFragmentation() const;
+        // Share of the free size that is not in the largest free block
+        float getExternalFragmentation() const;
+    };
+
+    HeapSuballocator(){};
+    HeapSuballocator(const HeapSuballocator&) = delete;
+    HeapSuballocator(HeapSuballocator&&) = delete;
+    HeapSuballocator& operator=(const HeapSuballocator&) = delete;
+    HeapSuballocator& operator=(HeapSuballocator&&) = delete;
+
+    // Releases everything. The sizes must be powers of two, size classes range from the smallest one to half a page.
+    void initialize(uint64_t size, uint64_t pageSize, uint64_t minSizeClass);
+
+    // Returns c_invalidOffset if there is no room. The alignment must be a power of two.
+    uint64_t allocate(uint64_t size, uint64_t alignment);
+    void free(uint64_t offset);
+
+    // Size of the slot or block that would be allocated for the size and the alignment
+    uint64_t getAllocationSize(uint64_t size, uint64_t alignment) const;
+    Stats getStats() const;
+
+private:
+    struct Page
+    {
+        uint32_t sizeClass;
+        uint32_t usedSlotCount;
+        std::vector<uint32_t> freeSlots;
+    };
+
+    BuddyAllocator m_buddyAllocator;
+    uint64_t m_pageSize = 0;
+    uint64_t m_minSizeClass = 0;
+    // Offsets of the pages that have free slots, per size class
+    std::vector<std::vector<uint64_t>> m_partialPages;
+    std::unordered_map<uint64_t, Page> m_pages;
+    // Requested size of each allocation
+    std::unordered_map<uint64_t, uint64_t> m_allocations;
+    uint64_t m_requestedSize = 0;
+    uint64_t m_slotSize = 0;
+
+    uint32_t getSizeClass(uint64_t slotSize) const;
+    uint64_t getSlotSize(uint32_t sizeClass) const;
+    uint64_t allocateSlot(uint32_t sizeClass);
+    void freeSlot(uint64_t pageOffset, Page& page, uint64_t offset);
+};
+
+} // namespace fw
@@ -1,14 +1,28 @@
 #pragma once
 
+#include "MeshSimplifier.h"
+#include "Meshlet.h"
+#include "Span.h"
+
 #include <assimp/material.h>
+#include <DirectXCollision.h>
 #include <DirectXMath.h>
 
+#include <cstdint>
 #include <string>
-#include <unordered_map>
 #include <vector>
 
 namespace fw
 {
+// Placement of a mesh in its model. A mesh that appears several times in the source asset is stored
+// once and has one instance per appearance.
+struct MeshInstance
+{
+    DirectX::XMFLOAT4X4 transform; // Mesh to model space, for row vectors like the rest of DirectXMath
+    uint32_t meshIndex;
+    uint32_t reserved[3];
+};
+
 class Mesh
 {
 public:
@@ -20,18 +34,90 @@ public:
         DirectX::XMFLOAT2 uv;
     };
 
+    // Attributes that follow the position in the second stream of the SplitPosition layout
+    struct VertexAttributes
+    {
+        DirectX::XMFLOAT3 normal;
+        DirectX::XMFLOAT3 tangent;
+        DirectX::XMFLOAT2 uv;
+    };
+
+    enum class VertexLayout
+    {
+        Separate,     // One stream per attribute
+        Interleaved,  // A single stream of Vertex
+        SplitPosition // A stream of positions and a stream of VertexAttributes
+    };
+
+    // Vertex buffer contents, the stream can be uploaded as is
+    struct VertexStream
+    {
+        Span<const unsigned char> data;
+        uint32_t stride = 0;
+    };
+
+    enum class IndexType
+    {
+        UInt16,
+        UInt32
+    };
+
+    struct TextureReference
+    {
+        aiTextureType type = aiTextureType_NONE;
+        // Index to the embedded textures of the owning model, -1 for textures that are external files
+        int textureIndex = -1;
+        Span<const char> name;
+    };
+
+    static const uint32_t c_maxVertexStreams = 4;
+
     using Vertices = std::vector<Vertex>;
-    using TextureNames = std::unordered_map<aiTextureType, std::vector<std::string>>;
 
-    std::vector<DirectX::XMFLOAT3> positions;
-    std::vector<DirectX::XMFLOAT3> normals;
-    std::vector<DirectX::XMFLOAT3> tangents;
-    std::vector<DirectX::XMFLOAT2> uvs;
-    std::vector<uint16_t> indices;
-    TextureNames textureNames;
+    // Views into the storage of the owning model, tangents and uvs may be empty
+    VertexLayout vertexLayout = VertexLayout::Separate;
+    StridedSpan<const DirectX::XMFLOAT3> positions;
+    StridedSpan<const DirectX::XMFLOAT3> normals;
+    StridedSpan<const DirectX::XMFLOAT3> tangents;
+    StridedSpan<const DirectX::XMFLOAT2> uvs;
+    VertexStream vertexStreams[c_maxVertexStreams];
+    uint32_t vertexStreamCount = 0;
+    // 16-bit indices are used whenever all the vertices can be addressed with them
+    IndexType indexType = IndexType::UInt16;
+    Span<const uint16_t> indices16;
+    Span<const uint32_t> indices32;
+    // Levels of detail share the vertices and the index buffer, empty if only the full mesh was loaded
+    Span<const MeshLod> lods;
+    DirectX::BoundingBox boundingBox;
+    DirectX::BoundingSphere boundingSphere;
+    // Empty unless meshlets were generated when loading the model
+    Span<const Meshlet> meshlets;
+    Span<const MeshletBounds> meshletBounds;
+    Span<const uint32_t> meshletVertices;
+    Span<const uint8_t> meshletTriangles;
+    Span<const TextureReference> textures;
+    // Instances of this mesh, firstInstance is the index of the first one in the instances of the model
+    Span<const MeshInstance> instances;
+    uint32_t firstInstance = 0;
 
     Mesh(){};
+    void setVertices(Span<const Vertex> vertices);
+    size_t getVertexCount() const;
+    Span<const VertexStream> getVertexStreams() const;
+    // Empty unless the layout is Interleaved
+    Span<const Vertex> getInterleavedVertices() const;
+    // Copies the vertices to a new array regardless of the layout
     Vertices getVertices() const;
+    size_t getIndexCount() const;
+    size_t getIndexSize() const;
+    const void* getIndexData() const;
+    size_t getIndexDataSize() const;
+    uint32_t getIndex(size_t i) const;
+    size_t getLodCount() const;
+    MeshLod getLod(size_t level) const;
+    // Coarsest level whose accumulated quadric error, see MeshLod::error, is at most maxError
+    size_t selectLod(float maxError) const;
     std::string getFirstTextureOfType(aiTextureType type) const;
+    int getFirstTextureIndexOfType(aiTextureType type) const;
 };
 } // namespace fw
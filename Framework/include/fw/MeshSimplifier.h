@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace fw
+{
+class Mesh;
+
+// Range of the index buffer that draws one level of detail
+struct MeshLod
+{
+    uint32_t indexOffset;
+    uint32_t indexCount;
+    // Sum over the simplification steps up to this level of the square root of the largest collapse cost. The cost is
+    // the area weighted mean squared distance to the planes of the merged faces plus a penalty for bending normals,
+    // so the error is an RMS quadric error in model units that grows with coarser levels. It is not a bound of the
+    // distance to the full mesh surface.
+    float error;
+    uint32_t reserved;
+};
+
+// Quadric error metric edge collapse simplifier. Vertices that are split by UV or normal seams and
+// vertices on open borders stay in place, and collapses that would flip a face are rejected.
+class MeshSimplifier
+{
+public:
+    MeshSimplifier() = delete;
+
+    // Collapses edges until there are at most targetIndexCount indices left or nothing can be collapsed,
+    // returns the square root of the largest collapse cost, see MeshLod::error
+    static float simplify(const Mesh& mesh,
+                          const std::vector<uint32_t>& indices,
+                          size_t targetIndexCount,
+                          std::vector<uint32_t>& result);
+
+    // Level 0 is the full mesh and every ratio adds a level with at most that fraction of its triangles.
+    // All levels are stored one after another in indices.
+    static void buildLodChain(const Mesh& mesh,
+                              const std::vector<float>& ratios,
+                              std::vector<MeshLod>& lods,
+                              std::vector<uint32_t>& indices);
+};
+
+} // namespace fw
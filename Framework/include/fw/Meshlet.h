@@ -0,0 +1,53 @@
+#pragma once
+
+#include <DirectXMath.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace fw
+{
+class Mesh;
+
+// Cluster of at most MeshletBuilder::c_maxVertices vertices and MeshletBuilder::c_maxTriangles triangles
+struct Meshlet
+{
+    uint32_t vertexOffset;   // First element in the meshlet vertex array
+    uint32_t triangleOffset; // First element in the meshlet triangle array, three local indices per triangle
+    uint32_t vertexCount;
+    uint32_t triangleCount;
+};
+
+// The meshlet faces away from a camera at position p if
+// dot(center - p, coneAxis) >= coneCutoff * length(center - p) + radius
+struct MeshletBounds
+{
+    DirectX::XMFLOAT3 center;
+    float radius;
+    DirectX::XMFLOAT3 coneAxis;
+    float coneCutoff; // 1 if the cone is too wide for culling
+};
+
+struct MeshletData
+{
+    std::vector<Meshlet> meshlets;
+    std::vector<MeshletBounds> bounds;
+    // Mesh vertex indices referenced by the meshlets
+    std::vector<uint32_t> vertices;
+    // Indices to the meshlet vertices
+    std::vector<uint8_t> triangles;
+};
+
+class MeshletBuilder
+{
+public:
+    static const uint32_t c_maxVertices = 64;
+    static const uint32_t c_maxTriangles = 124;
+
+    MeshletBuilder() = delete;
+
+    // Partitions the triangles of the most detailed level in index order
+    static void build(const Mesh& mesh, MeshletData& data);
+};
+
+} // namespace fw
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "Span.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace fw
+{
+// Builds the mip chain of an RGBA8 image on the CPU
+class MipGenerator
+{
+public:
+    static const uint32_t c_pixelSize = 4;
+
+    enum class Filter
+    {
+        Box,   // Average of the covered pixels
+        Kaiser // Kaiser windowed sinc, sharper than Box
+    };
+
+    enum class ColorSpace
+    {
+        Linear,
+        Srgb // Color channels are converted to linear before filtering, alpha is always linear
+    };
+
+    // Vector instructions of the filters. The best set that the CPU supports is picked when the first image is
+    // filtered, so the framework is built without AVX2 and still uses it where it can.
+    enum class InstructionSet
+    {
+        Sse2,
+        Avx2
+    };
+
+    // Rows are tightly packed
+    struct Level
+    {
+        uint32_t width;
+        uint32_t height;
+        size_t offset;
+
+        size_t getRowPitch() const;
+        size_t getSize() const;
+    };
+
+    struct Chain
+    {
+        std::vector<Level> levels;
+        std::vector<unsigned char> pixels;
+
+        Span<const unsigned char> getLevelData(size_t level) const;
+    };
+
+    MipGenerator() = delete;
+
+    static uint32_t getLevelCount(uint32_t width, uint32_t height);
+
+    // Level 0 is a copy of the image and every following level is filtered from the previous one.
+    // Rows of a level are filtered in parallel on the default thread pool.
+    static void generate(const unsigned char* pixels, uint32_t width, uint32_t height, ColorSpace colorSpace, Filter filter, Chain& chain);
+    // Scales the image to the new size, which can also be larger
+    static void resize(const unsigned char* pixels,
+                       uint32_t width,
+                       uint32_t height,
+                       uint32_t newWidth,
+                       uint32_t newHeight,
+                       ColorSpace colorSpace,
+                       Filter filter,
+                       std::vector<unsigned char>& result);
+
+    static InstructionSet getInstructionSet();
+    // Returns false if the CPU does not support the set, e.g. to compare the results of the sets
+    static bool setInstructionSet(InstructionSet instructionSet);
+
+private:
+    // Weighted sum of whole source rows for one destination row, in MipGeneratorAvx2.cpp which is the only file that
+    // is compiled for AVX2. Returns the number of floats written, the rest of the row is left to the caller.
+    static size_t filterRowAvx2(const float* source, size_t rowLength, const uint32_t* indices, const float* weights, uint32_t tapCount, float* destination);
+};
+
+} // namespace fw
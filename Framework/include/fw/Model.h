@@ -1,9 +1,16 @@
 #pragma once
 
+#include "Arena.h"
+#include "Bounds.h"
 #include "Mesh.h"
+#include "MappedFile.h"
+#include "ModelCache.h"
 
+#include <atomic>
+#include <cstdint>
+#include <future>
+#include <memory>
 #include <string>
-#include <unordered_map>
 #include <vector>
 
 namespace fw
@@ -12,21 +19,105 @@ class Model
 {
 public:
     using Meshes = std::vector<Mesh>;
-    using TextureData = std::vector<unsigned char>;
+    // Compressed bytes of an embedded texture, valid while the model is alive
+    using TextureData = Span<const unsigned char>;
+
+    struct LoadOptions
+    {
+        // Meshes with more vertices than 16-bit indices can address use 32-bit indices unless they are split
+        bool splitLargeMeshes = false;
+        // Layout the vertex data is stored in, so that it can be uploaded without conversion
+        Mesh::VertexLayout vertexLayout = Mesh::VertexLayout::Interleaved;
+        bool generateMeshlets = false;
+        // Triangle ratios of the simplified levels of detail, e.g. {0.5f, 0.25f}, none if empty
+        std::vector<float> lodRatios;
+        // Meshes with the same geometry and textures are stored once and drawn through their instances
+        bool deduplicateMeshes = true;
+    };
+
+    // Shared by a background load and its handles
+    struct LoadState
+    {
+        std::atomic<float> progress{0.0f};
+        std::atomic<bool> cancelled{false};
+    };
+
+    struct MemoryUsage
+    {
+        size_t mappedBytes = 0; // Cache file mapped into memory
+        size_t imageBytes = 0;  // Cache image of a model that was imported
+        size_t arenaBytes = 0;  // Texture references and other per-mesh data
+        size_t meshBytes = 0;
+
+        size_t getHeapBytes() const;
+    };
+
+    class LoadHandle
+    {
+    public:
+        LoadHandle(){};
+
+        bool isValid() const;
+        bool isReady() const;
+        // Fraction of the load that is done, from 0 to 1
+        float getProgress() const;
+        // The load stops at its next checkpoint and fails
+        void cancel();
+        // Waits for the load to finish and returns whether it succeeded
+        bool get() const;
+
+    private:
+        friend class Model;
+        std::shared_future<bool> m_result;
+        std::shared_ptr<LoadState> m_state;
+    };
 
     Model(){};
+    ~Model();
     Model(const Model&) = delete;
     Model(Model&&) = delete;
     Model& operator=(const Model&) = delete;
     Model& operator=(Model&&) = delete;
 
     bool loadModel(const std::string& file);
+    bool loadModel(const std::string& file, const LoadOptions& options);
+    // Loads the model on the default thread pool. The model must not be accessed before the load is ready.
+    LoadHandle loadAsync(const std::string& file);
+    LoadHandle loadAsync(const std::string& file, const LoadOptions& options);
     const Meshes& getMeshes() const;
-    const TextureData& getTextureData(unsigned int index);
+    size_t getTextureCount() const;
+    TextureData getTextureData(unsigned int index) const;
+    const DirectX::BoundingBox& getBoundingBox() const;
+    const DirectX::BoundingSphere& getBoundingSphere() const;
+    // Sorted by mesh so that the instances of each mesh can be drawn with one instanced draw
+    Span<const MeshInstance> getInstances() const;
+    // Hierarchy of instance bounds, the items of the leaves index getHierarchyInstanceIndices
+    Span<const BoundsNode> getHierarchy() const;
+    Span<const uint32_t> getHierarchyInstanceIndices() const;
+    MemoryUsage getMemoryUsage() const;
 
 private:
+    // Apart from the mesh array, everything the model owns is in the cache image and the arena so
+    // releasing it takes a few frees
     Meshes m_meshes;
-    std::unordered_map<unsigned int, TextureData> m_textureDatas;
+    Arena m_arena;
+    Span<const TextureData> m_textures;
+    Span<const MeshInstance> m_instances;
+    DirectX::BoundingBox m_boundingBox;
+    DirectX::BoundingSphere m_boundingSphere;
+    Span<const BoundsNode> m_hierarchy;
+    Span<const uint32_t> m_hierarchyInstanceIndices;
+
+    // Mesh data lives either in the mapped cache file or, if the model was imported, in the cache image
+    MappedFile m_cacheFile;
+    std::vector<unsigned char> m_cacheImage;
+
+    LoadHandle m_pendingLoad;
+
+    void waitForPendingLoad();
+    bool load(const std::string& file, const LoadOptions& options, LoadState* state);
+    bool importModel(const std::string& file, const ModelCache::Header& cacheKey, const LoadOptions& options, LoadState* state);
+    bool readCacheImage(const unsigned char* data, size_t size);
 };
 
 } // namespace fw
@@ -0,0 +1,129 @@
+#pragma once
+
+#include "Bounds.h"
+#include "Mesh.h"
+#include "Meshlet.h"
+
+#include <DirectXCollision.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace fw
+{
+// Binary cache of imported models. The cache image is written next to the source asset and read back
+// through a memory mapping so that mesh data can be used in place without running the importer.
+class ModelCache
+{
+public:
+    static const uint32_t c_magic = 0x4D323144; // "D12M"
+    static const uint32_t c_version = 8;
+    static const uint32_t c_meshletsFlag = 0x1;
+    static const uint32_t c_lodsFlag = 0x2;
+    static const uint32_t c_deduplicatedFlag = 0x4;
+    static const size_t c_alignment = 16;
+
+    struct Header
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t sourceHash;
+        uint32_t importFlags;
+        uint32_t meshCount;
+        uint32_t textureCount;
+        uint32_t vertexLayout;
+        uint32_t contentFlags;
+        uint32_t lodRatiosHash;
+        uint64_t imageSize;
+        uint64_t meshesOffset;
+        uint64_t texturesOffset;
+        uint64_t hierarchyOffset;
+        uint64_t hierarchyInstanceIndicesOffset;
+        uint32_t hierarchyNodeCount;
+        uint32_t instanceCount;
+        uint64_t instancesOffset;
+    };
+
+    struct MeshEntry
+    {
+        uint32_t vertexCount;
+        uint32_t indexCount;
+        uint64_t positionsOffset;
+        uint64_t normalsOffset;
+        uint64_t tangentsOffset;
+        uint64_t uvsOffset;
+        uint64_t indicesOffset;
+        uint32_t tangentCount;
+        uint32_t uvCount;
+        uint64_t textureNamesOffset;
+        uint32_t textureNameCount;
+        uint32_t indexSize;
+        uint64_t meshletsOffset;
+        uint64_t meshletBoundsOffset;
+        uint64_t meshletVerticesOffset;
+        uint64_t meshletTrianglesOffset;
+        uint32_t meshletCount;
+        uint32_t meshletVertexCount;
+        uint32_t meshletTriangleIndexCount;
+        uint32_t lodCount;
+        uint64_t lodsOffset;
+        uint32_t firstInstance;
+        uint32_t instanceCount;
+        DirectX::BoundingBox boundingBox;
+        DirectX::BoundingSphere boundingSphere;
+    };
+
+    struct TextureNameEntry
+    {
+        uint32_t type;
+        int32_t textureIndex; // Index of an embedded texture or -1
+        uint32_t length;
+        uint32_t reserved;
+        uint64_t offset;
+    };
+
+    struct TextureEntry
+    {
+        uint32_t index;
+        uint32_t reserved;
+        uint64_t offset;
+        uint64_t size;
+    };
+
+    ModelCache() = delete;
+
+    static std::string getCachePath(const std::string& sourceFile);
+    static bool hashFile(const std::string& file, uint64_t& hash);
+    static uint64_t hashData(const void* data, size_t size);
+    // Continues the hash of the preceding data
+    static uint64_t hashData(const void* data, size_t size, uint64_t hash);
+    // The image is valid if it was built from the same source and with the same options as the key
+    static bool isValid(const unsigned char* data, size_t size, const Header& key);
+    static bool isRangeValid(size_t imageSize, uint64_t offset, uint64_t size);
+    static bool write(const std::string& path, const std::vector<unsigned char>& image);
+
+    // Reserves the meshlets of a mesh at the end of the image and sets their offsets and counts in the entry
+    static void reserveMeshlets(const MeshletData& meshlets, uint64_t& imageSize, MeshEntry& entry);
+    // The image must have the size reserved for the meshlets
+    static void writeMeshlets(const MeshletData& meshlets, const MeshEntry& entry, std::vector<unsigned char>& image);
+    // Points the meshlet views of the mesh to the image. Returns false if the meshlets of the entry are outside the
+    // image or reference vertices and triangles outside of it.
+    static bool readMeshlets(const unsigned char* data, size_t size, const MeshEntry& entry, Mesh& mesh);
+
+    static uint64_t align(uint64_t offset)
+    {
+        return (offset + c_alignment - 1) & ~static_cast<uint64_t>(c_alignment - 1);
+    }
+
+    // Returns the aligned offset of size bytes at the end of the image and grows the image size past them
+    static uint64_t reserve(uint64_t& imageSize, uint64_t size)
+    {
+        const uint64_t offset = align(imageSize);
+        imageSize = offset + size;
+        return offset;
+    }
+};
+
+} // namespace fw
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "Backend.h"
+
+namespace fw
+{
+// A device that executes nothing and needs no GPU. It records the resource creations, the allocated bytes, the
+// barriers, the draws and the dispatches. Fences complete when they are signaled, upload and readback resources
+// have CPU memory that the GPU never writes, and there is no ray tracing.
+class NullBackend : public Backend
+{
+public:
+    NullBackend(){};
+
+    bool createDevice(const Config& config, Microsoft::WRL::ComPtr<ID3D12Device5>& device) override;
+    bool createCommandQueue(ID3D12Device5* device, Microsoft::WRL::ComPtr<ID3D12CommandQueue>& commandQueue) override;
+    bool createCommandList(ID3D12Device5* device, ID3D12CommandAllocator* commandAllocator, Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList4>& commandList) override;
+    bool getCounters(Counters& counters) const override;
+
+private:
+    Microsoft::WRL::ComPtr<ID3D12Device5> m_device;
+};
+
+} // namespace fw
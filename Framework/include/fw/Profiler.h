@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace fw
+{
+// Records scoped zones of CPU time. Every thread appends its zones to a buffer of its own without locks, so a zone
+// costs two reads of the clock and a store. Zone names are interned at compile time: the name, file and line of a
+// zone are a constant that the zones point to. The buffers keep the latest zones of each thread and are written as
+// JSON that chrome://tracing and Perfetto open. Without FW_PROFILER_ENABLED the zone macros compile to nothing.
+class Profiler
+{
+public:
+    struct Site
+    {
+        const char* name;
+        const char* file;
+        uint32_t line;
+    };
+
+    Profiler() = delete;
+
+    // Nanoseconds from the start of the process
+    static int64_t now();
+    static void record(const Site* site, int64_t begin, int64_t end);
+
+    // Shown in the trace instead of the thread number
+    static void setThreadName(const char* name);
+
+    // A timeline that is not a thread, e.g. the GPU queue, with zones recorded from one thread at a time
+    static uint32_t createTimeline(const char* name);
+    static void record(uint32_t timeline, const Site* site, int64_t begin, int64_t end);
+
+    // Zones that are recorded while the trace is written may be missing from it or torn, so it should be written
+    // when the other threads are idle
+    static bool writeChromeTrace(const std::string& filepath);
+    static void clear();
+};
+
+class ProfileScope
+{
+public:
+    explicit ProfileScope(const Profiler::Site* site) :
+        m_site(site),
+        m_begin(Profiler::now())
+    {
+    }
+    ~ProfileScope()
+    {
+        Profiler::record(m_site, m_begin, Profiler::now());
+    }
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope(ProfileScope&&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+    ProfileScope& operator=(ProfileScope&&) = delete;
+
+private:
+    const Profiler::Site* m_site;
+    int64_t m_begin;
+};
+
+} // namespace fw
+
+#define FW_PROFILE_CONCAT_INNER(a, b) a##b
+#define FW_PROFILE_CONCAT(a, b) FW_PROFILE_CONCAT_INNER(a, b)
+
+#ifdef FW_PROFILER_ENABLED
+#define FW_PROFILE_SCOPE(name)                                                                                      \
+    static constexpr fw::Profiler::Site FW_PROFILE_CONCAT(s_profileSite, __LINE__){name, __FILE__, __LINE__}; \
+    fw::ProfileScope FW_PROFILE_CONCAT(profileScope, __LINE__)(&FW_PROFILE_CONCAT(s_profileSite, __LINE__))
+#define FW_PROFILE_FUNCTION() FW_PROFILE_SCOPE(__FUNCTION__)
+#define FW_PROFILE_THREAD(name) fw::Profiler::setThreadName(name)
+#else
+#define FW_PROFILE_SCOPE(name)
+#define FW_PROFILE_FUNCTION()
+#define FW_PROFILE_THREAD(name)
+#endif
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+
+namespace fw
+{
+// Bookkeeping of a ring buffer whose allocations are used by the GPU. Allocations are grouped into
+// batches by the fence value they are submitted with and released in submission order once the fence
+// has passed that value. The allocator only hands out offsets so it can be used without a device.
+class RingAllocator
+{
+public:
+    static const uint64_t c_invalidOffset = ~0ull;
+
+    RingAllocator(){};
+    RingAllocator(const RingAllocator&) = delete;
+    RingAllocator(RingAllocator&&) = delete;
+    RingAllocator& operator=(const RingAllocator&) = delete;
+    RingAllocator& operator=(RingAllocator&&) = delete;
+
+    // Releases everything
+    void initialize(uint64_t size);
+
+    // Returns c_invalidOffset if there is no contiguous free range of the size. Allocations never wrap
+    // around the end of the ring. The alignment must be a power of two.
+    uint64_t allocate(uint64_t size, uint64_t alignment);
+    // The allocations made since the previous submit are released when the fence reaches the value
+    void submit(uint64_t fenceValue);
+    // Releases the batches whose fence value is at most the completed value
+    void release(uint64_t completedFenceValue);
+
+    bool hasSubmittedBatches() const;
+    // Fence value the oldest submitted batch waits for
+    uint64_t getOldestFenceValue() const;
+    uint64_t getSize() const;
+    // Includes the padding of aligned allocations and the end of the ring skipped by wrapping
+    uint64_t getUsedSize() const;
+
+private:
+    struct Batch
+    {
+        uint64_t fenceValue;
+        uint64_t end;
+        uint64_t size;
+    };
+
+    uint64_t m_size = 0;
+    uint64_t m_head = 0; // Where the next allocation starts
+    uint64_t m_tail = 0; // Start of the oldest allocation in use
+    uint64_t m_usedSize = 0;
+    uint64_t m_pendingSize = 0; // Used by allocations that have not been submitted
+    std::deque<Batch> m_batches;
+};
+
+} // namespace fw
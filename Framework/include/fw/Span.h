@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+namespace fw
+{
+// Non-owning view over contiguous data, e.g. a vector or a region of a memory-mapped file
+template<typename T>
+class Span
+{
+public:
+    Span(){};
+    Span(T* data, size_t size) :
+        m_data(data),
+        m_size(size)
+    {
+    }
+    template<size_t N>
+    Span(T (&data)[N]) :
+        m_data(data),
+        m_size(N)
+    {
+    }
+    template<typename U>
+    Span(std::vector<U>& container) :
+        m_data(container.data()),
+        m_size(container.size())
+    {
+    }
+    template<typename U>
+    Span(const std::vector<U>& container) :
+        m_data(container.data()),
+        m_size(container.size())
+    {
+    }
+
+    T* data() const { return m_data; }
+    size_t size() const { return m_size; }
+    size_t sizeInBytes() const { return m_size * sizeof(T); }
+    bool empty() const { return m_size == 0; }
+
+    T* begin() const { return m_data; }
+    T* end() const { return m_data + m_size; }
+    T& operator[](size_t index) const { return m_data[index]; }
+
+private:
+    T* m_data = nullptr;
+    size_t m_size = 0;
+};
+
+// Non-owning view over elements that are stride bytes apart, e.g. one attribute of interleaved vertices
+template<typename T>
+class StridedSpan
+{
+public:
+    StridedSpan(){};
+    StridedSpan(T* data, size_t size, size_t stride) :
+        m_data(data),
+        m_size(size),
+        m_stride(stride)
+    {
+    }
+    template<typename U>
+    StridedSpan(Span<U> span) :
+        m_data(span.data()),
+        m_size(span.size()),
+        m_stride(sizeof(U))
+    {
+    }
+    template<size_t N>
+    StridedSpan(T (&data)[N]) :
+        m_data(data),
+        m_size(N),
+        m_stride(sizeof(T))
+    {
+    }
+
+    T* data() const { return m_data; }
+    size_t size() const { return m_size; }
+    size_t stride() const { return m_stride; }
+    bool empty() const { return m_size == 0; }
+    bool isContiguous() const { return m_stride == sizeof(T); }
+
+    T& operator[](size_t index) const
+    {
+        return *reinterpret_cast<T*>(reinterpret_cast<Byte*>(m_data) + index * m_stride);
+    }
+
+private:
+    using Byte = std::conditional_t<std::is_const<T>::value, const unsigned char, unsigned char>;
+
+    T* m_data = nullptr;
+    size_t m_size = 0;
+    size_t m_stride = sizeof(T);
+};
+
+} // namespace fw
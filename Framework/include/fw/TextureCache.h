@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace fw
+{
+// Decodes image files on the default thread pool. Each file is decoded once and shared by everyone
+// who requests it while the cache is alive.
+class TextureCache
+{
+public:
+    struct PixelDeleter
+    {
+        void operator()(unsigned char* pixels) const;
+    };
+
+    // Four 8-bit channels per pixel, pixels is null if the file could not be decoded
+    struct Image
+    {
+        int width = 0;
+        int height = 0;
+        std::unique_ptr<unsigned char, PixelDeleter> pixels;
+
+        size_t getSize() const;
+    };
+
+    using ImageHandle = std::shared_ptr<const Image>;
+
+    struct Stats
+    {
+        uint32_t decodedCount = 0;
+        uint32_t hitCount = 0; // Requests for files that were already requested
+        uint64_t decodedBytes = 0;
+        double decodeSeconds = 0.0; // Summed over the decoding threads
+    };
+
+    TextureCache(){};
+    ~TextureCache();
+    TextureCache(const TextureCache&) = delete;
+    TextureCache(TextureCache&&) = delete;
+    TextureCache& operator=(const TextureCache&) = delete;
+    TextureCache& operator=(TextureCache&&) = delete;
+
+    // Starts decoding the files that are not in the cache yet
+    void prefetch(const std::vector<std::string>& files);
+    // Waits for the file if it is being decoded, a file that was not prefetched is decoded on the calling thread
+    ImageHandle get(const std::string& file);
+    Stats getStats() const;
+
+private:
+    using Promise = std::shared_ptr<std::promise<ImageHandle>>;
+
+    mutable std::mutex m_mutex;
+    std::unordered_map<std::string, std::shared_future<ImageHandle>> m_images;
+    Stats m_stats;
+
+    // The promise is set if the caller has to decode the file
+    std::shared_future<ImageHandle> request(const std::string& file, Promise& promise);
+    ImageHandle decode(const std::string& file);
+};
+
+} // namespace fw
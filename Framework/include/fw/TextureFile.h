@@ -0,0 +1,87 @@
+#pragma once
+
+#include "BlockCompressor.h"
+#include "MappedFile.h"
+#include "MipGenerator.h"
+#include "Span.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace fw
+{
+// Cooked texture in a DDS file with a DX10 header. The mip levels follow the headers and are laid out like
+// the copyable footprints of D3D12, so that the mapped file can be copied into an upload buffer as it is.
+// Rows of levels narrower than the pitch alignment are padded, which generic DDS readers do not expect.
+// The first level is made of whole blocks as D3D12 requires, images of other sizes are scaled up when cooked.
+class TextureFile
+{
+public:
+    // Same as D3D12_TEXTURE_DATA_PITCH_ALIGNMENT and D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT
+    static const uint32_t c_pitchAlignment = 256;
+    static const uint32_t c_placementAlignment = 512;
+    static const uint32_t c_version = 2;
+
+    // The offset is relative to the start of the level data
+    struct Subresource
+    {
+        uint32_t width;
+        uint32_t height;
+        uint64_t offset;
+        uint32_t rowPitch;
+        uint32_t rowSize;
+        uint32_t rowCount;
+    };
+
+    TextureFile(){};
+    TextureFile(const TextureFile&) = delete;
+    TextureFile(TextureFile&&) = delete;
+    TextureFile& operator=(const TextureFile&) = delete;
+    TextureFile& operator=(TextureFile&&) = delete;
+
+    static std::string getCookedPath(const std::string& sourceFile);
+    static void cook(const BlockCompressor::Texture& texture,
+                     uint64_t sourceHash,
+                     MipGenerator::ColorSpace colorSpace,
+                     BlockCompressor::Quality quality,
+                     std::vector<unsigned char>& image);
+
+    // Maps a cooked file, it is valid if it was cooked from the same source with the same color space and quality
+    bool open(const std::string& path, uint64_t sourceHash, MipGenerator::ColorSpace colorSpace, BlockCompressor::Quality quality);
+    // Takes over a cooked image that could not be written to disk
+    bool open(std::vector<unsigned char> image);
+
+    // Cooks the files that have no valid cooked file yet, decoding them in parallel, and opens the cooked files.
+    // Files that are shared by several textures are opened once.
+    static bool loadFiles(const std::vector<std::string>& files,
+                          MipGenerator::ColorSpace colorSpace,
+                          BlockCompressor::Quality quality,
+                          std::vector<std::shared_ptr<const TextureFile>>& textureFiles);
+
+    BlockCompressor::Format getFormat() const;
+    uint32_t getWidth() const;
+    uint32_t getHeight() const;
+    uint32_t getLevelCount() const;
+    const Subresource& getSubresource(uint32_t level) const;
+    // Data of every level, including the padding of the rows and between the levels
+    Span<const unsigned char> getData() const;
+    float getPsnr() const;
+
+private:
+    MappedFile m_file;
+    std::vector<unsigned char> m_image;
+    BlockCompressor::Format m_format = BlockCompressor::Format::BC1;
+    std::vector<Subresource> m_subresources;
+    Span<const unsigned char> m_data;
+    uint64_t m_sourceHash = 0;
+    MipGenerator::ColorSpace m_colorSpace = MipGenerator::ColorSpace::Linear;
+    BlockCompressor::Quality m_quality = BlockCompressor::Quality::Fast;
+    float m_psnr = 0.0f;
+
+    bool parse(const unsigned char* data, size_t size);
+};
+
+} // namespace fw
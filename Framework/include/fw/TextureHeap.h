@@ -0,0 +1,80 @@
+#pragma once
+
+#include "HeapSuballocator.h"
+
+#include <d3d12.h>
+#include <wrl.h>
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace fw
+{
+// Default heap memory for textures that are created as placed resources. Textures and render targets have heaps
+// of their own, as resource heap tier 1 does not allow mixing them. Small textures use the 4 KB placement
+// alignment and are slots of size classes, larger ones blocks of a buddy allocator, a full heap adds another one.
+class TextureHeap
+{
+public:
+    enum class Type
+    {
+        Textures,
+        RenderTargets
+    };
+
+    TextureHeap(){};
+    TextureHeap(const TextureHeap&) = delete;
+    TextureHeap(TextureHeap&&) = delete;
+    TextureHeap& operator=(const TextureHeap&) = delete;
+    TextureHeap& operator=(TextureHeap&&) = delete;
+
+    void initialize(ID3D12Device* device, Type type, UINT64 heapSize);
+
+    // The memory is freed when the texture is destroyed, the GPU must be done with the texture by then
+    Microsoft::WRL::ComPtr<ID3D12Resource> createTexture(const D3D12_RESOURCE_DESC& desc,
+                                                         D3D12_RESOURCE_STATES initialState,
+                                                         const D3D12_CLEAR_VALUE* clearValue,
+                                                         const std::wstring& name);
+    // Places the texture in the memory of another texture of the heap, e.g. for render targets that are not used
+    // at the same time. It has to fit into the memory. The contents are undefined after switching between the
+    // textures, which needs an aliasing barrier, and render targets have to be cleared or discarded first. The
+    // memory is freed when the last texture placed in it is destroyed.
+    Microsoft::WRL::ComPtr<ID3D12Resource> createAliasedTexture(const D3D12_RESOURCE_DESC& desc,
+                                                                D3D12_RESOURCE_STATES initialState,
+                                                                const D3D12_CLEAR_VALUE* clearValue,
+                                                                ID3D12Resource* aliasedTexture,
+                                                                const std::wstring& name);
+    HeapSuballocator::Stats getStats() const;
+
+private:
+    struct Heap
+    {
+        Microsoft::WRL::ComPtr<ID3D12Heap> heap;
+        HeapSuballocator allocator;
+        // Number of textures placed in each allocation
+        std::unordered_map<UINT64, UINT> textureCounts;
+    };
+
+    // Private data of a placed texture, which is released with the texture. Textures that outlive the heap have
+    // nothing to free.
+    class Placement;
+
+    Microsoft::WRL::ComPtr<ID3D12Device> m_device;
+    Type m_type = Type::Textures;
+    UINT64 m_heapSize = 0;
+    std::vector<std::shared_ptr<Heap>> m_heaps;
+
+    D3D12_RESOURCE_ALLOCATION_INFO getAllocationInfo(D3D12_RESOURCE_DESC& desc) const;
+    Microsoft::WRL::ComPtr<ID3D12Resource> createPlacedTexture(const std::shared_ptr<Heap>& heap,
+                                                               UINT64 offset,
+                                                               UINT64 size,
+                                                               const D3D12_RESOURCE_DESC& desc,
+                                                               D3D12_RESOURCE_STATES initialState,
+                                                               const D3D12_CLEAR_VALUE* clearValue,
+                                                               const std::wstring& name);
+    std::shared_ptr<Heap> createHeap(UINT64 size);
+};
+
+} // namespace fw
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace fw
+{
+class ThreadPool
+{
+public:
+    // Zero threads means one less than the number of hardware threads
+    explicit ThreadPool(unsigned int threadCount = 0);
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool(ThreadPool&&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    ThreadPool& operator=(ThreadPool&&) = delete;
+
+    static ThreadPool& getDefault();
+
+    unsigned int getThreadCount() const;
+
+    template<typename F>
+    std::future<std::invoke_result_t<F>> submit(F&& function);
+
+    // Calls function(begin, end) for ranges of at most grainSize items. The calling thread takes part
+    // in the work so this can also be used from inside a job.
+    void parallelFor(size_t count, size_t grainSize, const std::function<void(size_t, size_t)>& function);
+
+private:
+    std::vector<std::thread> m_threads;
+    std::queue<std::function<void()>> m_jobs;
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    bool m_stopping = false;
+
+    void enqueue(std::function<void()> job);
+    void work();
+};
+
+template<typename F>
+std::future<std::invoke_result_t<F>> ThreadPool::submit(F&& function)
+{
+    using Result = std::invoke_result_t<F>;
+    auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(function));
+    std::future<Result> future = task->get_future();
+    enqueue([task]() { (*task)(); });
+    return future;
+}
+
+} // namespace fw
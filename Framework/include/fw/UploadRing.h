@@ -0,0 +1,63 @@
+#pragma once
+
+#include "RingAllocator.h"
+
+#include <d3d12.h>
+#include <wrl.h>
+#include <windows.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace fw
+{
+// Persistently mapped upload buffer shared by all uploads. Uploads are suballocated from it and stay
+// alive until the GPU has passed the fence value of the submission they were recorded in.
+class UploadRing
+{
+public:
+    struct Allocation
+    {
+        ID3D12Resource* buffer = nullptr;
+        UINT64 offset = 0;
+        unsigned char* data = nullptr;
+    };
+
+    UploadRing(){};
+    ~UploadRing();
+    UploadRing(const UploadRing&) = delete;
+    UploadRing(UploadRing&&) = delete;
+    UploadRing& operator=(const UploadRing&) = delete;
+    UploadRing& operator=(UploadRing&&) = delete;
+
+    void initialize(ID3D12Device* device, ID3D12Fence* fence, UINT64 size);
+
+    // Waits for the oldest submission when the ring is full. Uploads that do not fit even into an idle ring,
+    // for example when everything in it is still waiting to be submitted, get a buffer of their own.
+    Allocation allocate(UINT64 size, UINT64 alignment);
+    // The allocations made since the previous submit are released when the fence reaches the value
+    void submit(UINT64 fenceValue);
+
+    UINT64 getSize() const;
+    UINT64 getUsedSize() const;
+
+private:
+    struct DedicatedBuffer
+    {
+        UINT64 fenceValue; // Zero until the upload is submitted
+        Microsoft::WRL::ComPtr<ID3D12Resource> buffer;
+    };
+
+    Microsoft::WRL::ComPtr<ID3D12Device> m_device;
+    Microsoft::WRL::ComPtr<ID3D12Fence> m_fence;
+    Microsoft::WRL::ComPtr<ID3D12Resource> m_buffer;
+    unsigned char* m_data = nullptr;
+    RingAllocator m_allocator;
+    std::vector<DedicatedBuffer> m_dedicatedBuffers;
+    HANDLE m_fenceEvent = nullptr;
+
+    void release();
+    Microsoft::WRL::ComPtr<ID3D12Resource> createBuffer(UINT64 size);
+};
+
+} // namespace fw
@@ -18,7 +18,9 @@ public:
     Window& operator=(const Window&) = delete;
     Window& operator=(Window&&) = delete;
 
-    bool initialize();
+    bool initialize(int width, int height);
+    // Only has the size, there are no events and it never closes
+    void initializeHeadless(int width, int height);
     bool shouldClose() const;
     void update();
     void clearKeyStatus();
@@ -36,9 +38,8 @@ public:
     float getDeltaY() const;
 
 private:
-    int m_width = 1200;
-    int m_height = 960;
-    float m_aspectRatio = static_cast<float>(m_width) / static_cast<float>(m_height);
+    int m_width = 0;
+    int m_height = 0;
 
     GLFWwindow* m_window = nullptr;
 
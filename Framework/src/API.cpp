@@ -39,16 +39,56 @@ Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList4> API::getCommandList()
     return s_framework->m_commandList;
 }
 
+UploadRing& API::getUploadRing()
+{
+    return s_framework->m_uploadRing;
+}
+
+FrameAllocator& API::getFrameAllocator()
+{
+    return s_framework->m_frameAllocator;
+}
+
+BufferHeap& API::getBufferHeap()
+{
+    return s_framework->m_bufferHeap;
+}
+
+TextureHeap& API::getTextureHeap()
+{
+    return s_framework->m_textureHeap;
+}
+
+TextureHeap& API::getRenderTargetHeap()
+{
+    return s_framework->m_renderTargetHeap;
+}
+
+DescriptorHeap& API::getDescriptorHeap()
+{
+    return s_framework->m_descriptorHeap;
+}
+
 int API::getCurrentFrameIndex()
 {
     return s_framework->m_currentFrameIndex;
 }
 
+int API::getFrameCount()
+{
+    return s_framework->m_config.framesInFlight;
+}
+
 int API::getSwapChainBufferCount()
 {
     return s_framework->m_swapChainBufferCount;
 }
 
+bool API::isFrameComplete(int frameIndex)
+{
+    return s_framework->isFrameComplete(frameIndex);
+}
+
 UINT API::getCbvSrvUavDescriptorIncrementSize()
 {
     return s_framework->m_cbvSrvUavDescriptorIncrementSize;
@@ -134,4 +174,24 @@ float API::getTimeDelta()
     return s_framework->m_timeDelta;
 }
 
+const Config& API::getConfig()
+{
+    return s_framework->m_config;
+}
+
+const FrameTimer& API::getFrameTimer()
+{
+    return s_framework->m_frameTimer;
+}
+
+void API::printFrameTimes()
+{
+    s_framework->printFrameTimes();
+}
+
+GpuProfiler& API::getGpuProfiler()
+{
+    return s_framework->m_gpuProfiler;
+}
+
 } // namespace fw
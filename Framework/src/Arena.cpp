@@ -0,0 +1,68 @@
+#include "Arena.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+
+namespace fw
+{
+Arena::Arena(size_t blockSize) :
+    m_blockSize(blockSize)
+{
+}
+
+void* Arena::allocate(size_t size, size_t alignment)
+{
+    assert(alignment != 0 && (alignment & (alignment - 1)) == 0);
+
+    if (!m_blocks.empty())
+    {
+        Block& block = m_blocks.back();
+        const uintptr_t address = reinterpret_cast<uintptr_t>(block.data.get()) + m_offset;
+        const size_t padding = (alignment - address % alignment) % alignment;
+        if (m_offset + padding + size <= block.size)
+        {
+            m_offset += padding + size;
+            m_usedSize += size;
+            return block.data.get() + m_offset - size;
+        }
+    }
+
+    // Large allocations get a block of their own
+    Block block;
+    block.size = std::max(m_blockSize, size + alignment);
+    block.data.reset(new unsigned char[block.size]);
+    const uintptr_t address = reinterpret_cast<uintptr_t>(block.data.get());
+    const size_t padding = (alignment - address % alignment) % alignment;
+    m_blocks.push_back(std::move(block));
+    m_offset = padding + size;
+    m_usedSize += size;
+    return m_blocks.back().data.get() + padding;
+}
+
+void Arena::reset()
+{
+    if (m_blocks.size() > 1)
+    {
+        m_blocks.erase(m_blocks.begin() + 1, m_blocks.end());
+    }
+    m_offset = 0;
+    m_usedSize = 0;
+}
+
+size_t Arena::getUsedSize() const
+{
+    return m_usedSize;
+}
+
+size_t Arena::getReservedSize() const
+{
+    size_t size = 0;
+    for (const Block& block : m_blocks)
+    {
+        size += block.size;
+    }
+    return size;
+}
+
+} // namespace fw
@@ -0,0 +1,833 @@
+#include "BlockCompressor.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace
+{
+const uint32_t c_channelCount = 4;
+const uint32_t c_blockPixelCount = 16;
+// Blocks encoded by one job
+const size_t c_blocksPerTile = 256;
+const char* c_normalMapSuffix = "_normal";
+// Least squares refinements of the endpoints that are tried after the principal axis fit
+const int c_refinementCount = 2;
+// Interpolation weights of the 4-bit indices of BC7, out of 64
+const int c_bc7Weights[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+using BlockPixels = unsigned char[c_blockPixelCount][c_channelCount];
+using BlockValues = float[c_blockPixelCount][c_channelCount];
+
+// Pixels outside of the level repeat the last row and column
+void loadBlock(const unsigned char* pixels, uint32_t width, uint32_t height, uint32_t blockX, uint32_t blockY, BlockPixels& block)
+{
+    for (uint32_t y = 0; y < fw::BlockCompressor::c_blockDimension; ++y)
+    {
+        const uint32_t sourceY = std::min(blockY * fw::BlockCompressor::c_blockDimension + y, height - 1);
+        for (uint32_t x = 0; x < fw::BlockCompressor::c_blockDimension; ++x)
+        {
+            const uint32_t sourceX = std::min(blockX * fw::BlockCompressor::c_blockDimension + x, width - 1);
+            std::memcpy(block[y * fw::BlockCompressor::c_blockDimension + x], pixels + (size_t(sourceY) * width + sourceX) * c_channelCount, c_channelCount);
+        }
+    }
+}
+
+void storeBlock(const BlockPixels& block, uint32_t width, uint32_t height, uint32_t blockX, uint32_t blockY, unsigned char* pixels)
+{
+    for (uint32_t y = 0; y < fw::BlockCompressor::c_blockDimension; ++y)
+    {
+        const uint32_t targetY = blockY * fw::BlockCompressor::c_blockDimension + y;
+        for (uint32_t x = 0; x < fw::BlockCompressor::c_blockDimension; ++x)
+        {
+            const uint32_t targetX = blockX * fw::BlockCompressor::c_blockDimension + x;
+            if (targetX < width && targetY < height)
+            {
+                std::memcpy(pixels + (size_t(targetY) * width + targetX) * c_channelCount, block[y * fw::BlockCompressor::c_blockDimension + x], c_channelCount);
+            }
+        }
+    }
+}
+
+void toValues(const BlockPixels& block, BlockValues& values)
+{
+    for (uint32_t i = 0; i < c_blockPixelCount; ++i)
+    {
+        for (uint32_t c = 0; c < c_channelCount; ++c)
+        {
+            values[i][c] = block[i][c];
+        }
+    }
+}
+
+// Mean and principal axis of the first N channels of the block
+template<int N>
+void computePrincipalAxis(const BlockValues& values, float (&mean)[N], float (&axis)[N])
+{
+    float minimum[N];
+    float maximum[N];
+    for (int c = 0; c < N; ++c)
+    {
+        mean[c] = 0.0f;
+        minimum[c] = values[0][c];
+        maximum[c] = values[0][c];
+    }
+    for (uint32_t i = 0; i < c_blockPixelCount; ++i)
+    {
+        for (int c = 0; c < N; ++c)
+        {
+            mean[c] += values[i][c];
+            minimum[c] = std::min(minimum[c], values[i][c]);
+            maximum[c] = std::max(maximum[c], values[i][c]);
+        }
+    }
+
+    float covariance[N][N] = {};
+    for (int c = 0; c < N; ++c)
+    {
+        mean[c] /= c_blockPixelCount;
+    }
+    for (uint32_t i = 0; i < c_blockPixelCount; ++i)
+    {
+        for (int a = 0; a < N; ++a)
+        {
+            for (int b = 0; b < N; ++b)
+            {
+                covariance[a][b] += (values[i][a] - mean[a]) * (values[i][b] - mean[b]);
+            }
+        }
+    }
+
+    // Power iteration from the diagonal of the bounding box, which is rarely orthogonal to the principal axis
+    for (int c = 0; c < N; ++c)
+    {
+        axis[c] = maximum[c] - minimum[c];
+    }
+    for (int iteration = 0; iteration < 8; ++iteration)
+    {
+        float next[N] = {};
+        float largest = 0.0f;
+        for (int a = 0; a < N; ++a)
+        {
+            for (int b = 0; b < N; ++b)
+            {
+                next[a] += covariance[a][b] * axis[b];
+            }
+            largest = std::max(largest, std::abs(next[a]));
+        }
+        if (largest == 0.0f)
+        {
+            break;
+        }
+        for (int c = 0; c < N; ++c)
+        {
+            axis[c] = next[c] / largest;
+        }
+    }
+
+    float length = 0.0f;
+    for (int c = 0; c < N; ++c)
+    {
+        length += axis[c] * axis[c];
+    }
+    length = std::sqrt(length);
+    for (int c = 0; c < N; ++c)
+    {
+        axis[c] = length > 0.0f ? axis[c] / length : 0.0f;
+    }
+}
+
+// Endpoints at the extremes of the projections of the block on its principal axis
+template<int N>
+void fitEndpoints(const BlockValues& values, float (&first)[N], float (&second)[N])
+{
+    float mean[N];
+    float axis[N];
+    computePrincipalAxis<N>(values, mean, axis);
+
+    float minimum = std::numeric_limits<float>::max();
+    float maximum = -std::numeric_limits<float>::max();
+    for (uint32_t i = 0; i < c_blockPixelCount; ++i)
+    {
+        float projection = 0.0f;
+        for (int c = 0; c < N; ++c)
+        {
+            projection += (values[i][c] - mean[c]) * axis[c];
+        }
+        minimum = std::min(minimum, projection);
+        maximum = std::max(maximum, projection);
+    }
+
+    for (int c = 0; c < N; ++c)
+    {
+        first[c] = std::clamp(mean[c] + axis[c] * maximum, 0.0f, 255.0f);
+        second[c] = std::clamp(mean[c] + axis[c] * minimum, 0.0f, 255.0f);
+    }
+}
+
+// Endpoints that minimize the squared error of the block for fixed weights of the first endpoint
+template<int N>
+bool solveEndpoints(const BlockValues& values, const float (&weights)[c_blockPixelCount], float (&first)[N], float (&second)[N])
+{
+    float aa = 0.0f;
+    float ab = 0.0f;
+    float bb = 0.0f;
+    float ax[N] = {};
+    float bx[N] = {};
+    for (uint32_t i = 0; i < c_blockPixelCount; ++i)
+    {
+        const float a = weights[i];
+        const float b = 1.0f - a;
+        aa += a * a;
+        ab += a * b;
+        bb += b * b;
+        for (int c = 0; c < N; ++c)
+        {
+            ax[c] += a * values[i][c];
+            bx[c] += b * values[i][c];
+        }
+    }
+
+    const float determinant = aa * bb - ab * ab;
+    if (std::abs(determinant) < 1e-6f)
+    {
+        return false;
+    }
+    for (int c = 0; c < N; ++c)
+    {
+        first[c] = std::clamp((bb * ax[c] - ab * bx[c]) / determinant, 0.0f, 255.0f);
+        second[c] = std::clamp((aa * bx[c] - ab * ax[c]) / determinant, 0.0f, 255.0f);
+    }
+    return true;
+}
+
+template<int N>
+float getDistance(const float* a, const float* b)
+{
+    float distance = 0.0f;
+    for (int c = 0; c < N; ++c)
+    {
+        distance += (a[c] - b[c]) * (a[c] - b[c]);
+    }
+    return distance;
+}
+
+// BC1
+
+uint16_t packRgb565(const float (&color)[3])
+{
+    const uint32_t r = static_cast<uint32_t>(color[0] * 31.0f / 255.0f + 0.5f);
+    const uint32_t g = static_cast<uint32_t>(color[1] * 63.0f / 255.0f + 0.5f);
+    const uint32_t b = static_cast<uint32_t>(color[2] * 31.0f / 255.0f + 0.5f);
+    return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+}
+
+void unpackRgb565(uint16_t packed, float (&color)[3])
+{
+    const uint32_t r = (packed >> 11) & 0x1F;
+    const uint32_t g = (packed >> 5) & 0x3F;
+    const uint32_t b = packed & 0x1F;
+    color[0] = static_cast<float>((r << 3) | (r >> 2));
+    color[1] = static_cast<float>((g << 2) | (g >> 4));
+    color[2] = static_cast<float>((b << 3) | (b >> 2));
+}
+
+// Palette of the four color mode if color0 > color1, otherwise of the three color mode whose last entry is transparent black
+void getBc1Palette(uint16_t color0, uint16_t color1, float (&palette)[4][3])
+{
+    unpackRgb565(color0, palette[0]);
+    unpackRgb565(color1, palette[1]);
+    for (int c = 0; c < 3; ++c)
+    {
+        if (color0 > color1)
+        {
+            palette[2][c] = std::floor((2.0f * palette[0][c] + palette[1][c]) / 3.0f + 0.5f);
+            palette[3][c] = std::floor((palette[0][c] + 2.0f * palette[1][c]) / 3.0f + 0.5f);
+        }
+        else
+        {
+            palette[2][c] = std::floor((palette[0][c] + palette[1][c]) / 2.0f + 0.5f);
+            palette[3][c] = 0.0f;
+        }
+    }
+}
+
+// Orders the endpoints for the four color mode and picks the closest palette entry of every pixel
+float evaluateBc1(const BlockValues& values, uint16_t& color0, uint16_t& color1, uint32_t& indices)
+{
+    if (color0 < color1)
+    {
+        std::swap(color0, color1);
+    }
+
+    float palette[4][3];
+    getBc1Palette(color0, color1, palette);
+    // Equal endpoints select the three color mode, where only the first entry is the endpoint color
+    const uint32_t paletteSize = color0 == color1 ? 1 : 4;
+
+    float error = 0.0f;
+    indices = 0;
+    for (uint32_t i = 0; i < c_blockPixelCount; ++i)
+    {
+        uint32_t bestIndex = 0;
+        float bestDistance = getDistance<3>(values[i], palette[0]);
+        for (uint32_t p = 1; p < paletteSize; ++p)
+        {
+            const float distance = getDistance<3>(values[i], palette[p]);
+            if (distance < bestDistance)
+            {
+                bestIndex = p;
+                bestDistance = distance;
+            }
+        }
+        indices |= bestIndex << (2 * i);
+        error += bestDistance;
+    }
+    return error;
+}
+
+void encodeBc1(const BlockPixels& block, unsigned char* output)
+{
+    BlockValues values;
+    toValues(block, values);
+
+    float first[3];
+    float second[3];
+    fitEndpoints<3>(values, first, second);
+
+    uint16_t color0 = packRgb565(first);
+    uint16_t color1 = packRgb565(second);
+    uint32_t indices = 0;
+    float error = evaluateBc1(values, color0, color1, indices);
+
+    // Weight of the first endpoint in the four color mode
+    const float c_indexWeights[4] = {1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f};
+    for (int iteration = 0; iteration < c_refinementCount && error > 0.0f && color0 != color1; ++iteration)
+    {
+        float weights[c_blockPixelCount];
+        for (uint32_t i = 0; i < c_blockPixelCount; ++i)
+        {
+            weights[i] = c_indexWeights[(indices >> (2 * i)) & 0x3];
+        }
+        if (!solveEndpoints<3>(values, weights, first, second))
+        {
+            break;
+        }
+
+        uint16_t candidate0 = packRgb565(first);
+        uint16_t candidate1 = packRgb565(second);
+        uint32_t candidateIndices = 0;
+        const float candidateError = evaluateBc1(values, candidate0, candidate1, candidateIndices);
+        if (candidateError >= error)
+        {
+            break;
+        }
+        color0 = candidate0;
+        color1 = candidate1;
+        indices = candidateIndices;
+        error = candidateError;
+    }
+
+    std::memcpy(output, &color0, sizeof(color0));
+    std::memcpy(output + 2, &color1, sizeof(color1));
+    std::memcpy(output + 4, &indices, sizeof(indices));
+}
+
+void decodeBc1(const unsigned char* input, BlockPixels& block)
+{
+    uint16_t color0;
+    uint16_t color1;
+    uint32_t indices;
+    std::memcpy(&color0, input, sizeof(color0));
+    std::memcpy(&color1, input + 2, sizeof(color1));
+    std::memcpy(&indices, input + 4, sizeof(indices));
+
+    float palette[4][3];
+    getBc1Palette(color0, color1, palette);
+    for (uint32_t i = 0; i < c_blockPixelCount; ++i)
+    {
+        const uint32_t index = (indices >> (2 * i)) & 0x3;
+        for (int c = 0; c < 3; ++c)
+        {
+            block[i][c] = static_cast<unsigned char>(palette[index][c]);
+        }
+        block[i][3] = color0 <= color1 && index == 3 ? 0 : 255;
+    }
+}
+
+// BC4, a single channel block that BC3 uses for alpha and BC5 for each of its channels
+
+void getBc4Palette(unsigned char value0, unsigned char value1, int (&palette)[8])
+{
+    palette[0] = value0;
+    palette[1] = value1;
+    if (value0 > value1)
+    {
+        for (int i = 1; i < 7; ++i)
+        {
+            palette[i + 1] = ((7 - i) * value0 + i * value1 + 3) / 7;
+        }
+    }
+    else
+    {
+        for (int i = 1; i < 5; ++i)
+        {
+            palette[i + 1] = ((5 - i) * value0 + i * value1 + 2) / 5;
+        }
+        palette[6] = 0;
+        palette[7] = 255;
+    }
+}
+
+void encodeBc4(const BlockPixels& block, uint32_t channel, unsigned char* output)
+{
+    unsigned char minimum = block[0][channel];
+    unsigned char maximum = block[0][channel];
+    for (uint32_t i = 1; i < c_blockPixelCount; ++i)
+    {
+        minimum = std::min(minimum, block[i][channel]);
+        maximum = std::max(maximum, block[i][channel]);
+    }
+
+    // The eight value mode spans the range of the block, equal endpoints leave every index at zero
+    int palette[8];
+    getBc4Palette(maximum, minimum, palette);
+    const int paletteSize = maximum > minimum ? 8 : 1;
+
+    uint64_t indices = 0;
+    for (uint32_t i = 0; i < c_blockPixelCount; ++i)
+    {
+        uint64_t bestIndex = 0;
+        int bestDistance = std::abs(block[i][channel] - palette[0]);
+        for (int p = 1; p < paletteSize; ++p)
+        {
+            const int distance = std::abs(block[i][channel] - palette[p]);
+            if (distance < bestDistance)
+            {
+                bestIndex = p;
+                bestDistance = distance;
+            }
+        }
+        indices |= bestIndex << (3 * i);
+    }
+
+    output[0] = maximum;
+    output[1] = minimum;
+    for (int i = 0; i < 6; ++i)
+    {
+        output[2 + i] = static_cast<unsigned char>(indices >> (8 * i));
+    }
+}
+
+void decodeBc4(const unsigned char* input, uint32_t channel, BlockPixels& block)
+{
+    int palette[8];
+    getBc4Palette(input[0], input[1], palette);
+
+    uint64_t indices = 0;
+    for (int i = 0; i < 6; ++i)
+    {
+        indices |= uint64_t(input[2 + i]) << (8 * i);
+    }
+    for (uint32_t i = 0; i < c_blockPixelCount; ++i)
+    {
+        block[i][channel] = static_cast<unsigned char>(palette[(indices >> (3 * i)) & 0x7]);
+    }
+}
+
+// BC7, only mode 6 is used. It has one subset, 7-bit RGBA endpoints with a shared low bit per endpoint
+// and 4-bit indices, which suits the smooth gradients of most albedo textures.
+
+struct Bc7Endpoints
+{
+    int values[2][c_channelCount];
+    int pBits[2];
+
+    int get(int endpoint, uint32_t channel) const
+    {
+        return (values[endpoint][channel] << 1) | pBits[endpoint];
+    }
+};
+
+void quantizeBc7Endpoint(const float (&color)[c_channelCount], int endpoint, Bc7Endpoints& endpoints)
+{
+    float bestError = std::numeric_limits<float>::max();
+    for (int pBit = 0; pBit < 2; ++pBit)
+    {
+        int values[c_channelCount];
+        float error = 0.0f;
+        for (uint32_t c = 0; c < c_channelCount; ++c)
+        {
+            values[c] = std::clamp(static_cast<int>(std::floor((color[c] - pBit) / 2.0f + 0.5f)), 0, 127);
+            const float difference = color[c] - static_cast<float>((values[c] << 1) | pBit);
+            error += difference * difference;
+        }
+        if (error < bestError)
+        {
+            bestError = error;
+            std::memcpy(endpoints.values[endpoint], values, sizeof(values));
+            endpoints.pBits[endpoint] = pBit;
+        }
+    }
+}
+
+float evaluateBc7(const BlockValues& values, const Bc7Endpoints& endpoints, uint8_t (&indices)[c_blockPixelCount])
+{
+    float palette[16][c_channelCount];
+    for (int p = 0; p < 16; ++p)
+    {
+        for (uint32_t c = 0; c < c_channelCount; ++c)
+        {
+            palette[p][c] = static_cast<float>(((64 - c_bc7Weights[p]) * endpoints.get(0, c) + c_bc7Weights[p] * endpoints.get(1, c) + 32) >> 6);
+        }
+    }
+
+    float error = 0.0f;
+    for (uint32_t i = 0; i < c_blockPixelCount; ++i)
+    {
+        uint8_t bestIndex = 0;
+        float bestDistance = getDistance<c_channelCount>(values[i], palette[0]);
+        for (uint8_t p = 1; p < 16; ++p)
+        {
+            const float distance = getDistance<c_channelCount>(values[i], palette[p]);
+            if (distance < bestDistance)
+            {
+                bestIndex = p;
+                bestDistance = distance;
+            }
+        }
+        indices[i] = bestIndex;
+        error += bestDistance;
+    }
+    return error;
+}
+
+void writeBits(unsigned char* output, uint32_t& position, uint32_t value, uint32_t count)
+{
+    for (uint32_t i = 0; i < count; ++i, ++position)
+    {
+        if ((value >> i) & 1)
+        {
+            output[position / 8] |= static_cast<unsigned char>(1 << (position % 8));
+        }
+    }
+}
+
+uint32_t readBits(const unsigned char* input, uint32_t& position, uint32_t count)
+{
+    uint32_t value = 0;
+    for (uint32_t i = 0; i < count; ++i, ++position)
+    {
+        value |= ((input[position / 8] >> (position % 8)) & 1u) << i;
+    }
+    return value;
+}
+
+void encodeBc7(const BlockPixels& block, unsigned char* output)
+{
+    BlockValues values;
+    toValues(block, values);
+
+    float first[c_channelCount];
+    float second[c_channelCount];
+    fitEndpoints<c_channelCount>(values, first, second);
+
+    Bc7Endpoints endpoints;
+    quantizeBc7Endpoint(first, 0, endpoints);
+    quantizeBc7Endpoint(second, 1, endpoints);
+    uint8_t indices[c_blockPixelCount];
+    float error = evaluateBc7(values, endpoints, indices);
+
+    for (int iteration = 0; iteration < c_refinementCount && error > 0.0f; ++iteration)
+    {
+        float weights[c_blockPixelCount];
+        for (uint32_t i = 0; i < c_blockPixelCount; ++i)
+        {
+            weights[i] = 1.0f - c_bc7Weights[indices[i]] / 64.0f;
+        }
+        if (!solveEndpoints<c_channelCount>(values, weights, first, second))
+        {
+            break;
+        }
+
+        Bc7Endpoints candidate;
+        quantizeBc7Endpoint(first, 0, candidate);
+        quantizeBc7Endpoint(second, 1, candidate);
+        uint8_t candidateIndices[c_blockPixelCount];
+        const float candidateError = evaluateBc7(values, candidate, candidateIndices);
+        if (candidateError >= error)
+        {
+            break;
+        }
+        endpoints = candidate;
+        std::memcpy(indices, candidateIndices, sizeof(indices));
+        error = candidateError;
+    }
+
+    // The high bit of the first index is implicitly zero
+    if (indices[0] >= 8)
+    {
+        std::swap(endpoints.values[0], endpoints.values[1]);
+        std::swap(endpoints.pBits[0], endpoints.pBits[1]);
+        for (uint8_t& index : indices)
+        {
+            index = 15 - index;
+        }
+    }
+
+    std::memset(output, 0, 16);
+    uint32_t position = 0;
+    writeBits(output, position, 1 << 6, 7);
+    for (uint32_t c = 0; c < c_channelCount; ++c)
+    {
+        writeBits(output, position, endpoints.values[0][c], 7);
+        writeBits(output, position, endpoints.values[1][c], 7);
+    }
+    writeBits(output, position, endpoints.pBits[0], 1);
+    writeBits(output, position, endpoints.pBits[1], 1);
+    for (uint32_t i = 0; i < c_blockPixelCount; ++i)
+    {
+        writeBits(output, position, indices[i], i == 0 ? 3 : 4);
+    }
+    assert(position == 128);
+}
+
+void decodeBc7(const unsigned char* input, BlockPixels& block)
+{
+    // Other modes are never written, their blocks decode to zero
+    if ((input[0] & 0x7F) != 0x40)
+    {
+        std::memset(block, 0, sizeof(BlockPixels));
+        return;
+    }
+
+    uint32_t position = 7;
+    Bc7Endpoints endpoints;
+    for (uint32_t c = 0; c < c_channelCount; ++c)
+    {
+        endpoints.values[0][c] = readBits(input, position, 7);
+        endpoints.values[1][c] = readBits(input, position, 7);
+    }
+    endpoints.pBits[0] = readBits(input, position, 1);
+    endpoints.pBits[1] = readBits(input, position, 1);
+    for (uint32_t i = 0; i < c_blockPixelCount; ++i)
+    {
+        const int weight = c_bc7Weights[readBits(input, position, i == 0 ? 3 : 4)];
+        for (uint32_t c = 0; c < c_channelCount; ++c)
+        {
+            block[i][c] = static_cast<unsigned char>(((64 - weight) * endpoints.get(0, c) + weight * endpoints.get(1, c) + 32) >> 6);
+        }
+    }
+}
+
+void encodeBlock(const BlockPixels& block, fw::BlockCompressor::Format format, unsigned char* output)
+{
+    switch (format)
+    {
+    case fw::BlockCompressor::Format::BC1:
+        encodeBc1(block, output);
+        break;
+    case fw::BlockCompressor::Format::BC3:
+        encodeBc4(block, 3, output);
+        encodeBc1(block, output + 8);
+        break;
+    case fw::BlockCompressor::Format::BC5:
+        encodeBc4(block, 0, output);
+        encodeBc4(block, 1, output + 8);
+        break;
+    case fw::BlockCompressor::Format::BC7:
+        encodeBc7(block, output);
+        break;
+    }
+}
+
+void decodeBlock(const unsigned char* input, fw::BlockCompressor::Format format, BlockPixels& block)
+{
+    switch (format)
+    {
+    case fw::BlockCompressor::Format::BC1:
+        decodeBc1(input, block);
+        break;
+    case fw::BlockCompressor::Format::BC3:
+        decodeBc1(input + 8, block);
+        decodeBc4(input, 3, block);
+        break;
+    case fw::BlockCompressor::Format::BC5:
+        std::memset(block, 0, sizeof(BlockPixels));
+        decodeBc4(input, 0, block);
+        decodeBc4(input + 8, 1, block);
+        for (uint32_t i = 0; i < c_blockPixelCount; ++i)
+        {
+            block[i][3] = 255;
+        }
+        break;
+    case fw::BlockCompressor::Format::BC7:
+        decodeBc7(input, block);
+        break;
+    }
+}
+
+uint32_t getStoredChannelCount(fw::BlockCompressor::Format format)
+{
+    switch (format)
+    {
+    case fw::BlockCompressor::Format::BC1:
+        return 3;
+    case fw::BlockCompressor::Format::BC5:
+        return 2;
+    default:
+        return 4;
+    }
+}
+
+bool isNormalMap(const std::string& file)
+{
+    const size_t nameStart = file.find_last_of("/\\");
+    return file.find(c_normalMapSuffix, nameStart == std::string::npos ? 0 : nameStart) != std::string::npos;
+}
+} // namespace
+
+namespace fw
+{
+uint32_t BlockCompressor::Level::getBlockColumnCount() const
+{
+    return std::max((width + c_blockDimension - 1) / c_blockDimension, 1u);
+}
+
+uint32_t BlockCompressor::Level::getBlockRowCount() const
+{
+    return std::max((height + c_blockDimension - 1) / c_blockDimension, 1u);
+}
+
+size_t BlockCompressor::Texture::getRowPitch(size_t level) const
+{
+    return levels[level].getBlockColumnCount() * getBlockSize(format);
+}
+
+Span<const unsigned char> BlockCompressor::Texture::getLevelData(size_t level) const
+{
+    return Span<const unsigned char>(blocks.data() + levels[level].offset, getRowPitch(level) * levels[level].getBlockRowCount());
+}
+
+size_t BlockCompressor::getBlockSize(Format format)
+{
+    return format == Format::BC1 ? 8 : 16;
+}
+
+const char* BlockCompressor::getFormatName(Format format)
+{
+    const char* names[] = {"BC1", "BC3", "BC5", "BC7"};
+    return names[static_cast<uint32_t>(format)];
+}
+
+BlockCompressor::Format BlockCompressor::selectFormat(const std::string& file, const unsigned char* pixels, uint32_t width, uint32_t height, Quality quality)
+{
+    if (isNormalMap(file))
+    {
+        return Format::BC5;
+    }
+    if (quality == Quality::High)
+    {
+        return Format::BC7;
+    }
+
+    const size_t pixelCount = size_t(width) * height;
+    for (size_t i = 0; i < pixelCount; ++i)
+    {
+        if (pixels[i * c_channelCount + 3] != 255)
+        {
+            return Format::BC3;
+        }
+    }
+    return Format::BC1;
+}
+
+void BlockCompressor::compress(const MipGenerator::Chain& chain, Format format, Texture& texture)
+{
+    texture.format = format;
+    texture.levels.resize(chain.levels.size());
+    size_t size = 0;
+    for (size_t i = 0; i < chain.levels.size(); ++i)
+    {
+        Level& level = texture.levels[i];
+        level.width = chain.levels[i].width;
+        level.height = chain.levels[i].height;
+        level.offset = size;
+        size += texture.getRowPitch(i) * level.getBlockRowCount();
+    }
+    texture.blocks.resize(size);
+
+    const size_t blockSize = getBlockSize(format);
+    ThreadPool& threadPool = ThreadPool::getDefault();
+    for (size_t i = 0; i < texture.levels.size(); ++i)
+    {
+        const Level& level = texture.levels[i];
+        const unsigned char* pixels = chain.pixels.data() + chain.levels[i].offset;
+        unsigned char* blocks = texture.blocks.data() + level.offset;
+        const uint32_t columnCount = level.getBlockColumnCount();
+        const size_t rowsPerTile = std::max(c_blocksPerTile / columnCount, size_t(1));
+
+        threadPool.parallelFor(level.getBlockRowCount(), rowsPerTile, [&](size_t begin, size_t end) {
+            BlockPixels block;
+            for (size_t y = begin; y < end; ++y)
+            {
+                for (uint32_t x = 0; x < columnCount; ++x)
+                {
+                    loadBlock(pixels, level.width, level.height, x, static_cast<uint32_t>(y), block);
+                    encodeBlock(block, format, blocks + (y * columnCount + x) * blockSize);
+                }
+            }
+        });
+    }
+}
+
+void BlockCompressor::decompress(const Texture& texture, size_t level, std::vector<unsigned char>& pixels)
+{
+    const Level& levelInfo = texture.levels[level];
+    pixels.resize(size_t(levelInfo.width) * levelInfo.height * c_channelCount);
+
+    const size_t blockSize = getBlockSize(texture.format);
+    const unsigned char* blocks = texture.getLevelData(level).data();
+    const uint32_t columnCount = levelInfo.getBlockColumnCount();
+    BlockPixels block;
+    for (uint32_t y = 0; y < levelInfo.getBlockRowCount(); ++y)
+    {
+        for (uint32_t x = 0; x < columnCount; ++x)
+        {
+            decodeBlock(blocks + (size_t(y) * columnCount + x) * blockSize, texture.format, block);
+            storeBlock(block, levelInfo.width, levelInfo.height, x, y, pixels.data());
+        }
+    }
+}
+
+float BlockCompressor::computePsnr(const MipGenerator::Chain& chain, const Texture& texture)
+{
+    std::vector<unsigned char> decoded;
+    decompress(texture, 0, decoded);
+
+    const Span<const unsigned char> source = chain.getLevelData(0);
+    assert(source.size() == decoded.size());
+
+    const uint32_t channelCount = getStoredChannelCount(texture.format);
+    double squaredError = 0.0;
+    for (size_t i = 0; i < source.size(); i += c_channelCount)
+    {
+        for (uint32_t c = 0; c < channelCount; ++c)
+        {
+            const double difference = double(source[i + c]) - double(decoded[i + c]);
+            squaredError += difference * difference;
+        }
+    }
+
+    const double meanSquaredError = squaredError / (double(source.size() / c_channelCount) * channelCount);
+    if (meanSquaredError == 0.0)
+    {
+        return std::numeric_limits<float>::infinity();
+    }
+    return static_cast<float>(10.0 * std::log10(255.0 * 255.0 / meanSquaredError));
+}
+
+} // namespace fw
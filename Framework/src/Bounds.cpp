@@ -0,0 +1,110 @@
+#include "Bounds.h"
+
+#include <algorithm>
+
+namespace
+{
+float getAxis(const DirectX::XMFLOAT3& v, int axis)
+{
+    return axis == 0 ? v.x : (axis == 1 ? v.y : v.z);
+}
+
+void buildNode(const std::vector<DirectX::BoundingBox>& boxes,
+               std::vector<fw::BoundsNode>& nodes,
+               std::vector<uint32_t>& itemIndices,
+               uint32_t nodeIndex,
+               uint32_t first,
+               uint32_t count)
+{
+    DirectX::BoundingBox box = boxes[itemIndices[first]];
+    DirectX::XMFLOAT3 centerMin = box.Center;
+    DirectX::XMFLOAT3 centerMax = box.Center;
+    for (uint32_t i = first + 1; i < first + count; ++i)
+    {
+        const DirectX::BoundingBox& itemBox = boxes[itemIndices[i]];
+        DirectX::BoundingBox::CreateMerged(box, box, itemBox);
+        centerMin = DirectX::XMFLOAT3(std::min(centerMin.x, itemBox.Center.x), std::min(centerMin.y, itemBox.Center.y), std::min(centerMin.z, itemBox.Center.z));
+        centerMax = DirectX::XMFLOAT3(std::max(centerMax.x, itemBox.Center.x), std::max(centerMax.y, itemBox.Center.y), std::max(centerMax.z, itemBox.Center.z));
+    }
+
+    nodes[nodeIndex].box = box;
+    if (count <= fw::Bounds::c_maxLeafItems)
+    {
+        nodes[nodeIndex].firstItem = first;
+        nodes[nodeIndex].itemCount = count;
+        return;
+    }
+
+    int axis = 0;
+    const float extents[] = {centerMax.x - centerMin.x, centerMax.y - centerMin.y, centerMax.z - centerMin.z};
+    if (extents[1] > extents[axis])
+    {
+        axis = 1;
+    }
+    if (extents[2] > extents[axis])
+    {
+        axis = 2;
+    }
+
+    const uint32_t half = count / 2;
+    std::nth_element(itemIndices.begin() + first, itemIndices.begin() + first + half, itemIndices.begin() + first + count, [&](uint32_t a, uint32_t b) {
+        return getAxis(boxes[a].Center, axis) < getAxis(boxes[b].Center, axis);
+    });
+
+    const uint32_t firstChild = static_cast<uint32_t>(nodes.size());
+    nodes[nodeIndex].firstChild = firstChild;
+    nodes.resize(nodes.size() + 2, fw::BoundsNode{});
+    buildNode(boxes, nodes, itemIndices, firstChild, first, half);
+    buildNode(boxes, nodes, itemIndices, firstChild + 1, first + half, count - half);
+}
+} // namespace
+
+namespace fw
+{
+void Bounds::compute(StridedSpan<const DirectX::XMFLOAT3> positions, DirectX::BoundingBox& box, DirectX::BoundingSphere& sphere)
+{
+    if (positions.empty())
+    {
+        box = DirectX::BoundingBox(DirectX::XMFLOAT3(0.0f, 0.0f, 0.0f), DirectX::XMFLOAT3(0.0f, 0.0f, 0.0f));
+        sphere = DirectX::BoundingSphere(DirectX::XMFLOAT3(0.0f, 0.0f, 0.0f), 0.0f);
+        return;
+    }
+    DirectX::BoundingBox::CreateFromPoints(box, positions.size(), positions.data(), positions.stride());
+    DirectX::BoundingSphere::CreateFromPoints(sphere, positions.size(), positions.data(), positions.stride());
+}
+
+DirectX::BoundingBox Bounds::transform(const DirectX::BoundingBox& box, const DirectX::XMFLOAT4X4& matrix)
+{
+    DirectX::BoundingBox result;
+    box.Transform(result, DirectX::XMLoadFloat4x4(&matrix));
+    return result;
+}
+
+DirectX::BoundingSphere Bounds::transform(const DirectX::BoundingSphere& sphere, const DirectX::XMFLOAT4X4& matrix)
+{
+    DirectX::BoundingSphere result;
+    sphere.Transform(result, DirectX::XMLoadFloat4x4(&matrix));
+    return result;
+}
+
+void Bounds::buildHierarchy(const std::vector<DirectX::BoundingBox>& boxes,
+                            std::vector<BoundsNode>& nodes,
+                            std::vector<uint32_t>& itemIndices)
+{
+    nodes.clear();
+    itemIndices.resize(boxes.size());
+    for (uint32_t i = 0; i < itemIndices.size(); ++i)
+    {
+        itemIndices[i] = i;
+    }
+
+    if (boxes.empty())
+    {
+        return;
+    }
+
+    nodes.resize(1, BoundsNode{});
+    buildNode(boxes, nodes, itemIndices, 0, 0, static_cast<uint32_t>(boxes.size()));
+}
+
+} // namespace fw
@@ -0,0 +1,157 @@
+#include "BuddyAllocator.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace
+{
+bool isPowerOfTwo(uint64_t value)
+{
+    return value != 0 && (value & (value - 1)) == 0;
+}
+
+uint64_t nextPowerOfTwo(uint64_t value)
+{
+    uint64_t result = 1;
+    while (result < value)
+    {
+        result <<= 1;
+    }
+    return result;
+}
+} // namespace
+
+namespace fw
+{
+void BuddyAllocator::initialize(uint64_t size, uint64_t minBlockSize)
+{
+    assert(isPowerOfTwo(size) && isPowerOfTwo(minBlockSize) && size >= minBlockSize);
+
+    m_size = size;
+    m_minBlockSize = minBlockSize;
+    m_allocatedSize = 0;
+    m_allocations.clear();
+    m_freeBlocks.clear();
+    m_freeBlocks.resize(getLevel(size) + 1);
+    m_freeBlocks.back().insert(0);
+}
+
+uint64_t BuddyAllocator::allocate(uint64_t size, uint64_t alignment)
+{
+    assert(isPowerOfTwo(alignment));
+
+    if (size == 0 || size > m_size)
+    {
+        return c_invalidOffset;
+    }
+
+    const uint64_t blockSize = getBlockSize(size, alignment);
+    if (blockSize > m_size)
+    {
+        return c_invalidOffset;
+    }
+
+    const uint32_t level = getLevel(blockSize);
+    uint32_t freeLevel = level;
+    while (freeLevel < m_freeBlocks.size() && m_freeBlocks[freeLevel].empty())
+    {
+        ++freeLevel;
+    }
+    if (freeLevel == m_freeBlocks.size())
+    {
+        return c_invalidOffset;
+    }
+
+    // Split the free block until it has the size, the upper halves stay free
+    const uint64_t offset = *m_freeBlocks[freeLevel].begin();
+    m_freeBlocks[freeLevel].erase(m_freeBlocks[freeLevel].begin());
+    while (freeLevel > level)
+    {
+        --freeLevel;
+        m_freeBlocks[freeLevel].insert(offset + getLevelSize(freeLevel));
+    }
+
+    m_allocations[offset] = level;
+    m_allocatedSize += blockSize;
+    return offset;
+}
+
+void BuddyAllocator::free(uint64_t offset)
+{
+    auto allocation = m_allocations.find(offset);
+    assert(allocation != m_allocations.end());
+
+    uint32_t level = allocation->second;
+    m_allocatedSize -= getLevelSize(level);
+    m_allocations.erase(allocation);
+
+    uint64_t blockOffset = offset;
+    while (level + 1 < m_freeBlocks.size())
+    {
+        const uint64_t buddyOffset = blockOffset ^ getLevelSize(level);
+        auto buddy = m_freeBlocks[level].find(buddyOffset);
+        if (buddy == m_freeBlocks[level].end())
+        {
+            break;
+        }
+        m_freeBlocks[level].erase(buddy);
+        blockOffset = std::min(blockOffset, buddyOffset);
+        ++level;
+    }
+    m_freeBlocks[level].insert(blockOffset);
+}
+
+uint64_t BuddyAllocator::getBlockSize(uint64_t size, uint64_t alignment) const
+{
+    // Blocks are aligned to their size
+    return std::max({nextPowerOfTwo(size), alignment, m_minBlockSize});
+}
+
+uint64_t BuddyAllocator::getSize() const
+{
+    return m_size;
+}
+
+uint64_t BuddyAllocator::getMinBlockSize() const
+{
+    return m_minBlockSize;
+}
+
+uint64_t BuddyAllocator::getAllocatedSize() const
+{
+    return m_allocatedSize;
+}
+
+uint64_t BuddyAllocator::getLargestFreeBlock() const
+{
+    for (size_t level = m_freeBlocks.size(); level > 0; --level)
+    {
+        if (!m_freeBlocks[level - 1].empty())
+        {
+            return getLevelSize(static_cast<uint32_t>(level - 1));
+        }
+    }
+    return 0;
+}
+
+uint32_t BuddyAllocator::getAllocationCount() const
+{
+    return static_cast<uint32_t>(m_allocations.size());
+}
+
+uint32_t BuddyAllocator::getLevel(uint64_t blockSize) const
+{
+    uint32_t level = 0;
+    while ((m_minBlockSize << level) < blockSize)
+    {
+        ++level;
+    }
+    return level;
+}
+
+uint64_t BuddyAllocator::getLevelSize(uint32_t level) const
+{
+    return m_minBlockSize << level;
+}
+
+} // namespace fw
@@ -0,0 +1,193 @@
+#include "BufferHeap.h"
+#include "Macros.h"
+
+#include "d3dx12.h"
+
+#include <cassert>
+#include <utility>
+
+namespace
+{
+// Smallest size class, buffers of a size class can be viewed as constant buffers
+const UINT64 c_minSizeClass = D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT;
+const UINT64 c_pageSize = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
+
+bool isPowerOfTwo(UINT64 value)
+{
+    return value != 0 && (value & (value - 1)) == 0;
+}
+} // namespace
+
+namespace fw
+{
+BufferHeap::Buffer::~Buffer()
+{
+    release();
+}
+
+BufferHeap::Buffer::Buffer(Buffer&& other) :
+    resource(other.resource),
+    offset(other.offset),
+    size(other.size),
+    gpuAddress(other.gpuAddress),
+    m_allocationOffset(other.m_allocationOffset),
+    m_heap(std::move(other.m_heap))
+{
+    other.m_heap.reset();
+}
+
+BufferHeap::Buffer& BufferHeap::Buffer::operator=(Buffer&& other)
+{
+    if (this != &other)
+    {
+        release();
+        resource = other.resource;
+        offset = other.offset;
+        size = other.size;
+        gpuAddress = other.gpuAddress;
+        m_allocationOffset = other.m_allocationOffset;
+        m_heap = std::move(other.m_heap);
+        other.m_heap.reset();
+    }
+    return *this;
+}
+
+void BufferHeap::Buffer::release()
+{
+    if (std::shared_ptr<Heap> heap = m_heap.lock())
+    {
+        heap->allocator.free(m_allocationOffset);
+    }
+    m_heap.reset();
+}
+
+void BufferHeap::initialize(ID3D12Device* device, UINT64 heapSize)
+{
+    assert(isPowerOfTwo(heapSize));
+
+    m_device = device;
+    m_heapSize = heapSize;
+    m_heaps.clear();
+    m_uploadsEnded = false;
+    createHeap(heapSize);
+}
+
+BufferHeap::Buffer BufferHeap::allocate(UINT64 size, UINT64 alignment)
+{
+    assert(size > 0 && alignment > 0);
+
+    // Other alignments are met by padding the allocation
+    const UINT64 padding = isPowerOfTwo(alignment) ? 0 : alignment - 1;
+    const UINT64 allocationAlignment = isPowerOfTwo(alignment) ? alignment : c_minSizeClass;
+
+    std::shared_ptr<Heap> heap;
+    UINT64 allocationOffset = HeapSuballocator::c_invalidOffset;
+    for (const std::shared_ptr<Heap>& candidate : m_heaps)
+    {
+        allocationOffset = candidate->allocator.allocate(size + padding, allocationAlignment);
+        if (allocationOffset != HeapSuballocator::c_invalidOffset)
+        {
+            heap = candidate;
+            break;
+        }
+    }
+
+    if (!heap)
+    {
+        UINT64 heapSize = m_heapSize;
+        while (heapSize < size + padding)
+        {
+            heapSize *= 2;
+        }
+        heap = createHeap(heapSize);
+        allocationOffset = heap->allocator.allocate(size + padding, allocationAlignment);
+        assert(allocationOffset != HeapSuballocator::c_invalidOffset);
+    }
+
+    Buffer buffer;
+    buffer.resource = heap->buffer.Get();
+    buffer.offset = (allocationOffset + alignment - 1) / alignment * alignment;
+    buffer.size = size;
+    buffer.gpuAddress = heap->buffer->GetGPUVirtualAddress() + buffer.offset;
+    buffer.m_allocationOffset = allocationOffset;
+    buffer.m_heap = heap;
+    return buffer;
+}
+
+void BufferHeap::transition(ID3D12GraphicsCommandList* cmdList, const Buffer& buffer, D3D12_RESOURCE_STATES state)
+{
+    const std::shared_ptr<Heap> heap = buffer.m_heap.lock();
+    assert(heap && heap->buffer.Get() == buffer.resource && "The buffer is not from this heap");
+    assert((!m_uploadsEnded || state != D3D12_RESOURCE_STATE_COPY_DEST) && "Buffers are only uploaded during initialization");
+    if (heap->state != state)
+    {
+        cmdList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(heap->buffer.Get(), heap->state, state));
+        heap->state = state;
+    }
+}
+
+bool BufferHeap::hasUnfinishedUploads() const
+{
+    for (const std::shared_ptr<Heap>& heap : m_heaps)
+    {
+        if (heap->state == D3D12_RESOURCE_STATE_COPY_DEST)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void BufferHeap::finishUploads(ID3D12GraphicsCommandList* cmdList)
+{
+    std::vector<D3D12_RESOURCE_BARRIER> barriers;
+    for (const std::shared_ptr<Heap>& heap : m_heaps)
+    {
+        if (heap->state == D3D12_RESOURCE_STATE_COPY_DEST)
+        {
+            barriers.push_back(CD3DX12_RESOURCE_BARRIER::Transition(heap->buffer.Get(), D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_GENERIC_READ));
+            heap->state = D3D12_RESOURCE_STATE_GENERIC_READ;
+        }
+    }
+    if (!barriers.empty())
+    {
+        cmdList->ResourceBarrier(static_cast<UINT>(barriers.size()), barriers.data());
+    }
+}
+
+void BufferHeap::endUploads()
+{
+    assert(!hasUnfinishedUploads());
+    m_uploadsEnded = true;
+}
+
+HeapSuballocator::Stats BufferHeap::getStats() const
+{
+    HeapSuballocator::Stats stats;
+    for (const std::shared_ptr<Heap>& heap : m_heaps)
+    {
+        stats.add(heap->allocator.getStats());
+    }
+    return stats;
+}
+
+std::shared_ptr<BufferHeap::Heap> BufferHeap::createHeap(UINT64 size)
+{
+    std::shared_ptr<Heap> heap = std::make_shared<Heap>();
+
+    CHECK(m_device->CreateHeap(&CD3DX12_HEAP_DESC(size, D3D12_HEAP_TYPE_DEFAULT, 0, D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS), IID_PPV_ARGS(&heap->heap)));
+    CHECK(m_device->CreatePlacedResource(heap->heap.Get(),
+                                         0,
+                                         &CD3DX12_RESOURCE_DESC::Buffer(size),
+                                         heap->state,
+                                         nullptr,
+                                         IID_PPV_ARGS(&heap->buffer)));
+    heap->heap->SetName(L"BufferHeap");
+    heap->buffer->SetName(L"BufferHeapBuffer");
+    heap->allocator.initialize(size, c_pageSize, c_minSizeClass);
+
+    m_heaps.push_back(heap);
+    return heap;
+}
+
+} // namespace fw
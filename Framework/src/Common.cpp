@@ -1,4 +1,34 @@
 ﻿#include "Common.h"
+#include "Profiler.h"
+
+#include <cassert>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+// Buffers may be copied from any offset, the alignment only keeps the copies fast
+const UINT64 c_bufferUploadAlignment = 16;
+
+Microsoft::WRL::ComPtr<ID3D12Resource> createTexture(ID3D12GraphicsCommandList* cmdList,
+                                                     const std::vector<D3D12_SUBRESOURCE_DATA>& subresources,
+                                                     const D3D12_RESOURCE_DESC& textureDesc,
+                                                     fw::UploadRing& uploadRing,
+                                                     fw::TextureHeap& textureHeap,
+                                                     const std::wstring& name)
+{
+    Microsoft::WRL::ComPtr<ID3D12Resource> gpuTexture = textureHeap.createTexture(textureDesc, D3D12_RESOURCE_STATE_COPY_DEST, nullptr, name);
+
+    const UINT subresourceCount = static_cast<UINT>(subresources.size());
+    const fw::UploadRing::Allocation allocation = uploadRing.allocate(GetRequiredIntermediateSize(gpuTexture.Get(), 0, subresourceCount),
+                                                                      D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT);
+
+    UpdateSubresources(cmdList, gpuTexture.Get(), allocation.buffer, allocation.offset, 0, subresourceCount, subresources.data());
+    cmdList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(gpuTexture.Get(), D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE));
+
+    return gpuTexture;
+}
+} // namespace
 
 namespace fw
 {
@@ -8,6 +38,7 @@ Microsoft::WRL::ComPtr<ID3DBlob> compileShader(const std::wstring& filename,
                                                const std::string& target,
                                                UINT flags)
 {
+    FW_PROFILE_FUNCTION();
     uint32_t compileFlags = flags;
 #if defined(DEBUG) || defined(_DEBUG)
     compileFlags |= D3DCOMPILE_DEBUG | D3DCOMPILE_SKIP_OPTIMIZATION;
@@ -38,36 +69,30 @@ std::wstring stringToWstring(const std::string& str)
     return wstr;
 }
 
-Microsoft::WRL::ComPtr<ID3D12Resource> createGPUBuffer(ID3D12Device* device,
-                                                       ID3D12GraphicsCommandList* cmdList,
-                                                       const void* data,
-                                                       UINT64 size,
-                                                       Microsoft::WRL::ComPtr<ID3D12Resource>& uploadBuffer)
+BufferHeap::Buffer createGPUBuffer(ID3D12GraphicsCommandList* cmdList,
+                                   const void* data,
+                                   UINT64 size,
+                                   UploadRing& uploadRing,
+                                   BufferHeap& bufferHeap)
+{
+    return createGPUBuffer(cmdList, data, size, D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT, uploadRing, bufferHeap);
+}
+
+BufferHeap::Buffer createGPUBuffer(ID3D12GraphicsCommandList* cmdList,
+                                   const void* data,
+                                   UINT64 size,
+                                   UINT64 alignment,
+                                   UploadRing& uploadRing,
+                                   BufferHeap& bufferHeap)
 {
-    Microsoft::WRL::ComPtr<ID3D12Resource> gpuBuffer;
-
-    CHECK(device->CreateCommittedResource(&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT),
-                                          D3D12_HEAP_FLAG_NONE,
-                                          &CD3DX12_RESOURCE_DESC::Buffer(size),
-                                          D3D12_RESOURCE_STATE_COMMON,
-                                          nullptr,
-                                          IID_PPV_ARGS(gpuBuffer.GetAddressOf())));
-
-    CHECK(device->CreateCommittedResource(&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
-                                          D3D12_HEAP_FLAG_NONE,
-                                          &CD3DX12_RESOURCE_DESC::Buffer(size),
-                                          D3D12_RESOURCE_STATE_GENERIC_READ,
-                                          nullptr,
-                                          IID_PPV_ARGS(uploadBuffer.GetAddressOf())));
-
-    D3D12_SUBRESOURCE_DATA subResourceData{};
-    subResourceData.pData = data;
-    subResourceData.RowPitch = size;
-    subResourceData.SlicePitch = subResourceData.RowPitch;
-
-    cmdList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(gpuBuffer.Get(), D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_COPY_DEST));
-    UpdateSubresources<1>(cmdList, gpuBuffer.Get(), uploadBuffer.Get(), 0, 0, 1, &subResourceData);
-    cmdList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(gpuBuffer.Get(), D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_GENERIC_READ));
+    BufferHeap::Buffer gpuBuffer = bufferHeap.allocate(size, alignment);
+
+    const UploadRing::Allocation allocation = uploadRing.allocate(size, c_bufferUploadAlignment);
+    std::memcpy(allocation.data, data, size);
+
+    // The heap stays in COPY_DEST until the uploads are finished, so a batch of uploads records one barrier
+    bufferHeap.transition(cmdList, gpuBuffer, D3D12_RESOURCE_STATE_COPY_DEST);
+    cmdList->CopyBufferRegion(gpuBuffer.resource, gpuBuffer.offset, allocation.buffer, allocation.offset, size);
 
     return gpuBuffer;
 }
@@ -78,42 +103,167 @@ Microsoft::WRL::ComPtr<ID3D12Resource> createGPUTexture(ID3D12Device* device,
                                                         UINT64 size,
                                                         const D3D12_RESOURCE_DESC& textureDesc,
                                                         int pixelSize,
-                                                        Microsoft::WRL::ComPtr<ID3D12Resource>& uploadBuffer,
+                                                        UploadRing& uploadRing,
+                                                        TextureHeap& textureHeap,
                                                         std::wstring name)
 {
-    Microsoft::WRL::ComPtr<ID3D12Resource> gpuTexture;
+    D3D12_SUBRESOURCE_DATA textureData{};
+    textureData.pData = data;
+    textureData.RowPitch = textureDesc.Width * pixelSize;
+    textureData.SlicePitch = textureData.RowPitch * textureDesc.Height;
 
-    CHECK(device->CreateCommittedResource(&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT),
-                                          D3D12_HEAP_FLAG_NONE,
-                                          &textureDesc,
-                                          D3D12_RESOURCE_STATE_COPY_DEST,
-                                          nullptr,
-                                          IID_PPV_ARGS(&gpuTexture)));
+    return createTexture(cmdList, {textureData}, textureDesc, uploadRing, textureHeap, name);
+}
 
-    gpuTexture->SetName(name.c_str());
+Microsoft::WRL::ComPtr<ID3D12Resource> createGPUTexture(ID3D12Device* device,
+                                                        ID3D12GraphicsCommandList* cmdList,
+                                                        const MipGenerator::Chain& mipChain,
+                                                        const D3D12_RESOURCE_DESC& textureDesc,
+                                                        UploadRing& uploadRing,
+                                                        TextureHeap& textureHeap,
+                                                        std::wstring name)
+{
+    assert(textureDesc.MipLevels == mipChain.levels.size());
 
-    const UINT64 uploadBufferSize = GetRequiredIntermediateSize(gpuTexture.Get(), 0, 1);
+    std::vector<D3D12_SUBRESOURCE_DATA> subresources(mipChain.levels.size());
+    for (size_t i = 0; i < subresources.size(); ++i)
+    {
+        const MipGenerator::Level& level = mipChain.levels[i];
+        subresources[i].pData = mipChain.pixels.data() + level.offset;
+        subresources[i].RowPitch = level.getRowPitch();
+        subresources[i].SlicePitch = level.getSize();
+    }
 
-    CHECK(device->CreateCommittedResource(&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
-                                          D3D12_HEAP_FLAG_NONE,
-                                          &CD3DX12_RESOURCE_DESC::Buffer(uploadBufferSize),
-                                          D3D12_RESOURCE_STATE_GENERIC_READ,
-                                          nullptr,
-                                          IID_PPV_ARGS(&uploadBuffer)));
+    return createTexture(cmdList, subresources, textureDesc, uploadRing, textureHeap, name);
+}
 
-    uploadBuffer->SetName(L"TextureUploadHeap");
+Microsoft::WRL::ComPtr<ID3D12Resource> createGPUTexture(ID3D12Device* device,
+                                                        ID3D12GraphicsCommandList* cmdList,
+                                                        const TextureFile& textureFile,
+                                                        const D3D12_RESOURCE_DESC& textureDesc,
+                                                        UploadRing& uploadRing,
+                                                        TextureHeap& textureHeap,
+                                                        std::wstring name)
+{
+    static_assert(TextureFile::c_pitchAlignment == D3D12_TEXTURE_DATA_PITCH_ALIGNMENT, "Cooked rows must be aligned like upload rows");
+    static_assert(TextureFile::c_placementAlignment == D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT, "Cooked levels must be aligned like upload levels");
+    assert(textureDesc.MipLevels == textureFile.getLevelCount());
+    assert(textureDesc.Format == getTextureFormat(textureFile.getFormat()));
+    // The first level of a block compressed texture has to be made of whole blocks
+    assert(textureDesc.Width % BlockCompressor::c_blockDimension == 0 && textureDesc.Height % BlockCompressor::c_blockDimension == 0);
 
-    D3D12_SUBRESOURCE_DATA textureData{};
-    textureData.pData = data;
-    textureData.RowPitch = textureDesc.Width * pixelSize;
-    textureData.SlicePitch = textureData.RowPitch * textureDesc.Height;
+    Microsoft::WRL::ComPtr<ID3D12Resource> gpuTexture = textureHeap.createTexture(textureDesc, D3D12_RESOURCE_STATE_COPY_DEST, nullptr, name);
+
+    const UINT subresourceCount = textureFile.getLevelCount();
+    std::vector<D3D12_PLACED_SUBRESOURCE_FOOTPRINT> footprints(subresourceCount);
+    UINT64 uploadSize = 0;
+    device->GetCopyableFootprints(&textureDesc, 0, subresourceCount, 0, nullptr, nullptr, nullptr, &uploadSize);
+    const UploadRing::Allocation allocation = uploadRing.allocate(uploadSize, D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT);
+    // The footprint offsets are relative to the start of the upload buffer
+    device->GetCopyableFootprints(&textureDesc, 0, subresourceCount, allocation.offset, footprints.data(), nullptr, nullptr, nullptr);
+
+    const unsigned char* data = textureFile.getData().data();
+    for (UINT i = 0; i < subresourceCount; ++i)
+    {
+        const TextureFile::Subresource& subresource = textureFile.getSubresource(i);
+        const D3D12_PLACED_SUBRESOURCE_FOOTPRINT& footprint = footprints[i];
+        assert(footprint.Footprint.RowPitch >= subresource.rowSize);
+
+        // The cooked rows are already aligned like the upload rows so a level is usually copied at once
+        const unsigned char* source = data + subresource.offset;
+        unsigned char* destination = allocation.data + (footprint.Offset - allocation.offset);
+        if (footprint.Footprint.RowPitch == subresource.rowPitch)
+        {
+            std::memcpy(destination, source, size_t(subresource.rowPitch) * (subresource.rowCount - 1) + subresource.rowSize);
+        }
+        else
+        {
+            for (uint32_t row = 0; row < subresource.rowCount; ++row)
+            {
+                std::memcpy(destination + size_t(row) * footprint.Footprint.RowPitch, source + size_t(row) * subresource.rowPitch, subresource.rowSize);
+            }
+        }
+
+        cmdList->CopyTextureRegion(&CD3DX12_TEXTURE_COPY_LOCATION(gpuTexture.Get(), i), 0, 0, 0, &CD3DX12_TEXTURE_COPY_LOCATION(allocation.buffer, footprint), nullptr);
+    }
 
-    UpdateSubresources(cmdList, gpuTexture.Get(), uploadBuffer.Get(), 0, 0, 1, &textureData);
     cmdList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(gpuTexture.Get(), D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE));
 
     return gpuTexture;
 }
 
+std::vector<Microsoft::WRL::ComPtr<ID3D12Resource>> createAlbedoTextures(ID3D12Device* device,
+                                                                         ID3D12GraphicsCommandList* cmdList,
+                                                                         const Model& model,
+                                                                         const std::string& directory,
+                                                                         BlockCompressor::Quality quality,
+                                                                         DescriptorHeap& descriptorHeap,
+                                                                         const DescriptorHeap::Range& views,
+                                                                         UploadRing& uploadRing,
+                                                                         TextureHeap& textureHeap)
+{
+    const Model::Meshes& meshes = model.getMeshes();
+    assert(views.count >= meshes.size());
+
+    std::vector<std::string> filepaths;
+    for (const Mesh& mesh : meshes)
+    {
+        filepaths.push_back(directory + mesh.getFirstTextureOfType(aiTextureType::aiTextureType_DIFFUSE));
+    }
+
+    std::vector<std::shared_ptr<const TextureFile>> textureFiles;
+    bool texturesLoaded = TextureFile::loadFiles(filepaths, MipGenerator::ColorSpace::Srgb, quality, textureFiles);
+    assert(texturesLoaded);
+
+    D3D12_RESOURCE_DESC textureDesc{};
+    textureDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+    textureDesc.DepthOrArraySize = 1;
+    textureDesc.SampleDesc.Count = 1;
+    textureDesc.SampleDesc.Quality = 0;
+    textureDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+
+    std::vector<Microsoft::WRL::ComPtr<ID3D12Resource>> textures(meshes.size());
+    for (size_t i = 0; i < meshes.size(); ++i)
+    {
+        const TextureFile& textureFile = *textureFiles[i];
+        textureDesc.Width = textureFile.getWidth();
+        textureDesc.Height = textureFile.getHeight();
+        textureDesc.MipLevels = static_cast<UINT16>(textureFile.getLevelCount());
+        textureDesc.Format = getTextureFormat(textureFile.getFormat());
+
+        textures[i] = createGPUTexture(device, cmdList, textureFile, textureDesc, uploadRing, textureHeap);
+
+        D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc{};
+        srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+        srvDesc.Format = textureDesc.Format;
+        srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+        srvDesc.Texture2D.MipLevels = textureDesc.MipLevels;
+        device->CreateShaderResourceView(textures[i].Get(), &srvDesc, descriptorHeap.getCpuHandle(views, static_cast<uint32_t>(i)));
+    }
+    return textures;
+}
+
+DXGI_FORMAT getIndexFormat(const Mesh& mesh)
+{
+    return mesh.indexType == Mesh::IndexType::UInt16 ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT;
+}
+
+DXGI_FORMAT getTextureFormat(BlockCompressor::Format format)
+{
+    switch (format)
+    {
+    case BlockCompressor::Format::BC1:
+        return DXGI_FORMAT_BC1_UNORM;
+    case BlockCompressor::Format::BC3:
+        return DXGI_FORMAT_BC3_UNORM;
+    case BlockCompressor::Format::BC5:
+        return DXGI_FORMAT_BC5_UNORM;
+    case BlockCompressor::Format::BC7:
+        return DXGI_FORMAT_BC7_UNORM;
+    }
+    return DXGI_FORMAT_UNKNOWN;
+}
+
 void serializeAndCreateRootSignature(ID3D12Device* device, const D3D12_ROOT_SIGNATURE_DESC& desc, Microsoft::WRL::ComPtr<ID3D12RootSignature>& rootSig)
 {
     Microsoft::WRL::ComPtr<ID3DBlob> signatureBlob;
@@ -0,0 +1,196 @@
+#include "Config.h"
+
+#include <cctype>
+#include <cstdlib>
+#include <iostream>
+
+namespace
+{
+const char* c_options[] = {"backend", "validation", "frames-in-flight", "vsync", "resolution", "frame-limit", "texture-quality"};
+
+std::string getEnvironmentName(const std::string& option)
+{
+    std::string name = "FW_";
+    for (char c : option)
+    {
+        name += c == '-' ? '_' : static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+    }
+    return name;
+}
+
+bool getEnvironmentVariable(const std::string& name, std::string& value)
+{
+    char* buffer = nullptr;
+    size_t size = 0;
+    if (_dupenv_s(&buffer, &size, name.c_str()) != 0 || !buffer)
+    {
+        return false;
+    }
+    value = buffer;
+    free(buffer);
+    return true;
+}
+
+bool parseInt(const std::string& str, int& value)
+{
+    if (str.empty())
+    {
+        return false;
+    }
+    char* end = nullptr;
+    const long parsed = std::strtol(str.c_str(), &end, 10);
+    if (*end != '\0')
+    {
+        return false;
+    }
+    value = static_cast<int>(parsed);
+    return true;
+}
+
+bool parsePositiveInt(const std::string& str, int& value)
+{
+    int parsed = 0;
+    if (!parseInt(str, parsed) || parsed <= 0)
+    {
+        return false;
+    }
+    value = parsed;
+    return true;
+}
+} // namespace
+
+namespace fw
+{
+bool Config::parse(int argc, char** argv)
+{
+    for (const char* option : c_options)
+    {
+        const std::string environmentName = getEnvironmentName(option);
+        std::string value;
+        if (getEnvironmentVariable(environmentName, value) && !set(option, value))
+        {
+            std::cerr << "Invalid value of " << environmentName << ": " << value << "\n";
+            return false;
+        }
+    }
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string argument = argv[i];
+        const size_t separator = argument.find('=');
+        if (argument.compare(0, 2, "--") != 0 || separator == std::string::npos)
+        {
+            std::cerr << "Expected --name=value instead of: " << argument << "\n";
+            return false;
+        }
+        if (!set(argument.substr(2, separator - 2), argument.substr(separator + 1)))
+        {
+            std::cerr << "Invalid option: " << argument << "\n";
+            return false;
+        }
+    }
+
+    // Nothing ends a run without a window but the frame limit
+    if (backend != Backend::Windowed && frameLimit < 0)
+    {
+        std::cerr << "A run without a window needs a frame limit\n";
+        return false;
+    }
+    return true;
+}
+
+bool Config::set(const std::string& name, const std::string& value)
+{
+    if (name == "backend")
+    {
+        if (value == "windowed")
+        {
+            backend = Backend::Windowed;
+            return true;
+        }
+        if (value == "offscreen")
+        {
+            backend = Backend::Offscreen;
+            return true;
+        }
+        if (value == "null")
+        {
+            backend = Backend::Null;
+            return true;
+        }
+        return false;
+    }
+
+    if (name == "validation")
+    {
+        if (value == "none")
+        {
+            validation = Validation::None;
+            return true;
+        }
+        if (value == "debug")
+        {
+            validation = Validation::DebugLayer;
+            return true;
+        }
+        if (value == "gpu")
+        {
+            validation = Validation::GpuBased;
+            return true;
+        }
+        return false;
+    }
+
+    if (name == "frames-in-flight")
+    {
+        return parsePositiveInt(value, framesInFlight);
+    }
+
+    if (name == "vsync")
+    {
+        if (value == "on" || value == "off")
+        {
+            vsync = value == "on";
+            return true;
+        }
+        return false;
+    }
+
+    if (name == "resolution")
+    {
+        const size_t separator = value.find('x');
+        int parsedWidth = 0;
+        int parsedHeight = 0;
+        if (separator == std::string::npos || !parsePositiveInt(value.substr(0, separator), parsedWidth) || !parsePositiveInt(value.substr(separator + 1), parsedHeight))
+        {
+            return false;
+        }
+        width = parsedWidth;
+        height = parsedHeight;
+        return true;
+    }
+
+    if (name == "frame-limit")
+    {
+        return parseInt(value, frameLimit);
+    }
+
+    if (name == "texture-quality")
+    {
+        if (value == "fast")
+        {
+            textureQuality = BlockCompressor::Quality::Fast;
+            return true;
+        }
+        if (value == "high")
+        {
+            textureQuality = BlockCompressor::Quality::High;
+            return true;
+        }
+        return false;
+    }
+
+    return false;
+}
+
+} // namespace fw
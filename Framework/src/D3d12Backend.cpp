@@ -0,0 +1,58 @@
+#include "D3d12Backend.h"
+#include "Macros.h"
+
+#include <dxgi1_4.h>
+
+#include <iostream>
+
+namespace fw
+{
+bool D3d12Backend::createDevice(const Config& config, Microsoft::WRL::ComPtr<ID3D12Device5>& device)
+{
+    // Enable debug layer and GBV
+    if (config.validation != Config::Validation::None)
+    {
+        Microsoft::WRL::ComPtr<ID3D12Debug1> debugController;
+        CHECK(D3D12GetDebugInterface(IID_PPV_ARGS(&debugController)));
+        debugController->EnableDebugLayer();
+        debugController->SetEnableGPUBasedValidation(config.validation == Config::Validation::GpuBased);
+    }
+
+    Microsoft::WRL::ComPtr<IDXGIAdapter> adapter;
+    if (config.backend == Config::Backend::Offscreen)
+    {
+        // The software rasterizer is there also without a GPU
+        Microsoft::WRL::ComPtr<IDXGIFactory4> dxgiFactory;
+        CHECK(CreateDXGIFactory1(IID_PPV_ARGS(&dxgiFactory)));
+        CHECK(dxgiFactory->EnumWarpAdapter(IID_PPV_ARGS(&adapter)));
+    }
+
+    if (FAILED(D3D12CreateDevice(adapter.Get(), D3D_FEATURE_LEVEL_11_0, IID_PPV_ARGS(&device))))
+    {
+        std::cerr << "Failed to create a D3D12 device" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool D3d12Backend::createCommandQueue(ID3D12Device5* device, Microsoft::WRL::ComPtr<ID3D12CommandQueue>& commandQueue)
+{
+    D3D12_COMMAND_QUEUE_DESC queueDesc{};
+    queueDesc.Type = D3D12_COMMAND_LIST_TYPE_DIRECT;
+    queueDesc.Flags = D3D12_COMMAND_QUEUE_FLAG_NONE;
+    CHECK(device->CreateCommandQueue(&queueDesc, IID_PPV_ARGS(&commandQueue)));
+    return true;
+}
+
+bool D3d12Backend::createCommandList(ID3D12Device5* device, ID3D12CommandAllocator* commandAllocator, Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList4>& commandList)
+{
+    CHECK(device->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT, commandAllocator, nullptr, IID_PPV_ARGS(commandList.GetAddressOf())));
+    return true;
+}
+
+bool D3d12Backend::getCounters(Counters& /*counters*/) const
+{
+    return false;
+}
+
+} // namespace fw
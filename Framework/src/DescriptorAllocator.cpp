@@ -0,0 +1,133 @@
+#include "DescriptorAllocator.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace fw
+{
+void DescriptorAllocator::initialize(uint32_t persistentCount, uint32_t transientCount, uint32_t frameCount)
+{
+    m_persistentCount = persistentCount;
+    m_transientCount = transientCount;
+    m_frameCount = frameCount;
+    m_allocatedCount = 0;
+    m_freeRanges.clear();
+    if (persistentCount > 0)
+    {
+        m_freeRanges[0] = persistentCount;
+    }
+    m_allocations.clear();
+    beginFrame(0);
+}
+
+uint32_t DescriptorAllocator::allocate(uint32_t count)
+{
+    if (count == 0)
+    {
+        return c_invalidIndex;
+    }
+
+    // First fit keeps the persistent descriptors packed to the start of the heap
+    for (auto freeRange = m_freeRanges.begin(); freeRange != m_freeRanges.end(); ++freeRange)
+    {
+        if (freeRange->second < count)
+        {
+            continue;
+        }
+
+        const uint32_t index = freeRange->first;
+        const uint32_t remainingCount = freeRange->second - count;
+        m_freeRanges.erase(freeRange);
+        if (remainingCount > 0)
+        {
+            m_freeRanges[index + count] = remainingCount;
+        }
+        m_allocations[index] = count;
+        m_allocatedCount += count;
+        return index;
+    }
+    return c_invalidIndex;
+}
+
+void DescriptorAllocator::free(uint32_t index)
+{
+    auto allocation = m_allocations.find(index);
+    assert(allocation != m_allocations.end());
+    uint32_t count = allocation->second;
+    m_allocations.erase(allocation);
+    m_allocatedCount -= count;
+
+    auto next = m_freeRanges.lower_bound(index);
+    if (next != m_freeRanges.end() && next->first == index + count)
+    {
+        count += next->second;
+        next = m_freeRanges.erase(next);
+    }
+    if (next != m_freeRanges.begin())
+    {
+        auto previous = std::prev(next);
+        if (previous->first + previous->second == index)
+        {
+            previous->second += count;
+            return;
+        }
+    }
+    m_freeRanges[index] = count;
+}
+
+void DescriptorAllocator::beginFrame(uint32_t frameIndex)
+{
+    assert(m_frameCount == 0 || frameIndex < m_frameCount);
+
+    m_transientStart = m_persistentCount + frameIndex * m_transientCount;
+    m_transientOffset = 0;
+}
+
+uint32_t DescriptorAllocator::allocateTransient(uint32_t count)
+{
+    if (count == 0 || m_transientOffset + count > m_transientCount)
+    {
+        return c_invalidIndex;
+    }
+
+    const uint32_t index = m_transientStart + m_transientOffset;
+    m_transientOffset += count;
+    return index;
+}
+
+uint32_t DescriptorAllocator::getCount() const
+{
+    return m_persistentCount + m_frameCount * m_transientCount;
+}
+
+uint32_t DescriptorAllocator::getPersistentCount() const
+{
+    return m_persistentCount;
+}
+
+uint32_t DescriptorAllocator::getAllocatedCount() const
+{
+    return m_allocatedCount;
+}
+
+uint32_t DescriptorAllocator::getLargestFreeRange() const
+{
+    uint32_t largestFreeRange = 0;
+    for (const auto& freeRange : m_freeRanges)
+    {
+        largestFreeRange = std::max(largestFreeRange, freeRange.second);
+    }
+    return largestFreeRange;
+}
+
+uint32_t DescriptorAllocator::getTransientCount() const
+{
+    return m_transientCount;
+}
+
+uint32_t DescriptorAllocator::getUsedTransientCount() const
+{
+    return m_transientOffset;
+}
+
+} // namespace fw
@@ -0,0 +1,164 @@
+#include "DescriptorHeap.h"
+#include "Macros.h"
+
+#include <cassert>
+#include <iostream>
+
+namespace fw
+{
+void DescriptorHeap::initialize(ID3D12Device* device,
+                                D3D12_DESCRIPTOR_HEAP_TYPE type,
+                                uint32_t persistentCount,
+                                uint32_t transientCount,
+                                int frameCount,
+                                uint32_t stagingCount)
+{
+    assert(type == D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV || type == D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER);
+
+    m_device = device;
+    m_type = type;
+    m_incrementSize = device->GetDescriptorHandleIncrementSize(type);
+
+    m_allocator.initialize(persistentCount, transientCount, static_cast<uint32_t>(frameCount));
+    D3D12_DESCRIPTOR_HEAP_DESC heapDesc{};
+    heapDesc.NumDescriptors = m_allocator.getCount();
+    heapDesc.Type = type;
+    heapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
+    CHECK(device->CreateDescriptorHeap(&heapDesc, IID_PPV_ARGS(&m_heap)));
+    m_heap->SetName(L"DescriptorHeap");
+
+    m_stagingAllocator.initialize(stagingCount, 0, 0);
+    D3D12_DESCRIPTOR_HEAP_DESC stagingHeapDesc{};
+    stagingHeapDesc.NumDescriptors = stagingCount;
+    stagingHeapDesc.Type = type;
+    stagingHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
+    CHECK(device->CreateDescriptorHeap(&stagingHeapDesc, IID_PPV_ARGS(&m_stagingHeap)));
+    m_stagingHeap->SetName(L"StagingDescriptorHeap");
+}
+
+DescriptorHeap::Range DescriptorHeap::allocate(uint32_t count)
+{
+    const uint32_t index = m_allocator.allocate(count);
+    if (index == DescriptorAllocator::c_invalidIndex)
+    {
+        std::cerr << "Descriptor heap has no free range of " << count << " descriptors" << std::endl;
+        return Range();
+    }
+    return getRange(index, count);
+}
+
+void DescriptorHeap::free(const Range& range)
+{
+    m_allocator.free(range.index);
+}
+
+void DescriptorHeap::beginFrame(int frameIndex)
+{
+    m_allocator.beginFrame(static_cast<uint32_t>(frameIndex));
+}
+
+DescriptorHeap::Range DescriptorHeap::allocateTransient(uint32_t count)
+{
+    const uint32_t index = m_allocator.allocateTransient(count);
+    if (index == DescriptorAllocator::c_invalidIndex)
+    {
+        std::cerr << "Descriptor heap is out of transient descriptors, " << count << " requested" << std::endl;
+        return Range();
+    }
+    return getRange(index, count);
+}
+
+DescriptorHeap::Range DescriptorHeap::allocateStaging(uint32_t count)
+{
+    const uint32_t index = m_stagingAllocator.allocate(count);
+    if (index == DescriptorAllocator::c_invalidIndex)
+    {
+        std::cerr << "Staging descriptor heap has no free range of " << count << " descriptors" << std::endl;
+        return Range();
+    }
+
+    Range range;
+    range.index = index;
+    range.count = count;
+    range.cpuHandle.ptr = m_stagingHeap->GetCPUDescriptorHandleForHeapStart().ptr + static_cast<SIZE_T>(index) * m_incrementSize;
+    return range;
+}
+
+void DescriptorHeap::freeStaging(const Range& range)
+{
+    m_stagingAllocator.free(range.index);
+}
+
+void DescriptorHeap::copy(const Range& destination, uint32_t destinationOffset, D3D12_CPU_DESCRIPTOR_HANDLE source, uint32_t count)
+{
+    assert(destinationOffset + count <= destination.count);
+
+    m_copyDestinations.push_back(getCpuHandle(destination, destinationOffset));
+    m_copySources.push_back(source);
+    m_copySizes.push_back(count);
+}
+
+void DescriptorHeap::flushCopies()
+{
+    if (m_copySizes.empty())
+    {
+        return;
+    }
+
+    // Ranges of the same size are copied as they are, so the sizes serve both the destinations and the sources
+    const UINT rangeCount = static_cast<UINT>(m_copySizes.size());
+    m_device->CopyDescriptors(rangeCount,
+                              m_copyDestinations.data(),
+                              m_copySizes.data(),
+                              rangeCount,
+                              m_copySources.data(),
+                              m_copySizes.data(),
+                              m_type);
+    m_copyDestinations.clear();
+    m_copySources.clear();
+    m_copySizes.clear();
+}
+
+D3D12_CPU_DESCRIPTOR_HANDLE DescriptorHeap::getCpuHandle(const Range& range, uint32_t offset) const
+{
+    assert(offset < range.count);
+    return D3D12_CPU_DESCRIPTOR_HANDLE{range.cpuHandle.ptr + static_cast<SIZE_T>(offset) * m_incrementSize};
+}
+
+D3D12_GPU_DESCRIPTOR_HANDLE DescriptorHeap::getGpuHandle(const Range& range, uint32_t offset) const
+{
+    assert(offset < range.count && range.gpuHandle.ptr != 0);
+    return D3D12_GPU_DESCRIPTOR_HANDLE{range.gpuHandle.ptr + static_cast<UINT64>(offset) * m_incrementSize};
+}
+
+ID3D12DescriptorHeap* DescriptorHeap::getHeap() const
+{
+    return m_heap.Get();
+}
+
+UINT DescriptorHeap::getIncrementSize() const
+{
+    return m_incrementSize;
+}
+
+const DescriptorAllocator& DescriptorHeap::getAllocator() const
+{
+    return m_allocator;
+}
+
+const DescriptorAllocator& DescriptorHeap::getStagingAllocator() const
+{
+    return m_stagingAllocator;
+}
+
+DescriptorHeap::Range DescriptorHeap::getRange(uint32_t index, uint32_t count) const
+{
+    Range range;
+    range.index = index;
+    range.count = count;
+    range.cpuHandle.ptr = m_heap->GetCPUDescriptorHandleForHeapStart().ptr + static_cast<SIZE_T>(index) * m_incrementSize;
+    range.gpuHandle.ptr = m_heap->GetGPUDescriptorHandleForHeapStart().ptr + static_cast<UINT64>(index) * m_incrementSize;
+    return range;
+}
+
+} // namespace fw
@@ -0,0 +1,82 @@
+#include "FrameAllocator.h"
+#include "Macros.h"
+
+#include "d3dx12.h"
+
+#include <cassert>
+#include <cstring>
+#include <iostream>
+
+namespace fw
+{
+FrameAllocator::~FrameAllocator()
+{
+    if (m_buffer)
+    {
+        m_buffer->Unmap(0, nullptr);
+    }
+}
+
+void FrameAllocator::initialize(ID3D12Device* device, UINT64 frameSize, int frameCount)
+{
+    assert(frameSize % D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT == 0);
+
+    m_frameSize = frameSize;
+    CHECK(device->CreateCommittedResource(&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
+                                          D3D12_HEAP_FLAG_NONE,
+                                          &CD3DX12_RESOURCE_DESC::Buffer(frameSize * frameCount),
+                                          D3D12_RESOURCE_STATE_GENERIC_READ,
+                                          nullptr,
+                                          IID_PPV_ARGS(&m_buffer)));
+    m_buffer->SetName(L"FrameAllocator");
+    m_gpuAddress = m_buffer->GetGPUVirtualAddress();
+
+    // The buffer stays mapped for its lifetime, the CPU only writes to it
+    CHECK(m_buffer->Map(0, &CD3DX12_RANGE(0, 0), reinterpret_cast<void**>(&m_data)));
+    beginFrame(0);
+}
+
+void FrameAllocator::beginFrame(int frameIndex)
+{
+    m_frameOffset = frameIndex * m_frameSize;
+    m_offset = 0;
+}
+
+FrameAllocator::Allocation FrameAllocator::allocate(UINT64 size)
+{
+    const UINT64 alignedSize = (size + D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT - 1) & ~static_cast<UINT64>(D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT - 1);
+    if (m_offset + alignedSize > m_frameSize)
+    {
+        std::cerr << "Frame allocator is out of memory, " << size << " bytes requested" << std::endl;
+        assert(false);
+        return Allocation();
+    }
+
+    Allocation allocation;
+    allocation.data = m_data + m_frameOffset + m_offset;
+    allocation.gpuAddress = m_gpuAddress + m_frameOffset + m_offset;
+    m_offset += alignedSize;
+    return allocation;
+}
+
+FrameAllocator::Allocation FrameAllocator::allocate(const void* data, UINT64 size)
+{
+    Allocation allocation = allocate(size);
+    if (allocation.data)
+    {
+        memcpy(allocation.data, data, size);
+    }
+    return allocation;
+}
+
+UINT64 FrameAllocator::getFrameSize() const
+{
+    return m_frameSize;
+}
+
+UINT64 FrameAllocator::getUsedSize() const
+{
+    return m_offset;
+}
+
+} // namespace fw
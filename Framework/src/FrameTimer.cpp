@@ -0,0 +1,117 @@
+#include "FrameTimer.h"
+
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+namespace
+{
+float toMilliseconds(std::chrono::steady_clock::duration duration)
+{
+    return std::chrono::duration<float, std::milli>(duration).count();
+}
+
+// Nearest rank, computed with integers so that rounding does not move it
+float getPercentile(const std::vector<float>& sortedValues, size_t percent)
+{
+    const size_t rank = (percent * sortedValues.size() + 99) / 100;
+    return sortedValues[std::max(rank, size_t(1)) - 1];
+}
+} // namespace
+
+namespace fw
+{
+void FrameTimer::initialize(size_t historySize)
+{
+    initialize(historySize, []() { return std::chrono::steady_clock::now(); });
+}
+
+void FrameTimer::initialize(size_t historySize, Clock clock)
+{
+    assert(historySize > 0);
+
+    m_clock = std::move(clock);
+    m_historySize = historySize;
+    m_durations = std::make_unique<std::atomic<float>[]>(historySize * c_stageCount);
+    for (size_t i = 0; i < historySize * c_stageCount; ++i)
+    {
+        m_durations[i].store(0.0f, std::memory_order_relaxed);
+    }
+    m_endedFrameCount.store(0, std::memory_order_release);
+}
+
+void FrameTimer::beginFrame()
+{
+    m_frameBegin = m_clock();
+    m_stageBegin = m_frameBegin;
+    std::fill(std::begin(m_currentDurations), std::end(m_currentDurations), 0.0f);
+}
+
+void FrameTimer::endStage(Stage stage)
+{
+    assert(stage != Stage::Frame && stage != Stage::Count);
+
+    const std::chrono::steady_clock::time_point now = m_clock();
+    m_currentDurations[static_cast<size_t>(stage)] += toMilliseconds(now - m_stageBegin);
+    m_stageBegin = now;
+}
+
+void FrameTimer::endFrame()
+{
+    m_currentDurations[static_cast<size_t>(Stage::Frame)] = toMilliseconds(m_clock() - m_frameBegin);
+
+    // Only this thread writes, so the count can be read before it is published
+    const uint64_t frame = m_endedFrameCount.load(std::memory_order_relaxed);
+    std::atomic<float>* durations = &m_durations[(frame % m_historySize) * c_stageCount];
+    for (size_t i = 0; i < c_stageCount; ++i)
+    {
+        durations[i].store(m_currentDurations[i], std::memory_order_relaxed);
+    }
+    m_endedFrameCount.store(frame + 1, std::memory_order_release);
+}
+
+size_t FrameTimer::getFrameCount() const
+{
+    return static_cast<size_t>(std::min<uint64_t>(m_endedFrameCount.load(std::memory_order_acquire), m_historySize));
+}
+
+float FrameTimer::getLatest(Stage stage) const
+{
+    const uint64_t endedFrameCount = m_endedFrameCount.load(std::memory_order_acquire);
+    if (endedFrameCount == 0)
+    {
+        return 0.0f;
+    }
+    const size_t slot = static_cast<size_t>((endedFrameCount - 1) % m_historySize);
+    return m_durations[slot * c_stageCount + static_cast<size_t>(stage)].load(std::memory_order_relaxed);
+}
+
+FrameTimer::Percentiles FrameTimer::getPercentiles(Stage stage) const
+{
+    const size_t frameCount = getFrameCount();
+    if (frameCount == 0)
+    {
+        return Percentiles();
+    }
+
+    std::vector<float> values(frameCount);
+    for (size_t i = 0; i < frameCount; ++i)
+    {
+        values[i] = m_durations[i * c_stageCount + static_cast<size_t>(stage)].load(std::memory_order_relaxed);
+    }
+    std::sort(values.begin(), values.end());
+
+    Percentiles percentiles;
+    percentiles.p50 = getPercentile(values, 50);
+    percentiles.p95 = getPercentile(values, 95);
+    percentiles.p99 = getPercentile(values, 99);
+    return percentiles;
+}
+
+const char* FrameTimer::getStageName(Stage stage)
+{
+    const char* names[] = {"Events", "Fence wait", "Update", "Record", "Present", "Frame"};
+    return names[static_cast<size_t>(stage)];
+}
+
+} // namespace fw
@@ -1,7 +1,12 @@
 #include "Framework.h"
+#include "D3d12Backend.h"
 #include "Macros.h"
+#include "NullBackend.h"
+#include "Profiler.h"
 
 #include <cassert>
+#include <iostream>
+#include <utility>
 
 namespace fw
 {
@@ -12,27 +17,44 @@ Framework::Framework()
 
 Framework::~Framework()
 {
+    for (HANDLE eventHandle : m_frameEvents)
+    {
+        CloseHandle(eventHandle);
+    }
 }
 
 bool Framework::initialize()
 {
-    m_window.initialize();
-
-    // Enable GBV
-    Microsoft::WRL::ComPtr<ID3D12Debug> spDebugController0;
-    Microsoft::WRL::ComPtr<ID3D12Debug1> spDebugController1;
-    CHECK(D3D12GetDebugInterface(IID_PPV_ARGS(&spDebugController0)));
-    CHECK(spDebugController0->QueryInterface(IID_PPV_ARGS(&spDebugController1)));
-    spDebugController1->SetEnableGPUBasedValidation(true);
+    return initialize(Config());
+}
 
-    // Enable debug layer
-    Microsoft::WRL::ComPtr<ID3D12Debug> debugController;
-    CHECK(D3D12GetDebugInterface(IID_PPV_ARGS(&debugController)));
-    debugController->EnableDebugLayer();
+bool Framework::initialize(const Config& config)
+{
+    FW_PROFILE_THREAD("Main");
+    FW_PROFILE_FUNCTION();
+    m_config = config;
+    if (m_config.backend == Config::Backend::Windowed)
+    {
+        m_window.initialize(m_config.width, m_config.height);
+    }
+    else
+    {
+        m_window.initializeHeadless(m_config.width, m_config.height);
+    }
 
-    // Create dxgi factory and d3d device
-    CHECK(CreateDXGIFactory1(IID_PPV_ARGS(&m_dxgiFactory)));
-    CHECK(D3D12CreateDevice(nullptr, D3D_FEATURE_LEVEL_11_0, IID_PPV_ARGS(&m_d3dDevice)));
+    // Create d3d device
+    if (m_config.backend == Config::Backend::Null)
+    {
+        m_backend = std::make_unique<NullBackend>();
+    }
+    else
+    {
+        m_backend = std::make_unique<D3d12Backend>();
+    }
+    if (!m_backend->createDevice(m_config, m_d3dDevice))
+    {
+        return false;
+    }
 
     // Check feature support
     D3D12_FEATURE_DATA_MULTISAMPLE_QUALITY_LEVELS msQualityLevels;
@@ -43,9 +65,35 @@ bool Framework::initialize()
     CHECK(m_d3dDevice->CheckFeatureSupport(D3D12_FEATURE_MULTISAMPLE_QUALITY_LEVELS, &msQualityLevels, sizeof(msQualityLevels)));
     assert(msQualityLevels.NumQualityLevels > 0 && "Unexpected MSAA quality level");
 
-    // Create fence
-    m_fenceIds.resize(m_swapChainBufferCount);
+    // Create fence and the events to wait for frames
+    assert(m_config.framesInFlight > 0 && m_swapChainBufferCount > 1);
+    m_fenceIds.resize(m_config.framesInFlight);
     m_d3dDevice->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&m_fence));
+    m_frameEvents.resize(m_config.framesInFlight);
+    for (HANDLE& eventHandle : m_frameEvents)
+    {
+        eventHandle = CreateEventEx(nullptr, nullptr, 0, EVENT_ALL_ACCESS);
+        if (!eventHandle)
+        {
+            std::cerr << "Failed to create frame event" << std::endl;
+            return false;
+        }
+    }
+
+    // Create upload ring, frame allocator and resource heaps
+    m_uploadRing.initialize(m_d3dDevice.Get(), m_fence.Get(), m_uploadRingSize);
+    m_frameAllocator.initialize(m_d3dDevice.Get(), m_frameAllocatorSize, m_config.framesInFlight);
+    m_bufferHeap.initialize(m_d3dDevice.Get(), m_bufferHeapSize);
+    m_textureHeap.initialize(m_d3dDevice.Get(), TextureHeap::Type::Textures, m_textureHeapSize);
+    m_renderTargetHeap.initialize(m_d3dDevice.Get(), TextureHeap::Type::RenderTargets, m_renderTargetHeapSize);
+
+    // Create shader visible descriptor heap
+    m_descriptorHeap.initialize(m_d3dDevice.Get(),
+                                D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV,
+                                m_persistentDescriptorCount,
+                                m_transientDescriptorCount,
+                                m_config.framesInFlight,
+                                m_stagingDescriptorCount);
 
     // Get handle increment sizes
     m_rtvDescriptorIncrementSize = m_d3dDevice->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_RTV);
@@ -55,18 +103,22 @@ bool Framework::initialize()
     // Create command list
     CHECK(m_d3dDevice->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(m_commandAllocator.GetAddressOf())));
 
-    D3D12_COMMAND_QUEUE_DESC queueDesc{};
-    queueDesc.Type = D3D12_COMMAND_LIST_TYPE_DIRECT;
-    queueDesc.Flags = D3D12_COMMAND_QUEUE_FLAG_NONE;
-    CHECK(m_d3dDevice->CreateCommandQueue(&queueDesc, IID_PPV_ARGS(&m_commandQueue)));
-    CHECK(m_d3dDevice->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT, m_commandAllocator.Get(), nullptr, IID_PPV_ARGS(m_commandList.GetAddressOf())));
+    if (!m_backend->createCommandQueue(m_d3dDevice.Get(), m_commandQueue) ||
+        !m_backend->createCommandList(m_d3dDevice.Get(), m_commandAllocator.Get(), m_commandList) ||
+        !m_backend->createCommandList(m_d3dDevice.Get(), m_commandAllocator.Get(), m_uploadCommandList))
+    {
+        return false;
+    }
+    CHECK(m_uploadCommandList->Close());
 
-    m_frameCommandAllocators.resize(m_swapChainBufferCount);
+    m_frameCommandAllocators.resize(m_config.framesInFlight);
     for (Microsoft::WRL::ComPtr<ID3D12CommandAllocator>& frameCommandAllocator : m_frameCommandAllocators)
     {
         CHECK(m_d3dDevice->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(frameCommandAllocator.GetAddressOf())));
     }
 
+    m_gpuProfiler.initialize(m_d3dDevice.Get(), m_commandQueue.Get(), m_gpuPassesPerFrame, m_config.framesInFlight);
+
     // Create descriptor heaps
     D3D12_DESCRIPTOR_HEAP_DESC rtvHeapDesc;
     rtvHeapDesc.NumDescriptors = m_swapChainBufferCount;
@@ -82,35 +134,26 @@ bool Framework::initialize()
     dsvHeapDesc.NodeMask = 0;
     CHECK(m_d3dDevice->CreateDescriptorHeap(&dsvHeapDesc, IID_PPV_ARGS(m_dsvHeap.GetAddressOf())));
 
-    // Create swap chain
-    m_swapChain.Reset();
-
-    DXGI_SWAP_CHAIN_DESC swapChainDesc;
-    swapChainDesc.BufferDesc.Width = m_window.getWidth();
-    swapChainDesc.BufferDesc.Height = m_window.getHeight();
-    swapChainDesc.BufferDesc.RefreshRate.Numerator = 60;
-    swapChainDesc.BufferDesc.RefreshRate.Denominator = 1;
-    swapChainDesc.BufferDesc.Format = m_backBufferFormat;
-    swapChainDesc.BufferDesc.ScanlineOrdering = DXGI_MODE_SCANLINE_ORDER_UNSPECIFIED;
-    swapChainDesc.BufferDesc.Scaling = DXGI_MODE_SCALING_UNSPECIFIED;
-    swapChainDesc.SampleDesc.Count = 1;
-    swapChainDesc.SampleDesc.Quality = 0;
-    swapChainDesc.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
-    swapChainDesc.BufferCount = m_swapChainBufferCount;
-    swapChainDesc.OutputWindow = m_window.getNativeHandle();
-    swapChainDesc.Windowed = true;
-    swapChainDesc.SwapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD;
-    swapChainDesc.Flags = DXGI_SWAP_CHAIN_FLAG_ALLOW_MODE_SWITCH;
-
-    m_swapChain.Reset();
-    CHECK(m_dxgiFactory->CreateSwapChain(m_commandQueue.Get(), &swapChainDesc, m_swapChain.GetAddressOf()));
+    // Create swap chain, without a window the back buffers are render targets of the swap chain format
+    if (m_config.backend == Config::Backend::Windowed)
+    {
+        createSwapChain();
+    }
 
     // Create render targets
     m_swapChainBuffers.resize(m_swapChainBufferCount);
     CD3DX12_CPU_DESCRIPTOR_HANDLE rtvHeapHandle(m_rtvHeap->GetCPUDescriptorHandleForHeapStart());
     for (int i = 0; i < m_swapChainBufferCount; ++i)
     {
-        CHECK(m_swapChain->GetBuffer(i, IID_PPV_ARGS(&m_swapChainBuffers[i])));
+        if (m_swapChain)
+        {
+            CHECK(m_swapChain->GetBuffer(i, IID_PPV_ARGS(&m_swapChainBuffers[i])));
+        }
+        else
+        {
+            const D3D12_RESOURCE_DESC backBufferDesc = CD3DX12_RESOURCE_DESC::Tex2D(m_backBufferFormat, m_window.getWidth(), m_window.getHeight(), 1, 1, 1, 0, D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET);
+            m_swapChainBuffers[i] = m_renderTargetHeap.createTexture(backBufferDesc, D3D12_RESOURCE_STATE_PRESENT, nullptr, L"OffscreenBackBuffer");
+        }
         m_d3dDevice->CreateRenderTargetView(m_swapChainBuffers[i].Get(), nullptr, rtvHeapHandle);
         rtvHeapHandle.Offset(1, m_rtvDescriptorIncrementSize);
     }
@@ -134,12 +177,7 @@ bool Framework::initialize()
     optClear.DepthStencil.Depth = 1.0f;
     optClear.DepthStencil.Stencil = 0;
 
-    CHECK(m_d3dDevice->CreateCommittedResource(&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT),
-                                               D3D12_HEAP_FLAG_NONE,
-                                               &depthStencilDesc,
-                                               D3D12_RESOURCE_STATE_COMMON,
-                                               &optClear,
-                                               IID_PPV_ARGS(m_depthStencilBuffer.GetAddressOf())));
+    m_depthStencilBuffer = m_renderTargetHeap.createTexture(depthStencilDesc, D3D12_RESOURCE_STATE_COMMON, &optClear, L"DepthStencilBuffer");
 
     // Create depth stencil view
     D3D12_DEPTH_STENCIL_VIEW_DESC dsvDesc;
@@ -154,6 +192,7 @@ bool Framework::initialize()
 
     m_timeFromBegin = std::chrono::steady_clock::now();
     m_timeLastUpdate = std::chrono::steady_clock::now();
+    m_frameTimer.initialize(m_frameTimingHistory);
 
     return true;
 }
@@ -165,69 +204,211 @@ void Framework::setApplication(Application* application)
 
 void Framework::execute()
 {
-    while (m_running && !m_window.shouldClose())
+    execute(m_config.frameLimit);
+}
+
+void Framework::execute(int frameCount)
+{
+    assert(frameCount >= 0 || m_config.backend == Config::Backend::Windowed);
+
+    for (int frame = 0; frame != frameCount && m_running && !m_window.shouldClose(); ++frame)
     {
+        FW_PROFILE_SCOPE("Frame");
+        m_frameTimer.beginFrame();
         m_window.update();
         long long delta = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - m_timeLastUpdate).count();
         m_timeDelta = static_cast<float>(delta) / 1000000.0f;
         m_timeLastUpdate = std::chrono::steady_clock::now();
+        if (m_config.backend != Config::Backend::Windowed)
+        {
+            // Runs without a window are repeatable with a fixed step
+            m_timeDelta = c_fixedTimeDelta;
+        }
+        m_frameTimer.endStage(FrameTimer::Stage::Events);
         waitForFrame(m_currentFrameIndex);
-        m_app->update();
-        m_app->fillCommandList();
+        m_frameTimer.endStage(FrameTimer::Stage::FenceWait);
+        m_gpuProfiler.beginFrame(m_currentFrameIndex);
+        m_frameAllocator.beginFrame(m_currentFrameIndex);
+        m_descriptorHeap.beginFrame(m_currentFrameIndex);
+        {
+            FW_PROFILE_SCOPE("Update");
+            m_app->update();
+        }
+        m_frameTimer.endStage(FrameTimer::Stage::Update);
+        {
+            FW_PROFILE_SCOPE("Record");
+            m_app->fillCommandList();
+        }
+        m_frameTimer.endStage(FrameTimer::Stage::Record);
         render();
+        m_frameTimer.endStage(FrameTimer::Stage::Present);
         m_window.clearKeyStatus();
+        m_frameTimer.endFrame();
     }
 
-    for (int i = 0; i < m_swapChainBufferCount; ++i)
+    for (int i = 0; i < m_config.framesInFlight; ++i)
     {
         waitForFrame(i);
     }
+
+#ifdef FW_PROFILER_ENABLED
+    Profiler::writeChromeTrace(m_traceFilepath);
+#endif
+
+    if (m_config.backend != Config::Backend::Windowed)
+    {
+        printSummary();
+    }
 }
 
 void Framework::completeInitialization()
 {
+    FW_PROFILE_FUNCTION();
+    m_descriptorHeap.flushCopies();
     std::vector<ID3D12CommandList*> cmdsLists{m_commandList.Get()};
+    if (ID3D12CommandList* uploadCommandList = finishUploads(m_commandAllocator.Get()))
+    {
+        cmdsLists.push_back(uploadCommandList);
+    }
+    m_bufferHeap.endUploads();
     m_commandQueue->ExecuteCommandLists((UINT)cmdsLists.size(), cmdsLists.data());
     CHECK(m_commandQueue->Signal(m_fence.Get(), 1));
-    HANDLE eventHandle = CreateEventEx(nullptr, false, false, EVENT_ALL_ACCESS);
-    CHECK(m_fence->SetEventOnCompletion(1, eventHandle));
-    WaitForSingleObject(eventHandle, INFINITE);
-    CloseHandle(eventHandle);
+    m_uploadRing.submit(1);
+    waitForFence(1, m_frameEvents[m_currentFrameIndex]);
 }
 
 void Framework::waitForFrame(int frameIndex)
 {
-    if (m_fence->GetCompletedValue() <= m_fenceIds[frameIndex])
+    FW_PROFILE_FUNCTION();
+    waitForFence(m_fenceIds[frameIndex], m_frameEvents[frameIndex]);
+}
+
+bool Framework::isFrameComplete(int frameIndex) const
+{
+    return m_fence->GetCompletedValue() >= m_fenceIds[frameIndex];
+}
+
+void Framework::waitForFence(UINT64 fenceId, HANDLE eventHandle)
+{
+    if (m_fence->GetCompletedValue() < fenceId)
     {
-        HANDLE eventHandle = CreateEventEx(nullptr, false, false, EVENT_ALL_ACCESS);
-        CHECK(m_fence->SetEventOnCompletion(m_fenceIds[frameIndex], eventHandle));
+        CHECK(m_fence->SetEventOnCompletion(fenceId, eventHandle));
         WaitForSingleObject(eventHandle, INFINITE);
-        CloseHandle(eventHandle);
     }
 }
 
 void Framework::render()
 {
+    FW_PROFILE_FUNCTION();
+    m_descriptorHeap.flushCopies();
     std::vector<ID3D12CommandList*> cmdLists{m_commandList.Get()};
+    if (ID3D12CommandList* resolveCommandList = m_gpuProfiler.endFrame())
+    {
+        cmdLists.push_back(resolveCommandList);
+    }
     m_commandQueue->ExecuteCommandLists(static_cast<UINT>(cmdLists.size()), cmdLists.data());
 
-    CHECK(m_swapChain->Present(1, 0));
+    if (m_swapChain)
+    {
+        CHECK(m_swapChain->Present(m_config.vsync ? 1 : 0, 0));
+    }
 
     m_fenceIds[m_currentFrameIndex] = m_currentFenceId;
     CHECK(m_commandQueue->Signal(m_fence.Get(), m_currentFenceId));
+    m_uploadRing.submit(m_currentFenceId);
 
-    m_currentFrameIndex = (m_currentFrameIndex + 1) % m_swapChainBufferCount;
+    m_currentFrameIndex = (m_currentFrameIndex + 1) % m_config.framesInFlight;
+    m_currentBackBufferIndex = (m_currentBackBufferIndex + 1) % m_swapChainBufferCount;
     ++m_currentFenceId;
 }
 
+ID3D12CommandList* Framework::finishUploads(ID3D12CommandAllocator* commandAllocator)
+{
+    if (!m_bufferHeap.hasUnfinishedUploads())
+    {
+        return nullptr;
+    }
+
+    // The command list of the allocator is closed, so the allocator can record another one
+    CHECK(m_uploadCommandList->Reset(commandAllocator, nullptr));
+    m_bufferHeap.finishUploads(m_uploadCommandList.Get());
+    CHECK(m_uploadCommandList->Close());
+    return m_uploadCommandList.Get();
+}
+
+void Framework::createSwapChain()
+{
+    DXGI_SWAP_CHAIN_DESC swapChainDesc;
+    swapChainDesc.BufferDesc.Width = m_window.getWidth();
+    swapChainDesc.BufferDesc.Height = m_window.getHeight();
+    swapChainDesc.BufferDesc.RefreshRate.Numerator = 60;
+    swapChainDesc.BufferDesc.RefreshRate.Denominator = 1;
+    swapChainDesc.BufferDesc.Format = m_backBufferFormat;
+    swapChainDesc.BufferDesc.ScanlineOrdering = DXGI_MODE_SCANLINE_ORDER_UNSPECIFIED;
+    swapChainDesc.BufferDesc.Scaling = DXGI_MODE_SCALING_UNSPECIFIED;
+    swapChainDesc.SampleDesc.Count = 1;
+    swapChainDesc.SampleDesc.Quality = 0;
+    swapChainDesc.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
+    swapChainDesc.BufferCount = m_swapChainBufferCount;
+    swapChainDesc.OutputWindow = m_window.getNativeHandle();
+    swapChainDesc.Windowed = true;
+    swapChainDesc.SwapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD;
+    swapChainDesc.Flags = DXGI_SWAP_CHAIN_FLAG_ALLOW_MODE_SWITCH;
+
+    Microsoft::WRL::ComPtr<IDXGIFactory4> dxgiFactory;
+    CHECK(CreateDXGIFactory1(IID_PPV_ARGS(&dxgiFactory)));
+    CHECK(dxgiFactory->CreateSwapChain(m_commandQueue.Get(), &swapChainDesc, m_swapChain.GetAddressOf()));
+}
+
+void Framework::printFrameTimes() const
+{
+    std::cout << "Frame times of the last " << m_frameTimer.getFrameCount() << " frames in ms (p50 / p95 / p99)\n";
+    for (size_t i = 0; i < static_cast<size_t>(FrameTimer::Stage::Count); ++i)
+    {
+        const FrameTimer::Stage stage = static_cast<FrameTimer::Stage>(i);
+        const FrameTimer::Percentiles percentiles = m_frameTimer.getPercentiles(stage);
+        std::cout << FrameTimer::getStageName(stage) << ": " << percentiles.p50 << " / " << percentiles.p95 << " / " << percentiles.p99 << "\n";
+    }
+
+    std::cout << "GPU passes of the latest frame read back in ms\n";
+    for (const GpuProfiler::PassTiming& pass : m_gpuProfiler.getLatest())
+    {
+        std::cout << pass.name << ": " << pass.milliseconds << "\n";
+    }
+}
+
+void Framework::printSummary() const
+{
+    printFrameTimes();
+
+    const std::pair<const char*, HeapSuballocator::Stats> heaps[] = {{"Buffer heap", m_bufferHeap.getStats()},
+                                                                     {"Texture heap", m_textureHeap.getStats()},
+                                                                     {"Render target heap", m_renderTargetHeap.getStats()}};
+    for (const std::pair<const char*, HeapSuballocator::Stats>& heap : heaps)
+    {
+        std::cout << heap.first << ": " << heap.second.allocationCount << " allocations, " << heap.second.requestedSize << " / " << heap.second.size << " bytes in " << heap.second.heapCount << " heaps\n";
+    }
+    std::cout << "Upload ring: " << m_uploadRing.getUsedSize() << " / " << m_uploadRing.getSize() << " bytes\n";
+    std::cout << "Frame allocator: " << m_frameAllocator.getUsedSize() << " bytes in the last frame\n";
+    std::cout << "Descriptors: " << m_descriptorHeap.getAllocator().getAllocatedCount() << " / " << m_descriptorHeap.getAllocator().getPersistentCount() << " persistent\n";
+
+    Backend::Counters counters;
+    if (m_backend->getCounters(counters))
+    {
+        std::cout << "Null device: " << counters.resourceCount << " resources, " << counters.heapCount << " heaps, " << counters.allocatedSize << " bytes allocated\n";
+        std::cout << "Null device: " << counters.barrierCount << " barriers in " << counters.barrierCallCount << " calls, " << counters.drawCount << " draws, " << counters.dispatchCount
+                  << " dispatches in " << counters.executedCommandListCount << " executed command lists\n";
+    }
+}
+
 ID3D12Resource* Framework::getCurrentBackBuffer()
 {
-    return m_swapChainBuffers[m_currentFrameIndex].Get();
+    return m_swapChainBuffers[m_currentBackBufferIndex].Get();
 }
 
 CD3DX12_CPU_DESCRIPTOR_HANDLE Framework::getCurrentBackBufferView()
 {
-    return CD3DX12_CPU_DESCRIPTOR_HANDLE(m_rtvHeap->GetCPUDescriptorHandleForHeapStart(), m_currentFrameIndex, m_rtvDescriptorIncrementSize);
+    return CD3DX12_CPU_DESCRIPTOR_HANDLE(m_rtvHeap->GetCPUDescriptorHandleForHeapStart(), m_currentBackBufferIndex, m_rtvDescriptorIncrementSize);
 }
 
 } // namespace fw
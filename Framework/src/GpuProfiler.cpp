@@ -0,0 +1,150 @@
+#include "GpuProfiler.h"
+#include "Macros.h"
+
+#include "d3dx12.h"
+
+#include <windows.h>
+
+namespace
+{
+class D3D12TimestampCommandList : public fw::GpuTimestampQueries::CommandList
+{
+public:
+    D3D12TimestampCommandList(ID3D12GraphicsCommandList* commandList, ID3D12QueryHeap* queryHeap, ID3D12Resource* readbackBuffer) :
+        m_commandList(commandList),
+        m_queryHeap(queryHeap),
+        m_readbackBuffer(readbackBuffer)
+    {
+    }
+
+    void writeTimestamp(uint32_t query) override
+    {
+        m_commandList->EndQuery(m_queryHeap, D3D12_QUERY_TYPE_TIMESTAMP, query);
+    }
+
+    void resolve(uint32_t firstQuery, uint32_t queryCount) override
+    {
+        m_commandList->ResolveQueryData(m_queryHeap, D3D12_QUERY_TYPE_TIMESTAMP, firstQuery, queryCount, m_readbackBuffer, firstQuery * sizeof(uint64_t));
+    }
+
+private:
+    ID3D12GraphicsCommandList* m_commandList;
+    ID3D12QueryHeap* m_queryHeap;
+    ID3D12Resource* m_readbackBuffer;
+};
+
+int64_t toNanoseconds(int64_t ticks, UINT64 frequency)
+{
+    return static_cast<int64_t>(static_cast<double>(ticks) * 1000000000.0 / static_cast<double>(frequency));
+}
+} // namespace
+
+namespace fw
+{
+void GpuProfiler::initialize(ID3D12Device* device, ID3D12CommandQueue* commandQueue, uint32_t passesPerFrame, int frameCount)
+{
+    m_commandQueue = commandQueue;
+    m_queries.initialize(passesPerFrame, frameCount);
+    CHECK(m_commandQueue->GetTimestampFrequency(&m_timestampFrequency));
+
+    D3D12_QUERY_HEAP_DESC queryHeapDesc{};
+    queryHeapDesc.Type = D3D12_QUERY_HEAP_TYPE_TIMESTAMP;
+    queryHeapDesc.Count = m_queries.getQueryCount();
+    CHECK(device->CreateQueryHeap(&queryHeapDesc, IID_PPV_ARGS(&m_queryHeap)));
+    m_queryHeap->SetName(L"GpuProfilerQueryHeap");
+
+    CHECK(device->CreateCommittedResource(&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_READBACK),
+                                          D3D12_HEAP_FLAG_NONE,
+                                          &CD3DX12_RESOURCE_DESC::Buffer(m_queries.getQueryCount() * sizeof(uint64_t)),
+                                          D3D12_RESOURCE_STATE_COPY_DEST,
+                                          nullptr,
+                                          IID_PPV_ARGS(&m_readbackBuffer)));
+    m_readbackBuffer->SetName(L"GpuProfilerReadbackBuffer");
+    // The buffer stays mapped for its lifetime, a range is read only after the GPU is done with the frame that
+    // resolved into it
+    CHECK(m_readbackBuffer->Map(0, nullptr, reinterpret_cast<void**>(&m_timestamps)));
+
+    m_commandAllocators.resize(frameCount);
+    for (Microsoft::WRL::ComPtr<ID3D12CommandAllocator>& commandAllocator : m_commandAllocators)
+    {
+        CHECK(device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(commandAllocator.GetAddressOf())));
+    }
+    CHECK(device->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT, m_commandAllocators[0].Get(), nullptr, IID_PPV_ARGS(m_commandList.GetAddressOf())));
+    CHECK(m_commandList->Close());
+
+#ifdef FW_PROFILER_ENABLED
+    m_timeline = Profiler::createTimeline("GPU");
+#endif
+}
+
+void GpuProfiler::beginFrame(int frameIndex)
+{
+    m_currentFrameIndex = frameIndex;
+    const std::vector<GpuTimestampQueries::Pass>& passes = m_queries.beginFrame(frameIndex, m_timestamps);
+    if (passes.empty())
+    {
+        return;
+    }
+
+    m_latest.clear();
+    for (const GpuTimestampQueries::Pass& pass : passes)
+    {
+        const int64_t duration = toNanoseconds(static_cast<int64_t>(pass.end - pass.begin), m_timestampFrequency);
+        m_latest.push_back(PassTiming{pass.site->name, static_cast<float>(duration) / 1000000.0f});
+    }
+
+#ifdef FW_PROFILER_ENABLED
+    // Moves the GPU timestamps to the profiler time through a pair of GPU and CPU timestamps taken together
+    UINT64 gpuTimestamp = 0;
+    UINT64 cpuTimestamp = 0;
+    CHECK(m_commandQueue->GetClockCalibration(&gpuTimestamp, &cpuTimestamp));
+    const int64_t now = Profiler::now();
+    LARGE_INTEGER cpuNow;
+    LARGE_INTEGER cpuFrequency;
+    QueryPerformanceCounter(&cpuNow);
+    QueryPerformanceFrequency(&cpuFrequency);
+    const int64_t calibrationTime = now - toNanoseconds(cpuNow.QuadPart - static_cast<int64_t>(cpuTimestamp), cpuFrequency.QuadPart);
+
+    for (const GpuTimestampQueries::Pass& pass : passes)
+    {
+        const int64_t begin = calibrationTime + toNanoseconds(static_cast<int64_t>(pass.begin - gpuTimestamp), m_timestampFrequency);
+        const int64_t end = calibrationTime + toNanoseconds(static_cast<int64_t>(pass.end - gpuTimestamp), m_timestampFrequency);
+        Profiler::record(m_timeline, pass.site, begin, end);
+    }
+#endif
+}
+
+void GpuProfiler::beginPass(ID3D12GraphicsCommandList* commandList, const Profiler::Site* site)
+{
+    D3D12TimestampCommandList timestampCommandList(commandList, m_queryHeap.Get(), m_readbackBuffer.Get());
+    m_queries.beginPass(timestampCommandList, site);
+}
+
+void GpuProfiler::endPass(ID3D12GraphicsCommandList* commandList)
+{
+    D3D12TimestampCommandList timestampCommandList(commandList, m_queryHeap.Get(), m_readbackBuffer.Get());
+    m_queries.endPass(timestampCommandList);
+}
+
+ID3D12CommandList* GpuProfiler::endFrame()
+{
+    if (!m_queries.hasQueries())
+    {
+        return nullptr;
+    }
+
+    ID3D12CommandAllocator* commandAllocator = m_commandAllocators[m_currentFrameIndex].Get();
+    CHECK(commandAllocator->Reset());
+    CHECK(m_commandList->Reset(commandAllocator, nullptr));
+    D3D12TimestampCommandList timestampCommandList(m_commandList.Get(), m_queryHeap.Get(), m_readbackBuffer.Get());
+    m_queries.endFrame(timestampCommandList);
+    CHECK(m_commandList->Close());
+    return m_commandList.Get();
+}
+
+const std::vector<GpuProfiler::PassTiming>& GpuProfiler::getLatest() const
+{
+    return m_latest;
+}
+
+} // namespace fw
@@ -0,0 +1,92 @@
+#include "GpuTimestampQueries.h"
+
+#include <cassert>
+
+namespace fw
+{
+void GpuTimestampQueries::initialize(uint32_t passesPerFrame, int frameCount)
+{
+    assert(passesPerFrame > 0 && frameCount > 0);
+
+    // A begin and an end query for every pass
+    m_queriesPerFrame = passesPerFrame * 2;
+    m_frames.clear();
+    m_frames.resize(frameCount);
+    m_currentFrameIndex = 0;
+    m_openPasses.clear();
+    m_readPasses.clear();
+}
+
+uint32_t GpuTimestampQueries::getQueryCount() const
+{
+    return m_queriesPerFrame * static_cast<uint32_t>(m_frames.size());
+}
+
+const std::vector<GpuTimestampQueries::Pass>& GpuTimestampQueries::beginFrame(int frameIndex, const uint64_t* timestamps)
+{
+    assert(m_openPasses.empty());
+
+    m_currentFrameIndex = frameIndex;
+    Frame& frame = m_frames[frameIndex];
+
+    m_readPasses.clear();
+    if (frame.resolved)
+    {
+        for (const PendingPass& pass : frame.passes)
+        {
+            m_readPasses.push_back(Pass{pass.site, timestamps[pass.beginQuery], timestamps[pass.endQuery]});
+        }
+    }
+
+    frame.passes.clear();
+    frame.queryCount = 0;
+    frame.resolved = false;
+    return m_readPasses;
+}
+
+void GpuTimestampQueries::beginPass(CommandList& commandList, const Profiler::Site* site)
+{
+    Frame& frame = m_frames[m_currentFrameIndex];
+    if (frame.queryCount + 2 > m_queriesPerFrame)
+    {
+        m_openPasses.push_back(c_untimedPass);
+        return;
+    }
+
+    const uint32_t firstQuery = static_cast<uint32_t>(m_currentFrameIndex) * m_queriesPerFrame + frame.queryCount;
+    frame.queryCount += 2;
+    m_openPasses.push_back(static_cast<uint32_t>(frame.passes.size()));
+    frame.passes.push_back(PendingPass{site, firstQuery, firstQuery + 1});
+    commandList.writeTimestamp(firstQuery);
+}
+
+void GpuTimestampQueries::endPass(CommandList& commandList)
+{
+    assert(!m_openPasses.empty());
+
+    const uint32_t passIndex = m_openPasses.back();
+    m_openPasses.pop_back();
+    if (passIndex != c_untimedPass)
+    {
+        commandList.writeTimestamp(m_frames[m_currentFrameIndex].passes[passIndex].endQuery);
+    }
+}
+
+bool GpuTimestampQueries::hasQueries() const
+{
+    return m_frames[m_currentFrameIndex].queryCount > 0;
+}
+
+void GpuTimestampQueries::endFrame(CommandList& commandList)
+{
+    assert(m_openPasses.empty());
+
+    Frame& frame = m_frames[m_currentFrameIndex];
+    if (frame.queryCount > 0)
+    {
+        commandList.resolve(static_cast<uint32_t>(m_currentFrameIndex) * m_queriesPerFrame, frame.queryCount);
+        frame.resolved = true;
+    }
+}
+
+} // namespace fw
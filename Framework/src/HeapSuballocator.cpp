@@ -0,0 +1,189 @@
+#include "HeapSuballocator.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace fw
+{
+void HeapSuballocator::Stats::add(const Stats& stats)
+{
+    heapCount += stats.heapCount;
+    allocationCount += stats.allocationCount;
+    size += stats.size;
+    allocatedSize += stats.allocatedSize;
+    requestedSize += stats.requestedSize;
+    freeSize += stats.freeSize;
+    largestFreeBlock = std::max(largestFreeBlock, stats.largestFreeBlock);
+}
+
+float HeapSuballocator::Stats::getUtilization() const
+{
+    return size > 0 ? static_cast<float>(requestedSize) / static_cast<float>(size) : 0.0f;
+}
+
+float HeapSuballocator::Stats::getInternalFragmentation() const
+{
+    return allocatedSize > 0 ? 1.0f - static_cast<float>(requestedSize) / static_cast<float>(allocatedSize) : 0.0f;
+}
+
+float HeapSuballocator::Stats::getExternalFragmentation() const
+{
+    return freeSize > 0 ? 1.0f - static_cast<float>(largestFreeBlock) / static_cast<float>(freeSize) : 0.0f;
+}
+
+void HeapSuballocator::initialize(uint64_t size, uint64_t pageSize, uint64_t minSizeClass)
+{
+    assert(minSizeClass < pageSize);
+
+    m_buddyAllocator.initialize(size, pageSize);
+    m_pageSize = pageSize;
+    m_minSizeClass = minSizeClass;
+    m_partialPages.clear();
+    m_partialPages.resize(getSizeClass(pageSize / 2) + 1);
+    m_pages.clear();
+    m_allocations.clear();
+    m_requestedSize = 0;
+    m_slotSize = 0;
+}
+
+uint64_t HeapSuballocator::allocate(uint64_t size, uint64_t alignment)
+{
+    if (size == 0)
+    {
+        return c_invalidOffset;
+    }
+
+    const uint64_t allocationSize = getAllocationSize(size, alignment);
+    const uint64_t offset = allocationSize < m_pageSize ? allocateSlot(getSizeClass(allocationSize)) : m_buddyAllocator.allocate(size, alignment);
+    if (offset != c_invalidOffset)
+    {
+        m_allocations[offset] = size;
+        m_requestedSize += size;
+    }
+    return offset;
+}
+
+void HeapSuballocator::free(uint64_t offset)
+{
+    auto allocation = m_allocations.find(offset);
+    assert(allocation != m_allocations.end());
+    m_requestedSize -= allocation->second;
+    m_allocations.erase(allocation);
+
+    // Blocks are at least a page, so an offset in a page of slots is a slot
+    const uint64_t pageOffset = offset & ~(m_pageSize - 1);
+    auto page = m_pages.find(pageOffset);
+    if (page != m_pages.end())
+    {
+        freeSlot(pageOffset, page->second, offset);
+    }
+    else
+    {
+        m_buddyAllocator.free(offset);
+    }
+}
+
+uint64_t HeapSuballocator::getAllocationSize(uint64_t size, uint64_t alignment) const
+{
+    const uint64_t blockSize = m_buddyAllocator.getBlockSize(size, alignment);
+    if (blockSize > m_pageSize)
+    {
+        return blockSize;
+    }
+
+    uint64_t slotSize = std::max(m_minSizeClass, alignment);
+    while (slotSize < size)
+    {
+        slotSize <<= 1;
+    }
+    return slotSize;
+}
+
+HeapSuballocator::Stats HeapSuballocator::getStats() const
+{
+    Stats stats;
+    stats.heapCount = 1;
+    stats.allocationCount = static_cast<uint32_t>(m_allocations.size());
+    stats.size = m_buddyAllocator.getSize();
+    stats.allocatedSize = m_buddyAllocator.getAllocatedSize() - m_pages.size() * m_pageSize + m_slotSize;
+    stats.requestedSize = m_requestedSize;
+    stats.freeSize = m_buddyAllocator.getSize() - m_buddyAllocator.getAllocatedSize();
+    stats.largestFreeBlock = m_buddyAllocator.getLargestFreeBlock();
+    return stats;
+}
+
+uint32_t HeapSuballocator::getSizeClass(uint64_t slotSize) const
+{
+    uint32_t sizeClass = 0;
+    while ((m_minSizeClass << sizeClass) < slotSize)
+    {
+        ++sizeClass;
+    }
+    return sizeClass;
+}
+
+uint64_t HeapSuballocator::getSlotSize(uint32_t sizeClass) const
+{
+    return m_minSizeClass << sizeClass;
+}
+
+uint64_t HeapSuballocator::allocateSlot(uint32_t sizeClass)
+{
+    const uint64_t slotSize = getSlotSize(sizeClass);
+    std::vector<uint64_t>& partialPages = m_partialPages[sizeClass];
+    if (partialPages.empty())
+    {
+        const uint64_t pageOffset = m_buddyAllocator.allocate(m_pageSize, m_pageSize);
+        if (pageOffset == c_invalidOffset)
+        {
+            return c_invalidOffset;
+        }
+
+        // Slots are handed out from the start of the page
+        Page page{sizeClass, 0, {}};
+        const uint32_t slotCount = static_cast<uint32_t>(m_pageSize / slotSize);
+        for (uint32_t slot = slotCount; slot > 0; --slot)
+        {
+            page.freeSlots.push_back(slot - 1);
+        }
+        m_pages.emplace(pageOffset, std::move(page));
+        partialPages.push_back(pageOffset);
+    }
+
+    const uint64_t pageOffset = partialPages.back();
+    Page& page = m_pages.at(pageOffset);
+    const uint32_t slot = page.freeSlots.back();
+    page.freeSlots.pop_back();
+    ++page.usedSlotCount;
+    if (page.freeSlots.empty())
+    {
+        partialPages.pop_back();
+    }
+
+    m_slotSize += slotSize;
+    return pageOffset + slot * slotSize;
+}
+
+void HeapSuballocator::freeSlot(uint64_t pageOffset, Page& page, uint64_t offset)
+{
+    const uint64_t slotSize = getSlotSize(page.sizeClass);
+    std::vector<uint64_t>& partialPages = m_partialPages[page.sizeClass];
+    m_slotSize -= slotSize;
+
+    if (page.freeSlots.empty())
+    {
+        partialPages.push_back(pageOffset);
+    }
+    page.freeSlots.push_back(static_cast<uint32_t>((offset - pageOffset) / slotSize));
+    --page.usedSlotCount;
+
+    // Empty pages go back to the buddy allocator so that other size classes and blocks can use them
+    if (page.usedSlotCount == 0)
+    {
+        partialPages.erase(std::find(partialPages.begin(), partialPages.end(), pageOffset));
+        m_pages.erase(pageOffset);
+        m_buddyAllocator.free(pageOffset);
+    }
+}
+
+} // namespace fw
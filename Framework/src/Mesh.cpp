@@ -2,13 +2,49 @@
 
 namespace fw
 {
+void Mesh::setVertices(Span<const Vertex> vertices)
+{
+    const Vertex* data = vertices.data();
+    const size_t count = vertices.size();
+    vertexLayout = VertexLayout::Interleaved;
+    positions = StridedSpan<const DirectX::XMFLOAT3>(&data->position, count, sizeof(Vertex));
+    normals = StridedSpan<const DirectX::XMFLOAT3>(&data->normal, count, sizeof(Vertex));
+    tangents = StridedSpan<const DirectX::XMFLOAT3>(&data->tangent, count, sizeof(Vertex));
+    uvs = StridedSpan<const DirectX::XMFLOAT2>(&data->uv, count, sizeof(Vertex));
+
+    VertexStream stream;
+    stream.data = Span<const unsigned char>(reinterpret_cast<const unsigned char*>(data), vertices.sizeInBytes());
+    stream.stride = sizeof(Vertex);
+    vertexStreams[0] = stream;
+    vertexStreamCount = 1;
+}
+
+size_t Mesh::getVertexCount() const
+{
+    return positions.size();
+}
+
+Span<const Mesh::VertexStream> Mesh::getVertexStreams() const
+{
+    return Span<const VertexStream>(vertexStreams, vertexStreamCount);
+}
+
+Span<const Mesh::Vertex> Mesh::getInterleavedVertices() const
+{
+    if (vertexLayout != VertexLayout::Interleaved || vertexStreamCount == 0)
+    {
+        return Span<const Vertex>();
+    }
+    return Span<const Vertex>(reinterpret_cast<const Vertex*>(vertexStreams[0].data.data()), positions.size());
+}
+
 Mesh::Vertices Mesh::getVertices() const
 {
     Vertices vertices;
     vertices.reserve(positions.size());
-    for (unsigned int i = 0; i < positions.size(); ++i)
+    for (size_t i = 0; i < positions.size(); ++i)
     {
-        Vertex v;
+        Vertex v{};
         v.position = positions[i];
         v.normal = normals[i];
 
@@ -26,14 +62,77 @@ Mesh::Vertices Mesh::getVertices() const
     return vertices;
 }
 
+size_t Mesh::getIndexCount() const
+{
+    return indexType == IndexType::UInt16 ? indices16.size() : indices32.size();
+}
+
+size_t Mesh::getIndexSize() const
+{
+    return indexType == IndexType::UInt16 ? sizeof(uint16_t) : sizeof(uint32_t);
+}
+
+const void* Mesh::getIndexData() const
+{
+    return indexType == IndexType::UInt16 ? static_cast<const void*>(indices16.data()) : static_cast<const void*>(indices32.data());
+}
+
+size_t Mesh::getIndexDataSize() const
+{
+    return getIndexCount() * getIndexSize();
+}
+
+uint32_t Mesh::getIndex(size_t i) const
+{
+    return indexType == IndexType::UInt16 ? indices16[i] : indices32[i];
+}
+
+size_t Mesh::getLodCount() const
+{
+    return lods.empty() ? 1 : lods.size();
+}
+
+MeshLod Mesh::getLod(size_t level) const
+{
+    if (lods.empty())
+    {
+        return MeshLod{0, static_cast<uint32_t>(getIndexCount()), 0.0f, 0};
+    }
+    return lods[level];
+}
+
+size_t Mesh::selectLod(float maxError) const
+{
+    size_t level = 0;
+    while (level + 1 < lods.size() && lods[level + 1].error <= maxError)
+    {
+        ++level;
+    }
+    return level;
+}
+
 std::string Mesh::getFirstTextureOfType(aiTextureType type) const
 {
-    auto typeIter = textureNames.find(type);
-    if (typeIter != textureNames.end() && !typeIter->second.empty())
+    for (const TextureReference& texture : textures)
     {
-        return typeIter->second.front();
+        if (texture.type == type)
+        {
+            return std::string(texture.name.data(), texture.name.size());
+        }
     }
     return "";
 }
 
+int Mesh::getFirstTextureIndexOfType(aiTextureType type) const
+{
+    for (const TextureReference& texture : textures)
+    {
+        if (texture.type == type)
+        {
+            return texture.textureIndex;
+        }
+    }
+    return -1;
+}
+
 } // namespace fw
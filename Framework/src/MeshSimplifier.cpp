@@ -0,0 +1,387 @@
+#include "MeshSimplifier.h"
+#include "Mesh.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+
+namespace
+{
+const double c_normalWeight = 1.0;
+
+struct Quadric
+{
+    double a00 = 0.0;
+    double a11 = 0.0;
+    double a22 = 0.0;
+    double a01 = 0.0;
+    double a02 = 0.0;
+    double a12 = 0.0;
+    double b0 = 0.0;
+    double b1 = 0.0;
+    double b2 = 0.0;
+    double c = 0.0;
+    double weight = 0.0;
+
+    void addPlane(double nx, double ny, double nz, double d, double w)
+    {
+        a00 += w * nx * nx;
+        a11 += w * ny * ny;
+        a22 += w * nz * nz;
+        a01 += w * nx * ny;
+        a02 += w * nx * nz;
+        a12 += w * ny * nz;
+        b0 += w * nx * d;
+        b1 += w * ny * d;
+        b2 += w * nz * d;
+        c += w * d * d;
+        weight += w;
+    }
+
+    void add(const Quadric& q)
+    {
+        a00 += q.a00;
+        a11 += q.a11;
+        a22 += q.a22;
+        a01 += q.a01;
+        a02 += q.a02;
+        a12 += q.a12;
+        b0 += q.b0;
+        b1 += q.b1;
+        b2 += q.b2;
+        c += q.c;
+        weight += q.weight;
+    }
+
+    // Weighted mean of the squared distances to the planes
+    double evaluate(const DirectX::XMFLOAT3& p) const
+    {
+        const double x = p.x;
+        const double y = p.y;
+        const double z = p.z;
+        const double error = x * x * a00 + y * y * a11 + z * z * a22
+            + 2.0 * (x * y * a01 + x * z * a02 + y * z * a12)
+            + 2.0 * (x * b0 + y * b1 + z * b2)
+            + c;
+        return weight > 0.0 ? std::fabs(error) / weight : 0.0;
+    }
+};
+
+struct Collapse
+{
+    uint32_t from;
+    uint32_t to;
+    double cost;
+};
+
+struct PositionKey
+{
+    float x;
+    float y;
+    float z;
+
+    bool operator==(const PositionKey& other) const
+    {
+        return x == other.x && y == other.y && z == other.z;
+    }
+};
+
+struct PositionKeyHash
+{
+    size_t operator()(const PositionKey& key) const
+    {
+        uint32_t bits[3];
+        std::memcpy(bits, &key, sizeof(bits));
+        return (bits[0] * 73856093u) ^ (bits[1] * 19349663u) ^ (bits[2] * 83492791u);
+    }
+};
+
+DirectX::XMFLOAT3 subtract(const DirectX::XMFLOAT3& a, const DirectX::XMFLOAT3& b)
+{
+    return DirectX::XMFLOAT3(a.x - b.x, a.y - b.y, a.z - b.z);
+}
+
+DirectX::XMFLOAT3 cross(const DirectX::XMFLOAT3& a, const DirectX::XMFLOAT3& b)
+{
+    return DirectX::XMFLOAT3(a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x);
+}
+
+float dot(const DirectX::XMFLOAT3& a, const DirectX::XMFLOAT3& b)
+{
+    return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+DirectX::XMFLOAT3 getFaceNormal(const DirectX::XMFLOAT3& p0, const DirectX::XMFLOAT3& p1, const DirectX::XMFLOAT3& p2)
+{
+    return cross(subtract(p1, p0), subtract(p2, p0));
+}
+
+uint64_t getEdgeKey(uint32_t a, uint32_t b)
+{
+    return a < b ? (uint64_t(a) << 32) | b : (uint64_t(b) << 32) | a;
+}
+
+// Triangles around each vertex in compressed rows
+struct Adjacency
+{
+    std::vector<uint32_t> offsets;
+    std::vector<uint32_t> triangles;
+
+    void build(const std::vector<uint32_t>& indices, size_t vertexCount)
+    {
+        offsets.assign(vertexCount + 1, 0);
+        for (uint32_t index : indices)
+        {
+            ++offsets[index + 1];
+        }
+        for (size_t i = 0; i < vertexCount; ++i)
+        {
+            offsets[i + 1] += offsets[i];
+        }
+
+        triangles.resize(indices.size());
+        std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+        for (size_t i = 0; i < indices.size(); ++i)
+        {
+            triangles[fill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+        }
+    }
+};
+} // namespace
+
+namespace fw
+{
+float MeshSimplifier::simplify(const Mesh& mesh,
+                               const std::vector<uint32_t>& indices,
+                               size_t targetIndexCount,
+                               std::vector<uint32_t>& result)
+{
+    result = indices;
+    const size_t vertexCount = mesh.getVertexCount();
+    const StridedSpan<const DirectX::XMFLOAT3>& positions = mesh.positions;
+    const StridedSpan<const DirectX::XMFLOAT3>& normals = mesh.normals;
+
+    // Vertices that share a position but differ in other attributes lie on a seam
+    std::vector<uint32_t> positionRoot(vertexCount);
+    std::vector<uint32_t> wedgeCount(vertexCount, 0);
+    std::unordered_map<PositionKey, uint32_t, PositionKeyHash> roots;
+    roots.reserve(vertexCount);
+    for (uint32_t v = 0; v < vertexCount; ++v)
+    {
+        const PositionKey key{positions[v].x, positions[v].y, positions[v].z};
+        positionRoot[v] = roots.emplace(key, v).first->second;
+        ++wedgeCount[positionRoot[v]];
+    }
+
+    std::vector<char> locked(vertexCount, 0);
+    for (uint32_t v = 0; v < vertexCount; ++v)
+    {
+        locked[v] = wedgeCount[positionRoot[v]] > 1 ? 1 : 0;
+    }
+
+    // Edges with other than two faces are borders or non-manifold
+    std::unordered_map<uint64_t, uint32_t> edgeFaces;
+    edgeFaces.reserve(indices.size());
+    for (size_t i = 0; i < indices.size(); i += 3)
+    {
+        for (size_t e = 0; e < 3; ++e)
+        {
+            ++edgeFaces[getEdgeKey(positionRoot[indices[i + e]], positionRoot[indices[i + (e + 1) % 3]])];
+        }
+    }
+    for (size_t i = 0; i < indices.size(); i += 3)
+    {
+        for (size_t e = 0; e < 3; ++e)
+        {
+            const uint32_t a = indices[i + e];
+            const uint32_t b = indices[i + (e + 1) % 3];
+            if (edgeFaces[getEdgeKey(positionRoot[a], positionRoot[b])] != 2)
+            {
+                locked[a] = 1;
+                locked[b] = 1;
+            }
+        }
+    }
+
+    std::vector<Quadric> quadrics(vertexCount);
+    for (size_t i = 0; i < indices.size(); i += 3)
+    {
+        const DirectX::XMFLOAT3& p0 = positions[indices[i + 0]];
+        const DirectX::XMFLOAT3 normal = getFaceNormal(p0, positions[indices[i + 1]], positions[indices[i + 2]]);
+        const double length = std::sqrt(double(dot(normal, normal)));
+        if (length == 0.0)
+        {
+            continue;
+        }
+        const double nx = normal.x / length;
+        const double ny = normal.y / length;
+        const double nz = normal.z / length;
+        const double d = -(nx * p0.x + ny * p0.y + nz * p0.z);
+        const double area = length * 0.5;
+        for (size_t corner = 0; corner < 3; ++corner)
+        {
+            quadrics[positionRoot[indices[i + corner]]].addPlane(nx, ny, nz, d, area);
+        }
+    }
+
+    Adjacency adjacency;
+    std::vector<Collapse> collapses;
+    std::vector<uint32_t> collapseTarget(vertexCount);
+    std::vector<char> touched(vertexCount);
+    double maxError = 0.0;
+
+    auto flipsFace = [&](uint32_t from, uint32_t to) {
+        for (uint32_t t = adjacency.offsets[from]; t < adjacency.offsets[from + 1]; ++t)
+        {
+            const uint32_t* triangle = &result[adjacency.triangles[t] * 3];
+            if (triangle[0] == to || triangle[1] == to || triangle[2] == to)
+            {
+                continue;
+            }
+            const DirectX::XMFLOAT3 oldNormal = getFaceNormal(positions[triangle[0]], positions[triangle[1]], positions[triangle[2]]);
+            const DirectX::XMFLOAT3 newNormal = getFaceNormal(positions[triangle[0] == from ? to : triangle[0]],
+                                                              positions[triangle[1] == from ? to : triangle[1]],
+                                                              positions[triangle[2] == from ? to : triangle[2]]);
+            if (dot(oldNormal, newNormal) <= 0.0f)
+            {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    auto addCollapse = [&](uint32_t from, uint32_t to) {
+        if (locked[from] || from == to)
+        {
+            return;
+        }
+        Quadric quadric = quadrics[positionRoot[from]];
+        quadric.add(quadrics[positionRoot[to]]);
+        double cost = quadric.evaluate(positions[to]);
+        if (!normals.empty())
+        {
+            const DirectX::XMFLOAT3 edge = subtract(positions[to], positions[from]);
+            cost += c_normalWeight * (1.0 - dot(normals[from], normals[to])) * dot(edge, edge);
+        }
+        collapses.push_back({from, to, cost});
+    };
+
+    while (result.size() > targetIndexCount)
+    {
+        adjacency.build(result, vertexCount);
+
+        collapses.clear();
+        for (size_t i = 0; i < result.size(); i += 3)
+        {
+            for (size_t e = 0; e < 3; ++e)
+            {
+                const uint32_t a = result[i + e];
+                const uint32_t b = result[i + (e + 1) % 3];
+                addCollapse(a, b);
+                addCollapse(b, a);
+            }
+        }
+
+        std::sort(collapses.begin(), collapses.end(), [](const Collapse& a, const Collapse& b) { return a.cost < b.cost; });
+
+        for (uint32_t v = 0; v < vertexCount; ++v)
+        {
+            collapseTarget[v] = v;
+        }
+        std::fill(touched.begin(), touched.end(), 0);
+
+        // Collapses in one pass must not share faces, each one removes about two faces
+        const size_t removeLimit = (result.size() - targetIndexCount) / 3;
+        size_t removedFaces = 0;
+        size_t appliedCollapses = 0;
+        for (const Collapse& collapse : collapses)
+        {
+            if (removedFaces >= removeLimit)
+            {
+                break;
+            }
+            if (touched[collapse.from] || touched[collapse.to] || flipsFace(collapse.from, collapse.to))
+            {
+                continue;
+            }
+
+            collapseTarget[collapse.from] = collapse.to;
+            quadrics[positionRoot[collapse.to]].add(quadrics[positionRoot[collapse.from]]);
+            maxError = std::max(maxError, collapse.cost);
+            ++appliedCollapses;
+
+            for (uint32_t t = adjacency.offsets[collapse.from]; t < adjacency.offsets[collapse.from + 1]; ++t)
+            {
+                const uint32_t* triangle = &result[adjacency.triangles[t] * 3];
+                removedFaces += (triangle[0] == collapse.to || triangle[1] == collapse.to || triangle[2] == collapse.to) ? 1 : 0;
+                touched[triangle[0]] = 1;
+                touched[triangle[1]] = 1;
+                touched[triangle[2]] = 1;
+            }
+        }
+
+        if (appliedCollapses == 0)
+        {
+            break;
+        }
+
+        size_t writeIndex = 0;
+        for (size_t i = 0; i < result.size(); i += 3)
+        {
+            const uint32_t a = collapseTarget[result[i + 0]];
+            const uint32_t b = collapseTarget[result[i + 1]];
+            const uint32_t c = collapseTarget[result[i + 2]];
+            if (a != b && b != c && a != c)
+            {
+                result[writeIndex++] = a;
+                result[writeIndex++] = b;
+                result[writeIndex++] = c;
+            }
+        }
+        result.resize(writeIndex);
+    }
+
+    return static_cast<float>(std::sqrt(maxError));
+}
+
+void MeshSimplifier::buildLodChain(const Mesh& mesh,
+                                   const std::vector<float>& ratios,
+                                   std::vector<MeshLod>& lods,
+                                   std::vector<uint32_t>& indices)
+{
+    indices.resize(mesh.getIndexCount());
+    for (size_t i = 0; i < indices.size(); ++i)
+    {
+        indices[i] = mesh.getIndex(i);
+    }
+
+    lods.assign(1, MeshLod{0, static_cast<uint32_t>(indices.size()), 0.0f, 0});
+
+    const size_t triangleCount = indices.size() / 3;
+    std::vector<uint32_t> current = indices;
+    std::vector<uint32_t> simplified;
+    float error = 0.0f;
+    for (float ratio : ratios)
+    {
+        const size_t targetIndexCount = static_cast<size_t>(triangleCount * ratio) * 3;
+        if (targetIndexCount >= current.size())
+        {
+            continue;
+        }
+
+        // Every level is simplified from the previous one so the errors add up
+        const float levelError = simplify(mesh, current, targetIndexCount, simplified);
+        if (simplified.size() == current.size())
+        {
+            break;
+        }
+        error += levelError;
+
+        lods.push_back(MeshLod{static_cast<uint32_t>(indices.size()), static_cast<uint32_t>(simplified.size()), error, 0});
+        indices.insert(indices.end(), simplified.begin(), simplified.end());
+        current.swap(simplified);
+    }
+}
+
+} // namespace fw
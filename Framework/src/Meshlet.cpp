@@ -0,0 +1,193 @@
+#include "Meshlet.h"
+#include "Mesh.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+const uint8_t c_unusedVertex = 0xff;
+
+DirectX::XMFLOAT3 subtract(const DirectX::XMFLOAT3& a, const DirectX::XMFLOAT3& b)
+{
+    return DirectX::XMFLOAT3(a.x - b.x, a.y - b.y, a.z - b.z);
+}
+
+DirectX::XMFLOAT3 cross(const DirectX::XMFLOAT3& a, const DirectX::XMFLOAT3& b)
+{
+    return DirectX::XMFLOAT3(a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x);
+}
+
+float dot(const DirectX::XMFLOAT3& a, const DirectX::XMFLOAT3& b)
+{
+    return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+float length(const DirectX::XMFLOAT3& v)
+{
+    return std::sqrt(dot(v, v));
+}
+
+// Ritter's bounding sphere
+void computeBoundingSphere(const fw::Mesh& mesh, const uint32_t* vertices, uint32_t vertexCount, fw::MeshletBounds& bounds)
+{
+    const fw::StridedSpan<const DirectX::XMFLOAT3>& positions = mesh.positions;
+
+    auto findFarthest = [&](const DirectX::XMFLOAT3& from) {
+        DirectX::XMFLOAT3 farthest = from;
+        float maxDistance = 0.0f;
+        for (uint32_t i = 0; i < vertexCount; ++i)
+        {
+            const float distance = length(subtract(positions[vertices[i]], from));
+            if (distance > maxDistance)
+            {
+                maxDistance = distance;
+                farthest = positions[vertices[i]];
+            }
+        }
+        return farthest;
+    };
+
+    const DirectX::XMFLOAT3 a = findFarthest(positions[vertices[0]]);
+    const DirectX::XMFLOAT3 b = findFarthest(a);
+    DirectX::XMFLOAT3 center((a.x + b.x) * 0.5f, (a.y + b.y) * 0.5f, (a.z + b.z) * 0.5f);
+    float radius = length(subtract(b, a)) * 0.5f;
+
+    for (uint32_t i = 0; i < vertexCount; ++i)
+    {
+        const DirectX::XMFLOAT3 offset = subtract(positions[vertices[i]], center);
+        const float distance = length(offset);
+        if (distance > radius)
+        {
+            const float newRadius = (radius + distance) * 0.5f;
+            const float shift = (newRadius - radius) / distance;
+            center = DirectX::XMFLOAT3(center.x + offset.x * shift, center.y + offset.y * shift, center.z + offset.z * shift);
+            radius = newRadius;
+        }
+    }
+
+    bounds.center = center;
+    bounds.radius = radius;
+}
+
+// Cone around the average face normal that contains all the face normals
+void computeNormalCone(const fw::Mesh& mesh, const uint32_t* vertices, const uint8_t* triangles, uint32_t triangleCount, fw::MeshletBounds& bounds)
+{
+    const fw::StridedSpan<const DirectX::XMFLOAT3>& positions = mesh.positions;
+
+    auto getFaceNormal = [&](uint32_t triangle) {
+        const DirectX::XMFLOAT3& p0 = positions[vertices[triangles[triangle * 3 + 0]]];
+        const DirectX::XMFLOAT3& p1 = positions[vertices[triangles[triangle * 3 + 1]]];
+        const DirectX::XMFLOAT3& p2 = positions[vertices[triangles[triangle * 3 + 2]]];
+        DirectX::XMFLOAT3 normal = cross(subtract(p1, p0), subtract(p2, p0));
+        const float normalLength = length(normal);
+        if (normalLength > 0.0f)
+        {
+            normal = DirectX::XMFLOAT3(normal.x / normalLength, normal.y / normalLength, normal.z / normalLength);
+        }
+        return normal;
+    };
+
+    DirectX::XMFLOAT3 axis(0.0f, 0.0f, 0.0f);
+    for (uint32_t i = 0; i < triangleCount; ++i)
+    {
+        const DirectX::XMFLOAT3 normal = getFaceNormal(i);
+        axis = DirectX::XMFLOAT3(axis.x + normal.x, axis.y + normal.y, axis.z + normal.z);
+    }
+
+    bounds.coneAxis = DirectX::XMFLOAT3(0.0f, 0.0f, 0.0f);
+    bounds.coneCutoff = 1.0f;
+
+    const float axisLength = length(axis);
+    if (axisLength == 0.0f)
+    {
+        return;
+    }
+    axis = DirectX::XMFLOAT3(axis.x / axisLength, axis.y / axisLength, axis.z / axisLength);
+
+    float minDot = 1.0f;
+    for (uint32_t i = 0; i < triangleCount; ++i)
+    {
+        const DirectX::XMFLOAT3 normal = getFaceNormal(i);
+        if (dot(normal, normal) > 0.0f)
+        {
+            minDot = std::min(minDot, dot(normal, axis));
+        }
+    }
+
+    bounds.coneAxis = axis;
+    // Cones wider than a hemisphere can not be used for culling
+    if (minDot > 0.0f)
+    {
+        bounds.coneCutoff = std::sqrt(1.0f - minDot * minDot);
+    }
+}
+} // namespace
+
+namespace fw
+{
+void MeshletBuilder::build(const Mesh& mesh, MeshletData& data)
+{
+    data = MeshletData();
+
+    const MeshLod lod = mesh.getLod(0);
+    const size_t triangleCount = lod.indexCount / 3;
+    std::vector<uint8_t> localIndices(mesh.getVertexCount(), c_unusedVertex);
+
+    Meshlet meshlet{};
+    auto finishMeshlet = [&]() {
+        const uint32_t* vertices = data.vertices.data() + meshlet.vertexOffset;
+        const uint8_t* triangles = data.triangles.data() + meshlet.triangleOffset;
+        for (uint32_t i = 0; i < meshlet.vertexCount; ++i)
+        {
+            localIndices[vertices[i]] = c_unusedVertex;
+        }
+
+        MeshletBounds bounds{};
+        computeBoundingSphere(mesh, vertices, meshlet.vertexCount, bounds);
+        computeNormalCone(mesh, vertices, triangles, meshlet.triangleCount, bounds);
+
+        data.meshlets.push_back(meshlet);
+        data.bounds.push_back(bounds);
+
+        meshlet = Meshlet{};
+        meshlet.vertexOffset = static_cast<uint32_t>(data.vertices.size());
+        meshlet.triangleOffset = static_cast<uint32_t>(data.triangles.size());
+    };
+
+    for (size_t triangle = 0; triangle < triangleCount; ++triangle)
+    {
+        const size_t first = lod.indexOffset + triangle * 3;
+        const uint32_t indices[] = {mesh.getIndex(first + 0), mesh.getIndex(first + 1), mesh.getIndex(first + 2)};
+
+        // Repeated vertices of degenerate triangles are counted twice, which only ends the meshlet early
+        uint32_t newVertices = 0;
+        for (uint32_t index : indices)
+        {
+            newVertices += localIndices[index] == c_unusedVertex ? 1 : 0;
+        }
+
+        if (meshlet.vertexCount + newVertices > c_maxVertices || meshlet.triangleCount == c_maxTriangles)
+        {
+            finishMeshlet();
+        }
+
+        for (uint32_t index : indices)
+        {
+            if (localIndices[index] == c_unusedVertex)
+            {
+                localIndices[index] = static_cast<uint8_t>(meshlet.vertexCount++);
+                data.vertices.push_back(index);
+            }
+            data.triangles.push_back(localIndices[index]);
+        }
+        ++meshlet.triangleCount;
+    }
+
+    if (meshlet.triangleCount > 0)
+    {
+        finishMeshlet();
+    }
+}
+
+} // namespace fw
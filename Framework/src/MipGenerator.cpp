@@ -0,0 +1,424 @@
+#include "MipGenerator.h"
+#include "Profiler.h"
+#include "ThreadPool.h"
+
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+const uint32_t c_channelCount = 4;
+// Pixels filtered by one job
+const size_t c_pixelsPerTile = 16384;
+
+// Support and shape of the Kaiser filter, the width is in pixels of the smaller level
+const float c_kaiserWidth = 3.0f;
+const float c_kaiserAlpha = 4.0f;
+const float c_pi = 3.14159265358979f;
+// Resolution of the table that gives the first guess of the sRGB encoding of a linear value
+const int c_srgbGuessCount = 4096;
+
+bool isAvx2Supported()
+{
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7)
+    {
+        return false;
+    }
+    // The OS must also save the AVX registers on context switches
+    __cpuid(info, 1);
+    const bool osSavesAvx = (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0 && (_xgetbv(0) & 0x6) == 0x6;
+    __cpuidex(info, 7, 0);
+    return osSavesAvx && (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+std::atomic<fw::MipGenerator::InstructionSet>& getInstructionSetState()
+{
+    static std::atomic<fw::MipGenerator::InstructionSet> s_instructionSet{isAvx2Supported() ? fw::MipGenerator::InstructionSet::Avx2 : fw::MipGenerator::InstructionSet::Sse2};
+    return s_instructionSet;
+}
+
+float srgbToLinear(float value)
+{
+    return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+}
+
+struct ColorTables
+{
+    float unormToFloat[256];
+    float srgbToLinear[256];
+    // Linear values half way between two consecutive sRGB values, the encoded value of a linear value
+    // is the number of thresholds below it
+    float srgbThresholds[255];
+    // Encoded value of the start of each interval, at most one less than that of any value in the interval
+    unsigned char srgbGuesses[c_srgbGuessCount];
+};
+
+const ColorTables& getColorTables()
+{
+    static const ColorTables tables = []() {
+        ColorTables result;
+        for (int i = 0; i < 256; ++i)
+        {
+            result.unormToFloat[i] = i / 255.0f;
+            result.srgbToLinear[i] = srgbToLinear(i / 255.0f);
+        }
+        for (int i = 0; i < 255; ++i)
+        {
+            result.srgbThresholds[i] = srgbToLinear((i + 0.5f) / 255.0f);
+        }
+        for (int i = 0; i < c_srgbGuessCount; ++i)
+        {
+            const float value = static_cast<float>(i) / c_srgbGuessCount;
+            result.srgbGuesses[i] = static_cast<unsigned char>(std::upper_bound(result.srgbThresholds, result.srgbThresholds + 255, value) - result.srgbThresholds);
+        }
+        return result;
+    }();
+    return tables;
+}
+
+// Zeroth order modified Bessel function of the first kind
+float bessel0(float x)
+{
+    const float halfX = x * 0.5f;
+    float sum = 1.0f;
+    float term = 1.0f;
+    for (int k = 1; k < 32 && term > sum * 1e-8f; ++k)
+    {
+        term *= (halfX / k) * (halfX / k);
+        sum += term;
+    }
+    return sum;
+}
+
+float sinc(float x)
+{
+    return std::abs(x) < 1e-6f ? 1.0f : std::sin(c_pi * x) / (c_pi * x);
+}
+
+// x is the distance to the filter center in pixels of the smaller level
+float kaiser(float x)
+{
+    const float t = x / c_kaiserWidth;
+    if (t * t >= 1.0f)
+    {
+        return 0.0f;
+    }
+    return sinc(x) * bessel0(c_kaiserAlpha * std::sqrt(1.0f - t * t)) / bessel0(c_kaiserAlpha);
+}
+
+// Filters the start of a row with instructions wider than SSE2 and returns how much of it was filtered, see
+// MipGenerator::filterRowAvx2
+using FilterRow = size_t (*)(const float* source, size_t rowLength, const uint32_t* indices, const float* weights, uint32_t tapCount, float* destination);
+
+// Every destination element reads count source elements. Indices past the edges are clamped.
+struct FilterTaps
+{
+    uint32_t count = 0;
+    std::vector<uint32_t> indices;
+    std::vector<float> weights;
+};
+
+FilterTaps computeTaps(uint32_t sourceSize, uint32_t destinationSize, fw::MipGenerator::Filter filter)
+{
+    const float scale = static_cast<float>(sourceSize) / destinationSize;
+    // When magnifying the filter is as wide as when the size stays the same, a box then interpolates linearly
+    const float filterScale = std::max(scale, 1.0f);
+    const float radius = (filter == fw::MipGenerator::Filter::Box ? 0.5f : c_kaiserWidth) * filterScale;
+
+    FilterTaps taps;
+    taps.count = static_cast<uint32_t>(std::ceil(radius * 2.0f)) + 1;
+    taps.indices.resize(size_t(taps.count) * destinationSize);
+    taps.weights.resize(size_t(taps.count) * destinationSize);
+
+    for (uint32_t i = 0; i < destinationSize; ++i)
+    {
+        const float center = (i + 0.5f) * scale;
+        const int first = static_cast<int>(std::floor(center - radius));
+        uint32_t* indices = &taps.indices[size_t(i) * taps.count];
+        float* weights = &taps.weights[size_t(i) * taps.count];
+
+        float sum = 0.0f;
+        for (uint32_t k = 0; k < taps.count; ++k)
+        {
+            const int source = first + static_cast<int>(k);
+            if (filter == fw::MipGenerator::Filter::Box)
+            {
+                // Coverage of the source pixel by the footprint of the destination pixel
+                weights[k] = std::max(0.0f, std::min(source + 1.0f, center + radius) - std::max(static_cast<float>(source), center - radius));
+            }
+            else
+            {
+                weights[k] = kaiser((source + 0.5f - center) / filterScale);
+            }
+            indices[k] = static_cast<uint32_t>(std::min(std::max(source, 0), static_cast<int>(sourceSize) - 1));
+            sum += weights[k];
+        }
+
+        for (uint32_t k = 0; k < taps.count; ++k)
+        {
+            weights[k] /= sum;
+        }
+    }
+    return taps;
+}
+
+size_t getRowsPerTile(uint32_t width)
+{
+    return std::max<size_t>(1, c_pixelsPerTile / width);
+}
+
+void expandPixels(const unsigned char* pixels, size_t begin, size_t end, fw::MipGenerator::ColorSpace colorSpace, float* values)
+{
+    const ColorTables& tables = getColorTables();
+    const float* colorTable = colorSpace == fw::MipGenerator::ColorSpace::Srgb ? tables.srgbToLinear : tables.unormToFloat;
+    for (size_t i = begin; i < end; ++i)
+    {
+        const unsigned char* pixel = pixels + i * c_channelCount;
+        float* value = values + i * c_channelCount;
+        value[0] = colorTable[pixel[0]];
+        value[1] = colorTable[pixel[1]];
+        value[2] = colorTable[pixel[2]];
+        value[3] = tables.unormToFloat[pixel[3]];
+    }
+}
+
+void quantizePixels(const float* values, size_t begin, size_t end, fw::MipGenerator::ColorSpace colorSpace, unsigned char* pixels)
+{
+    const ColorTables& tables = getColorTables();
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 scale = _mm_set1_ps(255.0f);
+    const __m128 half = _mm_set1_ps(0.5f);
+    for (size_t i = begin; i < end; ++i)
+    {
+        // The Kaiser filter overshoots at sharp edges
+        const __m128 value = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(values + i * c_channelCount), zero), one);
+        const __m128i rounded = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(value, scale), half));
+        const __m128i packed = _mm_packus_epi16(_mm_packs_epi32(rounded, rounded), rounded);
+        const uint32_t quantized = static_cast<uint32_t>(_mm_cvtsi128_si32(packed));
+        unsigned char* pixel = pixels + i * c_channelCount;
+        std::memcpy(pixel, &quantized, sizeof(quantized));
+
+        if (colorSpace == fw::MipGenerator::ColorSpace::Srgb)
+        {
+            alignas(16) float color[c_channelCount];
+            _mm_store_ps(color, value);
+            for (uint32_t c = 0; c < 3; ++c)
+            {
+                const int guess = std::min(static_cast<int>(color[c] * c_srgbGuessCount), c_srgbGuessCount - 1);
+                unsigned int encoded = tables.srgbGuesses[guess];
+                while (encoded < 255 && color[c] >= tables.srgbThresholds[encoded])
+                {
+                    ++encoded;
+                }
+                pixel[c] = static_cast<unsigned char>(encoded);
+            }
+        }
+    }
+}
+
+void filterHorizontal(const float* source, uint32_t sourceWidth, float* destination, uint32_t destinationWidth, const FilterTaps& taps, size_t rowBegin, size_t rowEnd)
+{
+    for (size_t y = rowBegin; y < rowEnd; ++y)
+    {
+        const float* sourceRow = source + y * sourceWidth * c_channelCount;
+        float* destinationRow = destination + y * destinationWidth * c_channelCount;
+        for (uint32_t x = 0; x < destinationWidth; ++x)
+        {
+            const uint32_t* indices = &taps.indices[size_t(x) * taps.count];
+            const float* weights = &taps.weights[size_t(x) * taps.count];
+            __m128 sum = _mm_setzero_ps();
+            for (uint32_t k = 0; k < taps.count; ++k)
+            {
+                sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(weights[k]), _mm_loadu_ps(sourceRow + size_t(indices[k]) * c_channelCount)));
+            }
+            _mm_storeu_ps(destinationRow + size_t(x) * c_channelCount, sum);
+        }
+    }
+}
+
+// Rows are weighted sums of whole source rows, which vectorizes over the width
+void filterVertical(const float* source, float* destination, uint32_t width, const FilterTaps& taps, size_t rowBegin, size_t rowEnd, FilterRow filterRowWide)
+{
+    const size_t rowLength = size_t(width) * c_channelCount;
+    for (size_t y = rowBegin; y < rowEnd; ++y)
+    {
+        const uint32_t* indices = &taps.indices[y * taps.count];
+        const float* weights = &taps.weights[y * taps.count];
+        float* destinationRow = destination + y * rowLength;
+
+        size_t i = filterRowWide ? filterRowWide(source, rowLength, indices, weights, taps.count, destinationRow) : 0;
+        for (; i < rowLength; i += c_channelCount)
+        {
+            __m128 sum = _mm_setzero_ps();
+            for (uint32_t k = 0; k < taps.count; ++k)
+            {
+                sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(weights[k]), _mm_loadu_ps(source + indices[k] * rowLength + i)));
+            }
+            _mm_storeu_ps(destinationRow + i, sum);
+        }
+    }
+}
+
+// Filters the source to the size of the destination, horizontally first
+void filterImage(const std::vector<float>& source,
+                 uint32_t sourceWidth,
+                 uint32_t sourceHeight,
+                 uint32_t width,
+                 uint32_t height,
+                 fw::MipGenerator::Filter filter,
+                 FilterRow filterRowWide,
+                 std::vector<float>& horizontal,
+                 std::vector<float>& destination)
+{
+    fw::ThreadPool& threadPool = fw::ThreadPool::getDefault();
+
+    const FilterTaps horizontalTaps = computeTaps(sourceWidth, width, filter);
+    horizontal.resize(size_t(width) * sourceHeight * c_channelCount);
+    threadPool.parallelFor(sourceHeight, getRowsPerTile(sourceWidth), [&](size_t begin, size_t end) {
+        filterHorizontal(source.data(), sourceWidth, horizontal.data(), width, horizontalTaps, begin, end);
+    });
+
+    const FilterTaps verticalTaps = computeTaps(sourceHeight, height, filter);
+    destination.resize(size_t(width) * height * c_channelCount);
+    threadPool.parallelFor(height, getRowsPerTile(width), [&](size_t begin, size_t end) {
+        filterVertical(horizontal.data(), destination.data(), width, verticalTaps, begin, end, filterRowWide);
+    });
+}
+} // namespace
+
+namespace fw
+{
+size_t MipGenerator::Level::getRowPitch() const
+{
+    return size_t(width) * c_pixelSize;
+}
+
+size_t MipGenerator::Level::getSize() const
+{
+    return getRowPitch() * height;
+}
+
+Span<const unsigned char> MipGenerator::Chain::getLevelData(size_t level) const
+{
+    return Span<const unsigned char>(pixels.data() + levels[level].offset, levels[level].getSize());
+}
+
+uint32_t MipGenerator::getLevelCount(uint32_t width, uint32_t height)
+{
+    uint32_t count = 1;
+    for (uint32_t size = std::max(width, height); size > 1; size /= 2)
+    {
+        ++count;
+    }
+    return count;
+}
+
+void MipGenerator::generate(const unsigned char* pixels, uint32_t width, uint32_t height, ColorSpace colorSpace, Filter filter, Chain& chain)
+{
+    FW_PROFILE_FUNCTION();
+    assert(pixels != nullptr && width > 0 && height > 0);
+
+    const uint32_t levelCount = getLevelCount(width, height);
+    chain.levels.resize(levelCount);
+    size_t size = 0;
+    for (uint32_t i = 0; i < levelCount; ++i)
+    {
+        Level& level = chain.levels[i];
+        level.width = std::max(width >> i, 1u);
+        level.height = std::max(height >> i, 1u);
+        level.offset = size;
+        size += level.getSize();
+    }
+    chain.pixels.resize(size);
+    std::memcpy(chain.pixels.data(), pixels, chain.levels[0].getSize());
+
+    if (levelCount == 1)
+    {
+        return;
+    }
+
+    // Levels are filtered in floating point from the previous level so that rounding errors do not add up
+    ThreadPool& threadPool = ThreadPool::getDefault();
+    std::vector<float> source(size_t(width) * height * c_channelCount);
+    threadPool.parallelFor(size_t(width) * height, c_pixelsPerTile, [&](size_t begin, size_t end) {
+        expandPixels(pixels, begin, end, colorSpace, source.data());
+    });
+
+    const FilterRow filterRowWide = getInstructionSet() == InstructionSet::Avx2 ? &filterRowAvx2 : nullptr;
+    std::vector<float> horizontal;
+    std::vector<float> destination;
+    for (uint32_t i = 1; i < levelCount; ++i)
+    {
+        const Level& previous = chain.levels[i - 1];
+        const Level& level = chain.levels[i];
+        filterImage(source, previous.width, previous.height, level.width, level.height, filter, filterRowWide, horizontal, destination);
+
+        unsigned char* levelPixels = chain.pixels.data() + level.offset;
+        threadPool.parallelFor(size_t(level.width) * level.height, c_pixelsPerTile, [&](size_t begin, size_t end) {
+            quantizePixels(destination.data(), begin, end, colorSpace, levelPixels);
+        });
+
+        std::swap(source, destination);
+    }
+}
+
+void MipGenerator::resize(const unsigned char* pixels,
+                          uint32_t width,
+                          uint32_t height,
+                          uint32_t newWidth,
+                          uint32_t newHeight,
+                          ColorSpace colorSpace,
+                          Filter filter,
+                          std::vector<unsigned char>& result)
+{
+    FW_PROFILE_FUNCTION();
+    assert(pixels != nullptr && width > 0 && height > 0 && newWidth > 0 && newHeight > 0);
+
+    ThreadPool& threadPool = ThreadPool::getDefault();
+    std::vector<float> source(size_t(width) * height * c_channelCount);
+    threadPool.parallelFor(size_t(width) * height, c_pixelsPerTile, [&](size_t begin, size_t end) {
+        expandPixels(pixels, begin, end, colorSpace, source.data());
+    });
+
+    const FilterRow filterRowWide = getInstructionSet() == InstructionSet::Avx2 ? &filterRowAvx2 : nullptr;
+    std::vector<float> horizontal;
+    std::vector<float> destination;
+    filterImage(source, width, height, newWidth, newHeight, filter, filterRowWide, horizontal, destination);
+
+    result.resize(size_t(newWidth) * newHeight * c_pixelSize);
+    threadPool.parallelFor(size_t(newWidth) * newHeight, c_pixelsPerTile, [&](size_t begin, size_t end) {
+        quantizePixels(destination.data(), begin, end, colorSpace, result.data());
+    });
+}
+
+MipGenerator::InstructionSet MipGenerator::getInstructionSet()
+{
+    return getInstructionSetState().load(std::memory_order_relaxed);
+}
+
+bool MipGenerator::setInstructionSet(InstructionSet instructionSet)
+{
+    if (instructionSet == InstructionSet::Avx2 && !isAvx2Supported())
+    {
+        return false;
+    }
+    getInstructionSetState().store(instructionSet, std::memory_order_relaxed);
+    return true;
+}
+
+} // namespace fw
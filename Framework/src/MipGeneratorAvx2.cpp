@@ -0,0 +1,23 @@
+#include "MipGenerator.h"
+
+#include <immintrin.h>
+
+// Compiled with AVX2 enabled, so nothing else may live here. Code of this file only runs when the CPU supports it.
+namespace fw
+{
+size_t MipGenerator::filterRowAvx2(const float* source, size_t rowLength, const uint32_t* indices, const float* weights, uint32_t tapCount, float* destination)
+{
+    size_t i = 0;
+    for (; i + 8 <= rowLength; i += 8)
+    {
+        __m256 sum = _mm256_setzero_ps();
+        for (uint32_t k = 0; k < tapCount; ++k)
+        {
+            sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_set1_ps(weights[k]), _mm256_loadu_ps(source + indices[k] * rowLength + i)));
+        }
+        _mm256_storeu_ps(destination + i, sum);
+    }
+    return i;
+}
+
+} // namespace fw
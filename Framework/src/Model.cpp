@@ -1,140 +1,1249 @@
 #include "Model.h"
+#include "Bounds.h"
 #include "Common.h"
+#include "MeshSimplifier.h"
+#include "Meshlet.h"
+#include "ModelCache.h"
+#include "Profiler.h"
+#include "ThreadPool.h"
 
+#include <assimp/config.h>
 #include <assimp/Importer.hpp>
 #include <assimp/postprocess.h>
+#include <assimp/ProgressHandler.hpp>
 #include <assimp/scene.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include <unordered_map>
 #include <utility>
 
-namespace fw
+namespace
 {
-bool Model::loadModel(const std::string& file)
+const unsigned int c_importFlags = aiProcess_Triangulate
+    | aiProcess_JoinIdenticalVertices
+    | aiProcess_GenSmoothNormals
+    | aiProcess_GenUVCoords
+    | aiProcess_CalcTangentSpace;
+
+const unsigned int c_maxUInt16Vertices = 65536;
+
+// Progress at the start of each load stage
+const float c_importProgress = 0.05f;
+const float c_lodProgress = 0.5f;
+const float c_extractionProgress = 0.6f;
+const float c_meshletProgress = 0.8f;
+const float c_writeProgress = 0.9f;
+
+// Reports the progress of a background load, returns false if the load was cancelled
+bool updateProgress(fw::Model::LoadState* state, float progress)
 {
-    Assimp::Importer importer;
-    unsigned int flags = aiProcess_Triangulate
-        | aiProcess_JoinIdenticalVertices
-        | aiProcess_GenSmoothNormals
-        | aiProcess_GenUVCoords
-        | aiProcess_CalcTangentSpace;
-    const aiScene* aScene = importer.ReadFile(file, flags);
+    if (state == nullptr)
+    {
+        return true;
+    }
+    state->progress = progress;
+    return !state->cancelled;
+}
+
+// Maps the progress of Assimp to the import stage, returning false makes Assimp stop the import
+class ImportProgressHandler : public Assimp::ProgressHandler
+{
+public:
+    explicit ImportProgressHandler(fw::Model::LoadState* state) :
+        m_state(state)
+    {
+    }
+
+    virtual bool Update(float percentage) override
+    {
+        if (percentage < 0.0f)
+        {
+            return !m_state->cancelled;
+        }
+        const float fraction = std::min(percentage, 1.0f);
+        return updateProgress(m_state, c_importProgress + (c_lodProgress - c_importProgress) * fraction);
+    }
+
+private:
+    fw::Model::LoadState* m_state;
+};
+
+using TextureNames = std::vector<std::pair<aiTextureType, std::string>>;
+
+struct MeshLayout
+{
+    fw::ModelCache::MeshEntry entry{};
+    TextureNames textureNames;
+    std::vector<uint64_t> textureNameOffsets;
+};
+
+struct ExtractionRange
+{
+    unsigned int meshIndex = 0;
+    unsigned int vertexBegin = 0;
+    unsigned int vertexEnd = 0;
+    unsigned int faceBegin = 0;
+    unsigned int faceEnd = 0;
+};
+
+const unsigned int c_elementsPerRange = 16384;
+
+// Distances in bytes between consecutive elements of each vertex attribute
+struct AttributeStrides
+{
+    uint32_t position;
+    uint32_t normal;
+    uint32_t tangent;
+    uint32_t uv;
+};
+
+AttributeStrides getAttributeStrides(fw::Mesh::VertexLayout layout)
+{
+    switch (layout)
+    {
+    case fw::Mesh::VertexLayout::Interleaved:
+        return {sizeof(fw::Mesh::Vertex), sizeof(fw::Mesh::Vertex), sizeof(fw::Mesh::Vertex), sizeof(fw::Mesh::Vertex)};
+    case fw::Mesh::VertexLayout::SplitPosition:
+        return {sizeof(DirectX::XMFLOAT3), sizeof(fw::Mesh::VertexAttributes), sizeof(fw::Mesh::VertexAttributes), sizeof(fw::Mesh::VertexAttributes)};
+    default:
+        return {sizeof(DirectX::XMFLOAT3), sizeof(DirectX::XMFLOAT3), sizeof(DirectX::XMFLOAT3), sizeof(DirectX::XMFLOAT2)};
+    }
+}
 
-    if (aScene)
+// Size of the range covering count elements that are stride bytes apart
+uint64_t getStridedSize(uint32_t stride, size_t elementSize, uint32_t count)
+{
+    return count == 0 ? 0 : uint64_t(stride) * (count - 1) + elementSize;
+}
+
+template<typename T>
+T& getElement(unsigned char* image, uint64_t offset, uint32_t stride, unsigned int index)
+{
+    return *reinterpret_cast<T*>(image + offset + uint64_t(stride) * index);
+}
+
+struct LodChain
+{
+    std::vector<fw::MeshLod> lods;
+    std::vector<uint32_t> indices;
+};
+
+// Simplifies the imported geometry, the chain stays empty for invalid meshes which are rejected later
+void buildLodChain(const aiMesh* aMesh, const std::vector<float>& ratios, LodChain& chain)
+{
+    if (aMesh->mNumVertices == 0 || !aMesh->HasNormals())
+    {
+        return;
+    }
+
+    std::vector<uint32_t> indices;
+    indices.reserve(size_t(aMesh->mNumFaces) * 3);
+    for (unsigned int i = 0; i < aMesh->mNumFaces; ++i)
+    {
+        const aiFace& face = aMesh->mFaces[i];
+        if (face.mNumIndices != 3)
+        {
+            return;
+        }
+        indices.insert(indices.end(), face.mIndices, face.mIndices + 3);
+    }
+
+    fw::Mesh mesh;
+    mesh.positions = fw::StridedSpan<const DirectX::XMFLOAT3>(reinterpret_cast<const DirectX::XMFLOAT3*>(aMesh->mVertices), aMesh->mNumVertices, sizeof(aiVector3D));
+    mesh.normals = fw::StridedSpan<const DirectX::XMFLOAT3>(reinterpret_cast<const DirectX::XMFLOAT3*>(aMesh->mNormals), aMesh->mNumVertices, sizeof(aiVector3D));
+    mesh.indexType = fw::Mesh::IndexType::UInt32;
+    mesh.indices32 = indices;
+    fw::MeshSimplifier::buildLodChain(mesh, ratios, chain.lods, chain.indices);
+}
+
+template<typename T>
+void copyIndices(const std::vector<uint32_t>& source, size_t begin, T* indices)
+{
+    for (size_t i = begin; i < source.size(); ++i)
+    {
+        indices[i] = static_cast<T>(source[i]);
+    }
+}
+
+template<typename T>
+bool extractFaces(const aiMesh* aMesh, const ExtractionRange& range, T* indices)
+{
+    for (unsigned int i = range.faceBegin; i < range.faceEnd; ++i)
     {
-        if (aScene->mNumMeshes == 0)
+        const aiFace& face = aMesh->mFaces[i];
+        if (face.mNumIndices != 3)
         {
-            std::cerr << "No mesh found in the model: " << file << "\n";
             return false;
         }
+        indices[i * 3 + 0] = static_cast<T>(face.mIndices[0]);
+        indices[i * 3 + 1] = static_cast<T>(face.mIndices[1]);
+        indices[i * 3 + 2] = static_cast<T>(face.mIndices[2]);
+    }
+    return true;
+}
+
+// Copies one vertex and face range of a mesh into the cache image, returns false for non-triangle faces
+bool extractRange(const aiMesh* aMesh, const fw::ModelCache::MeshEntry& entry, const AttributeStrides& strides, const ExtractionRange& range, unsigned char* image)
+{
+    for (unsigned int i = range.vertexBegin; i < range.vertexEnd; ++i)
+    {
+        const aiVector3D& position = aMesh->mVertices[i];
+        getElement<DirectX::XMFLOAT3>(image, entry.positionsOffset, strides.position, i) = DirectX::XMFLOAT3(position.x, position.y, position.z);
+    }
+
+    for (unsigned int i = range.vertexBegin; i < range.vertexEnd; ++i)
+    {
+        const aiVector3D& normal = aMesh->mNormals[i];
+        getElement<DirectX::XMFLOAT3>(image, entry.normalsOffset, strides.normal, i) = DirectX::XMFLOAT3(normal.x, normal.y, normal.z);
+    }
+
+    if (entry.tangentCount > 0)
+    {
+        for (unsigned int i = range.vertexBegin; i < range.vertexEnd; ++i)
+        {
+            const aiVector3D& tangent = aMesh->mTangents[i];
+            getElement<DirectX::XMFLOAT3>(image, entry.tangentsOffset, strides.tangent, i) = DirectX::XMFLOAT3(tangent.x, tangent.y, tangent.z);
+        }
+    }
 
-        for (unsigned int meshIndex = 0; meshIndex < aScene->mNumMeshes; ++meshIndex)
+    if (entry.uvCount > 0)
+    {
+        const aiVector3D* textureCoords = aMesh->mTextureCoords[0];
+        for (unsigned int i = range.vertexBegin; i < range.vertexEnd; ++i)
         {
-            const aiMesh* aMesh = aScene->mMeshes[meshIndex];
-            Mesh mesh;
-            for (unsigned int vertexIndex = 0; vertexIndex < aMesh->mNumVertices; ++vertexIndex)
+            getElement<DirectX::XMFLOAT2>(image, entry.uvsOffset, strides.uv, i) = DirectX::XMFLOAT2(textureCoords[i].x, 1.0f - textureCoords[i].y);
+        }
+    }
+
+    if (entry.indexSize == sizeof(uint16_t))
+    {
+        return extractFaces(aMesh, range, reinterpret_cast<uint16_t*>(image + entry.indicesOffset));
+    }
+    return extractFaces(aMesh, range, reinterpret_cast<uint32_t*>(image + entry.indicesOffset));
+}
+
+// Embedded textures are referenced from materials as "*<index>"
+int getEmbeddedTextureIndex(const std::string& name, unsigned int numTextures)
+{
+    if (name.size() < 2 || name[0] != '*')
+    {
+        return -1;
+    }
+    char* end = nullptr;
+    const unsigned long index = std::strtoul(name.c_str() + 1, &end, 10);
+    if (*end != '\0' || index >= numTextures)
+    {
+        return -1;
+    }
+    return static_cast<int>(index);
+}
+
+TextureNames getTextureNames(const aiMaterial* aMaterial)
+{
+    TextureNames textureNames;
+    if (aMaterial)
+    {
+        for (int typeIndex = 0; typeIndex < aiTextureType_UNKNOWN; ++typeIndex)
+        {
+            aiTextureType type = static_cast<aiTextureType>(typeIndex);
+            unsigned int numTextures = aMaterial->GetTextureCount(type);
+            for (unsigned int texIndex = 0; texIndex < numTextures; ++texIndex)
             {
-                mesh.positions.push_back(DirectX::XMFLOAT3(aMesh->mVertices[vertexIndex].x,
-                                                           aMesh->mVertices[vertexIndex].y,
-                                                           aMesh->mVertices[vertexIndex].z));
-
-                mesh.normals.push_back(DirectX::XMFLOAT3(aMesh->mNormals[vertexIndex].x,
-                                                         aMesh->mNormals[vertexIndex].y,
-                                                         aMesh->mNormals[vertexIndex].z));
-
-                if (aMesh->HasTangentsAndBitangents())
-                {
-                    mesh.tangents.push_back(DirectX::XMFLOAT3(aMesh->mTangents[vertexIndex].x,
-                                                              aMesh->mTangents[vertexIndex].y,
-                                                              aMesh->mTangents[vertexIndex].z));
-                }
-
-                if (aMesh->HasTextureCoords(0))
-                {
-                    mesh.uvs.push_back(DirectX::XMFLOAT2(aMesh->mTextureCoords[0][vertexIndex].x,
-                                                         1.0f - aMesh->mTextureCoords[0][vertexIndex].y));
-                }
+                aiString path;
+                aMaterial->GetTexture(type, texIndex, &path);
+                textureNames.emplace_back(type, std::string(path.C_Str()));
             }
+        }
+    }
+    return textureNames;
+}
+
+// Hash of the attributes and faces that are imported
+uint64_t hashMesh(const aiMesh* aMesh)
+{
+    const size_t attributeSize = sizeof(aiVector3D) * aMesh->mNumVertices;
+    uint64_t hash = fw::ModelCache::hashData(aMesh->mVertices, attributeSize);
+    if (aMesh->HasNormals())
+    {
+        hash = fw::ModelCache::hashData(aMesh->mNormals, attributeSize, hash);
+    }
+    if (aMesh->HasTangentsAndBitangents())
+    {
+        hash = fw::ModelCache::hashData(aMesh->mTangents, attributeSize, hash);
+    }
+    if (aMesh->HasTextureCoords(0))
+    {
+        hash = fw::ModelCache::hashData(aMesh->mTextureCoords[0], attributeSize, hash);
+    }
+    for (unsigned int i = 0; i < aMesh->mNumFaces; ++i)
+    {
+        const aiFace& face = aMesh->mFaces[i];
+        hash = fw::ModelCache::hashData(face.mIndices, sizeof(unsigned int) * face.mNumIndices, hash);
+    }
+    return hash;
+}
+
+bool isSameAttribute(const aiVector3D* a, const aiVector3D* b, unsigned int count)
+{
+    if (a == nullptr || b == nullptr)
+    {
+        return a == b;
+    }
+    return std::memcmp(a, b, sizeof(aiVector3D) * count) == 0;
+}
+
+bool isSameMesh(const aiMesh* a, const aiMesh* b)
+{
+    if (a->mNumVertices != b->mNumVertices
+        || a->mNumFaces != b->mNumFaces
+        || !isSameAttribute(a->mVertices, b->mVertices, a->mNumVertices)
+        || !isSameAttribute(a->mNormals, b->mNormals, a->mNumVertices)
+        || !isSameAttribute(a->HasTangentsAndBitangents() ? a->mTangents : nullptr, b->HasTangentsAndBitangents() ? b->mTangents : nullptr, a->mNumVertices)
+        || !isSameAttribute(a->mTextureCoords[0], b->mTextureCoords[0], a->mNumVertices))
+    {
+        return false;
+    }
+    for (unsigned int i = 0; i < a->mNumFaces; ++i)
+    {
+        const aiFace& faceA = a->mFaces[i];
+        const aiFace& faceB = b->mFaces[i];
+        if (faceA.mNumIndices != faceB.mNumIndices || std::memcmp(faceA.mIndices, faceB.mIndices, sizeof(unsigned int) * faceA.mNumIndices) != 0)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Picks the meshes of the scene that are imported, meshRemap maps every mesh of the scene to an
+// imported one. Duplicates have the same geometry and textures as a mesh that comes before them.
+void deduplicateMeshes(const aiScene* aScene, bool deduplicate, std::vector<const aiMesh*>& meshes, std::vector<uint32_t>& meshRemap)
+{
+    const unsigned int sceneMeshCount = aScene->mNumMeshes;
+    meshes.clear();
+    meshRemap.resize(sceneMeshCount);
+    if (!deduplicate)
+    {
+        for (unsigned int i = 0; i < sceneMeshCount; ++i)
+        {
+            meshes.push_back(aScene->mMeshes[i]);
+            meshRemap[i] = i;
+        }
+        return;
+    }
 
-            for (unsigned int faceIndex = 0; faceIndex < aMesh->mNumFaces; ++faceIndex)
+    std::vector<uint64_t> hashes(sceneMeshCount);
+    std::vector<TextureNames> textureNames(sceneMeshCount);
+    fw::ThreadPool::getDefault().parallelFor(sceneMeshCount, 1, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            const aiMesh* aMesh = aScene->mMeshes[i];
+            hashes[i] = hashMesh(aMesh);
+            textureNames[i] = getTextureNames(aScene->mMaterials[aMesh->mMaterialIndex]);
+        }
+    });
+
+    // Scene mesh indices of the imported meshes by hash, equal hashes are confirmed by comparing the data
+    std::unordered_multimap<uint64_t, unsigned int> importedMeshes;
+    for (unsigned int i = 0; i < sceneMeshCount; ++i)
+    {
+        const aiMesh* aMesh = aScene->mMeshes[i];
+        bool duplicate = false;
+        const auto candidates = importedMeshes.equal_range(hashes[i]);
+        for (auto it = candidates.first; it != candidates.second && !duplicate; ++it)
+        {
+            const unsigned int original = it->second;
+            if (textureNames[i] == textureNames[original] && isSameMesh(aMesh, aScene->mMeshes[original]))
             {
-                if (aMesh->mFaces[faceIndex].mNumIndices != 3)
-                {
-                    std::cerr << "Unable to parse model indices for " << file << "\n";
-                    return false;
-                }
-                mesh.indices.push_back(aMesh->mFaces[faceIndex].mIndices[0]);
-                mesh.indices.push_back(aMesh->mFaces[faceIndex].mIndices[1]);
-                mesh.indices.push_back(aMesh->mFaces[faceIndex].mIndices[2]);
+                meshRemap[i] = meshRemap[original];
+                duplicate = true;
             }
+        }
+
+        if (!duplicate)
+        {
+            meshRemap[i] = static_cast<uint32_t>(meshes.size());
+            meshes.push_back(aMesh);
+            importedMeshes.emplace(hashes[i], i);
+        }
+    }
+}
+
+// Assimp matrices transform column vectors and DirectXMath ones row vectors
+DirectX::XMFLOAT4X4 toFloat4x4(const aiMatrix4x4& m)
+{
+    return DirectX::XMFLOAT4X4(m.a1, m.b1, m.c1, m.d1,
+                               m.a2, m.b2, m.c2, m.d2,
+                               m.a3, m.b3, m.c3, m.d3,
+                               m.a4, m.b4, m.c4, m.d4);
+}
+
+void collectInstances(const aiNode* aNode, const aiMatrix4x4& parentTransform, const std::vector<uint32_t>& meshRemap, std::vector<fw::MeshInstance>& instances)
+{
+    const aiMatrix4x4 transform = parentTransform * aNode->mTransformation;
+    for (unsigned int i = 0; i < aNode->mNumMeshes; ++i)
+    {
+        if (aNode->mMeshes[i] < meshRemap.size())
+        {
+            fw::MeshInstance instance{};
+            instance.transform = toFloat4x4(transform);
+            instance.meshIndex = meshRemap[aNode->mMeshes[i]];
+            instances.push_back(instance);
+        }
+    }
+    for (unsigned int i = 0; i < aNode->mNumChildren; ++i)
+    {
+        collectInstances(aNode->mChildren[i], transform, meshRemap, instances);
+    }
+}
+
+// Instances of all the nodes sorted by mesh, meshes that no node references are placed at the origin
+void buildInstances(const aiScene* aScene, const std::vector<uint32_t>& meshRemap, uint32_t meshCount, std::vector<fw::MeshInstance>& instances)
+{
+    instances.clear();
+    if (aScene->mRootNode)
+    {
+        collectInstances(aScene->mRootNode, aiMatrix4x4(), meshRemap, instances);
+    }
+
+    std::vector<bool> instanced(meshCount, false);
+    for (const fw::MeshInstance& instance : instances)
+    {
+        instanced[instance.meshIndex] = true;
+    }
+    for (uint32_t i = 0; i < meshCount; ++i)
+    {
+        if (!instanced[i])
+        {
+            fw::MeshInstance instance{};
+            instance.transform = toFloat4x4(aiMatrix4x4());
+            instance.meshIndex = i;
+            instances.push_back(instance);
+        }
+    }
+
+    std::stable_sort(instances.begin(), instances.end(), [](const fw::MeshInstance& a, const fw::MeshInstance& b) {
+        return a.meshIndex < b.meshIndex;
+    });
+}
+
+// Reserves the vertex data of a mesh, attributes that are interleaved point inside a shared stream
+void reserveVertices(uint64_t& imageSize, fw::Mesh::VertexLayout layout, fw::ModelCache::MeshEntry& entry)
+{
+    switch (layout)
+    {
+    case fw::Mesh::VertexLayout::Interleaved:
+    {
+        const uint64_t verticesOffset = fw::ModelCache::reserve(imageSize, sizeof(fw::Mesh::Vertex) * entry.vertexCount);
+        entry.positionsOffset = verticesOffset + offsetof(fw::Mesh::Vertex, position);
+        entry.normalsOffset = verticesOffset + offsetof(fw::Mesh::Vertex, normal);
+        entry.tangentsOffset = verticesOffset + offsetof(fw::Mesh::Vertex, tangent);
+        entry.uvsOffset = verticesOffset + offsetof(fw::Mesh::Vertex, uv);
+        break;
+    }
+    case fw::Mesh::VertexLayout::SplitPosition:
+    {
+        entry.positionsOffset = fw::ModelCache::reserve(imageSize, sizeof(DirectX::XMFLOAT3) * entry.vertexCount);
+        const uint64_t attributesOffset = fw::ModelCache::reserve(imageSize, sizeof(fw::Mesh::VertexAttributes) * entry.vertexCount);
+        entry.normalsOffset = attributesOffset + offsetof(fw::Mesh::VertexAttributes, normal);
+        entry.tangentsOffset = attributesOffset + offsetof(fw::Mesh::VertexAttributes, tangent);
+        entry.uvsOffset = attributesOffset + offsetof(fw::Mesh::VertexAttributes, uv);
+        break;
+    }
+    default:
+        entry.positionsOffset = fw::ModelCache::reserve(imageSize, sizeof(DirectX::XMFLOAT3) * entry.vertexCount);
+        entry.normalsOffset = fw::ModelCache::reserve(imageSize, sizeof(DirectX::XMFLOAT3) * entry.vertexCount);
+        entry.tangentsOffset = fw::ModelCache::reserve(imageSize, sizeof(DirectX::XMFLOAT3) * entry.tangentCount);
+        entry.uvsOffset = fw::ModelCache::reserve(imageSize, sizeof(DirectX::XMFLOAT2) * entry.uvCount);
+        break;
+    }
+}
+
+template<typename T>
+T* getImagePointer(std::vector<unsigned char>& image, uint64_t offset)
+{
+    return reinterpret_cast<T*>(image.data() + offset);
+}
+
+template<typename T>
+fw::Span<const T> getImageSpan(const unsigned char* data, uint64_t offset, uint32_t count)
+{
+    return fw::Span<const T>(reinterpret_cast<const T*>(data + offset), count);
+}
+
+template<typename T>
+fw::StridedSpan<const T> getImageStridedSpan(const unsigned char* data, uint64_t offset, uint32_t count, uint32_t stride)
+{
+    return fw::StridedSpan<const T>(reinterpret_cast<const T*>(data + offset), count, stride);
+}
+
+void addVertexStream(fw::Mesh& mesh, const unsigned char* data, uint64_t offset, uint32_t count, uint32_t stride)
+{
+    fw::Mesh::VertexStream stream;
+    stream.data = fw::Span<const unsigned char>(data + offset, static_cast<size_t>(uint64_t(stride) * count));
+    stream.stride = stride;
+    assert(mesh.vertexStreamCount < fw::Mesh::c_maxVertexStreams);
+    mesh.vertexStreams[mesh.vertexStreamCount++] = stream;
+}
+
+// Points the vertex and index views of the mesh to the cache image, the ranges must have been validated
+void setMeshGeometry(fw::Mesh& mesh, const unsigned char* data, const fw::ModelCache::MeshEntry& entry, fw::Mesh::VertexLayout vertexLayout)
+{
+    const AttributeStrides strides = getAttributeStrides(vertexLayout);
+    mesh.vertexLayout = vertexLayout;
+    mesh.positions = getImageStridedSpan<DirectX::XMFLOAT3>(data, entry.positionsOffset, entry.vertexCount, strides.position);
+    mesh.normals = getImageStridedSpan<DirectX::XMFLOAT3>(data, entry.normalsOffset, entry.vertexCount, strides.normal);
+    mesh.tangents = getImageStridedSpan<DirectX::XMFLOAT3>(data, entry.tangentsOffset, entry.tangentCount, strides.tangent);
+    mesh.uvs = getImageStridedSpan<DirectX::XMFLOAT2>(data, entry.uvsOffset, entry.uvCount, strides.uv);
+
+    mesh.vertexStreamCount = 0;
+    switch (vertexLayout)
+    {
+    case fw::Mesh::VertexLayout::Interleaved:
+        addVertexStream(mesh, data, entry.positionsOffset, entry.vertexCount, strides.position);
+        break;
+    case fw::Mesh::VertexLayout::SplitPosition:
+        addVertexStream(mesh, data, entry.positionsOffset, entry.vertexCount, strides.position);
+        addVertexStream(mesh, data, entry.normalsOffset, entry.vertexCount, strides.normal);
+        break;
+    default:
+        addVertexStream(mesh, data, entry.positionsOffset, entry.vertexCount, strides.position);
+        addVertexStream(mesh, data, entry.normalsOffset, entry.vertexCount, strides.normal);
+        if (entry.tangentCount > 0)
+        {
+            addVertexStream(mesh, data, entry.tangentsOffset, entry.tangentCount, strides.tangent);
+        }
+        if (entry.uvCount > 0)
+        {
+            addVertexStream(mesh, data, entry.uvsOffset, entry.uvCount, strides.uv);
+        }
+        break;
+    }
+
+    if (entry.indexSize == sizeof(uint16_t))
+    {
+        mesh.indexType = fw::Mesh::IndexType::UInt16;
+        mesh.indices16 = getImageSpan<uint16_t>(data, entry.indicesOffset, entry.indexCount);
+    }
+    else
+    {
+        mesh.indexType = fw::Mesh::IndexType::UInt32;
+        mesh.indices32 = getImageSpan<uint32_t>(data, entry.indicesOffset, entry.indexCount);
+    }
+}
+
+template<typename T>
+void copyToImage(std::vector<unsigned char>& image, uint64_t offset, const std::vector<T>& source)
+{
+    if (!source.empty())
+    {
+        std::memcpy(image.data() + offset, source.data(), source.size() * sizeof(T));
+    }
+}
+
+bool isHierarchyValid(const fw::BoundsNode* nodes, uint32_t nodeCount, const uint32_t* instanceIndices, uint32_t instanceCount)
+{
+    for (uint32_t i = 0; i < nodeCount; ++i)
+    {
+        const fw::BoundsNode& node = nodes[i];
+        if (node.itemCount == 0 ? (node.firstChild <= i || uint64_t(node.firstChild) + 1 >= nodeCount)
+                                : uint64_t(node.firstItem) + node.itemCount > instanceCount)
+        {
+            return false;
+        }
+    }
+    for (uint32_t i = 0; i < instanceCount; ++i)
+    {
+        if (instanceIndices[i] >= instanceCount)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool areInstancesValid(const fw::ModelCache::MeshEntry& entry, uint32_t meshIndex, const fw::MeshInstance* instances, uint32_t instanceCount)
+{
+    if (entry.instanceCount == 0 || uint64_t(entry.firstInstance) + entry.instanceCount > instanceCount)
+    {
+        return false;
+    }
+    for (uint32_t i = entry.firstInstance; i < entry.firstInstance + entry.instanceCount; ++i)
+    {
+        if (instances[i].meshIndex != meshIndex)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool areInstanceMeshesValid(const fw::MeshInstance* instances, uint32_t instanceCount, uint32_t meshCount)
+{
+    for (uint32_t i = 0; i < instanceCount; ++i)
+    {
+        if (instances[i].meshIndex >= meshCount)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool areLodsValid(const fw::ModelCache::MeshEntry& entry, const fw::MeshLod* lods)
+{
+    for (uint32_t i = 0; i < entry.lodCount; ++i)
+    {
+        if (uint64_t(lods[i].indexOffset) + lods[i].indexCount > entry.indexCount)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+} // namespace
+
+namespace fw
+{
+bool Model::loadModel(const std::string& file)
+{
+    return loadModel(file, LoadOptions());
+}
 
-            aiMaterial* aMaterial = aScene->mMaterials[aMesh->mMaterialIndex];
-            if (aMaterial)
+bool Model::loadModel(const std::string& file, const LoadOptions& options)
+{
+    waitForPendingLoad();
+    return load(file, options, nullptr);
+}
+
+Model::~Model()
+{
+    if (m_pendingLoad.isValid())
+    {
+        m_pendingLoad.cancel();
+    }
+    waitForPendingLoad();
+}
+
+Model::LoadHandle Model::loadAsync(const std::string& file)
+{
+    return loadAsync(file, LoadOptions());
+}
+
+Model::LoadHandle Model::loadAsync(const std::string& file, const LoadOptions& options)
+{
+    waitForPendingLoad();
+
+    LoadHandle handle;
+    handle.m_state = std::make_shared<LoadState>();
+    std::shared_ptr<LoadState> state = handle.m_state;
+    handle.m_result = ThreadPool::getDefault().submit([this, file, options, state]() { return load(file, options, state.get()); }).share();
+
+    m_pendingLoad = handle;
+    return handle;
+}
+
+bool Model::LoadHandle::isValid() const
+{
+    return m_result.valid();
+}
+
+bool Model::LoadHandle::isReady() const
+{
+    return m_result.valid() && m_result.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+float Model::LoadHandle::getProgress() const
+{
+    return m_state ? m_state->progress.load() : 0.0f;
+}
+
+void Model::LoadHandle::cancel()
+{
+    if (m_state)
+    {
+        m_state->cancelled = true;
+    }
+}
+
+bool Model::LoadHandle::get() const
+{
+    return m_result.valid() && m_result.get();
+}
+
+void Model::waitForPendingLoad()
+{
+    if (m_pendingLoad.isValid())
+    {
+        m_pendingLoad.get();
+        m_pendingLoad = LoadHandle();
+    }
+}
+
+bool Model::load(const std::string& file, const LoadOptions& options, LoadState* state)
+{
+    FW_PROFILE_FUNCTION();
+    unsigned int importFlags = c_importFlags;
+    if (options.splitLargeMeshes)
+    {
+        importFlags |= aiProcess_SplitLargeMeshes;
+    }
+
+    // The cache is rebuilt whenever any option that affects its contents changes
+    ModelCache::Header cacheKey{};
+    cacheKey.importFlags = importFlags;
+    cacheKey.vertexLayout = static_cast<uint32_t>(options.vertexLayout);
+    cacheKey.contentFlags = (options.generateMeshlets ? ModelCache::c_meshletsFlag : 0)
+        | (options.lodRatios.empty() ? 0 : ModelCache::c_lodsFlag)
+        | (options.deduplicateMeshes ? ModelCache::c_deduplicatedFlag : 0);
+    cacheKey.lodRatiosHash = static_cast<uint32_t>(ModelCache::hashData(options.lodRatios.data(), options.lodRatios.size() * sizeof(float)));
+
+    if (!ModelCache::hashFile(file, cacheKey.sourceHash))
+    {
+        std::cerr << "Failed to read model: " << file << "\n";
+        return false;
+    }
+
+    const std::string cachePath = ModelCache::getCachePath(file);
+    if (m_cacheFile.open(cachePath))
+    {
+        const unsigned char* data = m_cacheFile.getData();
+        const size_t size = m_cacheFile.getSize();
+        if (ModelCache::isValid(data, size, cacheKey) && readCacheImage(data, size))
+        {
+            updateProgress(state, 1.0f);
+            return true;
+        }
+        m_cacheFile.close();
+    }
+
+    if (!updateProgress(state, c_importProgress) || !importModel(file, cacheKey, options, state))
+    {
+        if (state && state->cancelled)
+        {
+            std::cerr << "Model loading cancelled: " << file << "\n";
+        }
+        m_cacheImage.clear();
+        return false;
+    }
+
+    if (!ModelCache::write(cachePath, m_cacheImage))
+    {
+        std::cerr << "Unable to write model cache: " << cachePath << "\n";
+    }
+
+    const bool loaded = readCacheImage(m_cacheImage.data(), m_cacheImage.size());
+    updateProgress(state, 1.0f);
+    return loaded;
+}
+
+const Model::Meshes& Model::getMeshes() const
+{
+    return m_meshes;
+}
+
+size_t Model::getTextureCount() const
+{
+    return m_textures.size();
+}
+
+Model::TextureData Model::getTextureData(unsigned int index) const
+{
+    return index < m_textures.size() ? m_textures[index] : TextureData();
+}
+
+const DirectX::BoundingBox& Model::getBoundingBox() const
+{
+    return m_boundingBox;
+}
+
+const DirectX::BoundingSphere& Model::getBoundingSphere() const
+{
+    return m_boundingSphere;
+}
+
+Span<const MeshInstance> Model::getInstances() const
+{
+    return m_instances;
+}
+
+Span<const BoundsNode> Model::getHierarchy() const
+{
+    return m_hierarchy;
+}
+
+Span<const uint32_t> Model::getHierarchyInstanceIndices() const
+{
+    return m_hierarchyInstanceIndices;
+}
+
+Model::MemoryUsage Model::getMemoryUsage() const
+{
+    MemoryUsage usage;
+    usage.mappedBytes = m_cacheFile.isOpen() ? m_cacheFile.getSize() : 0;
+    usage.imageBytes = m_cacheImage.capacity();
+    usage.arenaBytes = m_arena.getReservedSize();
+    usage.meshBytes = m_meshes.capacity() * sizeof(Mesh);
+    return usage;
+}
+
+size_t Model::MemoryUsage::getHeapBytes() const
+{
+    return imageBytes + arenaBytes + meshBytes;
+}
+
+bool Model::importModel(const std::string& file, const ModelCache::Header& cacheKey, const LoadOptions& options, LoadState* state)
+{
+    FW_PROFILE_FUNCTION();
+    const Mesh::VertexLayout vertexLayout = options.vertexLayout;
+
+    Assimp::Importer importer;
+    importer.SetPropertyInteger(AI_CONFIG_PP_SLM_VERTEX_LIMIT, c_maxUInt16Vertices);
+    if (state)
+    {
+        // The importer takes ownership of the handler
+        importer.SetProgressHandler(new ImportProgressHandler(state));
+    }
+    const aiScene* aScene = importer.ReadFile(file, cacheKey.importFlags);
+
+    if (!updateProgress(state, c_lodProgress))
+    {
+        return false;
+    }
+
+    if (!aScene)
+    {
+        std::cerr << "Failed to read model: " << file << "\n";
+        std::cerr << "Assimp error message: " << importer.GetErrorString() << "\n";
+        return false;
+    }
+
+    if (aScene->mNumMeshes == 0)
+    {
+        std::cerr << "No mesh found in the model: " << file << "\n";
+        return false;
+    }
+
+    // Duplicated meshes are imported once, the nodes that reference them become instances
+    std::vector<const aiMesh*> meshes;
+    std::vector<uint32_t> meshRemap;
+    deduplicateMeshes(aScene, options.deduplicateMeshes, meshes, meshRemap);
+    const uint32_t meshCount = static_cast<uint32_t>(meshes.size());
+    std::vector<MeshInstance> instances;
+    buildInstances(aScene, meshRemap, meshCount, instances);
+
+    // Levels of detail are built before the layout so that all levels fit in the index range of the mesh
+    std::vector<LodChain> lodChains(meshCount);
+    if (!options.lodRatios.empty())
+    {
+        ThreadPool::getDefault().parallelFor(meshCount, 1, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i)
             {
-                for (int typeIndex = 0; typeIndex < aiTextureType_UNKNOWN; ++typeIndex)
-                {
-                    aiTextureType type = static_cast<aiTextureType>(typeIndex);
-                    unsigned int numTextures = aMaterial->GetTextureCount(type);
-                    for (unsigned int texIndex = 0; texIndex < numTextures; ++texIndex)
-                    {
-                        aiString path;
-                        aMaterial->GetTexture(type, texIndex, &path);
-                        mesh.textureNames[type].push_back(std::string(path.C_Str()));
-                    }
-                }
+                buildLodChain(meshes[i], options.lodRatios, lodChains[i]);
             }
+        });
+    }
+
+    if (!updateProgress(state, c_extractionProgress))
+    {
+        return false;
+    }
+
+    // Lay out the cache image
+    uint64_t imageSize = sizeof(ModelCache::Header);
+    const uint64_t meshesOffset = ModelCache::reserve(imageSize, sizeof(ModelCache::MeshEntry) * meshCount);
+    std::vector<MeshLayout> meshLayouts(meshCount);
+
+    for (unsigned int meshIndex = 0; meshIndex < meshCount; ++meshIndex)
+    {
+        const aiMesh* aMesh = meshes[meshIndex];
+        MeshLayout& layout = meshLayouts[meshIndex];
+        ModelCache::MeshEntry& entry = layout.entry;
+
+        if (aMesh->mNumVertices == 0)
+        {
+            std::cerr << "Invalid mesh (no vertices): " << file << "\n";
+            return false;
+        }
+
+        if (!aMesh->HasNormals())
+        {
+            std::cerr << "Invalid mesh (number of vertices and normals do not match): " << file << "\n";
+            return false;
+        }
+
+        entry.vertexCount = aMesh->mNumVertices;
+        const LodChain& lodChain = lodChains[meshIndex];
+        entry.indexCount = lodChain.lods.empty() ? aMesh->mNumFaces * 3 : static_cast<uint32_t>(lodChain.indices.size());
+        entry.lodCount = static_cast<uint32_t>(lodChain.lods.size());
+        entry.lodsOffset = ModelCache::reserve(imageSize, sizeof(MeshLod) * entry.lodCount);
+        entry.tangentCount = aMesh->HasTangentsAndBitangents() ? aMesh->mNumVertices : 0;
+        entry.uvCount = aMesh->HasTextureCoords(0) ? aMesh->mNumVertices : 0;
+        reserveVertices(imageSize, vertexLayout, entry);
+        entry.indexSize = entry.vertexCount <= c_maxUInt16Vertices ? sizeof(uint16_t) : sizeof(uint32_t);
+        entry.indicesOffset = ModelCache::reserve(imageSize, uint64_t(entry.indexSize) * entry.indexCount);
+
+        layout.textureNames = getTextureNames(aScene->mMaterials[aMesh->mMaterialIndex]);
+        entry.textureNameCount = static_cast<uint32_t>(layout.textureNames.size());
+        entry.textureNamesOffset = ModelCache::reserve(imageSize, sizeof(ModelCache::TextureNameEntry) * entry.textureNameCount);
+        for (const std::pair<aiTextureType, std::string>& textureName : layout.textureNames)
+        {
+            layout.textureNameOffsets.push_back(ModelCache::reserve(imageSize, textureName.second.size()));
+        }
+    }
+
+    // The instances of each mesh are consecutive
+    for (uint32_t i = 0; i < instances.size(); ++i)
+    {
+        ModelCache::MeshEntry& entry = meshLayouts[instances[i].meshIndex].entry;
+        if (entry.instanceCount++ == 0)
+        {
+            entry.firstInstance = i;
+        }
+    }
 
-            if (aScene->HasTextures())
+    // Embedded textures are shared by all meshes and stored once
+    const uint64_t texturesOffset = ModelCache::reserve(imageSize, sizeof(ModelCache::TextureEntry) * aScene->mNumTextures);
+    std::vector<ModelCache::TextureEntry> textureEntries(aScene->mNumTextures);
+    for (unsigned int i = 0; i < aScene->mNumTextures; ++i)
+    {
+        const aiTexture* aTexture = aScene->mTextures[i];
+        assert(aTexture->mHeight == 0); // Means texture is compressed
+        ModelCache::TextureEntry& textureEntry = textureEntries[i];
+        textureEntry.index = i;
+        textureEntry.size = aTexture->mWidth;
+        textureEntry.offset = ModelCache::reserve(imageSize, textureEntry.size);
+    }
+    imageSize = ModelCache::align(imageSize);
+
+    // Fill the cache image
+    m_cacheImage.assign(static_cast<size_t>(imageSize), 0);
+
+    ModelCache::Header header = cacheKey;
+    header.magic = ModelCache::c_magic;
+    header.version = ModelCache::c_version;
+    header.meshCount = meshCount;
+    header.textureCount = static_cast<uint32_t>(textureEntries.size());
+    header.meshesOffset = meshesOffset;
+    header.texturesOffset = texturesOffset;
+
+    // Extract vertex and index data in parallel, large meshes are split into several ranges
+    std::vector<ExtractionRange> ranges;
+    for (unsigned int meshIndex = 0; meshIndex < meshCount; ++meshIndex)
+    {
+        const aiMesh* aMesh = meshes[meshIndex];
+        const unsigned int elementCount = std::max(aMesh->mNumVertices, aMesh->mNumFaces);
+        const unsigned int rangeCount = std::max(1u, (elementCount + c_elementsPerRange - 1) / c_elementsPerRange);
+        for (unsigned int i = 0; i < rangeCount; ++i)
+        {
+            ExtractionRange range;
+            range.meshIndex = meshIndex;
+            range.vertexBegin = static_cast<unsigned int>(uint64_t(aMesh->mNumVertices) * i / rangeCount);
+            range.vertexEnd = static_cast<unsigned int>(uint64_t(aMesh->mNumVertices) * (i + 1) / rangeCount);
+            range.faceBegin = static_cast<unsigned int>(uint64_t(aMesh->mNumFaces) * i / rangeCount);
+            range.faceEnd = static_cast<unsigned int>(uint64_t(aMesh->mNumFaces) * (i + 1) / rangeCount);
+            ranges.push_back(range);
+        }
+    }
+
+    const AttributeStrides strides = getAttributeStrides(vertexLayout);
+    std::atomic<bool> validFaces{true};
+    std::atomic<size_t> extractedRanges{0};
+    ThreadPool::getDefault().parallelFor(ranges.size(), 1, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            if (state && state->cancelled)
             {
-                for (unsigned int i = 0; i < aScene->mNumTextures; ++i)
-                {
-                    aiTexture* aTexture = aScene->mTextures[i];
-                    assert(aTexture->mHeight == 0); // Means texture is compressed
-                    m_textureDatas[i] = std::vector<unsigned char>(aTexture->mWidth);
-                    TextureData& data = m_textureDatas[i];
-                    std::memcpy(data.data(), aTexture->pcData, aTexture->mWidth);
-                }
+                return;
             }
-
-            if (mesh.positions.empty())
+            const ExtractionRange& range = ranges[i];
+            if (!extractRange(meshes[range.meshIndex], meshLayouts[range.meshIndex].entry, strides, range, m_cacheImage.data()))
             {
-                std::cerr << "Invalid mesh (no vertices): " << file << "\n";
-                return false;
+                validFaces = false;
             }
+            const float fraction = static_cast<float>(++extractedRanges) / ranges.size();
+            updateProgress(state, c_extractionProgress + (c_meshletProgress - c_extractionProgress) * fraction);
+        }
+    });
+
+    if (!updateProgress(state, c_meshletProgress))
+    {
+        return false;
+    }
+
+    if (!validFaces)
+    {
+        std::cerr << "Unable to parse model indices for " << file << "\n";
+        return false;
+    }
+
+    // The simplified levels follow the full mesh in the index range
+    for (unsigned int meshIndex = 0; meshIndex < meshCount; ++meshIndex)
+    {
+        const LodChain& lodChain = lodChains[meshIndex];
+        const ModelCache::MeshEntry& entry = meshLayouts[meshIndex].entry;
+        if (lodChain.lods.empty())
+        {
+            continue;
+        }
+
+        const size_t begin = lodChain.lods[0].indexCount;
+        if (entry.indexSize == sizeof(uint16_t))
+        {
+            copyIndices(lodChain.indices, begin, getImagePointer<uint16_t>(m_cacheImage, entry.indicesOffset));
+        }
+        else
+        {
+            copyIndices(lodChain.indices, begin, getImagePointer<uint32_t>(m_cacheImage, entry.indicesOffset));
+        }
+        copyToImage(m_cacheImage, entry.lodsOffset, lodChain.lods);
+    }
 
-            size_t numVertices = mesh.positions.size();
-            if (mesh.normals.size() != numVertices)
+    // Bounds of the full meshes and a hierarchy over their instances, the instances and the hierarchy
+    // are appended to the image
+    ThreadPool::getDefault().parallelFor(meshCount, 1, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            ModelCache::MeshEntry& entry = meshLayouts[i].entry;
+            Mesh mesh;
+            setMeshGeometry(mesh, m_cacheImage.data(), entry, vertexLayout);
+            Bounds::compute(mesh.positions, entry.boundingBox, entry.boundingSphere);
+        }
+    });
+
+    std::vector<DirectX::BoundingBox> instanceBoxes(instances.size());
+    for (size_t i = 0; i < instances.size(); ++i)
+    {
+        instanceBoxes[i] = Bounds::transform(meshLayouts[instances[i].meshIndex].entry.boundingBox, instances[i].transform);
+    }
+
+    std::vector<BoundsNode> hierarchy;
+    std::vector<uint32_t> hierarchyInstanceIndices;
+    Bounds::buildHierarchy(instanceBoxes, hierarchy, hierarchyInstanceIndices);
+    header.instanceCount = static_cast<uint32_t>(instances.size());
+    header.instancesOffset = ModelCache::reserve(imageSize, sizeof(MeshInstance) * instances.size());
+    header.hierarchyNodeCount = static_cast<uint32_t>(hierarchy.size());
+    header.hierarchyOffset = ModelCache::reserve(imageSize, sizeof(BoundsNode) * hierarchy.size());
+    header.hierarchyInstanceIndicesOffset = ModelCache::reserve(imageSize, sizeof(uint32_t) * hierarchyInstanceIndices.size());
+    imageSize = ModelCache::align(imageSize);
+    m_cacheImage.resize(static_cast<size_t>(imageSize), 0);
+    copyToImage(m_cacheImage, header.instancesOffset, instances);
+    copyToImage(m_cacheImage, header.hierarchyOffset, hierarchy);
+    copyToImage(m_cacheImage, header.hierarchyInstanceIndicesOffset, hierarchyInstanceIndices);
+
+    if (options.generateMeshlets)
+    {
+        // Meshlets are built from the extracted geometry and appended to the image
+        std::vector<MeshletData> meshletData(meshCount);
+        ThreadPool::getDefault().parallelFor(meshCount, 1, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i)
             {
-                std::cerr << "Invalid mesh (number of vertices and normals do not match): " << file << "\n";
-                return false;
+                Mesh mesh;
+                setMeshGeometry(mesh, m_cacheImage.data(), meshLayouts[i].entry, vertexLayout);
+                mesh.lods = lodChains[i].lods;
+                MeshletBuilder::build(mesh, meshletData[i]);
             }
-            m_meshes.push_back(std::move(mesh));
+        });
+
+        for (unsigned int meshIndex = 0; meshIndex < meshCount; ++meshIndex)
+        {
+            ModelCache::reserveMeshlets(meshletData[meshIndex], imageSize, meshLayouts[meshIndex].entry);
+        }
+        imageSize = ModelCache::align(imageSize);
+        m_cacheImage.resize(static_cast<size_t>(imageSize), 0);
+
+        for (unsigned int meshIndex = 0; meshIndex < meshCount; ++meshIndex)
+        {
+            ModelCache::writeMeshlets(meshletData[meshIndex], meshLayouts[meshIndex].entry, m_cacheImage);
         }
     }
-    else
+
+    header.imageSize = imageSize;
+    std::memcpy(m_cacheImage.data(), &header, sizeof(header));
+
+    if (!updateProgress(state, c_writeProgress))
     {
-        std::cerr << "Failed to read model: " << file << "\n";
-        std::cerr << "Assimp error message: " << importer.GetErrorString() << "\n";
         return false;
     }
 
-    if (m_meshes.empty())
+    for (unsigned int meshIndex = 0; meshIndex < meshCount; ++meshIndex)
     {
-        std::cerr << "Empty model: " << file << "\n";
-        return false;
+        const MeshLayout& layout = meshLayouts[meshIndex];
+        const ModelCache::MeshEntry& entry = layout.entry;
+
+        ModelCache::TextureNameEntry* textureNameEntries = getImagePointer<ModelCache::TextureNameEntry>(m_cacheImage, entry.textureNamesOffset);
+        for (size_t i = 0; i < layout.textureNames.size(); ++i)
+        {
+            const std::string& name = layout.textureNames[i].second;
+            textureNameEntries[i].type = static_cast<uint32_t>(layout.textureNames[i].first);
+            textureNameEntries[i].textureIndex = getEmbeddedTextureIndex(name, aScene->mNumTextures);
+            textureNameEntries[i].length = static_cast<uint32_t>(name.size());
+            textureNameEntries[i].offset = layout.textureNameOffsets[i];
+            std::memcpy(m_cacheImage.data() + layout.textureNameOffsets[i], name.data(), name.size());
+        }
+
+        std::memcpy(m_cacheImage.data() + meshesOffset + meshIndex * sizeof(ModelCache::MeshEntry), &entry, sizeof(entry));
+    }
+
+    for (size_t i = 0; i < textureEntries.size(); ++i)
+    {
+        const ModelCache::TextureEntry& textureEntry = textureEntries[i];
+        std::memcpy(m_cacheImage.data() + textureEntry.offset, aScene->mTextures[i]->pcData, textureEntry.size);
+        std::memcpy(m_cacheImage.data() + texturesOffset + i * sizeof(ModelCache::TextureEntry), &textureEntry, sizeof(textureEntry));
     }
 
     return true;
 }
 
-const Model::Meshes& Model::getMeshes() const
+bool Model::readCacheImage(const unsigned char* data, size_t size)
 {
-    return m_meshes;
-}
+    m_meshes.clear();
+    m_textures = Span<const TextureData>();
+    m_arena.reset();
+    m_instances = Span<const MeshInstance>();
+    m_hierarchy = Span<const BoundsNode>();
+    m_hierarchyInstanceIndices = Span<const uint32_t>();
 
-const Model::TextureData& Model::getTextureData(unsigned int index)
-{
-    return m_textureDatas[index];
+    ModelCache::Header header;
+    std::memcpy(&header, data, sizeof(header));
+
+    if (!ModelCache::isRangeValid(size, header.meshesOffset, sizeof(ModelCache::MeshEntry) * header.meshCount)
+        || !ModelCache::isRangeValid(size, header.texturesOffset, sizeof(ModelCache::TextureEntry) * header.textureCount)
+        || !ModelCache::isRangeValid(size, header.instancesOffset, sizeof(MeshInstance) * header.instanceCount)
+        || !ModelCache::isRangeValid(size, header.hierarchyOffset, sizeof(BoundsNode) * header.hierarchyNodeCount)
+        || !ModelCache::isRangeValid(size, header.hierarchyInstanceIndicesOffset, sizeof(uint32_t) * header.instanceCount)
+        || header.vertexLayout > static_cast<uint32_t>(Mesh::VertexLayout::SplitPosition))
+    {
+        std::cerr << "Corrupted model cache\n";
+        return false;
+    }
+
+    m_meshes.reserve(header.meshCount);
+
+    const MeshInstance* instances = reinterpret_cast<const MeshInstance*>(data + header.instancesOffset);
+    const BoundsNode* hierarchy = reinterpret_cast<const BoundsNode*>(data + header.hierarchyOffset);
+    const uint32_t* hierarchyInstanceIndices = reinterpret_cast<const uint32_t*>(data + header.hierarchyInstanceIndicesOffset);
+    if (!isHierarchyValid(hierarchy, header.hierarchyNodeCount, hierarchyInstanceIndices, header.instanceCount)
+        || !areInstanceMeshesValid(instances, header.instanceCount, header.meshCount))
+    {
+        std::cerr << "Corrupted model cache\n";
+        return false;
+    }
+
+    const Mesh::VertexLayout vertexLayout = static_cast<Mesh::VertexLayout>(header.vertexLayout);
+    const AttributeStrides strides = getAttributeStrides(vertexLayout);
+
+    const ModelCache::MeshEntry* meshEntries = reinterpret_cast<const ModelCache::MeshEntry*>(data + header.meshesOffset);
+    for (uint32_t meshIndex = 0; meshIndex < header.meshCount; ++meshIndex)
+    {
+        const ModelCache::MeshEntry& entry = meshEntries[meshIndex];
+        // Interleaved streams always have room for tangents and uvs, missing ones are zero
+        const uint32_t streamTangentCount = vertexLayout == Mesh::VertexLayout::Separate ? entry.tangentCount : entry.vertexCount;
+        const uint32_t streamUvCount = vertexLayout == Mesh::VertexLayout::Separate ? entry.uvCount : entry.vertexCount;
+        if (!ModelCache::isRangeValid(size, entry.positionsOffset, getStridedSize(strides.position, sizeof(DirectX::XMFLOAT3), entry.vertexCount))
+            || !ModelCache::isRangeValid(size, entry.normalsOffset, getStridedSize(strides.normal, sizeof(DirectX::XMFLOAT3), entry.vertexCount))
+            || !ModelCache::isRangeValid(size, entry.tangentsOffset, getStridedSize(strides.tangent, sizeof(DirectX::XMFLOAT3), streamTangentCount))
+            || !ModelCache::isRangeValid(size, entry.uvsOffset, getStridedSize(strides.uv, sizeof(DirectX::XMFLOAT2), streamUvCount))
+            || (vertexLayout == Mesh::VertexLayout::Interleaved && !ModelCache::isRangeValid(size, entry.positionsOffset, uint64_t(strides.position) * entry.vertexCount))
+            || (vertexLayout == Mesh::VertexLayout::SplitPosition && !ModelCache::isRangeValid(size, entry.normalsOffset, uint64_t(strides.normal) * entry.vertexCount))
+            || (entry.indexSize != sizeof(uint16_t) && entry.indexSize != sizeof(uint32_t))
+            || !ModelCache::isRangeValid(size, entry.indicesOffset, uint64_t(entry.indexSize) * entry.indexCount)
+            || !ModelCache::isRangeValid(size, entry.textureNamesOffset, sizeof(ModelCache::TextureNameEntry) * entry.textureNameCount)
+            || !ModelCache::isRangeValid(size, entry.lodsOffset, sizeof(MeshLod) * entry.lodCount)
+            || !areLodsValid(entry, reinterpret_cast<const MeshLod*>(data + entry.lodsOffset))
+            || !areInstancesValid(entry, meshIndex, instances, header.instanceCount))
+        {
+            std::cerr << "Corrupted model cache\n";
+            m_meshes.clear();
+            return false;
+        }
+
+        Mesh mesh;
+        if (!ModelCache::readMeshlets(data, size, entry, mesh))
+        {
+            std::cerr << "Corrupted model cache\n";
+            m_meshes.clear();
+            return false;
+        }
+        setMeshGeometry(mesh, data, entry, vertexLayout);
+        mesh.lods = getImageSpan<MeshLod>(data, entry.lodsOffset, entry.lodCount);
+        mesh.boundingBox = entry.boundingBox;
+        mesh.boundingSphere = entry.boundingSphere;
+        mesh.instances = Span<const MeshInstance>(instances + entry.firstInstance, entry.instanceCount);
+        mesh.firstInstance = entry.firstInstance;
+
+        // Texture names point to the image, only the references are allocated
+        const ModelCache::TextureNameEntry* textureNameEntries = reinterpret_cast<const ModelCache::TextureNameEntry*>(data + entry.textureNamesOffset);
+        Mesh::TextureReference* textures = m_arena.allocateArray<Mesh::TextureReference>(entry.textureNameCount);
+        for (uint32_t i = 0; i < entry.textureNameCount; ++i)
+        {
+            const ModelCache::TextureNameEntry& textureNameEntry = textureNameEntries[i];
+            if (!ModelCache::isRangeValid(size, textureNameEntry.offset, textureNameEntry.length))
+            {
+                std::cerr << "Corrupted model cache\n";
+                m_meshes.clear();
+                return false;
+            }
+            textures[i].type = static_cast<aiTextureType>(textureNameEntry.type);
+            textures[i].textureIndex = textureNameEntry.textureIndex;
+            textures[i].name = Span<const char>(reinterpret_cast<const char*>(data + textureNameEntry.offset), textureNameEntry.length);
+        }
+        mesh.textures = Span<const Mesh::TextureReference>(textures, entry.textureNameCount);
+
+        m_meshes.push_back(std::move(mesh));
+    }
+
+    const ModelCache::TextureEntry* textureEntries = reinterpret_cast<const ModelCache::TextureEntry*>(data + header.texturesOffset);
+    TextureData* textures = m_arena.allocateArray<TextureData>(header.textureCount);
+    for (uint32_t i = 0; i < header.textureCount; ++i)
+    {
+        const ModelCache::TextureEntry& textureEntry = textureEntries[i];
+        if (textureEntry.index >= header.textureCount || !ModelCache::isRangeValid(size, textureEntry.offset, textureEntry.size))
+        {
+            std::cerr << "Corrupted model cache\n";
+            m_meshes.clear();
+            return false;
+        }
+        textures[textureEntry.index] = TextureData(data + textureEntry.offset, static_cast<size_t>(textureEntry.size));
+    }
+    m_textures = Span<const TextureData>(textures, header.textureCount);
+
+    if (m_meshes.empty())
+    {
+        std::cerr << "Empty model\n";
+        return false;
+    }
+
+    // Every mesh has at least one instance
+    m_instances = Span<const MeshInstance>(instances, header.instanceCount);
+    m_hierarchy = Span<const BoundsNode>(hierarchy, header.hierarchyNodeCount);
+    m_hierarchyInstanceIndices = Span<const uint32_t>(hierarchyInstanceIndices, header.instanceCount);
+    for (size_t i = 0; i < m_instances.size(); ++i)
+    {
+        const MeshInstance& instance = m_instances[i];
+        const Mesh& mesh = m_meshes[instance.meshIndex];
+        const DirectX::BoundingBox box = Bounds::transform(mesh.boundingBox, instance.transform);
+        const DirectX::BoundingSphere sphere = Bounds::transform(mesh.boundingSphere, instance.transform);
+        if (i == 0)
+        {
+            m_boundingBox = box;
+            m_boundingSphere = sphere;
+        }
+        else
+        {
+            DirectX::BoundingBox::CreateMerged(m_boundingBox, m_boundingBox, box);
+            DirectX::BoundingSphere::CreateMerged(m_boundingSphere, m_boundingSphere, sphere);
+        }
+    }
+
+    return true;
 }
 
 } // namespace fw
@@ -0,0 +1,170 @@
+#include "ModelCache.h"
+#include "MappedFile.h"
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+namespace
+{
+const char* c_cacheExtension = ".d12mesh";
+const uint64_t c_fnvOffsetBasis = 0xcbf29ce484222325ull;
+const uint64_t c_fnvPrime = 0x100000001b3ull;
+
+template<typename T>
+void copyToImage(std::vector<unsigned char>& image, uint64_t offset, const std::vector<T>& source)
+{
+    if (!source.empty())
+    {
+        std::memcpy(image.data() + offset, source.data(), source.size() * sizeof(T));
+    }
+}
+
+bool areMeshletsValid(const fw::ModelCache::MeshEntry& entry, const fw::Meshlet* meshlets)
+{
+    for (uint32_t i = 0; i < entry.meshletCount; ++i)
+    {
+        const fw::Meshlet& meshlet = meshlets[i];
+        if (meshlet.vertexCount > fw::MeshletBuilder::c_maxVertices
+            || meshlet.triangleCount > fw::MeshletBuilder::c_maxTriangles
+            || uint64_t(meshlet.vertexOffset) + meshlet.vertexCount > entry.meshletVertexCount
+            || uint64_t(meshlet.triangleOffset) + uint64_t(meshlet.triangleCount) * 3 > entry.meshletTriangleIndexCount)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+} // namespace
+
+namespace fw
+{
+std::string ModelCache::getCachePath(const std::string& sourceFile)
+{
+    return sourceFile + c_cacheExtension;
+}
+
+bool ModelCache::hashFile(const std::string& file, uint64_t& hash)
+{
+    MappedFile mappedFile;
+    if (!mappedFile.open(file))
+    {
+        return false;
+    }
+
+    hash = hashData(mappedFile.getData(), mappedFile.getSize());
+    return true;
+}
+
+uint64_t ModelCache::hashData(const void* data, size_t size)
+{
+    return hashData(data, size, c_fnvOffsetBasis);
+}
+
+uint64_t ModelCache::hashData(const void* data, size_t size, uint64_t hash)
+{
+    // FNV-1a
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash ^= bytes[i];
+        hash *= c_fnvPrime;
+    }
+    return hash;
+}
+
+bool ModelCache::isValid(const unsigned char* data, size_t size, const Header& key)
+{
+    if (data == nullptr || size < sizeof(Header))
+    {
+        return false;
+    }
+
+    Header header;
+    std::memcpy(&header, data, sizeof(Header));
+
+    return header.magic == c_magic
+        && header.version == c_version
+        && header.sourceHash == key.sourceHash
+        && header.importFlags == key.importFlags
+        && header.vertexLayout == key.vertexLayout
+        && header.contentFlags == key.contentFlags
+        && header.lodRatiosHash == key.lodRatiosHash
+        && header.imageSize == size;
+}
+
+bool ModelCache::isRangeValid(size_t imageSize, uint64_t offset, uint64_t size)
+{
+    return offset <= imageSize && size <= imageSize - offset;
+}
+
+bool ModelCache::write(const std::string& path, const std::vector<unsigned char>& image)
+{
+    // Write to a temporary file first so that a partially written cache is never picked up
+    const std::string tempPath = path + ".tmp";
+    {
+        std::ofstream stream(tempPath, std::ios::binary | std::ios::trunc);
+        if (!stream)
+        {
+            return false;
+        }
+        stream.write(reinterpret_cast<const char*>(image.data()), image.size());
+        if (!stream)
+        {
+            stream.close();
+            std::remove(tempPath.c_str());
+            return false;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tempPath, path, error);
+    if (error)
+    {
+        std::cerr << "Failed to write cache " << path << ": " << error.message() << "\n";
+        std::remove(tempPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+void ModelCache::reserveMeshlets(const MeshletData& meshlets, uint64_t& imageSize, MeshEntry& entry)
+{
+    entry.meshletCount = static_cast<uint32_t>(meshlets.meshlets.size());
+    entry.meshletVertexCount = static_cast<uint32_t>(meshlets.vertices.size());
+    entry.meshletTriangleIndexCount = static_cast<uint32_t>(meshlets.triangles.size());
+    entry.meshletsOffset = reserve(imageSize, sizeof(Meshlet) * meshlets.meshlets.size());
+    entry.meshletBoundsOffset = reserve(imageSize, sizeof(MeshletBounds) * meshlets.bounds.size());
+    entry.meshletVerticesOffset = reserve(imageSize, sizeof(uint32_t) * meshlets.vertices.size());
+    entry.meshletTrianglesOffset = reserve(imageSize, meshlets.triangles.size());
+}
+
+void ModelCache::writeMeshlets(const MeshletData& meshlets, const MeshEntry& entry, std::vector<unsigned char>& image)
+{
+    copyToImage(image, entry.meshletsOffset, meshlets.meshlets);
+    copyToImage(image, entry.meshletBoundsOffset, meshlets.bounds);
+    copyToImage(image, entry.meshletVerticesOffset, meshlets.vertices);
+    copyToImage(image, entry.meshletTrianglesOffset, meshlets.triangles);
+}
+
+bool ModelCache::readMeshlets(const unsigned char* data, size_t size, const MeshEntry& entry, Mesh& mesh)
+{
+    if (!isRangeValid(size, entry.meshletsOffset, sizeof(Meshlet) * entry.meshletCount)
+        || !isRangeValid(size, entry.meshletBoundsOffset, sizeof(MeshletBounds) * entry.meshletCount)
+        || !isRangeValid(size, entry.meshletVerticesOffset, sizeof(uint32_t) * entry.meshletVertexCount)
+        || !isRangeValid(size, entry.meshletTrianglesOffset, entry.meshletTriangleIndexCount)
+        || !areMeshletsValid(entry, reinterpret_cast<const Meshlet*>(data + entry.meshletsOffset)))
+    {
+        return false;
+    }
+
+    mesh.meshlets = Span<const Meshlet>(reinterpret_cast<const Meshlet*>(data + entry.meshletsOffset), entry.meshletCount);
+    mesh.meshletBounds = Span<const MeshletBounds>(reinterpret_cast<const MeshletBounds*>(data + entry.meshletBoundsOffset), entry.meshletCount);
+    mesh.meshletVertices = Span<const uint32_t>(reinterpret_cast<const uint32_t*>(data + entry.meshletVerticesOffset), entry.meshletVertexCount);
+    mesh.meshletTriangles = Span<const uint8_t>(data + entry.meshletTrianglesOffset, entry.meshletTriangleIndexCount);
+    return true;
+}
+
+} // namespace fw
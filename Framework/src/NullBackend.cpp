@@ -0,0 +1,1668 @@
+#include "NullBackend.h"
+#include "Macros.h"
+
+#include <windows.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace
+{
+// Descriptor handles and GPU addresses only have to be distinct, nothing reads through them
+const UINT c_descriptorSize = 32;
+const SIZE_T c_firstCpuDescriptor = 0x10000;
+const UINT64 c_firstGpuDescriptor = 0x10000;
+const D3D12_GPU_VIRTUAL_ADDRESS c_firstGpuAddress = 0x100000000;
+// Timestamps are nanoseconds, they all read back as zero
+const UINT64 c_timestampFrequency = 1000000000;
+
+struct FormatInfo
+{
+    // Pixels per side of a block, 1 for uncompressed formats
+    UINT blockDimension;
+    UINT blockSize;
+};
+
+FormatInfo getFormatInfo(DXGI_FORMAT format)
+{
+    switch (format)
+    {
+    case DXGI_FORMAT_UNKNOWN:
+        return FormatInfo{1, 1};
+    case DXGI_FORMAT_R32G32B32A32_TYPELESS:
+    case DXGI_FORMAT_R32G32B32A32_FLOAT:
+    case DXGI_FORMAT_R32G32B32A32_UINT:
+    case DXGI_FORMAT_R32G32B32A32_SINT:
+        return FormatInfo{1, 16};
+    case DXGI_FORMAT_R32G32B32_TYPELESS:
+    case DXGI_FORMAT_R32G32B32_FLOAT:
+    case DXGI_FORMAT_R32G32B32_UINT:
+    case DXGI_FORMAT_R32G32B32_SINT:
+        return FormatInfo{1, 12};
+    case DXGI_FORMAT_R16G16B16A16_TYPELESS:
+    case DXGI_FORMAT_R16G16B16A16_FLOAT:
+    case DXGI_FORMAT_R16G16B16A16_UNORM:
+    case DXGI_FORMAT_R16G16B16A16_UINT:
+    case DXGI_FORMAT_R16G16B16A16_SNORM:
+    case DXGI_FORMAT_R16G16B16A16_SINT:
+    case DXGI_FORMAT_R32G32_TYPELESS:
+    case DXGI_FORMAT_R32G32_FLOAT:
+    case DXGI_FORMAT_R32G32_UINT:
+    case DXGI_FORMAT_R32G32_SINT:
+    case DXGI_FORMAT_R32G8X24_TYPELESS:
+    case DXGI_FORMAT_D32_FLOAT_S8X24_UINT:
+    case DXGI_FORMAT_R32_FLOAT_X8X24_TYPELESS:
+    case DXGI_FORMAT_X32_TYPELESS_G8X24_UINT:
+        return FormatInfo{1, 8};
+    case DXGI_FORMAT_R8G8_TYPELESS:
+    case DXGI_FORMAT_R8G8_UNORM:
+    case DXGI_FORMAT_R8G8_UINT:
+    case DXGI_FORMAT_R8G8_SNORM:
+    case DXGI_FORMAT_R8G8_SINT:
+    case DXGI_FORMAT_R16_TYPELESS:
+    case DXGI_FORMAT_R16_FLOAT:
+    case DXGI_FORMAT_D16_UNORM:
+    case DXGI_FORMAT_R16_UNORM:
+    case DXGI_FORMAT_R16_UINT:
+    case DXGI_FORMAT_R16_SNORM:
+    case DXGI_FORMAT_R16_SINT:
+    case DXGI_FORMAT_B5G6R5_UNORM:
+    case DXGI_FORMAT_B5G5R5A1_UNORM:
+        return FormatInfo{1, 2};
+    case DXGI_FORMAT_R8_TYPELESS:
+    case DXGI_FORMAT_R8_UNORM:
+    case DXGI_FORMAT_R8_UINT:
+    case DXGI_FORMAT_R8_SNORM:
+    case DXGI_FORMAT_R8_SINT:
+    case DXGI_FORMAT_A8_UNORM:
+        return FormatInfo{1, 1};
+    case DXGI_FORMAT_BC1_TYPELESS:
+    case DXGI_FORMAT_BC1_UNORM:
+    case DXGI_FORMAT_BC1_UNORM_SRGB:
+    case DXGI_FORMAT_BC4_TYPELESS:
+    case DXGI_FORMAT_BC4_UNORM:
+    case DXGI_FORMAT_BC4_SNORM:
+        return FormatInfo{4, 8};
+    case DXGI_FORMAT_BC2_TYPELESS:
+    case DXGI_FORMAT_BC2_UNORM:
+    case DXGI_FORMAT_BC2_UNORM_SRGB:
+    case DXGI_FORMAT_BC3_TYPELESS:
+    case DXGI_FORMAT_BC3_UNORM:
+    case DXGI_FORMAT_BC3_UNORM_SRGB:
+    case DXGI_FORMAT_BC5_TYPELESS:
+    case DXGI_FORMAT_BC5_UNORM:
+    case DXGI_FORMAT_BC5_SNORM:
+    case DXGI_FORMAT_BC6H_TYPELESS:
+    case DXGI_FORMAT_BC6H_UF16:
+    case DXGI_FORMAT_BC6H_SF16:
+    case DXGI_FORMAT_BC7_TYPELESS:
+    case DXGI_FORMAT_BC7_UNORM:
+    case DXGI_FORMAT_BC7_UNORM_SRGB:
+        return FormatInfo{4, 16};
+    default:
+        // The remaining formats that can be in a texture have 32-bit pixels
+        return FormatInfo{1, 4};
+    }
+}
+
+UINT getMipLevelCount(const D3D12_RESOURCE_DESC& desc)
+{
+    if (desc.MipLevels != 0)
+    {
+        return desc.MipLevels;
+    }
+    UINT64 size = std::max<UINT64>(desc.Width, desc.Height);
+    UINT levelCount = 1;
+    while (size > 1)
+    {
+        size /= 2;
+        ++levelCount;
+    }
+    return levelCount;
+}
+
+// Tightly packed rows at the pitch and placement alignments of D3D12, returns the size of the footprints
+UINT64 getFootprints(const D3D12_RESOURCE_DESC& desc,
+                     UINT firstSubresource,
+                     UINT subresourceCount,
+                     UINT64 baseOffset,
+                     D3D12_PLACED_SUBRESOURCE_FOOTPRINT* layouts,
+                     UINT* rowCounts,
+                     UINT64* rowSizes)
+{
+    if (desc.Dimension == D3D12_RESOURCE_DIMENSION_BUFFER)
+    {
+        if (layouts)
+        {
+            layouts[0].Offset = baseOffset;
+            layouts[0].Footprint = D3D12_SUBRESOURCE_FOOTPRINT{DXGI_FORMAT_UNKNOWN, static_cast<UINT>(desc.Width), 1, 1, static_cast<UINT>(ROUND_UP(desc.Width, D3D12_TEXTURE_DATA_PITCH_ALIGNMENT))};
+        }
+        if (rowCounts)
+        {
+            rowCounts[0] = 1;
+        }
+        if (rowSizes)
+        {
+            rowSizes[0] = desc.Width;
+        }
+        return desc.Width;
+    }
+
+    const FormatInfo formatInfo = getFormatInfo(desc.Format);
+    const UINT mipLevelCount = getMipLevelCount(desc);
+    UINT64 offset = 0;
+    UINT64 totalSize = 0;
+    for (UINT i = 0; i < subresourceCount; ++i)
+    {
+        // Planes of depth stencil formats are laid out like array slices of the first plane
+        const UINT mipLevel = (firstSubresource + i) % mipLevelCount;
+        const UINT width = std::max(static_cast<UINT>(desc.Width >> mipLevel), 1u);
+        const UINT height = std::max(desc.Height >> mipLevel, 1u);
+        const UINT depth = desc.Dimension == D3D12_RESOURCE_DIMENSION_TEXTURE3D ? std::max<UINT>(desc.DepthOrArraySize >> mipLevel, 1) : 1;
+        const UINT blockColumnCount = (width + formatInfo.blockDimension - 1) / formatInfo.blockDimension;
+        const UINT rowCount = (height + formatInfo.blockDimension - 1) / formatInfo.blockDimension;
+        const UINT64 rowSize = UINT64(blockColumnCount) * formatInfo.blockSize;
+        const UINT64 rowPitch = ROUND_UP(rowSize, D3D12_TEXTURE_DATA_PITCH_ALIGNMENT);
+
+        offset = ROUND_UP(offset, D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT);
+        if (layouts)
+        {
+            layouts[i].Offset = baseOffset + offset;
+            layouts[i].Footprint = D3D12_SUBRESOURCE_FOOTPRINT{desc.Format, blockColumnCount * formatInfo.blockDimension, rowCount * formatInfo.blockDimension, depth, static_cast<UINT>(rowPitch)};
+        }
+        if (rowCounts)
+        {
+            rowCounts[i] = rowCount;
+        }
+        if (rowSizes)
+        {
+            rowSizes[i] = rowSize;
+        }
+        // The last row is not padded to the pitch
+        totalSize = offset + rowPitch * (UINT64(rowCount) * depth - 1) + rowSize;
+        offset += rowPitch * rowCount * depth;
+    }
+    return totalSize;
+}
+
+D3D12_RESOURCE_ALLOCATION_INFO getAllocationInfo(const D3D12_RESOURCE_DESC& desc)
+{
+    if (desc.Dimension == D3D12_RESOURCE_DIMENSION_BUFFER)
+    {
+        return D3D12_RESOURCE_ALLOCATION_INFO{ROUND_UP(desc.Width, D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT), D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT};
+    }
+
+    const UINT subresourceCount = getMipLevelCount(desc) * (desc.Dimension == D3D12_RESOURCE_DIMENSION_TEXTURE3D ? 1 : desc.DepthOrArraySize);
+    const UINT64 size = getFootprints(desc, 0, subresourceCount, 0, nullptr, nullptr, nullptr) * desc.SampleDesc.Count;
+    const bool isRenderTarget = (desc.Flags & (D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET | D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL)) != 0;
+    UINT64 alignment = desc.SampleDesc.Count > 1 ? D3D12_DEFAULT_MSAA_RESOURCE_PLACEMENT_ALIGNMENT : D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
+    // The small alignment is granted like on hardware, when it is asked for and the texture fits into a 64 KB tile
+    if (desc.Alignment == D3D12_SMALL_RESOURCE_PLACEMENT_ALIGNMENT && !isRenderTarget && desc.SampleDesc.Count == 1 && size <= D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT)
+    {
+        alignment = D3D12_SMALL_RESOURCE_PLACEMENT_ALIGNMENT;
+    }
+    return D3D12_RESOURCE_ALLOCATION_INFO{ROUND_UP(size, alignment), alignment};
+}
+
+bool isCpuAccessible(const D3D12_HEAP_PROPERTIES& heapProperties)
+{
+    if (heapProperties.Type == D3D12_HEAP_TYPE_CUSTOM)
+    {
+        return heapProperties.CPUPageProperty != D3D12_CPU_PAGE_PROPERTY_NOT_AVAILABLE;
+    }
+    return heapProperties.Type == D3D12_HEAP_TYPE_UPLOAD || heapProperties.Type == D3D12_HEAP_TYPE_READBACK;
+}
+
+// Hands out the interface of a new object, which is released again if it does not have the interface
+template<typename T>
+HRESULT queryNewObject(T* object, REFIID riid, void** result)
+{
+    Microsoft::WRL::ComPtr<T> owner;
+    owner.Attach(object);
+    if (!result)
+    {
+        return S_FALSE;
+    }
+    return owner->QueryInterface(riid, result);
+}
+
+// IUnknown and ID3D12Object of every null object. QueryInterface hands out the interface and the interfaces that
+// it derives from, which all start at the same address.
+template<typename Interface, typename... BaseInterfaces>
+class NullObject : public Interface
+{
+public:
+    NullObject(){};
+    virtual ~NullObject(){};
+    NullObject(const NullObject&) = delete;
+    NullObject(NullObject&&) = delete;
+    NullObject& operator=(const NullObject&) = delete;
+    NullObject& operator=(NullObject&&) = delete;
+
+    HRESULT STDMETHODCALLTYPE QueryInterface(REFIID riid, void** object) override
+    {
+        if (!object)
+        {
+            return E_POINTER;
+        }
+        if (riid == __uuidof(IUnknown) || riid == __uuidof(ID3D12Object) || riid == __uuidof(Interface) || ((riid == __uuidof(BaseInterfaces)) || ...))
+        {
+            *object = static_cast<Interface*>(this);
+            AddRef();
+            return S_OK;
+        }
+        *object = nullptr;
+        return E_NOINTERFACE;
+    }
+
+    ULONG STDMETHODCALLTYPE AddRef() override
+    {
+        return ++m_refCount;
+    }
+
+    ULONG STDMETHODCALLTYPE Release() override
+    {
+        const ULONG refCount = --m_refCount;
+        if (refCount == 0)
+        {
+            delete this;
+        }
+        return refCount;
+    }
+
+    HRESULT STDMETHODCALLTYPE GetPrivateData(REFGUID guid, UINT* dataSize, void* data) override
+    {
+        std::lock_guard<std::mutex> lock(m_privateDataMutex);
+        auto privateData = findPrivateData(guid);
+        if (privateData == m_privateData.end())
+        {
+            *dataSize = 0;
+            return DXGI_ERROR_NOT_FOUND;
+        }
+
+        const UINT size = privateData->object ? sizeof(IUnknown*) : static_cast<UINT>(privateData->data.size());
+        if (!data)
+        {
+            *dataSize = size;
+            return S_OK;
+        }
+        if (*dataSize < size)
+        {
+            *dataSize = size;
+            return DXGI_ERROR_MORE_DATA;
+        }
+        *dataSize = size;
+
+        // Getting an interface adds a reference to it
+        if (privateData->object)
+        {
+            IUnknown* object = privateData->object.Get();
+            object->AddRef();
+            std::memcpy(data, &object, sizeof(object));
+        }
+        else
+        {
+            std::memcpy(data, privateData->data.data(), size);
+        }
+        return S_OK;
+    }
+
+    HRESULT STDMETHODCALLTYPE SetPrivateData(REFGUID guid, UINT dataSize, const void* data) override
+    {
+        std::lock_guard<std::mutex> lock(m_privateDataMutex);
+        PrivateData& privateData = replacePrivateData(guid);
+        if (data)
+        {
+            privateData.data.assign(static_cast<const unsigned char*>(data), static_cast<const unsigned char*>(data) + dataSize);
+        }
+        else
+        {
+            m_privateData.pop_back();
+        }
+        return S_OK;
+    }
+
+    HRESULT STDMETHODCALLTYPE SetPrivateDataInterface(REFGUID guid, const IUnknown* data) override
+    {
+        std::lock_guard<std::mutex> lock(m_privateDataMutex);
+        PrivateData& privateData = replacePrivateData(guid);
+        if (data)
+        {
+            privateData.object = const_cast<IUnknown*>(data);
+        }
+        else
+        {
+            m_privateData.pop_back();
+        }
+        return S_OK;
+    }
+
+    HRESULT STDMETHODCALLTYPE SetName(LPCWSTR /*name*/) override
+    {
+        return S_OK;
+    }
+
+private:
+    // Either data or a reference to an interface
+    struct PrivateData
+    {
+        GUID guid;
+        std::vector<unsigned char> data;
+        Microsoft::WRL::ComPtr<IUnknown> object;
+    };
+
+    std::atomic<ULONG> m_refCount{1};
+    std::mutex m_privateDataMutex;
+    std::vector<PrivateData> m_privateData;
+
+    typename std::vector<PrivateData>::iterator findPrivateData(REFGUID guid)
+    {
+        return std::find_if(m_privateData.begin(), m_privateData.end(), [&guid](const PrivateData& privateData) { return privateData.guid == guid; });
+    }
+
+    // The new private data of the GUID is the last one
+    PrivateData& replacePrivateData(REFGUID guid)
+    {
+        auto privateData = findPrivateData(guid);
+        if (privateData != m_privateData.end())
+        {
+            m_privateData.erase(privateData);
+        }
+        m_privateData.push_back(PrivateData{guid, {}, nullptr});
+        return m_privateData.back();
+    }
+};
+
+class NullDevice : public NullObject<ID3D12Device5, ID3D12Device, ID3D12Device1, ID3D12Device2, ID3D12Device3, ID3D12Device4>
+{
+public:
+    NullDevice(){};
+
+    fw::Backend::Counters getCounters() const;
+    void addCounters(const fw::Backend::Counters& counters);
+    D3D12_GPU_VIRTUAL_ADDRESS allocateGpuAddress(UINT64 size);
+
+    // ID3D12Device
+    UINT STDMETHODCALLTYPE GetNodeCount() override;
+    HRESULT STDMETHODCALLTYPE CreateCommandQueue(const D3D12_COMMAND_QUEUE_DESC* desc, REFIID riid, void** commandQueue) override;
+    HRESULT STDMETHODCALLTYPE CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE type, REFIID riid, void** commandAllocator) override;
+    HRESULT STDMETHODCALLTYPE CreateGraphicsPipelineState(const D3D12_GRAPHICS_PIPELINE_STATE_DESC* desc, REFIID riid, void** pipelineState) override;
+    HRESULT STDMETHODCALLTYPE CreateComputePipelineState(const D3D12_COMPUTE_PIPELINE_STATE_DESC* desc, REFIID riid, void** pipelineState) override;
+    HRESULT STDMETHODCALLTYPE
+    CreateCommandList(UINT nodeMask, D3D12_COMMAND_LIST_TYPE type, ID3D12CommandAllocator* commandAllocator, ID3D12PipelineState* initialState, REFIID riid, void** commandList) override;
+    HRESULT STDMETHODCALLTYPE CheckFeatureSupport(D3D12_FEATURE feature, void* featureSupportData, UINT featureSupportDataSize) override;
+    HRESULT STDMETHODCALLTYPE CreateDescriptorHeap(const D3D12_DESCRIPTOR_HEAP_DESC* descriptorHeapDesc, REFIID riid, void** heap) override;
+    UINT STDMETHODCALLTYPE GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE descriptorHeapType) override;
+    HRESULT STDMETHODCALLTYPE CreateRootSignature(UINT nodeMask, const void* blobWithRootSignature, SIZE_T blobLengthInBytes, REFIID riid, void** rootSignature) override;
+    void STDMETHODCALLTYPE CreateConstantBufferView(const D3D12_CONSTANT_BUFFER_VIEW_DESC* desc, D3D12_CPU_DESCRIPTOR_HANDLE destDescriptor) override;
+    void STDMETHODCALLTYPE CreateShaderResourceView(ID3D12Resource* resource, const D3D12_SHADER_RESOURCE_VIEW_DESC* desc, D3D12_CPU_DESCRIPTOR_HANDLE destDescriptor) override;
+    void STDMETHODCALLTYPE CreateUnorderedAccessView(ID3D12Resource* resource,
+                                                     ID3D12Resource* counterResource,
+                                                     const D3D12_UNORDERED_ACCESS_VIEW_DESC* desc,
+                                                     D3D12_CPU_DESCRIPTOR_HANDLE destDescriptor) override;
+    void STDMETHODCALLTYPE CreateRenderTargetView(ID3D12Resource* resource, const D3D12_RENDER_TARGET_VIEW_DESC* desc, D3D12_CPU_DESCRIPTOR_HANDLE destDescriptor) override;
+    void STDMETHODCALLTYPE CreateDepthStencilView(ID3D12Resource* resource, const D3D12_DEPTH_STENCIL_VIEW_DESC* desc, D3D12_CPU_DESCRIPTOR_HANDLE destDescriptor) override;
+    void STDMETHODCALLTYPE CreateSampler(const D3D12_SAMPLER_DESC* desc, D3D12_CPU_DESCRIPTOR_HANDLE destDescriptor) override;
+    void STDMETHODCALLTYPE CopyDescriptors(UINT destDescriptorRangeCount,
+                                           const D3D12_CPU_DESCRIPTOR_HANDLE* destDescriptorRangeStarts,
+                                           const UINT* destDescriptorRangeSizes,
+                                           UINT srcDescriptorRangeCount,
+                                           const D3D12_CPU_DESCRIPTOR_HANDLE* srcDescriptorRangeStarts,
+                                           const UINT* srcDescriptorRangeSizes,
+                                           D3D12_DESCRIPTOR_HEAP_TYPE descriptorHeapsType) override;
+    void STDMETHODCALLTYPE CopyDescriptorsSimple(UINT descriptorCount,
+                                                 D3D12_CPU_DESCRIPTOR_HANDLE destDescriptorRangeStart,
+                                                 D3D12_CPU_DESCRIPTOR_HANDLE srcDescriptorRangeStart,
+                                                 D3D12_DESCRIPTOR_HEAP_TYPE descriptorHeapsType) override;
+    D3D12_RESOURCE_ALLOCATION_INFO STDMETHODCALLTYPE GetResourceAllocationInfo(UINT visibleMask, UINT resourceDescCount, const D3D12_RESOURCE_DESC* resourceDescs) override;
+    D3D12_HEAP_PROPERTIES STDMETHODCALLTYPE GetCustomHeapProperties(UINT nodeMask, D3D12_HEAP_TYPE heapType) override;
+    HRESULT STDMETHODCALLTYPE CreateCommittedResource(const D3D12_HEAP_PROPERTIES* heapProperties,
+                                                      D3D12_HEAP_FLAGS heapFlags,
+                                                      const D3D12_RESOURCE_DESC* desc,
+                                                      D3D12_RESOURCE_STATES initialResourceState,
+                                                      const D3D12_CLEAR_VALUE* optimizedClearValue,
+                                                      REFIID riidResource,
+                                                      void** resource) override;
+    HRESULT STDMETHODCALLTYPE CreateHeap(const D3D12_HEAP_DESC* desc, REFIID riid, void** heap) override;
+    HRESULT STDMETHODCALLTYPE CreatePlacedResource(ID3D12Heap* heap,
+                                                   UINT64 heapOffset,
+                                                   const D3D12_RESOURCE_DESC* desc,
+                                                   D3D12_RESOURCE_STATES initialState,
+                                                   const D3D12_CLEAR_VALUE* optimizedClearValue,
+                                                   REFIID riid,
+                                                   void** resource) override;
+    HRESULT STDMETHODCALLTYPE
+    CreateReservedResource(const D3D12_RESOURCE_DESC* desc, D3D12_RESOURCE_STATES initialState, const D3D12_CLEAR_VALUE* optimizedClearValue, REFIID riid, void** resource) override;
+    HRESULT STDMETHODCALLTYPE CreateSharedHandle(ID3D12DeviceChild* object, const SECURITY_ATTRIBUTES* attributes, DWORD access, LPCWSTR name, HANDLE* handle) override;
+    HRESULT STDMETHODCALLTYPE OpenSharedHandle(HANDLE ntHandle, REFIID riid, void** object) override;
+    HRESULT STDMETHODCALLTYPE OpenSharedHandleByName(LPCWSTR name, DWORD access, HANDLE* ntHandle) override;
+    HRESULT STDMETHODCALLTYPE MakeResident(UINT objectCount, ID3D12Pageable* const* objects) override;
+    HRESULT STDMETHODCALLTYPE Evict(UINT objectCount, ID3D12Pageable* const* objects) override;
+    HRESULT STDMETHODCALLTYPE CreateFence(UINT64 initialValue, D3D12_FENCE_FLAGS flags, REFIID riid, void** fence) override;
+    HRESULT STDMETHODCALLTYPE GetDeviceRemovedReason() override;
+    void STDMETHODCALLTYPE GetCopyableFootprints(const D3D12_RESOURCE_DESC* resourceDesc,
+                                                 UINT firstSubresource,
+                                                 UINT subresourceCount,
+                                                 UINT64 baseOffset,
+                                                 D3D12_PLACED_SUBRESOURCE_FOOTPRINT* layouts,
+                                                 UINT* rowCounts,
+                                                 UINT64* rowSizesInBytes,
+                                                 UINT64* totalBytes) override;
+    HRESULT STDMETHODCALLTYPE CreateQueryHeap(const D3D12_QUERY_HEAP_DESC* desc, REFIID riid, void** heap) override;
+    HRESULT STDMETHODCALLTYPE SetStablePowerState(BOOL enable) override;
+    HRESULT STDMETHODCALLTYPE CreateCommandSignature(const D3D12_COMMAND_SIGNATURE_DESC* desc, ID3D12RootSignature* rootSignature, REFIID riid, void** commandSignature) override;
+    void STDMETHODCALLTYPE GetResourceTiling(ID3D12Resource* tiledResource,
+                                             UINT* tileCountForEntireResource,
+                                             D3D12_PACKED_MIP_INFO* packedMipDesc,
+                                             D3D12_TILE_SHAPE* standardTileShapeForNonPackedMips,
+                                             UINT* subresourceTilingCount,
+                                             UINT firstSubresourceTilingToGet,
+                                             D3D12_SUBRESOURCE_TILING* subresourceTilingsForNonPackedMips) override;
+    LUID STDMETHODCALLTYPE GetAdapterLuid() override;
+
+    // ID3D12Device1
+    HRESULT STDMETHODCALLTYPE CreatePipelineLibrary(const void* libraryBlob, SIZE_T blobLength, REFIID riid, void** pipelineLibrary) override;
+    HRESULT STDMETHODCALLTYPE
+    SetEventOnMultipleFenceCompletion(ID3D12Fence* const* fences, const UINT64* fenceValues, UINT fenceCount, D3D12_MULTIPLE_FENCE_WAIT_FLAGS flags, HANDLE event) override;
+    HRESULT STDMETHODCALLTYPE SetResidencyPriority(UINT objectCount, ID3D12Pageable* const* objects, const D3D12_RESIDENCY_PRIORITY* priorities) override;
+
+    // ID3D12Device2
+    HRESULT STDMETHODCALLTYPE CreatePipelineState(const D3D12_PIPELINE_STATE_STREAM_DESC* desc, REFIID riid, void** pipelineState) override;
+
+    // ID3D12Device3
+    HRESULT STDMETHODCALLTYPE OpenExistingHeapFromAddress(const void* address, REFIID riid, void** heap) override;
+    HRESULT STDMETHODCALLTYPE OpenExistingHeapFromFileMapping(HANDLE fileMapping, REFIID riid, void** heap) override;
+    HRESULT STDMETHODCALLTYPE
+    EnqueueMakeResident(D3D12_RESIDENCY_FLAGS flags, UINT objectCount, ID3D12Pageable* const* objects, ID3D12Fence* fenceToSignal, UINT64 fenceValueToSignal) override;
+
+    // ID3D12Device4
+    HRESULT STDMETHODCALLTYPE CreateCommandList1(UINT nodeMask, D3D12_COMMAND_LIST_TYPE type, D3D12_COMMAND_LIST_FLAGS flags, REFIID riid, void** commandList) override;
+    HRESULT STDMETHODCALLTYPE CreateProtectedResourceSession(const D3D12_PROTECTED_RESOURCE_SESSION_DESC* desc, REFIID riid, void** session) override;
+    HRESULT STDMETHODCALLTYPE CreateCommittedResource1(const D3D12_HEAP_PROPERTIES* heapProperties,
+                                                       D3D12_HEAP_FLAGS heapFlags,
+                                                       const D3D12_RESOURCE_DESC* desc,
+                                                       D3D12_RESOURCE_STATES initialResourceState,
+                                                       const D3D12_CLEAR_VALUE* optimizedClearValue,
+                                                       ID3D12ProtectedResourceSession* protectedSession,
+                                                       REFIID riidResource,
+                                                       void** resource) override;
+    HRESULT STDMETHODCALLTYPE CreateHeap1(const D3D12_HEAP_DESC* desc, ID3D12ProtectedResourceSession* protectedSession, REFIID riid, void** heap) override;
+    HRESULT STDMETHODCALLTYPE CreateReservedResource1(const D3D12_RESOURCE_DESC* desc,
+                                                      D3D12_RESOURCE_STATES initialState,
+                                                      const D3D12_CLEAR_VALUE* optimizedClearValue,
+                                                      ID3D12ProtectedResourceSession* protectedSession,
+                                                      REFIID riid,
+                                                      void** resource) override;
+    D3D12_RESOURCE_ALLOCATION_INFO STDMETHODCALLTYPE GetResourceAllocationInfo1(UINT visibleMask,
+                                                                                UINT resourceDescCount,
+                                                                                const D3D12_RESOURCE_DESC* resourceDescs,
+                                                                                D3D12_RESOURCE_ALLOCATION_INFO1* resourceAllocationInfo1) override;
+
+    // ID3D12Device5
+    HRESULT STDMETHODCALLTYPE CreateLifetimeTracker(ID3D12LifetimeOwner* owner, REFIID riid, void** tracker) override;
+    void STDMETHODCALLTYPE RemoveDevice() override;
+    HRESULT STDMETHODCALLTYPE EnumerateMetaCommands(UINT* metaCommandCount, D3D12_META_COMMAND_DESC* descs) override;
+    HRESULT STDMETHODCALLTYPE EnumerateMetaCommandParameters(REFGUID commandId,
+                                                             D3D12_META_COMMAND_PARAMETER_STAGE stage,
+                                                             UINT* totalStructureSizeInBytes,
+                                                             UINT* parameterCount,
+                                                             D3D12_META_COMMAND_PARAMETER_DESC* parameterDescs) override;
+    HRESULT STDMETHODCALLTYPE
+    CreateMetaCommand(REFGUID commandId, UINT nodeMask, const void* creationParametersData, SIZE_T creationParametersDataSizeInBytes, REFIID riid, void** metaCommand) override;
+    HRESULT STDMETHODCALLTYPE CreateStateObject(const D3D12_STATE_OBJECT_DESC* desc, REFIID riid, void** stateObject) override;
+    void STDMETHODCALLTYPE GetRaytracingAccelerationStructurePrebuildInfo(const D3D12_BUILD_RAYTRACING_ACCELERATION_STRUCTURE_INPUTS* desc,
+                                                                          D3D12_RAYTRACING_ACCELERATION_STRUCTURE_PREBUILD_INFO* info) override;
+    D3D12_DRIVER_MATCHING_IDENTIFIER_STATUS STDMETHODCALLTYPE CheckDriverMatchingIdentifier(D3D12_SERIALIZED_DATA_TYPE serializedDataType,
+                                                                                            const D3D12_SERIALIZED_DATA_DRIVER_MATCHING_IDENTIFIER* identifierToCheck) override;
+
+private:
+    mutable std::mutex m_countersMutex;
+    fw::Backend::Counters m_counters;
+    std::atomic<D3D12_GPU_VIRTUAL_ADDRESS> m_nextGpuAddress{c_firstGpuAddress};
+    std::atomic<SIZE_T> m_nextCpuDescriptor{c_firstCpuDescriptor};
+    std::atomic<UINT64> m_nextGpuDescriptor{c_firstGpuDescriptor};
+
+    HRESULT createResource(const D3D12_HEAP_PROPERTIES& heapProperties,
+                           D3D12_HEAP_FLAGS heapFlags,
+                           const D3D12_RESOURCE_DESC& desc,
+                           D3D12_GPU_VIRTUAL_ADDRESS gpuAddress,
+                           REFIID riid,
+                           void** resource);
+};
+
+// ID3D12DeviceChild of the null objects, which keep the device alive
+template<typename Interface, typename... BaseInterfaces>
+class NullDeviceChild : public NullObject<Interface, ID3D12DeviceChild, BaseInterfaces...>
+{
+public:
+    explicit NullDeviceChild(NullDevice* device) :
+        m_device(device)
+    {
+    }
+
+    HRESULT STDMETHODCALLTYPE GetDevice(REFIID riid, void** device) override
+    {
+        return m_device->QueryInterface(riid, device);
+    }
+
+protected:
+    NullDevice& getDevice() const
+    {
+        return *m_device.Get();
+    }
+
+private:
+    Microsoft::WRL::ComPtr<NullDevice> m_device;
+};
+
+class NullHeap : public NullDeviceChild<ID3D12Heap, ID3D12Pageable>
+{
+public:
+    NullHeap(NullDevice* device, const D3D12_HEAP_DESC& desc) :
+        NullDeviceChild(device),
+        m_desc(desc),
+        m_gpuAddress(device->allocateGpuAddress(desc.SizeInBytes))
+    {
+    }
+
+    D3D12_HEAP_DESC STDMETHODCALLTYPE GetDesc() override
+    {
+        return m_desc;
+    }
+
+    D3D12_GPU_VIRTUAL_ADDRESS getGpuAddress() const
+    {
+        return m_gpuAddress;
+    }
+
+private:
+    D3D12_HEAP_DESC m_desc;
+    D3D12_GPU_VIRTUAL_ADDRESS m_gpuAddress;
+};
+
+class NullResource : public NullDeviceChild<ID3D12Resource, ID3D12Pageable>
+{
+public:
+    NullResource(NullDevice* device, const D3D12_RESOURCE_DESC& desc, const D3D12_HEAP_PROPERTIES& heapProperties, D3D12_HEAP_FLAGS heapFlags, D3D12_GPU_VIRTUAL_ADDRESS gpuAddress) :
+        NullDeviceChild(device),
+        m_desc(desc),
+        m_heapProperties(heapProperties),
+        m_heapFlags(heapFlags),
+        m_gpuAddress(gpuAddress)
+    {
+        // Mapped memory is written by the CPU only, readbacks read zeros
+        if (isCpuAccessible(heapProperties))
+        {
+            m_memory.resize(static_cast<size_t>(getAllocationInfo(desc).SizeInBytes));
+        }
+    }
+
+    HRESULT STDMETHODCALLTYPE Map(UINT /*subresource*/, const D3D12_RANGE* /*readRange*/, void** data) override
+    {
+        if (m_memory.empty())
+        {
+            return E_INVALIDARG;
+        }
+        if (data)
+        {
+            *data = m_memory.data();
+        }
+        return S_OK;
+    }
+
+    void STDMETHODCALLTYPE Unmap(UINT /*subresource*/, const D3D12_RANGE* /*writtenRange*/) override {}
+
+    D3D12_RESOURCE_DESC STDMETHODCALLTYPE GetDesc() override
+    {
+        return m_desc;
+    }
+
+    D3D12_GPU_VIRTUAL_ADDRESS STDMETHODCALLTYPE GetGPUVirtualAddress() override
+    {
+        return m_desc.Dimension == D3D12_RESOURCE_DIMENSION_BUFFER ? m_gpuAddress : 0;
+    }
+
+    HRESULT STDMETHODCALLTYPE WriteToSubresource(UINT /*dstSubresource*/, const D3D12_BOX* /*dstBox*/, const void* /*srcData*/, UINT /*srcRowPitch*/, UINT /*srcDepthPitch*/) override
+    {
+        return E_NOTIMPL;
+    }
+
+    HRESULT STDMETHODCALLTYPE ReadFromSubresource(void* /*dstData*/, UINT /*dstRowPitch*/, UINT /*dstDepthPitch*/, UINT /*srcSubresource*/, const D3D12_BOX* /*srcBox*/) override
+    {
+        return E_NOTIMPL;
+    }
+
+    HRESULT STDMETHODCALLTYPE GetHeapProperties(D3D12_HEAP_PROPERTIES* heapProperties, D3D12_HEAP_FLAGS* heapFlags) override
+    {
+        if (heapProperties)
+        {
+            *heapProperties = m_heapProperties;
+        }
+        if (heapFlags)
+        {
+            *heapFlags = m_heapFlags;
+        }
+        return S_OK;
+    }
+
+private:
+    D3D12_RESOURCE_DESC m_desc;
+    D3D12_HEAP_PROPERTIES m_heapProperties;
+    D3D12_HEAP_FLAGS m_heapFlags;
+    D3D12_GPU_VIRTUAL_ADDRESS m_gpuAddress;
+    std::vector<unsigned char> m_memory;
+};
+
+class NullCommandAllocator : public NullDeviceChild<ID3D12CommandAllocator, ID3D12Pageable>
+{
+public:
+    explicit NullCommandAllocator(NullDevice* device) :
+        NullDeviceChild(device)
+    {
+    }
+
+    HRESULT STDMETHODCALLTYPE Reset() override
+    {
+        return S_OK;
+    }
+};
+
+// Nothing executes, so a value is complete as soon as it is signaled
+class NullFence : public NullDeviceChild<ID3D12Fence, ID3D12Pageable>
+{
+public:
+    NullFence(NullDevice* device, UINT64 initialValue) :
+        NullDeviceChild(device),
+        m_value(initialValue)
+    {
+    }
+
+    UINT64 STDMETHODCALLTYPE GetCompletedValue() override
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_value;
+    }
+
+    HRESULT STDMETHODCALLTYPE SetEventOnCompletion(UINT64 value, HANDLE event) override
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (!event)
+        {
+            // Blocks until another thread signals the value
+            m_signaled.wait(lock, [this, value] { return m_value >= value; });
+        }
+        else if (m_value >= value)
+        {
+            SetEvent(event);
+        }
+        else
+        {
+            m_waits.push_back(std::make_pair(value, event));
+        }
+        return S_OK;
+    }
+
+    HRESULT STDMETHODCALLTYPE Signal(UINT64 value) override
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_value = value;
+        auto completed = std::partition(m_waits.begin(), m_waits.end(), [value](const std::pair<UINT64, HANDLE>& wait) { return wait.first > value; });
+        for (auto wait = completed; wait != m_waits.end(); ++wait)
+        {
+            SetEvent(wait->second);
+        }
+        m_waits.erase(completed, m_waits.end());
+        m_signaled.notify_all();
+        return S_OK;
+    }
+
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_signaled;
+    UINT64 m_value;
+    std::vector<std::pair<UINT64, HANDLE>> m_waits;
+};
+
+class NullPipelineState : public NullDeviceChild<ID3D12PipelineState, ID3D12Pageable>
+{
+public:
+    explicit NullPipelineState(NullDevice* device) :
+        NullDeviceChild(device)
+    {
+    }
+
+    HRESULT STDMETHODCALLTYPE GetCachedBlob(ID3DBlob** /*blob*/) override
+    {
+        return E_NOTIMPL;
+    }
+};
+
+class NullRootSignature : public NullDeviceChild<ID3D12RootSignature>
+{
+public:
+    explicit NullRootSignature(NullDevice* device) :
+        NullDeviceChild(device)
+    {
+    }
+};
+
+class NullQueryHeap : public NullDeviceChild<ID3D12QueryHeap, ID3D12Pageable>
+{
+public:
+    explicit NullQueryHeap(NullDevice* device) :
+        NullDeviceChild(device)
+    {
+    }
+};
+
+class NullCommandSignature : public NullDeviceChild<ID3D12CommandSignature, ID3D12Pageable>
+{
+public:
+    explicit NullCommandSignature(NullDevice* device) :
+        NullDeviceChild(device)
+    {
+    }
+};
+
+class NullDescriptorHeap : public NullDeviceChild<ID3D12DescriptorHeap, ID3D12Pageable>
+{
+public:
+    NullDescriptorHeap(NullDevice* device, const D3D12_DESCRIPTOR_HEAP_DESC& desc, D3D12_CPU_DESCRIPTOR_HANDLE cpuStart, D3D12_GPU_DESCRIPTOR_HANDLE gpuStart) :
+        NullDeviceChild(device),
+        m_desc(desc),
+        m_cpuStart(cpuStart),
+        m_gpuStart(gpuStart)
+    {
+    }
+
+    D3D12_DESCRIPTOR_HEAP_DESC STDMETHODCALLTYPE GetDesc() override
+    {
+        return m_desc;
+    }
+
+    D3D12_CPU_DESCRIPTOR_HANDLE STDMETHODCALLTYPE GetCPUDescriptorHandleForHeapStart() override
+    {
+        return m_cpuStart;
+    }
+
+    D3D12_GPU_DESCRIPTOR_HANDLE STDMETHODCALLTYPE GetGPUDescriptorHandleForHeapStart() override
+    {
+        return m_gpuStart;
+    }
+
+private:
+    D3D12_DESCRIPTOR_HEAP_DESC m_desc;
+    D3D12_CPU_DESCRIPTOR_HANDLE m_cpuStart;
+    D3D12_GPU_DESCRIPTOR_HANDLE m_gpuStart;
+};
+
+class NullCommandQueue : public NullDeviceChild<ID3D12CommandQueue, ID3D12Pageable>
+{
+public:
+    NullCommandQueue(NullDevice* device, const D3D12_COMMAND_QUEUE_DESC& desc) :
+        NullDeviceChild(device),
+        m_desc(desc)
+    {
+    }
+
+    void STDMETHODCALLTYPE UpdateTileMappings(ID3D12Resource* /*resource*/,
+                                              UINT /*resourceRegionCount*/,
+                                              const D3D12_TILED_RESOURCE_COORDINATE* /*resourceRegionStartCoordinates*/,
+                                              const D3D12_TILE_REGION_SIZE* /*resourceRegionSizes*/,
+                                              ID3D12Heap* /*heap*/,
+                                              UINT /*rangeCount*/,
+                                              const D3D12_TILE_RANGE_FLAGS* /*rangeFlags*/,
+                                              const UINT* /*heapRangeStartOffsets*/,
+                                              const UINT* /*rangeTileCounts*/,
+                                              D3D12_TILE_MAPPING_FLAGS /*flags*/) override
+    {
+    }
+
+    void STDMETHODCALLTYPE CopyTileMappings(ID3D12Resource* /*dstResource*/,
+                                            const D3D12_TILED_RESOURCE_COORDINATE* /*dstRegionStartCoordinate*/,
+                                            ID3D12Resource* /*srcResource*/,
+                                            const D3D12_TILED_RESOURCE_COORDINATE* /*srcRegionStartCoordinate*/,
+                                            const D3D12_TILE_REGION_SIZE* /*regionSize*/,
+                                            D3D12_TILE_MAPPING_FLAGS /*flags*/) override
+    {
+    }
+
+    void STDMETHODCALLTYPE ExecuteCommandLists(UINT commandListCount, ID3D12CommandList* const* /*commandLists*/) override
+    {
+        fw::Backend::Counters counters;
+        counters.executedCommandListCount = commandListCount;
+        getDevice().addCounters(counters);
+    }
+
+    void STDMETHODCALLTYPE SetMarker(UINT /*metadata*/, const void* /*data*/, UINT /*size*/) override {}
+    void STDMETHODCALLTYPE BeginEvent(UINT /*metadata*/, const void* /*data*/, UINT /*size*/) override {}
+    void STDMETHODCALLTYPE EndEvent() override {}
+
+    HRESULT STDMETHODCALLTYPE Signal(ID3D12Fence* fence, UINT64 value) override
+    {
+        return fence->Signal(value);
+    }
+
+    HRESULT STDMETHODCALLTYPE Wait(ID3D12Fence* /*fence*/, UINT64 /*value*/) override
+    {
+        return S_OK;
+    }
+
+    HRESULT STDMETHODCALLTYPE GetTimestampFrequency(UINT64* frequency) override
+    {
+        *frequency = c_timestampFrequency;
+        return S_OK;
+    }
+
+    HRESULT STDMETHODCALLTYPE GetClockCalibration(UINT64* gpuTimestamp, UINT64* cpuTimestamp) override
+    {
+        LARGE_INTEGER cpuNow;
+        QueryPerformanceCounter(&cpuNow);
+        *gpuTimestamp = 0;
+        *cpuTimestamp = static_cast<UINT64>(cpuNow.QuadPart);
+        return S_OK;
+    }
+
+    D3D12_COMMAND_QUEUE_DESC STDMETHODCALLTYPE GetDesc() override
+    {
+        return m_desc;
+    }
+
+private:
+    D3D12_COMMAND_QUEUE_DESC m_desc;
+};
+
+// Counts the barriers, the draws and the dispatches, which are added to the counters of the device when the list
+// is closed
+class NullCommandList : public NullDeviceChild<ID3D12GraphicsCommandList4,
+                                               ID3D12CommandList,
+                                               ID3D12GraphicsCommandList,
+                                               ID3D12GraphicsCommandList1,
+                                               ID3D12GraphicsCommandList2,
+                                               ID3D12GraphicsCommandList3>
+{
+public:
+    NullCommandList(NullDevice* device, D3D12_COMMAND_LIST_TYPE type) :
+        NullDeviceChild(device),
+        m_type(type)
+    {
+    }
+
+    // ID3D12CommandList
+    D3D12_COMMAND_LIST_TYPE STDMETHODCALLTYPE GetType() override
+    {
+        return m_type;
+    }
+
+    // ID3D12GraphicsCommandList
+    HRESULT STDMETHODCALLTYPE Close() override
+    {
+        getDevice().addCounters(m_counters);
+        m_counters = fw::Backend::Counters();
+        return S_OK;
+    }
+
+    HRESULT STDMETHODCALLTYPE Reset(ID3D12CommandAllocator* /*allocator*/, ID3D12PipelineState* /*initialState*/) override
+    {
+        return S_OK;
+    }
+
+    void STDMETHODCALLTYPE ClearState(ID3D12PipelineState* /*pipelineState*/) override {}
+
+    void STDMETHODCALLTYPE DrawInstanced(UINT /*vertexCountPerInstance*/, UINT /*instanceCount*/, UINT /*startVertexLocation*/, UINT /*startInstanceLocation*/) override
+    {
+        ++m_counters.drawCount;
+    }
+
+    void STDMETHODCALLTYPE
+    DrawIndexedInstanced(UINT /*indexCountPerInstance*/, UINT /*instanceCount*/, UINT /*startIndexLocation*/, INT /*baseVertexLocation*/, UINT /*startInstanceLocation*/) override
+    {
+        ++m_counters.drawCount;
+    }
+
+    void STDMETHODCALLTYPE Dispatch(UINT /*threadGroupCountX*/, UINT /*threadGroupCountY*/, UINT /*threadGroupCountZ*/) override
+    {
+        ++m_counters.dispatchCount;
+    }
+
+    void STDMETHODCALLTYPE CopyBufferRegion(ID3D12Resource* /*dstBuffer*/, UINT64 /*dstOffset*/, ID3D12Resource* /*srcBuffer*/, UINT64 /*srcOffset*/, UINT64 /*byteCount*/) override {}
+
+    void STDMETHODCALLTYPE CopyTextureRegion(const D3D12_TEXTURE_COPY_LOCATION* /*dst*/,
+                                             UINT /*dstX*/,
+                                             UINT /*dstY*/,
+                                             UINT /*dstZ*/,
+                                             const D3D12_TEXTURE_COPY_LOCATION* /*src*/,
+                                             const D3D12_BOX* /*srcBox*/) override
+    {
+    }
+
+    void STDMETHODCALLTYPE CopyResource(ID3D12Resource* /*dstResource*/, ID3D12Resource* /*srcResource*/) override {}
+
+    void STDMETHODCALLTYPE CopyTiles(ID3D12Resource* /*tiledResource*/,
+                                     const D3D12_TILED_RESOURCE_COORDINATE* /*tileRegionStartCoordinate*/,
+                                     const D3D12_TILE_REGION_SIZE* /*tileRegionSize*/,
+                                     ID3D12Resource* /*buffer*/,
+                                     UINT64 /*bufferStartOffsetInBytes*/,
+                                     D3D12_TILE_COPY_FLAGS /*flags*/) override
+    {
+    }
+
+    void STDMETHODCALLTYPE
+    ResolveSubresource(ID3D12Resource* /*dstResource*/, UINT /*dstSubresource*/, ID3D12Resource* /*srcResource*/, UINT /*srcSubresource*/, DXGI_FORMAT /*format*/) override
+    {
+    }
+
+    void STDMETHODCALLTYPE IASetPrimitiveTopology(D3D12_PRIMITIVE_TOPOLOGY /*primitiveTopology*/) override {}
+    void STDMETHODCALLTYPE RSSetViewports(UINT /*viewportCount*/, const D3D12_VIEWPORT* /*viewports*/) override {}
+    void STDMETHODCALLTYPE RSSetScissorRects(UINT /*rectCount*/, const D3D12_RECT* /*rects*/) override {}
+    void STDMETHODCALLTYPE OMSetBlendFactor(const FLOAT /*blendFactor*/[4]) override {}
+    void STDMETHODCALLTYPE OMSetStencilRef(UINT /*stencilRef*/) override {}
+    void STDMETHODCALLTYPE SetPipelineState(ID3D12PipelineState* /*pipelineState*/) override {}
+
+    void STDMETHODCALLTYPE ResourceBarrier(UINT barrierCount, const D3D12_RESOURCE_BARRIER* /*barriers*/) override
+    {
+        ++m_counters.barrierCallCount;
+        m_counters.barrierCount += barrierCount;
+    }
+
+    void STDMETHODCALLTYPE ExecuteBundle(ID3D12GraphicsCommandList* /*commandList*/) override {}
+    void STDMETHODCALLTYPE SetDescriptorHeaps(UINT /*descriptorHeapCount*/, ID3D12DescriptorHeap* const* /*descriptorHeaps*/) override {}
+    void STDMETHODCALLTYPE SetComputeRootSignature(ID3D12RootSignature* /*rootSignature*/) override {}
+    void STDMETHODCALLTYPE SetGraphicsRootSignature(ID3D12RootSignature* /*rootSignature*/) override {}
+    void STDMETHODCALLTYPE SetComputeRootDescriptorTable(UINT /*rootParameterIndex*/, D3D12_GPU_DESCRIPTOR_HANDLE /*baseDescriptor*/) override {}
+    void STDMETHODCALLTYPE SetGraphicsRootDescriptorTable(UINT /*rootParameterIndex*/, D3D12_GPU_DESCRIPTOR_HANDLE /*baseDescriptor*/) override {}
+    void STDMETHODCALLTYPE SetComputeRoot32BitConstant(UINT /*rootParameterIndex*/, UINT /*srcData*/, UINT /*destOffsetIn32BitValues*/) override {}
+    void STDMETHODCALLTYPE SetGraphicsRoot32BitConstant(UINT /*rootParameterIndex*/, UINT /*srcData*/, UINT /*destOffsetIn32BitValues*/) override {}
+
+    void STDMETHODCALLTYPE SetComputeRoot32BitConstants(UINT /*rootParameterIndex*/, UINT /*num32BitValuesToSet*/, const void* /*srcData*/, UINT /*destOffsetIn32BitValues*/) override
+    {
+    }
+
+    void STDMETHODCALLTYPE SetGraphicsRoot32BitConstants(UINT /*rootParameterIndex*/, UINT /*num32BitValuesToSet*/, const void* /*srcData*/, UINT /*destOffsetIn32BitValues*/) override
+    {
+    }
+
+    void STDMETHODCALLTYPE SetComputeRootConstantBufferView(UINT /*rootParameterIndex*/, D3D12_GPU_VIRTUAL_ADDRESS /*bufferLocation*/) override {}
+    void STDMETHODCALLTYPE SetGraphicsRootConstantBufferView(UINT /*rootParameterIndex*/, D3D12_GPU_VIRTUAL_ADDRESS /*bufferLocation*/) override {}
+    void STDMETHODCALLTYPE SetComputeRootShaderResourceView(UINT /*rootParameterIndex*/, D3D12_GPU_VIRTUAL_ADDRESS /*bufferLocation*/) override {}
+    void STDMETHODCALLTYPE SetGraphicsRootShaderResourceView(UINT /*rootParameterIndex*/, D3D12_GPU_VIRTUAL_ADDRESS /*bufferLocation*/) override {}
+    void STDMETHODCALLTYPE SetComputeRootUnorderedAccessView(UINT /*rootParameterIndex*/, D3D12_GPU_VIRTUAL_ADDRESS /*bufferLocation*/) override {}
+    void STDMETHODCALLTYPE SetGraphicsRootUnorderedAccessView(UINT /*rootParameterIndex*/, D3D12_GPU_VIRTUAL_ADDRESS /*bufferLocation*/) override {}
+    void STDMETHODCALLTYPE IASetIndexBuffer(const D3D12_INDEX_BUFFER_VIEW* /*view*/) override {}
+    void STDMETHODCALLTYPE IASetVertexBuffers(UINT /*startSlot*/, UINT /*viewCount*/, const D3D12_VERTEX_BUFFER_VIEW* /*views*/) override {}
+    void STDMETHODCALLTYPE SOSetTargets(UINT /*startSlot*/, UINT /*viewCount*/, const D3D12_STREAM_OUTPUT_BUFFER_VIEW* /*views*/) override {}
+
+    void STDMETHODCALLTYPE OMSetRenderTargets(UINT /*renderTargetDescriptorCount*/,
+                                              const D3D12_CPU_DESCRIPTOR_HANDLE* /*renderTargetDescriptors*/,
+                                              BOOL /*rtsSingleHandleToDescriptorRange*/,
+                                              const D3D12_CPU_DESCRIPTOR_HANDLE* /*depthStencilDescriptor*/) override
+    {
+    }
+
+    void STDMETHODCALLTYPE ClearDepthStencilView(D3D12_CPU_DESCRIPTOR_HANDLE /*depthStencilView*/,
+                                                 D3D12_CLEAR_FLAGS /*clearFlags*/,
+                                                 FLOAT /*depth*/,
+                                                 UINT8 /*stencil*/,
+                                                 UINT /*rectCount*/,
+                                                 const D3D12_RECT* /*rects*/) override
+    {
+    }
+
+    void STDMETHODCALLTYPE ClearRenderTargetView(D3D12_CPU_DESCRIPTOR_HANDLE /*renderTargetView*/, const FLOAT /*colorRGBA*/[4], UINT /*rectCount*/, const D3D12_RECT* /*rects*/) override
+    {
+    }
+
+    void STDMETHODCALLTYPE ClearUnorderedAccessViewUint(D3D12_GPU_DESCRIPTOR_HANDLE /*viewGpuHandleInCurrentHeap*/,
+                                                        D3D12_CPU_DESCRIPTOR_HANDLE /*viewCpuHandle*/,
+                                                        ID3D12Resource* /*resource*/,
+                                                        const UINT /*values*/[4],
+                                                        UINT /*rectCount*/,
+                                                        const D3D12_RECT* /*rects*/) override
+    {
+    }
+
+    void STDMETHODCALLTYPE ClearUnorderedAccessViewFloat(D3D12_GPU_DESCRIPTOR_HANDLE /*viewGpuHandleInCurrentHeap*/,
+                                                         D3D12_CPU_DESCRIPTOR_HANDLE /*viewCpuHandle*/,
+                                                         ID3D12Resource* /*resource*/,
+                                                         const FLOAT /*values*/[4],
+                                                         UINT /*rectCount*/,
+                                                         const D3D12_RECT* /*rects*/) override
+    {
+    }
+
+    void STDMETHODCALLTYPE DiscardResource(ID3D12Resource* /*resource*/, const D3D12_DISCARD_REGION* /*region*/) override {}
+    void STDMETHODCALLTYPE BeginQuery(ID3D12QueryHeap* /*queryHeap*/, D3D12_QUERY_TYPE /*type*/, UINT /*index*/) override {}
+    void STDMETHODCALLTYPE EndQuery(ID3D12QueryHeap* /*queryHeap*/, D3D12_QUERY_TYPE /*type*/, UINT /*index*/) override {}
+
+    void STDMETHODCALLTYPE ResolveQueryData(ID3D12QueryHeap* /*queryHeap*/,
+                                            D3D12_QUERY_TYPE /*type*/,
+                                            UINT /*startIndex*/,
+                                            UINT /*queryCount*/,
+                                            ID3D12Resource* /*destinationBuffer*/,
+                                            UINT64 /*alignedDestinationBufferOffset*/) override
+    {
+    }
+
+    void STDMETHODCALLTYPE SetPredication(ID3D12Resource* /*buffer*/, UINT64 /*alignedBufferOffset*/, D3D12_PREDICATION_OP /*operation*/) override {}
+    void STDMETHODCALLTYPE SetMarker(UINT /*metadata*/, const void* /*data*/, UINT /*size*/) override {}
+    void STDMETHODCALLTYPE BeginEvent(UINT /*metadata*/, const void* /*data*/, UINT /*size*/) override {}
+    void STDMETHODCALLTYPE EndEvent() override {}
+
+    void STDMETHODCALLTYPE ExecuteIndirect(ID3D12CommandSignature* /*commandSignature*/,
+                                           UINT /*maxCommandCount*/,
+                                           ID3D12Resource* /*argumentBuffer*/,
+                                           UINT64 /*argumentBufferOffset*/,
+                                           ID3D12Resource* /*countBuffer*/,
+                                           UINT64 /*countBufferOffset*/) override
+    {
+    }
+
+    // ID3D12GraphicsCommandList1
+    void STDMETHODCALLTYPE AtomicCopyBufferUINT(ID3D12Resource* /*dstBuffer*/,
+                                                UINT64 /*dstOffset*/,
+                                                ID3D12Resource* /*srcBuffer*/,
+                                                UINT64 /*srcOffset*/,
+                                                UINT /*dependencies*/,
+                                                ID3D12Resource* const* /*dependentResources*/,
+                                                const D3D12_SUBRESOURCE_RANGE_UINT64* /*dependentSubresourceRanges*/) override
+    {
+    }
+
+    void STDMETHODCALLTYPE AtomicCopyBufferUINT64(ID3D12Resource* /*dstBuffer*/,
+                                                  UINT64 /*dstOffset*/,
+                                                  ID3D12Resource* /*srcBuffer*/,
+                                                  UINT64 /*srcOffset*/,
+                                                  UINT /*dependencies*/,
+                                                  ID3D12Resource* const* /*dependentResources*/,
+                                                  const D3D12_SUBRESOURCE_RANGE_UINT64* /*dependentSubresourceRanges*/) override
+    {
+    }
+
+    void STDMETHODCALLTYPE OMSetDepthBounds(FLOAT /*min*/, FLOAT /*max*/) override {}
+    void STDMETHODCALLTYPE SetSamplePositions(UINT /*samplesPerPixel*/, UINT /*pixelCount*/, D3D12_SAMPLE_POSITION* /*samplePositions*/) override {}
+
+    void STDMETHODCALLTYPE ResolveSubresourceRegion(ID3D12Resource* /*dstResource*/,
+                                                    UINT /*dstSubresource*/,
+                                                    UINT /*dstX*/,
+                                                    UINT /*dstY*/,
+                                                    ID3D12Resource* /*srcResource*/,
+                                                    UINT /*srcSubresource*/,
+                                                    D3D12_RECT* /*srcRect*/,
+                                                    DXGI_FORMAT /*format*/,
+                                                    D3D12_RESOLVE_MODE /*resolveMode*/) override
+    {
+    }
+
+    void STDMETHODCALLTYPE SetViewInstanceMask(UINT /*mask*/) override {}
+
+    // ID3D12GraphicsCommandList2
+    void STDMETHODCALLTYPE WriteBufferImmediate(UINT /*count*/, const D3D12_WRITEBUFFERIMMEDIATE_PARAMETER* /*params*/, const D3D12_WRITEBUFFERIMMEDIATE_MODE* /*modes*/) override {}
+
+    // ID3D12GraphicsCommandList3
+    void STDMETHODCALLTYPE SetProtectedResourceSession(ID3D12ProtectedResourceSession* /*protectedResourceSession*/) override {}
+
+    // ID3D12GraphicsCommandList4
+    void STDMETHODCALLTYPE BeginRenderPass(UINT /*renderTargetCount*/,
+                                           const D3D12_RENDER_PASS_RENDER_TARGET_DESC* /*renderTargets*/,
+                                           const D3D12_RENDER_PASS_DEPTH_STENCIL_DESC* /*depthStencil*/,
+                                           D3D12_RENDER_PASS_FLAGS /*flags*/) override
+    {
+    }
+
+    void STDMETHODCALLTYPE EndRenderPass() override {}
+    void STDMETHODCALLTYPE InitializeMetaCommand(ID3D12MetaCommand* /*metaCommand*/, const void* /*initializationParametersData*/, SIZE_T /*initializationParametersDataSizeInBytes*/) override {}
+    void STDMETHODCALLTYPE ExecuteMetaCommand(ID3D12MetaCommand* /*metaCommand*/, const void* /*executionParametersData*/, SIZE_T /*executionParametersDataSizeInBytes*/) override {}
+
+    void STDMETHODCALLTYPE BuildRaytracingAccelerationStructure(const D3D12_BUILD_RAYTRACING_ACCELERATION_STRUCTURE_DESC* /*desc*/,
+                                                                UINT /*postbuildInfoDescCount*/,
+                                                                const D3D12_RAYTRACING_ACCELERATION_STRUCTURE_POSTBUILD_INFO_DESC* /*postbuildInfoDescs*/) override
+    {
+    }
+
+    void STDMETHODCALLTYPE EmitRaytracingAccelerationStructurePostbuildInfo(const D3D12_RAYTRACING_ACCELERATION_STRUCTURE_POSTBUILD_INFO_DESC* /*desc*/,
+                                                                            UINT /*sourceAccelerationStructureCount*/,
+                                                                            const D3D12_GPU_VIRTUAL_ADDRESS* /*sourceAccelerationStructureData*/) override
+    {
+    }
+
+    void STDMETHODCALLTYPE CopyRaytracingAccelerationStructure(D3D12_GPU_VIRTUAL_ADDRESS /*destAccelerationStructureData*/,
+                                                               D3D12_GPU_VIRTUAL_ADDRESS /*sourceAccelerationStructureData*/,
+                                                               D3D12_RAYTRACING_ACCELERATION_STRUCTURE_COPY_MODE /*mode*/) override
+    {
+    }
+
+    void STDMETHODCALLTYPE SetPipelineState1(ID3D12StateObject* /*stateObject*/) override {}
+
+    void STDMETHODCALLTYPE DispatchRays(const D3D12_DISPATCH_RAYS_DESC* /*desc*/) override
+    {
+        ++m_counters.dispatchCount;
+    }
+
+private:
+    D3D12_COMMAND_LIST_TYPE m_type;
+    fw::Backend::Counters m_counters;
+};
+
+fw::Backend::Counters NullDevice::getCounters() const
+{
+    std::lock_guard<std::mutex> lock(m_countersMutex);
+    return m_counters;
+}
+
+void NullDevice::addCounters(const fw::Backend::Counters& counters)
+{
+    std::lock_guard<std::mutex> lock(m_countersMutex);
+    m_counters.resourceCount += counters.resourceCount;
+    m_counters.heapCount += counters.heapCount;
+    m_counters.allocatedSize += counters.allocatedSize;
+    m_counters.barrierCallCount += counters.barrierCallCount;
+    m_counters.barrierCount += counters.barrierCount;
+    m_counters.drawCount += counters.drawCount;
+    m_counters.dispatchCount += counters.dispatchCount;
+    m_counters.executedCommandListCount += counters.executedCommandListCount;
+}
+
+D3D12_GPU_VIRTUAL_ADDRESS NullDevice::allocateGpuAddress(UINT64 size)
+{
+    return m_nextGpuAddress.fetch_add(ROUND_UP(std::max<UINT64>(size, 1), D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT));
+}
+
+UINT NullDevice::GetNodeCount()
+{
+    return 1;
+}
+
+HRESULT NullDevice::CreateCommandQueue(const D3D12_COMMAND_QUEUE_DESC* desc, REFIID riid, void** commandQueue)
+{
+    return queryNewObject(new NullCommandQueue(this, *desc), riid, commandQueue);
+}
+
+HRESULT NullDevice::CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE /*type*/, REFIID riid, void** commandAllocator)
+{
+    return queryNewObject(new NullCommandAllocator(this), riid, commandAllocator);
+}
+
+HRESULT NullDevice::CreateGraphicsPipelineState(const D3D12_GRAPHICS_PIPELINE_STATE_DESC* /*desc*/, REFIID riid, void** pipelineState)
+{
+    return queryNewObject(new NullPipelineState(this), riid, pipelineState);
+}
+
+HRESULT NullDevice::CreateComputePipelineState(const D3D12_COMPUTE_PIPELINE_STATE_DESC* /*desc*/, REFIID riid, void** pipelineState)
+{
+    return queryNewObject(new NullPipelineState(this), riid, pipelineState);
+}
+
+HRESULT NullDevice::CreateCommandList(UINT /*nodeMask*/,
+                                      D3D12_COMMAND_LIST_TYPE type,
+                                      ID3D12CommandAllocator* /*commandAllocator*/,
+                                      ID3D12PipelineState* /*initialState*/,
+                                      REFIID riid,
+                                      void** commandList)
+{
+    return queryNewObject(new NullCommandList(this, type), riid, commandList);
+}
+
+HRESULT NullDevice::CheckFeatureSupport(D3D12_FEATURE feature, void* featureSupportData, UINT featureSupportDataSize)
+{
+    switch (feature)
+    {
+    case D3D12_FEATURE_MULTISAMPLE_QUALITY_LEVELS:
+    {
+        if (featureSupportDataSize != sizeof(D3D12_FEATURE_DATA_MULTISAMPLE_QUALITY_LEVELS))
+        {
+            return E_INVALIDARG;
+        }
+        // The sample counts that every format supports have one quality level
+        D3D12_FEATURE_DATA_MULTISAMPLE_QUALITY_LEVELS& qualityLevels = *static_cast<D3D12_FEATURE_DATA_MULTISAMPLE_QUALITY_LEVELS*>(featureSupportData);
+        qualityLevels.NumQualityLevels = qualityLevels.SampleCount == 1 || qualityLevels.SampleCount == 4 ? 1 : 0;
+        return S_OK;
+    }
+    case D3D12_FEATURE_D3D12_OPTIONS5:
+        if (featureSupportDataSize != sizeof(D3D12_FEATURE_DATA_D3D12_OPTIONS5))
+        {
+            return E_INVALIDARG;
+        }
+        // No render passes and no ray tracing
+        std::memset(featureSupportData, 0, featureSupportDataSize);
+        return S_OK;
+    default:
+        return E_INVALIDARG;
+    }
+}
+
+HRESULT NullDevice::CreateDescriptorHeap(const D3D12_DESCRIPTOR_HEAP_DESC* descriptorHeapDesc, REFIID riid, void** heap)
+{
+    const UINT64 size = UINT64(descriptorHeapDesc->NumDescriptors) * c_descriptorSize;
+    D3D12_CPU_DESCRIPTOR_HANDLE cpuStart;
+    cpuStart.ptr = m_nextCpuDescriptor.fetch_add(static_cast<SIZE_T>(size + c_descriptorSize));
+    D3D12_GPU_DESCRIPTOR_HANDLE gpuStart;
+    gpuStart.ptr = (descriptorHeapDesc->Flags & D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE) != 0 ? m_nextGpuDescriptor.fetch_add(size + c_descriptorSize) : 0;
+    return queryNewObject(new NullDescriptorHeap(this, *descriptorHeapDesc, cpuStart, gpuStart), riid, heap);
+}
+
+UINT NullDevice::GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE /*descriptorHeapType*/)
+{
+    return c_descriptorSize;
+}
+
+HRESULT NullDevice::CreateRootSignature(UINT /*nodeMask*/, const void* /*blobWithRootSignature*/, SIZE_T /*blobLengthInBytes*/, REFIID riid, void** rootSignature)
+{
+    return queryNewObject(new NullRootSignature(this), riid, rootSignature);
+}
+
+void NullDevice::CreateConstantBufferView(const D3D12_CONSTANT_BUFFER_VIEW_DESC* /*desc*/, D3D12_CPU_DESCRIPTOR_HANDLE /*destDescriptor*/) {}
+
+void NullDevice::CreateShaderResourceView(ID3D12Resource* /*resource*/, const D3D12_SHADER_RESOURCE_VIEW_DESC* /*desc*/, D3D12_CPU_DESCRIPTOR_HANDLE /*destDescriptor*/) {}
+
+void NullDevice::CreateUnorderedAccessView(ID3D12Resource* /*resource*/,
+                                           ID3D12Resource* /*counterResource*/,
+                                           const D3D12_UNORDERED_ACCESS_VIEW_DESC* /*desc*/,
+                                           D3D12_CPU_DESCRIPTOR_HANDLE /*destDescriptor*/)
+{
+}
+
+void NullDevice::CreateRenderTargetView(ID3D12Resource* /*resource*/, const D3D12_RENDER_TARGET_VIEW_DESC* /*desc*/, D3D12_CPU_DESCRIPTOR_HANDLE /*destDescriptor*/) {}
+
+void NullDevice::CreateDepthStencilView(ID3D12Resource* /*resource*/, const D3D12_DEPTH_STENCIL_VIEW_DESC* /*desc*/, D3D12_CPU_DESCRIPTOR_HANDLE /*destDescriptor*/) {}
+
+void NullDevice::CreateSampler(const D3D12_SAMPLER_DESC* /*desc*/, D3D12_CPU_DESCRIPTOR_HANDLE /*destDescriptor*/) {}
+
+void NullDevice::CopyDescriptors(UINT /*destDescriptorRangeCount*/,
+                                 const D3D12_CPU_DESCRIPTOR_HANDLE* /*destDescriptorRangeStarts*/,
+                                 const UINT* /*destDescriptorRangeSizes*/,
+                                 UINT /*srcDescriptorRangeCount*/,
+                                 const D3D12_CPU_DESCRIPTOR_HANDLE* /*srcDescriptorRangeStarts*/,
+                                 const UINT* /*srcDescriptorRangeSizes*/,
+                                 D3D12_DESCRIPTOR_HEAP_TYPE /*descriptorHeapsType*/)
+{
+}
+
+void NullDevice::CopyDescriptorsSimple(UINT /*descriptorCount*/,
+                                       D3D12_CPU_DESCRIPTOR_HANDLE /*destDescriptorRangeStart*/,
+                                       D3D12_CPU_DESCRIPTOR_HANDLE /*srcDescriptorRangeStart*/,
+                                       D3D12_DESCRIPTOR_HEAP_TYPE /*descriptorHeapsType*/)
+{
+}
+
+D3D12_RESOURCE_ALLOCATION_INFO NullDevice::GetResourceAllocationInfo(UINT visibleMask, UINT resourceDescCount, const D3D12_RESOURCE_DESC* resourceDescs)
+{
+    return GetResourceAllocationInfo1(visibleMask, resourceDescCount, resourceDescs, nullptr);
+}
+
+D3D12_HEAP_PROPERTIES NullDevice::GetCustomHeapProperties(UINT /*nodeMask*/, D3D12_HEAP_TYPE heapType)
+{
+    // Like a GPU with memory of its own
+    D3D12_HEAP_PROPERTIES heapProperties{};
+    heapProperties.Type = D3D12_HEAP_TYPE_CUSTOM;
+    heapProperties.CPUPageProperty = heapType == D3D12_HEAP_TYPE_UPLOAD ? D3D12_CPU_PAGE_PROPERTY_WRITE_COMBINE
+                                     : heapType == D3D12_HEAP_TYPE_READBACK ? D3D12_CPU_PAGE_PROPERTY_WRITE_BACK
+                                                                            : D3D12_CPU_PAGE_PROPERTY_NOT_AVAILABLE;
+    heapProperties.MemoryPoolPreference = heapType == D3D12_HEAP_TYPE_DEFAULT ? D3D12_MEMORY_POOL_L1 : D3D12_MEMORY_POOL_L0;
+    heapProperties.CreationNodeMask = 1;
+    heapProperties.VisibleNodeMask = 1;
+    return heapProperties;
+}
+
+HRESULT NullDevice::CreateCommittedResource(const D3D12_HEAP_PROPERTIES* heapProperties,
+                                            D3D12_HEAP_FLAGS heapFlags,
+                                            const D3D12_RESOURCE_DESC* desc,
+                                            D3D12_RESOURCE_STATES /*initialResourceState*/,
+                                            const D3D12_CLEAR_VALUE* /*optimizedClearValue*/,
+                                            REFIID riidResource,
+                                            void** resource)
+{
+    const UINT64 size = getAllocationInfo(*desc).SizeInBytes;
+    fw::Backend::Counters counters;
+    counters.resourceCount = 1;
+    counters.allocatedSize = size;
+    addCounters(counters);
+    return createResource(*heapProperties, heapFlags, *desc, allocateGpuAddress(size), riidResource, resource);
+}
+
+HRESULT NullDevice::CreateHeap(const D3D12_HEAP_DESC* desc, REFIID riid, void** heap)
+{
+    fw::Backend::Counters counters;
+    counters.heapCount = 1;
+    counters.allocatedSize = desc->SizeInBytes;
+    addCounters(counters);
+    return queryNewObject(new NullHeap(this, *desc), riid, heap);
+}
+
+HRESULT NullDevice::CreatePlacedResource(ID3D12Heap* heap,
+                                         UINT64 heapOffset,
+                                         const D3D12_RESOURCE_DESC* desc,
+                                         D3D12_RESOURCE_STATES /*initialState*/,
+                                         const D3D12_CLEAR_VALUE* /*optimizedClearValue*/,
+                                         REFIID riid,
+                                         void** resource)
+{
+    // The memory was counted with the heap
+    fw::Backend::Counters counters;
+    counters.resourceCount = 1;
+    addCounters(counters);
+
+    // Every heap of the device is a null heap
+    const NullHeap* nullHeap = static_cast<const NullHeap*>(heap);
+    const D3D12_HEAP_DESC heapDesc = heap->GetDesc();
+    assert(heapOffset + getAllocationInfo(*desc).SizeInBytes <= heapDesc.SizeInBytes && "The resource does not fit into the heap");
+    return createResource(heapDesc.Properties, heapDesc.Flags, *desc, nullHeap->getGpuAddress() + heapOffset, riid, resource);
+}
+
+HRESULT NullDevice::CreateReservedResource(const D3D12_RESOURCE_DESC* desc, D3D12_RESOURCE_STATES /*initialState*/, const D3D12_CLEAR_VALUE* /*optimizedClearValue*/, REFIID riid, void** resource)
+{
+    fw::Backend::Counters counters;
+    counters.resourceCount = 1;
+    addCounters(counters);
+    D3D12_HEAP_PROPERTIES heapProperties{};
+    heapProperties.Type = D3D12_HEAP_TYPE_DEFAULT;
+    return createResource(heapProperties, D3D12_HEAP_FLAG_NONE, *desc, allocateGpuAddress(getAllocationInfo(*desc).SizeInBytes), riid, resource);
+}
+
+HRESULT NullDevice::CreateSharedHandle(ID3D12DeviceChild* /*object*/, const SECURITY_ATTRIBUTES* /*attributes*/, DWORD /*access*/, LPCWSTR /*name*/, HANDLE* /*handle*/)
+{
+    return E_NOTIMPL;
+}
+
+HRESULT NullDevice::OpenSharedHandle(HANDLE /*ntHandle*/, REFIID /*riid*/, void** /*object*/)
+{
+    return E_NOTIMPL;
+}
+
+HRESULT NullDevice::OpenSharedHandleByName(LPCWSTR /*name*/, DWORD /*access*/, HANDLE* /*ntHandle*/)
+{
+    return E_NOTIMPL;
+}
+
+HRESULT NullDevice::MakeResident(UINT /*objectCount*/, ID3D12Pageable* const* /*objects*/)
+{
+    return S_OK;
+}
+
+HRESULT NullDevice::Evict(UINT /*objectCount*/, ID3D12Pageable* const* /*objects*/)
+{
+    return S_OK;
+}
+
+HRESULT NullDevice::CreateFence(UINT64 initialValue, D3D12_FENCE_FLAGS /*flags*/, REFIID riid, void** fence)
+{
+    return queryNewObject(new NullFence(this, initialValue), riid, fence);
+}
+
+HRESULT NullDevice::GetDeviceRemovedReason()
+{
+    return S_OK;
+}
+
+void NullDevice::GetCopyableFootprints(const D3D12_RESOURCE_DESC* resourceDesc,
+                                       UINT firstSubresource,
+                                       UINT subresourceCount,
+                                       UINT64 baseOffset,
+                                       D3D12_PLACED_SUBRESOURCE_FOOTPRINT* layouts,
+                                       UINT* rowCounts,
+                                       UINT64* rowSizesInBytes,
+                                       UINT64* totalBytes)
+{
+    const UINT64 size = getFootprints(*resourceDesc, firstSubresource, subresourceCount, baseOffset, layouts, rowCounts, rowSizesInBytes);
+    if (totalBytes)
+    {
+        *totalBytes = size;
+    }
+}
+
+HRESULT NullDevice::CreateQueryHeap(const D3D12_QUERY_HEAP_DESC* /*desc*/, REFIID riid, void** heap)
+{
+    return queryNewObject(new NullQueryHeap(this), riid, heap);
+}
+
+HRESULT NullDevice::SetStablePowerState(BOOL /*enable*/)
+{
+    return S_OK;
+}
+
+HRESULT NullDevice::CreateCommandSignature(const D3D12_COMMAND_SIGNATURE_DESC* /*desc*/, ID3D12RootSignature* /*rootSignature*/, REFIID riid, void** commandSignature)
+{
+    return queryNewObject(new NullCommandSignature(this), riid, commandSignature);
+}
+
+void NullDevice::GetResourceTiling(ID3D12Resource* /*tiledResource*/,
+                                   UINT* tileCountForEntireResource,
+                                   D3D12_PACKED_MIP_INFO* packedMipDesc,
+                                   D3D12_TILE_SHAPE* standardTileShapeForNonPackedMips,
+                                   UINT* subresourceTilingCount,
+                                   UINT /*firstSubresourceTilingToGet*/,
+                                   D3D12_SUBRESOURCE_TILING* /*subresourceTilingsForNonPackedMips*/)
+{
+    if (tileCountForEntireResource)
+    {
+        *tileCountForEntireResource = 0;
+    }
+    if (packedMipDesc)
+    {
+        *packedMipDesc = D3D12_PACKED_MIP_INFO{};
+    }
+    if (standardTileShapeForNonPackedMips)
+    {
+        *standardTileShapeForNonPackedMips = D3D12_TILE_SHAPE{};
+    }
+    if (subresourceTilingCount)
+    {
+        *subresourceTilingCount = 0;
+    }
+}
+
+LUID NullDevice::GetAdapterLuid()
+{
+    LUID luid{};
+    return luid;
+}
+
+HRESULT NullDevice::CreatePipelineLibrary(const void* /*libraryBlob*/, SIZE_T /*blobLength*/, REFIID /*riid*/, void** /*pipelineLibrary*/)
+{
+    return E_NOTIMPL;
+}
+
+HRESULT NullDevice::SetEventOnMultipleFenceCompletion(ID3D12Fence* const* fences, const UINT64* fenceValues, UINT fenceCount, D3D12_MULTIPLE_FENCE_WAIT_FLAGS flags, HANDLE event)
+{
+    UINT completedCount = 0;
+    for (UINT i = 0; i < fenceCount; ++i)
+    {
+        completedCount += fences[i]->GetCompletedValue() >= fenceValues[i] ? 1 : 0;
+    }
+    const bool isComplete = flags == D3D12_MULTIPLE_FENCE_WAIT_FLAG_ANY ? completedCount > 0 : completedCount == fenceCount;
+    // Only waits that are already complete are supported
+    if (!isComplete)
+    {
+        return E_NOTIMPL;
+    }
+    if (event)
+    {
+        SetEvent(event);
+    }
+    return S_OK;
+}
+
+HRESULT NullDevice::SetResidencyPriority(UINT /*objectCount*/, ID3D12Pageable* const* /*objects*/, const D3D12_RESIDENCY_PRIORITY* /*priorities*/)
+{
+    return S_OK;
+}
+
+HRESULT NullDevice::CreatePipelineState(const D3D12_PIPELINE_STATE_STREAM_DESC* /*desc*/, REFIID riid, void** pipelineState)
+{
+    return queryNewObject(new NullPipelineState(this), riid, pipelineState);
+}
+
+HRESULT NullDevice::OpenExistingHeapFromAddress(const void* /*address*/, REFIID /*riid*/, void** /*heap*/)
+{
+    return E_NOTIMPL;
+}
+
+HRESULT NullDevice::OpenExistingHeapFromFileMapping(HANDLE /*fileMapping*/, REFIID /*riid*/, void** /*heap*/)
+{
+    return E_NOTIMPL;
+}
+
+HRESULT NullDevice::EnqueueMakeResident(D3D12_RESIDENCY_FLAGS /*flags*/, UINT /*objectCount*/, ID3D12Pageable* const* /*objects*/, ID3D12Fence* fenceToSignal, UINT64 fenceValueToSignal)
+{
+    return fenceToSignal->Signal(fenceValueToSignal);
+}
+
+HRESULT NullDevice::CreateCommandList1(UINT nodeMask, D3D12_COMMAND_LIST_TYPE type, D3D12_COMMAND_LIST_FLAGS /*flags*/, REFIID riid, void** commandList)
+{
+    // The list starts closed, closing an empty list adds nothing to the counters
+    Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> closedCommandList;
+    const HRESULT result = CreateCommandList(nodeMask, type, nullptr, nullptr, IID_PPV_ARGS(&closedCommandList));
+    if (FAILED(result))
+    {
+        return result;
+    }
+    closedCommandList->Close();
+    return closedCommandList->QueryInterface(riid, commandList);
+}
+
+HRESULT NullDevice::CreateProtectedResourceSession(const D3D12_PROTECTED_RESOURCE_SESSION_DESC* /*desc*/, REFIID /*riid*/, void** /*session*/)
+{
+    return E_NOTIMPL;
+}
+
+HRESULT NullDevice::CreateCommittedResource1(const D3D12_HEAP_PROPERTIES* heapProperties,
+                                             D3D12_HEAP_FLAGS heapFlags,
+                                             const D3D12_RESOURCE_DESC* desc,
+                                             D3D12_RESOURCE_STATES initialResourceState,
+                                             const D3D12_CLEAR_VALUE* optimizedClearValue,
+                                             ID3D12ProtectedResourceSession* /*protectedSession*/,
+                                             REFIID riidResource,
+                                             void** resource)
+{
+    return CreateCommittedResource(heapProperties, heapFlags, desc, initialResourceState, optimizedClearValue, riidResource, resource);
+}
+
+HRESULT NullDevice::CreateHeap1(const D3D12_HEAP_DESC* desc, ID3D12ProtectedResourceSession* /*protectedSession*/, REFIID riid, void** heap)
+{
+    return CreateHeap(desc, riid, heap);
+}
+
+HRESULT NullDevice::CreateReservedResource1(const D3D12_RESOURCE_DESC* desc,
+                                            D3D12_RESOURCE_STATES initialState,
+                                            const D3D12_CLEAR_VALUE* optimizedClearValue,
+                                            ID3D12ProtectedResourceSession* /*protectedSession*/,
+                                            REFIID riid,
+                                            void** resource)
+{
+    return CreateReservedResource(desc, initialState, optimizedClearValue, riid, resource);
+}
+
+D3D12_RESOURCE_ALLOCATION_INFO NullDevice::GetResourceAllocationInfo1(UINT /*visibleMask*/,
+                                                                      UINT resourceDescCount,
+                                                                      const D3D12_RESOURCE_DESC* resourceDescs,
+                                                                      D3D12_RESOURCE_ALLOCATION_INFO1* resourceAllocationInfo1)
+{
+    // The resources follow each other at their alignments
+    D3D12_RESOURCE_ALLOCATION_INFO total{0, 0};
+    for (UINT i = 0; i < resourceDescCount; ++i)
+    {
+        const D3D12_RESOURCE_ALLOCATION_INFO info = getAllocationInfo(resourceDescs[i]);
+        const UINT64 offset = ROUND_UP(total.SizeInBytes, info.Alignment);
+        if (resourceAllocationInfo1)
+        {
+            resourceAllocationInfo1[i] = D3D12_RESOURCE_ALLOCATION_INFO1{offset, info.Alignment, info.SizeInBytes};
+        }
+        total.SizeInBytes = offset + info.SizeInBytes;
+        total.Alignment = std::max(total.Alignment, info.Alignment);
+    }
+    return total;
+}
+
+HRESULT NullDevice::CreateLifetimeTracker(ID3D12LifetimeOwner* /*owner*/, REFIID /*riid*/, void** /*tracker*/)
+{
+    return E_NOTIMPL;
+}
+
+void NullDevice::RemoveDevice() {}
+
+HRESULT NullDevice::EnumerateMetaCommands(UINT* metaCommandCount, D3D12_META_COMMAND_DESC* /*descs*/)
+{
+    *metaCommandCount = 0;
+    return S_OK;
+}
+
+HRESULT NullDevice::EnumerateMetaCommandParameters(REFGUID /*commandId*/,
+                                                   D3D12_META_COMMAND_PARAMETER_STAGE /*stage*/,
+                                                   UINT* /*totalStructureSizeInBytes*/,
+                                                   UINT* /*parameterCount*/,
+                                                   D3D12_META_COMMAND_PARAMETER_DESC* /*parameterDescs*/)
+{
+    return E_INVALIDARG;
+}
+
+HRESULT NullDevice::CreateMetaCommand(REFGUID /*commandId*/, UINT /*nodeMask*/, const void* /*creationParametersData*/, SIZE_T /*creationParametersDataSizeInBytes*/, REFIID /*riid*/, void** /*metaCommand*/)
+{
+    return E_INVALIDARG;
+}
+
+HRESULT NullDevice::CreateStateObject(const D3D12_STATE_OBJECT_DESC* /*desc*/, REFIID /*riid*/, void** /*stateObject*/)
+{
+    return E_NOTIMPL;
+}
+
+void NullDevice::GetRaytracingAccelerationStructurePrebuildInfo(const D3D12_BUILD_RAYTRACING_ACCELERATION_STRUCTURE_INPUTS* /*desc*/,
+                                                                D3D12_RAYTRACING_ACCELERATION_STRUCTURE_PREBUILD_INFO* info)
+{
+    *info = D3D12_RAYTRACING_ACCELERATION_STRUCTURE_PREBUILD_INFO{};
+}
+
+D3D12_DRIVER_MATCHING_IDENTIFIER_STATUS NullDevice::CheckDriverMatchingIdentifier(D3D12_SERIALIZED_DATA_TYPE /*serializedDataType*/,
+                                                                                  const D3D12_SERIALIZED_DATA_DRIVER_MATCHING_IDENTIFIER* /*identifierToCheck*/)
+{
+    return D3D12_DRIVER_MATCHING_IDENTIFIER_UNSUPPORTED_TYPE;
+}
+
+HRESULT NullDevice::createResource(const D3D12_HEAP_PROPERTIES& heapProperties,
+                                   D3D12_HEAP_FLAGS heapFlags,
+                                   const D3D12_RESOURCE_DESC& desc,
+                                   D3D12_GPU_VIRTUAL_ADDRESS gpuAddress,
+                                   REFIID riid,
+                                   void** resource)
+{
+    return queryNewObject(new NullResource(this, desc, heapProperties, heapFlags, gpuAddress), riid, resource);
+}
+} // namespace
+
+namespace fw
+{
+bool NullBackend::createDevice(const Config& /*config*/, Microsoft::WRL::ComPtr<ID3D12Device5>& device)
+{
+    m_device.Attach(new NullDevice());
+    device = m_device;
+    return true;
+}
+
+bool NullBackend::createCommandQueue(ID3D12Device5* device, Microsoft::WRL::ComPtr<ID3D12CommandQueue>& commandQueue)
+{
+    assert(device == m_device.Get() && "The device is not the null device of the backend");
+    D3D12_COMMAND_QUEUE_DESC queueDesc{};
+    queueDesc.Type = D3D12_COMMAND_LIST_TYPE_DIRECT;
+    queueDesc.Flags = D3D12_COMMAND_QUEUE_FLAG_NONE;
+    commandQueue.Attach(new NullCommandQueue(static_cast<NullDevice*>(device), queueDesc));
+    return true;
+}
+
+bool NullBackend::createCommandList(ID3D12Device5* device, ID3D12CommandAllocator* /*commandAllocator*/, Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList4>& commandList)
+{
+    assert(device == m_device.Get() && "The device is not the null device of the backend");
+    commandList.Attach(new NullCommandList(static_cast<NullDevice*>(device), D3D12_COMMAND_LIST_TYPE_DIRECT));
+    return true;
+}
+
+bool NullBackend::getCounters(Counters& counters) const
+{
+    counters = m_device ? static_cast<const NullDevice*>(m_device.Get())->getCounters() : Counters();
+    return true;
+}
+
+} // namespace fw
@@ -0,0 +1,197 @@
+#include "Profiler.h"
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+// The latest zones of each thread that are kept
+const size_t c_zonesPerThread = 64 * 1024;
+
+const std::chrono::steady_clock::time_point c_start = std::chrono::steady_clock::now();
+
+struct Zone
+{
+    const fw::Profiler::Site* site;
+    int64_t begin;
+    int64_t end;
+};
+
+struct ThreadBuffer
+{
+    uint32_t threadId = 0;
+    std::string name;
+    std::unique_ptr<Zone[]> zones;
+    // Zones recorded so far, published after the zone is written
+    std::atomic<uint64_t> zoneCount{0};
+};
+
+struct Registry
+{
+    std::mutex mutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+};
+
+Registry& getRegistry()
+{
+    static Registry registry;
+    return registry;
+}
+
+// The registry owns the buffers, so the zones of threads that have exited are still written
+ThreadBuffer* createBuffer()
+{
+    std::unique_ptr<ThreadBuffer> buffer = std::make_unique<ThreadBuffer>();
+    buffer->zones = std::make_unique<Zone[]>(c_zonesPerThread);
+
+    Registry& registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    buffer->threadId = static_cast<uint32_t>(registry.buffers.size());
+    registry.buffers.push_back(std::move(buffer));
+    return registry.buffers.back().get();
+}
+
+ThreadBuffer& getThreadBuffer()
+{
+    thread_local ThreadBuffer* threadBuffer = nullptr;
+    if (!threadBuffer)
+    {
+        threadBuffer = createBuffer();
+    }
+    return *threadBuffer;
+}
+
+void append(ThreadBuffer& buffer, const fw::Profiler::Site* site, int64_t begin, int64_t end)
+{
+    const uint64_t zoneCount = buffer.zoneCount.load(std::memory_order_relaxed);
+    buffer.zones[zoneCount % c_zonesPerThread] = Zone{site, begin, end};
+    buffer.zoneCount.store(zoneCount + 1, std::memory_order_release);
+}
+
+void writeJsonString(std::ostream& output, const char* str)
+{
+    output << '"';
+    for (const char* c = str; *c != '\0'; ++c)
+    {
+        if (*c == '"' || *c == '\\')
+        {
+            output << '\\';
+        }
+        output << *c;
+    }
+    output << '"';
+}
+
+// Trace times are microseconds, the nanoseconds are kept as decimals
+void writeMicroseconds(std::ostream& output, int64_t nanoseconds)
+{
+    const int64_t fraction = nanoseconds % 1000;
+    output << nanoseconds / 1000 << '.' << (fraction < 100 ? "0" : "") << (fraction < 10 ? "0" : "") << fraction;
+}
+} // namespace
+
+namespace fw
+{
+int64_t Profiler::now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - c_start).count();
+}
+
+void Profiler::record(const Site* site, int64_t begin, int64_t end)
+{
+    append(getThreadBuffer(), site, begin, end);
+}
+
+void Profiler::setThreadName(const char* name)
+{
+    ThreadBuffer& buffer = getThreadBuffer();
+    std::lock_guard<std::mutex> lock(getRegistry().mutex);
+    buffer.name = name;
+}
+
+uint32_t Profiler::createTimeline(const char* name)
+{
+    ThreadBuffer* buffer = createBuffer();
+    std::lock_guard<std::mutex> lock(getRegistry().mutex);
+    buffer->name = name;
+    return buffer->threadId;
+}
+
+void Profiler::record(uint32_t timeline, const Site* site, int64_t begin, int64_t end)
+{
+    ThreadBuffer* buffer = nullptr;
+    {
+        Registry& registry = getRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        buffer = registry.buffers[timeline].get();
+    }
+    append(*buffer, site, begin, end);
+}
+
+bool Profiler::writeChromeTrace(const std::string& filepath)
+{
+    std::ofstream file(filepath);
+    if (!file)
+    {
+        std::cerr << "Unable to write trace: " << filepath << "\n";
+        return false;
+    }
+
+    Registry& registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+
+    file << "{\"traceEvents\":[";
+    bool first = true;
+    for (const std::unique_ptr<ThreadBuffer>& buffer : registry.buffers)
+    {
+        if (!buffer->name.empty())
+        {
+            file << (first ? "\n" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->threadId << ",\"args\":{\"name\":";
+            writeJsonString(file, buffer->name.c_str());
+            file << "}}";
+            first = false;
+        }
+
+        const uint64_t zoneCount = buffer->zoneCount.load(std::memory_order_acquire);
+        const uint64_t firstZone = zoneCount > c_zonesPerThread ? zoneCount - c_zonesPerThread : 0;
+        for (uint64_t i = firstZone; i < zoneCount; ++i)
+        {
+            const Zone& zone = buffer->zones[i % c_zonesPerThread];
+            file << (first ? "\n" : ",\n") << "{\"name\":";
+            writeJsonString(file, zone.site->name);
+            file << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->threadId << ",\"ts\":";
+            writeMicroseconds(file, zone.begin);
+            file << ",\"dur\":";
+            writeMicroseconds(file, zone.end - zone.begin);
+            file << ",\"args\":{\"file\":";
+            writeJsonString(file, zone.site->file);
+            file << ",\"line\":" << zone.site->line << "}}";
+            first = false;
+        }
+    }
+    file << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+    if (!file)
+    {
+        std::cerr << "Unable to write trace: " << filepath << "\n";
+        return false;
+    }
+    return true;
+}
+
+void Profiler::clear()
+{
+    Registry& registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for (const std::unique_ptr<ThreadBuffer>& buffer : registry.buffers)
+    {
+        buffer->zoneCount.store(0, std::memory_order_release);
+    }
+}
+
+} // namespace fw
@@ -0,0 +1,108 @@
+#include "RingAllocator.h"
+
+#include <cassert>
+
+namespace
+{
+uint64_t alignUp(uint64_t value, uint64_t alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+} // namespace
+
+namespace fw
+{
+void RingAllocator::initialize(uint64_t size)
+{
+    m_size = size;
+    m_head = 0;
+    m_tail = 0;
+    m_usedSize = 0;
+    m_pendingSize = 0;
+    m_batches.clear();
+}
+
+uint64_t RingAllocator::allocate(uint64_t size, uint64_t alignment)
+{
+    assert(alignment != 0 && (alignment & (alignment - 1)) == 0);
+
+    if (size == 0 || size > m_size)
+    {
+        return c_invalidOffset;
+    }
+    if (m_usedSize == 0)
+    {
+        m_head = 0;
+        m_tail = 0;
+    }
+
+    uint64_t offset = alignUp(m_head, alignment);
+    uint64_t padding = offset - m_head;
+    if (m_usedSize == 0 || m_head > m_tail)
+    {
+        // Free space is at the end of the ring and then at its start
+        if (offset + size > m_size)
+        {
+            if (size > m_tail)
+            {
+                return c_invalidOffset;
+            }
+            padding = m_size - m_head;
+            offset = 0;
+        }
+    }
+    else if (m_head == m_tail || offset + size > m_tail)
+    {
+        return c_invalidOffset;
+    }
+
+    m_head = offset + size;
+    m_usedSize += padding + size;
+    m_pendingSize += padding + size;
+    return offset;
+}
+
+void RingAllocator::submit(uint64_t fenceValue)
+{
+    if (m_pendingSize == 0)
+    {
+        return;
+    }
+
+    assert(m_batches.empty() || m_batches.back().fenceValue <= fenceValue);
+    m_batches.push_back(Batch{fenceValue, m_head, m_pendingSize});
+    m_pendingSize = 0;
+}
+
+void RingAllocator::release(uint64_t completedFenceValue)
+{
+    while (!m_batches.empty() && m_batches.front().fenceValue <= completedFenceValue)
+    {
+        m_tail = m_batches.front().end;
+        m_usedSize -= m_batches.front().size;
+        m_batches.pop_front();
+    }
+}
+
+bool RingAllocator::hasSubmittedBatches() const
+{
+    return !m_batches.empty();
+}
+
+uint64_t RingAllocator::getOldestFenceValue() const
+{
+    assert(!m_batches.empty());
+    return m_batches.front().fenceValue;
+}
+
+uint64_t RingAllocator::getSize() const
+{
+    return m_size;
+}
+
+uint64_t RingAllocator::getUsedSize() const
+{
+    return m_usedSize;
+}
+
+} // namespace fw
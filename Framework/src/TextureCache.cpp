@@ -0,0 +1,103 @@
+#include "TextureCache.h"
+#include "ThreadPool.h"
+
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+
+#include <chrono>
+#include <iostream>
+
+namespace
+{
+const int c_channelCount = 4;
+} // namespace
+
+namespace fw
+{
+void TextureCache::PixelDeleter::operator()(unsigned char* pixels) const
+{
+    stbi_image_free(pixels);
+}
+
+size_t TextureCache::Image::getSize() const
+{
+    return pixels ? size_t(width) * height * c_channelCount : 0;
+}
+
+TextureCache::~TextureCache()
+{
+    // Decoding jobs refer to the cache
+    for (const auto& image : m_images)
+    {
+        image.second.wait();
+    }
+}
+
+void TextureCache::prefetch(const std::vector<std::string>& files)
+{
+    for (const std::string& file : files)
+    {
+        Promise promise;
+        request(file, promise);
+        if (promise)
+        {
+            ThreadPool::getDefault().submit([this, file, promise]() { promise->set_value(decode(file)); });
+        }
+    }
+}
+
+TextureCache::ImageHandle TextureCache::get(const std::string& file)
+{
+    Promise promise;
+    std::shared_future<ImageHandle> image = request(file, promise);
+    if (promise)
+    {
+        promise->set_value(decode(file));
+    }
+    return image.get();
+}
+
+TextureCache::Stats TextureCache::getStats() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+std::shared_future<TextureCache::ImageHandle> TextureCache::request(const std::string& file, Promise& promise)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_images.find(file);
+    if (it != m_images.end())
+    {
+        ++m_stats.hitCount;
+        return it->second;
+    }
+
+    promise = std::make_shared<std::promise<ImageHandle>>();
+    std::shared_future<ImageHandle> image = promise->get_future().share();
+    m_images.emplace(file, image);
+    return image;
+}
+
+TextureCache::ImageHandle TextureCache::decode(const std::string& file)
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    std::shared_ptr<Image> image = std::make_shared<Image>();
+    int channelCount = 0;
+    image->pixels.reset(stbi_load(file.c_str(), &image->width, &image->height, &channelCount, c_channelCount));
+    if (!image->pixels)
+    {
+        std::cerr << "Failed to decode image " << file << ": " << stbi_failure_reason() << "\n";
+    }
+
+    const std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ++m_stats.decodedCount;
+    m_stats.decodedBytes += image->getSize();
+    m_stats.decodeSeconds += duration.count();
+    return image;
+}
+
+} // namespace fw
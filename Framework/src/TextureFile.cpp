@@ -0,0 +1,390 @@
+#include "TextureFile.h"
+#include "ModelCache.h"
+#include "Profiler.h"
+#include "TextureCache.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <iostream>
+#include <unordered_map>
+
+namespace
+{
+const char* c_cookedExtension = ".cooked.dds";
+const uint32_t c_ddsMagic = 0x20534444;   // "DDS "
+const uint32_t c_dx10FourCC = 0x30315844; // "DX10"
+const uint32_t c_cookedTag = 0x43323144;  // "D12C"
+
+const uint32_t c_ddsFlags = 0x1 | 0x2 | 0x4 | 0x1000 | 0x20000 | 0x80000; // Caps, height, width, pixel format, mip count, linear size
+const uint32_t c_ddsPixelFormatFourCC = 0x4;
+const uint32_t c_ddsCaps = 0x8 | 0x1000 | 0x400000; // Complex, texture, mip map
+const uint32_t c_dx10Texture2D = 3;
+// DXGI_FORMAT_BC1_UNORM, DXGI_FORMAT_BC3_UNORM, DXGI_FORMAT_BC5_UNORM and DXGI_FORMAT_BC7_UNORM
+const uint32_t c_dxgiFormats[] = {71, 77, 83, 98};
+
+struct DdsPixelFormat
+{
+    uint32_t size;
+    uint32_t flags;
+    uint32_t fourCC;
+    uint32_t rgbBitCount;
+    uint32_t rBitMask;
+    uint32_t gBitMask;
+    uint32_t bBitMask;
+    uint32_t aBitMask;
+};
+
+// Written to the reserved words of the DDS header
+struct CookedInfo
+{
+    uint32_t tag;
+    uint32_t version;
+    uint32_t sourceHashLow;
+    uint32_t sourceHashHigh;
+    uint32_t colorSpace;
+    float psnr;
+    uint32_t pitchAlignment;
+    uint32_t placementAlignment;
+    uint32_t quality;
+    uint32_t reserved[2];
+};
+
+struct DdsHeader
+{
+    uint32_t size;
+    uint32_t flags;
+    uint32_t height;
+    uint32_t width;
+    uint32_t pitchOrLinearSize;
+    uint32_t depth;
+    uint32_t mipMapCount;
+    CookedInfo cookedInfo;
+    DdsPixelFormat pixelFormat;
+    uint32_t caps;
+    uint32_t caps2;
+    uint32_t caps3;
+    uint32_t caps4;
+    uint32_t reserved2;
+};
+
+struct DdsHeaderDx10
+{
+    uint32_t dxgiFormat;
+    uint32_t resourceDimension;
+    uint32_t miscFlag;
+    uint32_t arraySize;
+    uint32_t miscFlags2;
+};
+
+static_assert(sizeof(DdsHeader) == 124, "DDS header must match the file format");
+static_assert(sizeof(DdsHeaderDx10) == 20, "DX10 header must match the file format");
+
+const size_t c_dataOffset = sizeof(uint32_t) + sizeof(DdsHeader) + sizeof(DdsHeaderDx10);
+
+uint64_t alignUp(uint64_t value, uint64_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+// Returns the size of the level data
+uint64_t computeSubresources(fw::BlockCompressor::Format format, uint32_t width, uint32_t height, uint32_t levelCount, std::vector<fw::TextureFile::Subresource>& subresources)
+{
+    subresources.resize(levelCount);
+    uint64_t offset = 0;
+    for (uint32_t i = 0; i < levelCount; ++i)
+    {
+        fw::BlockCompressor::Level level{std::max(width >> i, 1u), std::max(height >> i, 1u), 0};
+
+        fw::TextureFile::Subresource& subresource = subresources[i];
+        subresource.width = level.width;
+        subresource.height = level.height;
+        subresource.offset = alignUp(offset, fw::TextureFile::c_placementAlignment);
+        subresource.rowSize = static_cast<uint32_t>(level.getBlockColumnCount() * fw::BlockCompressor::getBlockSize(format));
+        subresource.rowPitch = static_cast<uint32_t>(alignUp(subresource.rowSize, fw::TextureFile::c_pitchAlignment));
+        subresource.rowCount = level.getBlockRowCount();
+        offset = subresource.offset + uint64_t(subresource.rowPitch) * subresource.rowCount;
+    }
+    return offset;
+}
+} // namespace
+
+namespace fw
+{
+std::string TextureFile::getCookedPath(const std::string& sourceFile)
+{
+    return sourceFile + c_cookedExtension;
+}
+
+void TextureFile::cook(const BlockCompressor::Texture& texture,
+                       uint64_t sourceHash,
+                       MipGenerator::ColorSpace colorSpace,
+                       BlockCompressor::Quality quality,
+                       std::vector<unsigned char>& image)
+{
+    assert(!texture.levels.empty());
+    assert(texture.levels[0].width % BlockCompressor::c_blockDimension == 0 && texture.levels[0].height % BlockCompressor::c_blockDimension == 0);
+
+    const uint32_t width = texture.levels[0].width;
+    const uint32_t height = texture.levels[0].height;
+    const uint32_t levelCount = static_cast<uint32_t>(texture.levels.size());
+    std::vector<Subresource> subresources;
+    const uint64_t dataSize = computeSubresources(texture.format, width, height, levelCount, subresources);
+
+    DdsHeader header{};
+    header.size = sizeof(DdsHeader);
+    header.flags = c_ddsFlags;
+    header.height = height;
+    header.width = width;
+    header.pitchOrLinearSize = static_cast<uint32_t>(texture.getLevelData(0).size());
+    header.mipMapCount = levelCount;
+    header.cookedInfo.tag = c_cookedTag;
+    header.cookedInfo.version = c_version;
+    header.cookedInfo.sourceHashLow = static_cast<uint32_t>(sourceHash);
+    header.cookedInfo.sourceHashHigh = static_cast<uint32_t>(sourceHash >> 32);
+    header.cookedInfo.colorSpace = static_cast<uint32_t>(colorSpace);
+    header.cookedInfo.psnr = texture.psnr;
+    header.cookedInfo.pitchAlignment = c_pitchAlignment;
+    header.cookedInfo.placementAlignment = c_placementAlignment;
+    header.cookedInfo.quality = static_cast<uint32_t>(quality);
+    header.pixelFormat.size = sizeof(DdsPixelFormat);
+    header.pixelFormat.flags = c_ddsPixelFormatFourCC;
+    header.pixelFormat.fourCC = c_dx10FourCC;
+    header.caps = c_ddsCaps;
+
+    DdsHeaderDx10 headerDx10{};
+    headerDx10.dxgiFormat = c_dxgiFormats[static_cast<uint32_t>(texture.format)];
+    headerDx10.resourceDimension = c_dx10Texture2D;
+    headerDx10.arraySize = 1;
+
+    image.assign(c_dataOffset + dataSize, 0);
+    std::memcpy(image.data(), &c_ddsMagic, sizeof(c_ddsMagic));
+    std::memcpy(image.data() + sizeof(c_ddsMagic), &header, sizeof(DdsHeader));
+    std::memcpy(image.data() + sizeof(c_ddsMagic) + sizeof(DdsHeader), &headerDx10, sizeof(DdsHeaderDx10));
+
+    unsigned char* data = image.data() + c_dataOffset;
+    for (uint32_t i = 0; i < levelCount; ++i)
+    {
+        const Subresource& subresource = subresources[i];
+        const unsigned char* rows = texture.getLevelData(i).data();
+        assert(subresource.rowSize == texture.getRowPitch(i));
+        for (uint32_t row = 0; row < subresource.rowCount; ++row)
+        {
+            std::memcpy(data + subresource.offset + size_t(row) * subresource.rowPitch, rows + size_t(row) * subresource.rowSize, subresource.rowSize);
+        }
+    }
+}
+
+bool TextureFile::open(const std::string& path, uint64_t sourceHash, MipGenerator::ColorSpace colorSpace, BlockCompressor::Quality quality)
+{
+    m_image.clear();
+    if (!m_file.open(path))
+    {
+        return false;
+    }
+    if (!parse(m_file.getData(), m_file.getSize()) || m_sourceHash != sourceHash || m_colorSpace != colorSpace || m_quality != quality)
+    {
+        m_file.close();
+        return false;
+    }
+    return true;
+}
+
+bool TextureFile::open(std::vector<unsigned char> image)
+{
+    m_file.close();
+    m_image = std::move(image);
+    return parse(m_image.data(), m_image.size());
+}
+
+bool TextureFile::loadFiles(const std::vector<std::string>& files,
+                            MipGenerator::ColorSpace colorSpace,
+                            BlockCompressor::Quality quality,
+                            std::vector<std::shared_ptr<const TextureFile>>& textureFiles)
+{
+    FW_PROFILE_FUNCTION();
+    textureFiles.clear();
+    textureFiles.resize(files.size());
+
+    std::unordered_map<std::string, size_t> firstUses;
+    std::vector<uint64_t> sourceHashes(files.size());
+    std::vector<size_t> uncooked;
+    std::vector<std::string> uncookedFiles;
+    for (size_t i = 0; i < files.size(); ++i)
+    {
+        if (!firstUses.emplace(files[i], i).second)
+        {
+            continue;
+        }
+        if (!ModelCache::hashFile(files[i], sourceHashes[i]))
+        {
+            std::cerr << "Failed to open texture " << files[i] << "\n";
+            return false;
+        }
+
+        std::shared_ptr<TextureFile> textureFile = std::make_shared<TextureFile>();
+        if (textureFile->open(getCookedPath(files[i]), sourceHashes[i], colorSpace, quality))
+        {
+            textureFiles[i] = textureFile;
+        }
+        else
+        {
+            uncooked.push_back(i);
+            uncookedFiles.push_back(files[i]);
+        }
+    }
+
+    TextureCache textureCache;
+    textureCache.prefetch(uncookedFiles);
+    for (size_t i : uncooked)
+    {
+        TextureCache::ImageHandle image = textureCache.get(files[i]);
+        if (!image->pixels)
+        {
+            return false;
+        }
+
+        uint32_t width = static_cast<uint32_t>(image->width);
+        uint32_t height = static_cast<uint32_t>(image->height);
+        const unsigned char* pixels = image->pixels.get();
+        const BlockCompressor::Format format = BlockCompressor::selectFormat(files[i], pixels, width, height, quality);
+        // Normal maps are not colors so they are filtered as they are
+        const MipGenerator::ColorSpace filterColorSpace = format == BlockCompressor::Format::BC5 ? MipGenerator::ColorSpace::Linear : colorSpace;
+
+        // D3D12 only creates block compressed textures whose first level is made of whole blocks. The image is
+        // scaled instead of padded so that texture coordinates still cover it.
+        std::vector<unsigned char> scaledPixels;
+        const uint32_t blockWidth = (width + BlockCompressor::c_blockDimension - 1) / BlockCompressor::c_blockDimension * BlockCompressor::c_blockDimension;
+        const uint32_t blockHeight = (height + BlockCompressor::c_blockDimension - 1) / BlockCompressor::c_blockDimension * BlockCompressor::c_blockDimension;
+        if (blockWidth != width || blockHeight != height)
+        {
+            MipGenerator::resize(pixels, width, height, blockWidth, blockHeight, filterColorSpace, MipGenerator::Filter::Kaiser, scaledPixels);
+            pixels = scaledPixels.data();
+            width = blockWidth;
+            height = blockHeight;
+        }
+
+        MipGenerator::Chain mipChain;
+        MipGenerator::generate(pixels, width, height, filterColorSpace, MipGenerator::Filter::Kaiser, mipChain);
+
+        BlockCompressor::Texture texture;
+        BlockCompressor::compress(mipChain, format, texture);
+        texture.psnr = BlockCompressor::computePsnr(mipChain, texture);
+        std::cout << "Compressed " << files[i] << " to " << BlockCompressor::getFormatName(format) << ", " << mipChain.pixels.size() / 1024 << " KB -> "
+                  << texture.blocks.size() / 1024 << " KB, PSNR " << texture.psnr << " dB\n";
+
+        std::vector<unsigned char> cookedImage;
+        cook(texture, sourceHashes[i], colorSpace, quality, cookedImage);
+
+        // A texture that cannot be written is used from memory
+        const std::string cookedPath = getCookedPath(files[i]);
+        std::shared_ptr<TextureFile> textureFile = std::make_shared<TextureFile>();
+        if (!ModelCache::write(cookedPath, cookedImage) || !textureFile->open(cookedPath, sourceHashes[i], colorSpace, quality))
+        {
+            if (!textureFile->open(std::move(cookedImage)))
+            {
+                return false;
+            }
+        }
+        textureFiles[i] = textureFile;
+    }
+
+    if (!uncooked.empty())
+    {
+        const TextureCache::Stats stats = textureCache.getStats();
+        std::cout << "Decoded " << stats.decodedCount << " images, " << stats.decodedBytes / 1024 << " KB in " << stats.decodeSeconds * 1000.0
+                  << " ms summed over the threads\n";
+    }
+
+    for (size_t i = 0; i < files.size(); ++i)
+    {
+        textureFiles[i] = textureFiles[firstUses[files[i]]];
+    }
+    return true;
+}
+
+BlockCompressor::Format TextureFile::getFormat() const
+{
+    return m_format;
+}
+
+uint32_t TextureFile::getWidth() const
+{
+    return m_subresources.empty() ? 0 : m_subresources[0].width;
+}
+
+uint32_t TextureFile::getHeight() const
+{
+    return m_subresources.empty() ? 0 : m_subresources[0].height;
+}
+
+uint32_t TextureFile::getLevelCount() const
+{
+    return static_cast<uint32_t>(m_subresources.size());
+}
+
+const TextureFile::Subresource& TextureFile::getSubresource(uint32_t level) const
+{
+    return m_subresources[level];
+}
+
+Span<const unsigned char> TextureFile::getData() const
+{
+    return m_data;
+}
+
+float TextureFile::getPsnr() const
+{
+    return m_psnr;
+}
+
+bool TextureFile::parse(const unsigned char* data, size_t size)
+{
+    m_subresources.clear();
+    m_data = Span<const unsigned char>();
+    if (data == nullptr || size < c_dataOffset)
+    {
+        return false;
+    }
+
+    uint32_t magic;
+    DdsHeader header;
+    DdsHeaderDx10 headerDx10;
+    std::memcpy(&magic, data, sizeof(magic));
+    std::memcpy(&header, data + sizeof(magic), sizeof(DdsHeader));
+    std::memcpy(&headerDx10, data + sizeof(magic) + sizeof(DdsHeader), sizeof(DdsHeaderDx10));
+
+    const CookedInfo& cookedInfo = header.cookedInfo;
+    if (magic != c_ddsMagic || header.size != sizeof(DdsHeader) || header.pixelFormat.fourCC != c_dx10FourCC
+        || cookedInfo.tag != c_cookedTag || cookedInfo.version != c_version
+        || cookedInfo.pitchAlignment != c_pitchAlignment || cookedInfo.placementAlignment != c_placementAlignment
+        || headerDx10.resourceDimension != c_dx10Texture2D || headerDx10.arraySize != 1)
+    {
+        return false;
+    }
+
+    const uint32_t* format = std::find(std::begin(c_dxgiFormats), std::end(c_dxgiFormats), headerDx10.dxgiFormat);
+    if (format == std::end(c_dxgiFormats) || header.width == 0 || header.height == 0 || header.mipMapCount == 0
+        || header.width % BlockCompressor::c_blockDimension != 0 || header.height % BlockCompressor::c_blockDimension != 0
+        || header.mipMapCount > MipGenerator::getLevelCount(header.width, header.height))
+    {
+        return false;
+    }
+
+    m_format = static_cast<BlockCompressor::Format>(format - std::begin(c_dxgiFormats));
+    const uint64_t dataSize = computeSubresources(m_format, header.width, header.height, header.mipMapCount, m_subresources);
+    if (dataSize != size - c_dataOffset)
+    {
+        m_subresources.clear();
+        return false;
+    }
+
+    m_data = Span<const unsigned char>(data + c_dataOffset, static_cast<size_t>(dataSize));
+    m_sourceHash = (uint64_t(cookedInfo.sourceHashHigh) << 32) | cookedInfo.sourceHashLow;
+    m_colorSpace = static_cast<MipGenerator::ColorSpace>(cookedInfo.colorSpace);
+    m_quality = static_cast<BlockCompressor::Quality>(cookedInfo.quality);
+    m_psnr = cookedInfo.psnr;
+    return true;
+}
+
+} // namespace fw
@@ -0,0 +1,247 @@
+#include "TextureHeap.h"
+#include "Macros.h"
+
+#include "d3dx12.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <iostream>
+
+namespace
+{
+const UINT64 c_pageSize = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
+const UINT64 c_minSizeClass = D3D12_SMALL_RESOURCE_PLACEMENT_ALIGNMENT;
+// Identifies the placement in the private data of a texture
+const GUID c_placementGuid = {0x6f2a9c41, 0x3b7e, 0x4d15, {0x9a, 0x62, 0x1c, 0x8e, 0x45, 0xd0, 0x7b, 0x93}};
+
+bool isRenderTarget(const D3D12_RESOURCE_DESC& desc)
+{
+    return (desc.Flags & (D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET | D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL)) != 0;
+}
+} // namespace
+
+namespace fw
+{
+class TextureHeap::Placement : public IUnknown
+{
+public:
+    Placement(const std::shared_ptr<Heap>& heap, UINT64 offset, UINT64 size) :
+        m_heap(heap),
+        m_offset(offset),
+        m_size(size)
+    {
+        ++heap->textureCounts[offset];
+    }
+    Placement(const Placement&) = delete;
+    Placement(Placement&&) = delete;
+    Placement& operator=(const Placement&) = delete;
+    Placement& operator=(Placement&&) = delete;
+
+    HRESULT STDMETHODCALLTYPE QueryInterface(REFIID riid, void** object) override
+    {
+        if (riid == __uuidof(IUnknown))
+        {
+            *object = static_cast<IUnknown*>(this);
+            AddRef();
+            return S_OK;
+        }
+        *object = nullptr;
+        return E_NOINTERFACE;
+    }
+
+    ULONG STDMETHODCALLTYPE AddRef() override
+    {
+        return ++m_refCount;
+    }
+
+    ULONG STDMETHODCALLTYPE Release() override
+    {
+        const ULONG refCount = --m_refCount;
+        if (refCount == 0)
+        {
+            delete this;
+        }
+        return refCount;
+    }
+
+    std::shared_ptr<Heap> getHeap() const
+    {
+        return m_heap.lock();
+    }
+
+    UINT64 getOffset() const
+    {
+        return m_offset;
+    }
+
+    UINT64 getSize() const
+    {
+        return m_size;
+    }
+
+private:
+    std::atomic<ULONG> m_refCount{1};
+    std::weak_ptr<Heap> m_heap;
+    UINT64 m_offset;
+    UINT64 m_size;
+
+    ~Placement()
+    {
+        std::shared_ptr<Heap> heap = m_heap.lock();
+        if (!heap)
+        {
+            return;
+        }
+
+        auto textureCount = heap->textureCounts.find(m_offset);
+        if (--textureCount->second == 0)
+        {
+            heap->textureCounts.erase(textureCount);
+            heap->allocator.free(m_offset);
+        }
+    }
+};
+
+void TextureHeap::initialize(ID3D12Device* device, Type type, UINT64 heapSize)
+{
+    m_device = device;
+    m_type = type;
+    m_heapSize = heapSize;
+    m_heaps.clear();
+    createHeap(heapSize);
+}
+
+Microsoft::WRL::ComPtr<ID3D12Resource> TextureHeap::createTexture(const D3D12_RESOURCE_DESC& desc,
+                                                                  D3D12_RESOURCE_STATES initialState,
+                                                                  const D3D12_CLEAR_VALUE* clearValue,
+                                                                  const std::wstring& name)
+{
+    assert(isRenderTarget(desc) == (m_type == Type::RenderTargets));
+
+    D3D12_RESOURCE_DESC placedDesc = desc;
+    const D3D12_RESOURCE_ALLOCATION_INFO info = getAllocationInfo(placedDesc);
+
+    std::shared_ptr<Heap> heap;
+    UINT64 offset = HeapSuballocator::c_invalidOffset;
+    for (const std::shared_ptr<Heap>& candidate : m_heaps)
+    {
+        offset = candidate->allocator.allocate(info.SizeInBytes, info.Alignment);
+        if (offset != HeapSuballocator::c_invalidOffset)
+        {
+            heap = candidate;
+            break;
+        }
+    }
+
+    if (!heap)
+    {
+        UINT64 heapSize = m_heapSize;
+        while (heapSize < info.SizeInBytes)
+        {
+            heapSize *= 2;
+        }
+        heap = createHeap(heapSize);
+        offset = heap->allocator.allocate(info.SizeInBytes, info.Alignment);
+        assert(offset != HeapSuballocator::c_invalidOffset);
+    }
+
+    return createPlacedTexture(heap, offset, info.SizeInBytes, placedDesc, initialState, clearValue, name);
+}
+
+Microsoft::WRL::ComPtr<ID3D12Resource> TextureHeap::createAliasedTexture(const D3D12_RESOURCE_DESC& desc,
+                                                                         D3D12_RESOURCE_STATES initialState,
+                                                                         const D3D12_CLEAR_VALUE* clearValue,
+                                                                         ID3D12Resource* aliasedTexture,
+                                                                         const std::wstring& name)
+{
+    assert(isRenderTarget(desc) == (m_type == Type::RenderTargets));
+
+    // Getting private data that is an interface adds a reference to it
+    Microsoft::WRL::ComPtr<IUnknown> privateData;
+    UINT privateDataSize = sizeof(IUnknown*);
+    std::shared_ptr<Heap> heap;
+    if (SUCCEEDED(aliasedTexture->GetPrivateData(c_placementGuid, &privateDataSize, privateData.GetAddressOf())))
+    {
+        heap = static_cast<Placement*>(privateData.Get())->getHeap();
+    }
+    if (!heap || std::find(m_heaps.begin(), m_heaps.end(), heap) == m_heaps.end())
+    {
+        std::cerr << "The aliased texture is not from this heap" << std::endl;
+        return nullptr;
+    }
+
+    D3D12_RESOURCE_DESC placedDesc = desc;
+    const D3D12_RESOURCE_ALLOCATION_INFO info = getAllocationInfo(placedDesc);
+    const Placement& placement = *static_cast<Placement*>(privateData.Get());
+    if (info.SizeInBytes > placement.getSize() || placement.getOffset() % info.Alignment != 0)
+    {
+        std::cerr << "The texture does not fit into the memory of the aliased texture" << std::endl;
+        return nullptr;
+    }
+
+    return createPlacedTexture(heap, placement.getOffset(), placement.getSize(), placedDesc, initialState, clearValue, name);
+}
+
+HeapSuballocator::Stats TextureHeap::getStats() const
+{
+    HeapSuballocator::Stats stats;
+    for (const std::shared_ptr<Heap>& heap : m_heaps)
+    {
+        stats.add(heap->allocator.getStats());
+    }
+    return stats;
+}
+
+D3D12_RESOURCE_ALLOCATION_INFO TextureHeap::getAllocationInfo(D3D12_RESOURCE_DESC& desc) const
+{
+    // Small textures can use the small alignment if the whole texture fits into a 64 KB tile, render targets and
+    // multisampled textures never can
+    if (desc.Alignment == 0 && m_type == Type::Textures && desc.SampleDesc.Count == 1)
+    {
+        desc.Alignment = D3D12_SMALL_RESOURCE_PLACEMENT_ALIGNMENT;
+        const D3D12_RESOURCE_ALLOCATION_INFO info = m_device->GetResourceAllocationInfo(0, 1, &desc);
+        if (info.Alignment == D3D12_SMALL_RESOURCE_PLACEMENT_ALIGNMENT)
+        {
+            return info;
+        }
+        desc.Alignment = 0;
+    }
+    return m_device->GetResourceAllocationInfo(0, 1, &desc);
+}
+
+Microsoft::WRL::ComPtr<ID3D12Resource> TextureHeap::createPlacedTexture(const std::shared_ptr<Heap>& heap,
+                                                                        UINT64 offset,
+                                                                        UINT64 size,
+                                                                        const D3D12_RESOURCE_DESC& desc,
+                                                                        D3D12_RESOURCE_STATES initialState,
+                                                                        const D3D12_CLEAR_VALUE* clearValue,
+                                                                        const std::wstring& name)
+{
+    Microsoft::WRL::ComPtr<ID3D12Resource> texture;
+    CHECK(m_device->CreatePlacedResource(heap->heap.Get(), offset, &desc, initialState, clearValue, IID_PPV_ARGS(&texture)));
+    texture->SetName(name.c_str());
+
+    // The texture holds the only reference to the placement
+    Microsoft::WRL::ComPtr<Placement> placement;
+    placement.Attach(new Placement(heap, offset, size));
+    CHECK(texture->SetPrivateDataInterface(c_placementGuid, placement.Get()));
+    return texture;
+}
+
+std::shared_ptr<TextureHeap::Heap> TextureHeap::createHeap(UINT64 size)
+{
+    std::shared_ptr<Heap> heap = std::make_shared<Heap>();
+
+    // Multisampled render targets need the larger alignment of the heap
+    const D3D12_HEAP_FLAGS flags = m_type == Type::Textures ? D3D12_HEAP_FLAG_ALLOW_ONLY_NON_RT_DS_TEXTURES : D3D12_HEAP_FLAG_ALLOW_ONLY_RT_DS_TEXTURES;
+    const UINT64 alignment = m_type == Type::Textures ? D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT : D3D12_DEFAULT_MSAA_RESOURCE_PLACEMENT_ALIGNMENT;
+    CHECK(m_device->CreateHeap(&CD3DX12_HEAP_DESC(size, D3D12_HEAP_TYPE_DEFAULT, alignment, flags), IID_PPV_ARGS(&heap->heap)));
+    heap->heap->SetName(m_type == Type::Textures ? L"TextureHeap" : L"RenderTargetHeap");
+    heap->allocator.initialize(size, c_pageSize, c_minSizeClass);
+
+    m_heaps.push_back(heap);
+    return heap;
+}
+
+} // namespace fw
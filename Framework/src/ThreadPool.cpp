@@ -0,0 +1,142 @@
+#include "ThreadPool.h"
+#include "Profiler.h"
+
+#include <algorithm>
+#include <atomic>
+
+namespace
+{
+struct ParallelForState
+{
+    std::function<void(size_t, size_t)> function;
+    size_t count = 0;
+    size_t grainSize = 1;
+    size_t chunkCount = 0;
+    std::atomic<size_t> nextChunk{0};
+    std::atomic<size_t> completedChunks{0};
+    std::mutex mutex;
+    std::condition_variable condition;
+
+    void run()
+    {
+        for (size_t chunk = nextChunk++; chunk < chunkCount; chunk = nextChunk++)
+        {
+            const size_t begin = chunk * grainSize;
+            const size_t end = std::min(begin + grainSize, count);
+            function(begin, end);
+
+            if (++completedChunks == chunkCount)
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                condition.notify_all();
+            }
+        }
+    }
+};
+} // namespace
+
+namespace fw
+{
+ThreadPool::ThreadPool(unsigned int threadCount)
+{
+    if (threadCount == 0)
+    {
+        const unsigned int hardwareThreads = std::thread::hardware_concurrency();
+        threadCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+    }
+
+    for (unsigned int i = 0; i < threadCount; ++i)
+    {
+        m_threads.emplace_back(&ThreadPool::work, this);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_condition.notify_all();
+
+    for (std::thread& thread : m_threads)
+    {
+        thread.join();
+    }
+}
+
+ThreadPool& ThreadPool::getDefault()
+{
+    static ThreadPool threadPool;
+    return threadPool;
+}
+
+unsigned int ThreadPool::getThreadCount() const
+{
+    return static_cast<unsigned int>(m_threads.size());
+}
+
+void ThreadPool::parallelFor(size_t count, size_t grainSize, const std::function<void(size_t, size_t)>& function)
+{
+    if (count == 0)
+    {
+        return;
+    }
+
+    grainSize = std::max<size_t>(grainSize, 1);
+    if (count <= grainSize)
+    {
+        function(0, count);
+        return;
+    }
+
+    // Helpers may start after all the work is done so the state is shared with them
+    std::shared_ptr<ParallelForState> state = std::make_shared<ParallelForState>();
+    state->function = function;
+    state->count = count;
+    state->grainSize = grainSize;
+    state->chunkCount = (count + grainSize - 1) / grainSize;
+
+    const size_t helperCount = std::min<size_t>(m_threads.size(), state->chunkCount - 1);
+    for (size_t i = 0; i < helperCount; ++i)
+    {
+        enqueue([state]() { state->run(); });
+    }
+
+    state->run();
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->condition.wait(lock, [&state]() { return state->completedChunks == state->chunkCount; });
+}
+
+void ThreadPool::enqueue(std::function<void()> job)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_jobs.push(std::move(job));
+    }
+    m_condition.notify_one();
+}
+
+void ThreadPool::work()
+{
+    FW_PROFILE_THREAD("Worker");
+    while (true)
+    {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait(lock, [this]() { return m_stopping || !m_jobs.empty(); });
+            if (m_stopping && m_jobs.empty())
+            {
+                return;
+            }
+            job = std::move(m_jobs.front());
+            m_jobs.pop();
+        }
+        FW_PROFILE_SCOPE("Job");
+        job();
+    }
+}
+
+} // namespace fw
@@ -0,0 +1,114 @@
+#include "UploadRing.h"
+#include "Macros.h"
+
+#include "d3dx12.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace fw
+{
+UploadRing::~UploadRing()
+{
+    if (m_buffer)
+    {
+        m_buffer->Unmap(0, nullptr);
+    }
+    if (m_fenceEvent)
+    {
+        CloseHandle(m_fenceEvent);
+    }
+}
+
+void UploadRing::initialize(ID3D12Device* device, ID3D12Fence* fence, UINT64 size)
+{
+    m_device = device;
+    m_fence = fence;
+    m_buffer = createBuffer(size);
+    m_buffer->SetName(L"UploadRing");
+
+    // The buffer stays mapped for its lifetime, the CPU only writes to it
+    CHECK(m_buffer->Map(0, &CD3DX12_RANGE(0, 0), reinterpret_cast<void**>(&m_data)));
+    m_allocator.initialize(size);
+    m_fenceEvent = CreateEventEx(nullptr, false, false, EVENT_ALL_ACCESS);
+}
+
+UploadRing::Allocation UploadRing::allocate(UINT64 size, UINT64 alignment)
+{
+    release();
+
+    UINT64 offset = m_allocator.allocate(size, alignment);
+    while (offset == RingAllocator::c_invalidOffset && m_allocator.hasSubmittedBatches())
+    {
+        CHECK(m_fence->SetEventOnCompletion(m_allocator.getOldestFenceValue(), m_fenceEvent));
+        WaitForSingleObject(m_fenceEvent, INFINITE);
+        release();
+        offset = m_allocator.allocate(size, alignment);
+    }
+
+    Allocation allocation;
+    if (offset != RingAllocator::c_invalidOffset)
+    {
+        allocation.buffer = m_buffer.Get();
+        allocation.offset = offset;
+        allocation.data = m_data + offset;
+        return allocation;
+    }
+
+    DedicatedBuffer dedicatedBuffer{0, createBuffer(size)};
+    dedicatedBuffer.buffer->SetName(L"DedicatedUploadBuffer");
+    CHECK(dedicatedBuffer.buffer->Map(0, &CD3DX12_RANGE(0, 0), reinterpret_cast<void**>(&allocation.data)));
+    allocation.buffer = dedicatedBuffer.buffer.Get();
+    m_dedicatedBuffers.push_back(dedicatedBuffer);
+    return allocation;
+}
+
+void UploadRing::submit(UINT64 fenceValue)
+{
+    m_allocator.submit(fenceValue);
+    for (DedicatedBuffer& dedicatedBuffer : m_dedicatedBuffers)
+    {
+        if (dedicatedBuffer.fenceValue == 0)
+        {
+            dedicatedBuffer.fenceValue = fenceValue;
+        }
+    }
+}
+
+UINT64 UploadRing::getSize() const
+{
+    return m_allocator.getSize();
+}
+
+UINT64 UploadRing::getUsedSize() const
+{
+    return m_allocator.getUsedSize();
+}
+
+void UploadRing::release()
+{
+    const UINT64 completedFenceValue = m_fence->GetCompletedValue();
+    m_allocator.release(completedFenceValue);
+
+    // Dedicated buffers are unmapped when they are destroyed
+    m_dedicatedBuffers.erase(std::remove_if(m_dedicatedBuffers.begin(),
+                                            m_dedicatedBuffers.end(),
+                                            [completedFenceValue](const DedicatedBuffer& dedicatedBuffer) {
+                                                return dedicatedBuffer.fenceValue != 0 && dedicatedBuffer.fenceValue <= completedFenceValue;
+                                            }),
+                             m_dedicatedBuffers.end());
+}
+
+Microsoft::WRL::ComPtr<ID3D12Resource> UploadRing::createBuffer(UINT64 size)
+{
+    Microsoft::WRL::ComPtr<ID3D12Resource> buffer;
+    CHECK(m_device->CreateCommittedResource(&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
+                                            D3D12_HEAP_FLAG_NONE,
+                                            &CD3DX12_RESOURCE_DESC::Buffer(size),
+                                            D3D12_RESOURCE_STATE_GENERIC_READ,
+                                            nullptr,
+                                            IID_PPV_ARGS(&buffer)));
+    return buffer;
+}
+
+} // namespace fw
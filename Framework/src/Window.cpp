@@ -13,12 +13,18 @@ namespace fw
 {
 Window::~Window()
 {
-    glfwDestroyWindow(m_window);
-    glfwTerminate();
+    if (m_window)
+    {
+        glfwDestroyWindow(m_window);
+        glfwTerminate();
+    }
 }
 
-bool Window::initialize()
+bool Window::initialize(int width, int height)
 {
+    m_width = width;
+    m_height = height;
+
     glfwInit();
     glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
     m_window = glfwCreateWindow(m_width, m_height, "DX12", nullptr, nullptr);
@@ -36,13 +42,24 @@ bool Window::initialize()
     return true;
 }
 
+void Window::initializeHeadless(int width, int height)
+{
+    m_width = width;
+    m_height = height;
+}
+
 bool Window::shouldClose() const
 {
-    return glfwWindowShouldClose(m_window);
+    return m_window && glfwWindowShouldClose(m_window);
 }
 
 void Window::update()
 {
+    if (!m_window)
+    {
+        return;
+    }
+
     glfwPollEvents();
     double newX, newY;
     glfwGetCursorPos(m_window, &newX, &newY);
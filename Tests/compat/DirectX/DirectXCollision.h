@@ -0,0 +1,21 @@
+#pragma once
+
+#include "DirectXMath.h"
+
+// Bounding volume types of DirectXMath for platforms without it, without the intersection and construction
+// functions
+namespace DirectX
+{
+struct BoundingBox
+{
+    XMFLOAT3 Center{0.0f, 0.0f, 0.0f};
+    XMFLOAT3 Extents{1.0f, 1.0f, 1.0f};
+};
+
+struct BoundingSphere
+{
+    XMFLOAT3 Center{0.0f, 0.0f, 0.0f};
+    float Radius = 1.0f;
+};
+
+} // namespace DirectX
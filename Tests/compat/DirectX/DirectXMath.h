@@ -0,0 +1,57 @@
+#pragma once
+
+// Storage types of DirectXMath for platforms without it. Only what the framework headers that are built by the
+// tests name is declared, the framework code does its math on the components.
+namespace DirectX
+{
+struct XMFLOAT2
+{
+    float x;
+    float y;
+
+    XMFLOAT2() = default;
+    constexpr XMFLOAT2(float _x, float _y) :
+        x(_x),
+        y(_y)
+    {
+    }
+};
+
+struct XMFLOAT3
+{
+    float x;
+    float y;
+    float z;
+
+    XMFLOAT3() = default;
+    constexpr XMFLOAT3(float _x, float _y, float _z) :
+        x(_x),
+        y(_y),
+        z(_z)
+    {
+    }
+};
+
+struct XMFLOAT4
+{
+    float x;
+    float y;
+    float z;
+    float w;
+
+    XMFLOAT4() = default;
+    constexpr XMFLOAT4(float _x, float _y, float _z, float _w) :
+        x(_x),
+        y(_y),
+        z(_z),
+        w(_w)
+    {
+    }
+};
+
+struct XMFLOAT4X4
+{
+    float m[4][4];
+};
+
+} // namespace DirectX
@@ -0,0 +1,19 @@
+#pragma once
+
+// Texture types of assimp for builds without it, with the values of the real header
+enum aiTextureType
+{
+    aiTextureType_NONE = 0,
+    aiTextureType_DIFFUSE = 1,
+    aiTextureType_SPECULAR = 2,
+    aiTextureType_AMBIENT = 3,
+    aiTextureType_EMISSIVE = 4,
+    aiTextureType_HEIGHT = 5,
+    aiTextureType_NORMALS = 6,
+    aiTextureType_SHININESS = 7,
+    aiTextureType_OPACITY = 8,
+    aiTextureType_DISPLACEMENT = 9,
+    aiTextureType_LIGHTMAP = 10,
+    aiTextureType_REFLECTION = 11,
+    aiTextureType_UNKNOWN = 18
+};
@@ -0,0 +1,214 @@
+#include "Test.h"
+
+#include "BlockCompressor.h"
+#include "MipGenerator.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+using Format = fw::BlockCompressor::Format;
+
+const uint32_t c_pixelSize = fw::MipGenerator::c_pixelSize;
+const Format c_formats[] = {Format::BC1, Format::BC3, Format::BC5, Format::BC7};
+
+// A chain of only the image, so the blocks of level 0 are all of the image
+void makeChain(const std::vector<unsigned char>& pixels, uint32_t width, uint32_t height, fw::MipGenerator::Chain& chain)
+{
+    chain.levels = {fw::MipGenerator::Level{width, height, 0}};
+    chain.pixels = pixels;
+}
+
+std::vector<unsigned char> makeSolidImage(uint32_t width, uint32_t height, const unsigned char (&color)[4])
+{
+    std::vector<unsigned char> pixels(size_t(width) * height * c_pixelSize);
+    for (size_t i = 0; i < pixels.size(); ++i)
+    {
+        pixels[i] = color[i % c_pixelSize];
+    }
+    return pixels;
+}
+
+// Smooth ramps in every channel, alpha runs along the diagonal
+std::vector<unsigned char> makeGradientImage(uint32_t width, uint32_t height)
+{
+    std::vector<unsigned char> pixels(size_t(width) * height * c_pixelSize);
+    for (uint32_t y = 0; y < height; ++y)
+    {
+        for (uint32_t x = 0; x < width; ++x)
+        {
+            unsigned char* pixel = pixels.data() + (size_t(y) * width + x) * c_pixelSize;
+            pixel[0] = static_cast<unsigned char>(x * 255 / (width - 1));
+            pixel[1] = static_cast<unsigned char>(y * 255 / (height - 1));
+            pixel[2] = static_cast<unsigned char>(255 - (x + y) * 255 / (width + height - 2));
+            pixel[3] = static_cast<unsigned char>((x + y) * 255 / (width + height - 2));
+        }
+    }
+    return pixels;
+}
+
+// Opaque and transparent pixels of one color in a checkerboard of single pixels, like a cut out leaf
+std::vector<unsigned char> makeCutoutImage(uint32_t width, uint32_t height, const unsigned char (&color)[4])
+{
+    std::vector<unsigned char> pixels = makeSolidImage(width, height, color);
+    for (uint32_t y = 0; y < height; ++y)
+    {
+        for (uint32_t x = 0; x < width; ++x)
+        {
+            pixels[(size_t(y) * width + x) * c_pixelSize + 3] = (x + y) % 2 == 0 ? 255 : 0;
+        }
+    }
+    return pixels;
+}
+
+// Every BC7 block is written in mode 6, whose mode bits are 0000001
+bool isMode6(const fw::BlockCompressor::Texture& texture)
+{
+    for (size_t i = 0; i < texture.blocks.size(); i += fw::BlockCompressor::getBlockSize(Format::BC7))
+    {
+        if ((texture.blocks[i] & 0x7F) != 0x40)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Channels the format does not store are 0 except alpha which is 255
+bool isDecodedAs(const std::vector<unsigned char>& decoded, Format format, const unsigned char (&color)[4])
+{
+    const uint32_t storedChannelCount = format == Format::BC1 ? 3 : format == Format::BC5 ? 2 : 4;
+    for (size_t i = 0; i < decoded.size(); ++i)
+    {
+        const uint32_t c = i % c_pixelSize;
+        const unsigned char expected = c < storedChannelCount ? color[c] : c == 3 ? 255 : 0;
+        if (decoded[i] != expected)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void testSolidBlocks()
+{
+    // Colors that the endpoints of every format hold exactly: channels expanded from 5 and 6 bits for BC1, and the
+    // same low bit in every channel including alpha for the shared low bit of BC7
+    const unsigned char colors[][4] = {{0, 0, 0, 0}, {255, 255, 255, 255}, {255, 65, 33, 255}, {66, 130, 198, 128}};
+    for (const auto& color : colors)
+    {
+        // 10x6 also has blocks that repeat the last row and column
+        for (const uint32_t width : {4u, 10u})
+        {
+            const uint32_t height = width == 4 ? 4 : 6;
+            fw::MipGenerator::Chain chain;
+            makeChain(makeSolidImage(width, height, color), width, height, chain);
+            for (Format format : c_formats)
+            {
+                fw::BlockCompressor::Texture texture;
+                fw::BlockCompressor::compress(chain, format, texture);
+                EXPECT(texture.blocks.size() == texture.levels[0].getBlockColumnCount() * texture.levels[0].getBlockRowCount() * fw::BlockCompressor::getBlockSize(format));
+
+                std::vector<unsigned char> decoded;
+                fw::BlockCompressor::decompress(texture, 0, decoded);
+                EXPECT(decoded.size() == chain.pixels.size());
+                EXPECT(isDecodedAs(decoded, format, color));
+                EXPECT(format != Format::BC7 || isMode6(texture));
+            }
+        }
+    }
+}
+
+void testGradientBlocks()
+{
+    // The lowest peak signal to noise ratio in decibels of each format. The channels of the gradient do not lie on
+    // one line in a block, so only BC5 with a line per channel comes close to lossless.
+    const float minimumPsnrs[] = {36.0f, 37.0f, 50.0f, 38.0f};
+
+    const uint32_t width = 64;
+    const uint32_t height = 48;
+    fw::MipGenerator::Chain chain;
+    makeChain(makeGradientImage(width, height), width, height, chain);
+    for (Format format : c_formats)
+    {
+        fw::BlockCompressor::Texture texture;
+        fw::BlockCompressor::compress(chain, format, texture);
+        const float psnr = fw::BlockCompressor::computePsnr(chain, texture);
+        EXPECT(psnr >= minimumPsnrs[static_cast<uint32_t>(format)]);
+        EXPECT(format != Format::BC7 || isMode6(texture));
+    }
+}
+
+void testAlphaBlocks()
+{
+    // BC3 holds fully opaque and fully transparent pixels in the same block exactly
+    const unsigned char color[4] = {132, 65, 8, 255};
+    const uint32_t width = 8;
+    const uint32_t height = 8;
+    fw::MipGenerator::Chain chain;
+    makeChain(makeCutoutImage(width, height, color), width, height, chain);
+    fw::BlockCompressor::Texture texture;
+    fw::BlockCompressor::compress(chain, Format::BC3, texture);
+    std::vector<unsigned char> decoded;
+    fw::BlockCompressor::decompress(texture, 0, decoded);
+    EXPECT(decoded == chain.pixels);
+
+    // Alpha 255 and 0 need different low bits, which BC7 shares with the color channels of the endpoint
+    fw::BlockCompressor::compress(chain, Format::BC7, texture);
+    fw::BlockCompressor::decompress(texture, 0, decoded);
+    EXPECT(isMode6(texture));
+    EXPECT(decoded.size() == chain.pixels.size());
+    for (size_t i = 0; i < decoded.size(); ++i)
+    {
+        EXPECT(std::abs(decoded[i] - chain.pixels[i]) <= 1);
+    }
+
+    // BC1 drops alpha instead of using its three color mode for transparent pixels
+    fw::BlockCompressor::compress(chain, Format::BC1, texture);
+    fw::BlockCompressor::decompress(texture, 0, decoded);
+    EXPECT(isDecodedAs(decoded, Format::BC1, color));
+
+    // The alpha ramp of the gradient in blocks of BC3, whose alpha has eight levels per block
+    const uint32_t gradientWidth = 64;
+    const uint32_t gradientHeight = 48;
+    fw::MipGenerator::Chain gradient;
+    makeChain(makeGradientImage(gradientWidth, gradientHeight), gradientWidth, gradientHeight, gradient);
+    fw::BlockCompressor::compress(gradient, Format::BC3, texture);
+    fw::BlockCompressor::decompress(texture, 0, decoded);
+    int maximumAlphaError = 0;
+    for (size_t i = 3; i < decoded.size(); i += c_pixelSize)
+    {
+        maximumAlphaError = std::max(maximumAlphaError, std::abs(decoded[i] - gradient.pixels[i]));
+    }
+    EXPECT(maximumAlphaError <= 2);
+}
+
+void testFormatSelection()
+{
+    const unsigned char opaque[4] = {10, 20, 30, 255};
+    const unsigned char transparent[4] = {10, 20, 30, 254};
+    const std::vector<unsigned char> opaquePixels = makeSolidImage(4, 4, opaque);
+    const std::vector<unsigned char> transparentPixels = makeSolidImage(4, 4, transparent);
+    const fw::BlockCompressor::Quality fast = fw::BlockCompressor::Quality::Fast;
+    const fw::BlockCompressor::Quality high = fw::BlockCompressor::Quality::High;
+
+    EXPECT(fw::BlockCompressor::selectFormat("bark.png", opaquePixels.data(), 4, 4, fast) == Format::BC1);
+    EXPECT(fw::BlockCompressor::selectFormat("leaf.png", transparentPixels.data(), 4, 4, fast) == Format::BC3);
+    EXPECT(fw::BlockCompressor::selectFormat("leaf.png", transparentPixels.data(), 4, 4, high) == Format::BC7);
+    EXPECT(fw::BlockCompressor::selectFormat("textures/bark_normal.png", opaquePixels.data(), 4, 4, high) == Format::BC5);
+    EXPECT(fw::BlockCompressor::selectFormat("bark_normal/albedo.png", opaquePixels.data(), 4, 4, fast) == Format::BC1);
+}
+} // namespace
+
+int main()
+{
+    testSolidBlocks();
+    testGradientBlocks();
+    testAlphaBlocks();
+    testFormatSelection();
+    return test::getResult();
+}
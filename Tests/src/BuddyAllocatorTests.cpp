@@ -0,0 +1,114 @@
+#include "Test.h"
+
+#include "BuddyAllocator.h"
+
+#include <cstdint>
+#include <iterator>
+#include <map>
+#include <random>
+
+namespace
+{
+const uint64_t c_invalidOffset = fw::BuddyAllocator::c_invalidOffset;
+
+void testSplit()
+{
+    fw::BuddyAllocator allocator;
+    allocator.initialize(1024, 64);
+
+    // Rounded up to the block size, or to the alignment if it is larger
+    EXPECT(allocator.getBlockSize(1, 1) == 64);
+    EXPECT(allocator.getBlockSize(100, 1) == 128);
+    EXPECT(allocator.getBlockSize(100, 512) == 512);
+
+    EXPECT(allocator.allocate(64, 1) == 0);
+    EXPECT(allocator.allocate(64, 1) == 64);
+    EXPECT(allocator.allocate(128, 1) == 128);
+    EXPECT(allocator.allocate(1, 256) == 256);
+    EXPECT(allocator.getAllocatedSize() == 64 + 64 + 128 + 256);
+    EXPECT(allocator.getLargestFreeBlock() == 512);
+    EXPECT(allocator.allocate(1024, 1) == c_invalidOffset);
+}
+
+void testMerge()
+{
+    fw::BuddyAllocator allocator;
+    allocator.initialize(1024, 64);
+    const uint64_t a = allocator.allocate(64, 1);
+    const uint64_t b = allocator.allocate(64, 1);
+    const uint64_t c = allocator.allocate(128, 1);
+    const uint64_t d = allocator.allocate(256, 1);
+    EXPECT(allocator.getLargestFreeBlock() == 512);
+
+    // A block whose buddy is in use stays on its level
+    allocator.free(a);
+    EXPECT(allocator.getLargestFreeBlock() == 512);
+    EXPECT(allocator.allocate(128, 1) == 512);
+    allocator.free(512);
+
+    // Freeing the buddy merges the pair into a block of the next level
+    allocator.free(b);
+    EXPECT(allocator.allocate(128, 128) == 0);
+    allocator.free(0);
+    allocator.free(d);
+    EXPECT(allocator.getLargestFreeBlock() == 512);
+    // The last free merges up through every level
+    allocator.free(c);
+    EXPECT(allocator.getLargestFreeBlock() == 1024);
+    EXPECT(allocator.getAllocationCount() == 0);
+    EXPECT(allocator.getAllocatedSize() == 0);
+    EXPECT(allocator.allocate(1024, 1) == 0);
+}
+
+void testRandomAllocations()
+{
+    std::mt19937 random(2);
+    fw::BuddyAllocator allocator;
+    const uint64_t size = 1 << 20;
+    allocator.initialize(size, 256);
+
+    // Offset and end of the allocated blocks
+    std::map<uint64_t, uint64_t> blocks;
+    for (int operation = 0; operation < 20000; ++operation)
+    {
+        if (random() % 5 < 3)
+        {
+            const uint64_t allocationSize = 1 + random() % 20000;
+            const uint64_t alignment = 1ull << (random() % 14);
+            const uint64_t offset = allocator.allocate(allocationSize, alignment);
+            if (offset == c_invalidOffset)
+            {
+                continue;
+            }
+            const uint64_t blockSize = allocator.getBlockSize(allocationSize, alignment);
+            EXPECT(offset % blockSize == 0 && offset % alignment == 0);
+            EXPECT(offset + blockSize <= size);
+            auto next = blocks.lower_bound(offset);
+            EXPECT(next == blocks.end() || offset + blockSize <= next->first);
+            EXPECT(next == blocks.begin() || std::prev(next)->second <= offset);
+            blocks[offset] = offset + blockSize;
+        }
+        else if (!blocks.empty())
+        {
+            auto block = std::next(blocks.begin(), random() % blocks.size());
+            allocator.free(block->first);
+            blocks.erase(block);
+        }
+        EXPECT(allocator.getAllocationCount() == blocks.size());
+    }
+
+    for (const auto& block : blocks)
+    {
+        allocator.free(block.first);
+    }
+    EXPECT(allocator.getLargestFreeBlock() == size);
+}
+} // namespace
+
+int main()
+{
+    testSplit();
+    testMerge();
+    testRandomAllocations();
+    return test::getResult();
+}
@@ -0,0 +1,138 @@
+#include "Test.h"
+
+#include "DescriptorAllocator.h"
+
+#include <cstdint>
+#include <iterator>
+#include <map>
+#include <random>
+
+namespace
+{
+const uint32_t c_invalidIndex = fw::DescriptorAllocator::c_invalidIndex;
+
+void testCoalescing()
+{
+    fw::DescriptorAllocator allocator;
+    allocator.initialize(100, 0, 0);
+
+    const uint32_t a = allocator.allocate(10);
+    const uint32_t b = allocator.allocate(20);
+    const uint32_t c = allocator.allocate(30);
+    const uint32_t d = allocator.allocate(40);
+    EXPECT(a == 0 && b == 10 && c == 30 && d == 60);
+    EXPECT(allocator.allocate(1) == c_invalidIndex);
+
+    // Ranges that are not neighbours stay apart
+    allocator.free(a);
+    allocator.free(c);
+    EXPECT(allocator.getLargestFreeRange() == 30);
+    EXPECT(allocator.allocate(31) == c_invalidIndex);
+
+    // Freeing the range between them merges all three
+    allocator.free(b);
+    EXPECT(allocator.getLargestFreeRange() == 60);
+    EXPECT(allocator.allocate(60) == 0);
+    allocator.free(0);
+
+    // Merged with the previous range only, and then with the next one only
+    EXPECT(allocator.allocate(50) == 0);
+    allocator.free(d);
+    EXPECT(allocator.getLargestFreeRange() == 50);
+    allocator.free(0);
+    EXPECT(allocator.getLargestFreeRange() == 100);
+    EXPECT(allocator.getAllocatedCount() == 0);
+}
+
+void testFirstFit()
+{
+    fw::DescriptorAllocator allocator;
+    allocator.initialize(100, 0, 0);
+    const uint32_t a = allocator.allocate(10);
+    allocator.allocate(10);
+    const uint32_t c = allocator.allocate(30);
+    allocator.allocate(10);
+    allocator.free(a);
+    allocator.free(c);
+
+    // The first range that is large enough is split and the rest of it stays free
+    EXPECT(allocator.allocate(5) == 0);
+    EXPECT(allocator.allocate(20) == 20);
+    EXPECT(allocator.allocate(5) == 5);
+    EXPECT(allocator.allocate(10) == 40);
+    EXPECT(allocator.getAllocatedCount() == 60);
+}
+
+void testTransient()
+{
+    fw::DescriptorAllocator allocator;
+    allocator.initialize(10, 8, 3);
+    EXPECT(allocator.getCount() == 10 + 8 * 3);
+
+    // Every frame has its own part after the persistent descriptors
+    allocator.beginFrame(1);
+    EXPECT(allocator.allocateTransient(5) == 18);
+    EXPECT(allocator.allocateTransient(3) == 23);
+    EXPECT(allocator.allocateTransient(1) == c_invalidIndex);
+    EXPECT(allocator.getUsedTransientCount() == 8);
+
+    allocator.beginFrame(2);
+    EXPECT(allocator.allocateTransient(8) == 26);
+    allocator.beginFrame(1);
+    EXPECT(allocator.getUsedTransientCount() == 0);
+    EXPECT(allocator.allocateTransient(2) == 18);
+
+    // Persistent allocations never reach the transient parts
+    EXPECT(allocator.allocate(11) == c_invalidIndex);
+    EXPECT(allocator.allocate(10) == 0);
+}
+
+void testRandomAllocations()
+{
+    std::mt19937 random(4);
+    const uint32_t count = 1000;
+    fw::DescriptorAllocator allocator;
+    allocator.initialize(count, 0, 0);
+
+    // Start and end of the allocations
+    std::map<uint32_t, uint32_t> allocations;
+    for (int operation = 0; operation < 20000; ++operation)
+    {
+        if (random() % 2 == 0)
+        {
+            const uint32_t allocationCount = 1 + random() % 40;
+            const uint32_t index = allocator.allocate(allocationCount);
+            if (index == c_invalidIndex)
+            {
+                continue;
+            }
+            EXPECT(index + allocationCount <= count);
+            auto next = allocations.lower_bound(index);
+            EXPECT(next == allocations.end() || index + allocationCount <= next->first);
+            EXPECT(next == allocations.begin() || std::prev(next)->second <= index);
+            allocations[index] = index + allocationCount;
+        }
+        else if (!allocations.empty())
+        {
+            auto allocation = std::next(allocations.begin(), random() % allocations.size());
+            allocator.free(allocation->first);
+            allocations.erase(allocation);
+        }
+    }
+
+    for (const auto& allocation : allocations)
+    {
+        allocator.free(allocation.first);
+    }
+    EXPECT(allocator.getLargestFreeRange() == count);
+}
+} // namespace
+
+int main()
+{
+    testCoalescing();
+    testFirstFit();
+    testTransient();
+    testRandomAllocations();
+    return test::getResult();
+}
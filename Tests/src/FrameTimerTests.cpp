@@ -0,0 +1,111 @@
+#include "Test.h"
+
+#include "FrameTimer.h"
+
+#include <chrono>
+#include <cmath>
+
+namespace
+{
+using Stage = fw::FrameTimer::Stage;
+
+// Clock that only moves when advanced
+struct FakeClock
+{
+    std::chrono::steady_clock::time_point now{};
+
+    void advance(int milliseconds)
+    {
+        now += std::chrono::milliseconds(milliseconds);
+    }
+};
+
+bool isNear(float value, float expected)
+{
+    return std::fabs(value - expected) < 1e-3f;
+}
+
+void testPercentileRanks()
+{
+    FakeClock clock;
+    fw::FrameTimer timer;
+    timer.initialize(100, [&]() { return clock.now; });
+    EXPECT(timer.getFrameCount() == 0);
+    EXPECT(timer.getPercentiles(Stage::Frame).p50 == 0.0f);
+
+    // The update of frame i lasts i % 100 + 1 ms, so the last 100 frames have every duration from 1 to 100 ms once
+    for (int i = 1; i <= 250; ++i)
+    {
+        timer.beginFrame();
+        clock.advance(1);
+        timer.endStage(Stage::Events);
+        clock.advance(i % 100 + 1);
+        timer.endStage(Stage::Update);
+        timer.endFrame();
+    }
+
+    EXPECT(timer.getFrameCount() == 100);
+    const fw::FrameTimer::Percentiles update = timer.getPercentiles(Stage::Update);
+    EXPECT(isNear(update.p50, 50.0f));
+    EXPECT(isNear(update.p95, 95.0f));
+    EXPECT(isNear(update.p99, 99.0f));
+    EXPECT(isNear(timer.getPercentiles(Stage::Events).p99, 1.0f));
+    // Stages that are not ended are zero
+    EXPECT(timer.getPercentiles(Stage::Present).p99 == 0.0f);
+    EXPECT(isNear(timer.getLatest(Stage::Frame), 1.0f + 250 % 100 + 1));
+}
+
+void testNearestRank()
+{
+    FakeClock clock;
+    fw::FrameTimer timer;
+    timer.initialize(10, [&]() { return clock.now; });
+
+    // With fewer frames than the history only the ended frames count, the rank is rounded up
+    const int durations[] = {7, 3, 9};
+    for (int duration : durations)
+    {
+        timer.beginFrame();
+        clock.advance(duration);
+        timer.endStage(Stage::Record);
+        timer.endFrame();
+    }
+
+    EXPECT(timer.getFrameCount() == 3);
+    const fw::FrameTimer::Percentiles record = timer.getPercentiles(Stage::Record);
+    EXPECT(isNear(record.p50, 7.0f));
+    EXPECT(isNear(record.p95, 9.0f));
+    EXPECT(isNear(record.p99, 9.0f));
+    EXPECT(isNear(timer.getLatest(Stage::Record), 9.0f));
+}
+
+void testRepeatedStage()
+{
+    FakeClock clock;
+    fw::FrameTimer timer;
+    timer.initialize(4, [&]() { return clock.now; });
+
+    // A stage that is ended twice adds up, and the time between stages goes to the next one that is ended
+    timer.beginFrame();
+    clock.advance(2);
+    timer.endStage(Stage::Record);
+    clock.advance(3);
+    timer.endStage(Stage::Present);
+    clock.advance(4);
+    timer.endStage(Stage::Record);
+    clock.advance(5);
+    timer.endFrame();
+
+    EXPECT(isNear(timer.getLatest(Stage::Record), 6.0f));
+    EXPECT(isNear(timer.getLatest(Stage::Present), 3.0f));
+    EXPECT(isNear(timer.getLatest(Stage::Frame), 14.0f));
+}
+} // namespace
+
+int main()
+{
+    testPercentileRanks();
+    testNearestRank();
+    testRepeatedStage();
+    return test::getResult();
+}
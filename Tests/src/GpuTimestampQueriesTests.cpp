@@ -0,0 +1,119 @@
+#include "Test.h"
+
+#include "GpuTimestampQueries.h"
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace
+{
+// Records the queries instead of writing them into a D3D12 command list
+class MockCommandList : public fw::GpuTimestampQueries::CommandList
+{
+public:
+    // First query and query count of each resolve
+    using Resolves = std::vector<std::pair<uint32_t, uint32_t>>;
+
+    std::vector<uint32_t> writes;
+    Resolves resolves;
+
+    void writeTimestamp(uint32_t query) override
+    {
+        writes.push_back(query);
+    }
+
+    void resolve(uint32_t firstQuery, uint32_t queryCount) override
+    {
+        resolves.emplace_back(firstQuery, queryCount);
+    }
+};
+
+constexpr fw::Profiler::Site c_siteA{"A", __FILE__, __LINE__};
+constexpr fw::Profiler::Site c_siteB{"B", __FILE__, __LINE__};
+constexpr fw::Profiler::Site c_siteC{"C", __FILE__, __LINE__};
+
+void testScheduling()
+{
+    fw::GpuTimestampQueries queries;
+    queries.initialize(2, 2);
+    EXPECT(queries.getQueryCount() == 8);
+    std::vector<uint64_t> timestamps(queries.getQueryCount(), 0);
+    MockCommandList commandList;
+
+    // Nested passes get a begin and an end query each, the third pass does not fit and is not timed
+    EXPECT(queries.beginFrame(0, timestamps.data()).empty());
+    queries.beginPass(commandList, &c_siteA);
+    queries.beginPass(commandList, &c_siteB);
+    queries.beginPass(commandList, &c_siteC);
+    queries.endPass(commandList);
+    queries.endPass(commandList);
+    queries.endPass(commandList);
+    EXPECT(commandList.writes == std::vector<uint32_t>({0, 2, 3, 1}));
+    EXPECT(queries.hasQueries());
+    queries.endFrame(commandList);
+    EXPECT(commandList.resolves == MockCommandList::Resolves({{0, 4}}));
+
+    // Frame 1 owns the second half of the queries, a frame without passes resolves nothing
+    EXPECT(queries.beginFrame(1, timestamps.data()).empty());
+    EXPECT(!queries.hasQueries());
+    queries.endFrame(commandList);
+    EXPECT(commandList.resolves.size() == 1);
+
+    // The passes of frame 0 are read when it is recorded again
+    timestamps[0] = 100;
+    timestamps[1] = 200;
+    timestamps[2] = 120;
+    timestamps[3] = 150;
+    const std::vector<fw::GpuTimestampQueries::Pass> passes = queries.beginFrame(0, timestamps.data());
+    EXPECT(passes.size() == 2);
+    EXPECT(passes[0].site == &c_siteA && passes[0].begin == 100 && passes[0].end == 200);
+    EXPECT(passes[1].site == &c_siteB && passes[1].begin == 120 && passes[1].end == 150);
+
+    // Without a resolve there is nothing to read the next time
+    commandList.writes.clear();
+    queries.beginPass(commandList, &c_siteA);
+    queries.endPass(commandList);
+    EXPECT(commandList.writes == std::vector<uint32_t>({0, 1}));
+    EXPECT(queries.beginFrame(0, timestamps.data()).empty());
+}
+
+void testResolveRanges()
+{
+    fw::GpuTimestampQueries queries;
+    queries.initialize(3, 3);
+    std::vector<uint64_t> timestamps(queries.getQueryCount(), 0);
+    MockCommandList commandList;
+
+    // Every frame resolves only the queries it wrote, from the start of its own range
+    for (int frame = 0; frame < 3; ++frame)
+    {
+        queries.beginFrame(frame, timestamps.data());
+        for (int pass = 0; pass <= frame; ++pass)
+        {
+            queries.beginPass(commandList, &c_siteA);
+            queries.endPass(commandList);
+        }
+        queries.endFrame(commandList);
+    }
+    EXPECT(commandList.resolves == MockCommandList::Resolves({{0, 2}, {6, 4}, {12, 6}}));
+    EXPECT(commandList.writes == std::vector<uint32_t>({0, 1, 6, 7, 8, 9, 12, 13, 14, 15, 16, 17}));
+
+    // Frames reuse their range from the start
+    commandList.writes.clear();
+    commandList.resolves.clear();
+    EXPECT(queries.beginFrame(1, timestamps.data()).size() == 2);
+    queries.beginPass(commandList, &c_siteB);
+    queries.endPass(commandList);
+    queries.endFrame(commandList);
+    EXPECT(commandList.writes == std::vector<uint32_t>({6, 7}));
+    EXPECT(commandList.resolves == MockCommandList::Resolves({{6, 2}}));
+}
+} // namespace
+
+int main()
+{
+    testScheduling();
+    testResolveRanges();
+    return test::getResult();
+}
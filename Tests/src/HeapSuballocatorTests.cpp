@@ -0,0 +1,153 @@
+#include "Test.h"
+
+#include "HeapSuballocator.h"
+
+#include <cstdint>
+#include <iterator>
+#include <map>
+#include <random>
+#include <vector>
+
+namespace
+{
+const uint64_t c_invalidOffset = fw::HeapSuballocator::c_invalidOffset;
+const uint64_t c_size = 1 << 20;
+const uint64_t c_pageSize = 1 << 16;
+const uint64_t c_minSizeClass = 256;
+
+void testSlots()
+{
+    fw::HeapSuballocator allocator;
+    allocator.initialize(c_size, c_pageSize, c_minSizeClass);
+
+    EXPECT(allocator.getAllocationSize(1, 1) == 256);
+    EXPECT(allocator.getAllocationSize(300, 1) == 512);
+    EXPECT(allocator.getAllocationSize(300, 4096) == 4096);
+    EXPECT(allocator.getAllocationSize(c_pageSize / 2 + 1, 1) == c_pageSize);
+
+    // Slots of a size class fill a page from its start before the next page is taken
+    std::vector<uint64_t> offsets;
+    for (uint64_t i = 0; i < c_pageSize / 256; ++i)
+    {
+        offsets.push_back(allocator.allocate(200, 1));
+        EXPECT(offsets.back() == i * 256);
+    }
+    EXPECT(allocator.allocate(200, 1) == c_pageSize);
+    // Other size classes have pages of their own
+    EXPECT(allocator.allocate(1000, 1) == 2 * c_pageSize);
+
+    fw::HeapSuballocator::Stats stats = allocator.getStats();
+    EXPECT(stats.allocationCount == offsets.size() + 2);
+    EXPECT(stats.allocatedSize == (offsets.size() + 1) * 256 + 1024);
+    EXPECT(stats.requestedSize == (offsets.size() + 1) * 200 + 1000);
+    EXPECT(stats.freeSize == c_size - 3 * c_pageSize);
+
+    // A freed slot is the next one handed out of its size class
+    allocator.free(offsets[10]);
+    EXPECT(allocator.allocate(256, 1) == offsets[10]);
+}
+
+void testCoalescing()
+{
+    fw::HeapSuballocator allocator;
+    allocator.initialize(c_size, c_pageSize, c_minSizeClass);
+
+    std::vector<uint64_t> slots;
+    for (int i = 0; i < 600; ++i)
+    {
+        slots.push_back(allocator.allocate(256 << (i % 3), 1));
+    }
+    const uint64_t block = allocator.allocate(3 * c_pageSize, 1);
+    EXPECT(block != c_invalidOffset);
+    EXPECT(allocator.allocate(c_size, 1) == c_invalidOffset);
+
+    // Empty pages go back to the buddy allocator and merge with their free buddies, so once everything is
+    // freed the whole heap is one free block again
+    for (size_t i = 0; i < slots.size(); i += 2)
+    {
+        allocator.free(slots[i]);
+    }
+    for (size_t i = 1; i < slots.size(); i += 2)
+    {
+        allocator.free(slots[i]);
+    }
+    fw::HeapSuballocator::Stats stats = allocator.getStats();
+    EXPECT(stats.allocationCount == 1);
+    EXPECT(stats.freeSize == c_size - 4 * c_pageSize);
+
+    allocator.free(block);
+    stats = allocator.getStats();
+    EXPECT(stats.allocatedSize == 0);
+    EXPECT(stats.freeSize == c_size);
+    EXPECT(stats.largestFreeBlock == c_size);
+    EXPECT(stats.getExternalFragmentation() == 0.0f);
+    EXPECT(allocator.allocate(c_size, 1) == 0);
+}
+
+void testRandomAllocations()
+{
+    std::mt19937 random(3);
+    fw::HeapSuballocator allocator;
+    allocator.initialize(c_size * 4, c_pageSize, c_minSizeClass);
+
+    // Offset and end of the allocations and their requested sizes
+    std::map<uint64_t, uint64_t> allocations;
+    std::map<uint64_t, uint64_t> requestedSizes;
+    uint64_t requestedSize = 0;
+    for (int operation = 0; operation < 20000; ++operation)
+    {
+        if (random() % 5 < 3)
+        {
+            const uint64_t size = random() % 4 == 0 ? 1 + random() % (c_size / 2) : 1 + random() % 40000;
+            const uint64_t alignment = 1ull << (random() % 17);
+            const uint64_t offset = allocator.allocate(size, alignment);
+            if (offset == c_invalidOffset)
+            {
+                continue;
+            }
+            const uint64_t allocationSize = allocator.getAllocationSize(size, alignment);
+            EXPECT(allocationSize >= size);
+            EXPECT(offset % alignment == 0 && offset % allocationSize == 0);
+            auto next = allocations.lower_bound(offset);
+            EXPECT(next == allocations.end() || offset + allocationSize <= next->first);
+            EXPECT(next == allocations.begin() || std::prev(next)->second <= offset);
+            allocations[offset] = offset + allocationSize;
+            requestedSizes[offset] = size;
+            requestedSize += size;
+        }
+        else if (!allocations.empty())
+        {
+            auto allocation = std::next(allocations.begin(), random() % allocations.size());
+            allocator.free(allocation->first);
+            requestedSize -= requestedSizes[allocation->first];
+            requestedSizes.erase(allocation->first);
+            allocations.erase(allocation);
+        }
+
+        const fw::HeapSuballocator::Stats stats = allocator.getStats();
+        uint64_t allocatedSize = 0;
+        for (const auto& allocation : allocations)
+        {
+            allocatedSize += allocation.second - allocation.first;
+        }
+        EXPECT(stats.allocationCount == allocations.size());
+        EXPECT(stats.requestedSize == requestedSize);
+        EXPECT(stats.allocatedSize == allocatedSize);
+        EXPECT(stats.largestFreeBlock <= stats.freeSize);
+    }
+
+    for (const auto& allocation : allocations)
+    {
+        allocator.free(allocation.first);
+    }
+    EXPECT(allocator.getStats().largestFreeBlock == c_size * 4);
+}
+} // namespace
+
+int main()
+{
+    testSlots();
+    testCoalescing();
+    testRandomAllocations();
+    return test::getResult();
+}
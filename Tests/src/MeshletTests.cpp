@@ -0,0 +1,263 @@
+#include "Test.h"
+
+#include "MappedFile.h"
+#include "Mesh.h"
+#include "Meshlet.h"
+#include "ModelCache.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <vector>
+
+namespace
+{
+const uint32_t c_maxVertices = fw::MeshletBuilder::c_maxVertices;
+const uint32_t c_maxTriangles = fw::MeshletBuilder::c_maxTriangles;
+
+struct TestMesh
+{
+    std::vector<fw::Mesh::Vertex> vertices;
+    std::vector<uint32_t> indices;
+    fw::Mesh mesh;
+
+    void finish()
+    {
+        mesh.setVertices(vertices);
+        mesh.indexType = fw::Mesh::IndexType::UInt32;
+        mesh.indices32 = indices;
+    }
+};
+
+fw::Mesh::Vertex makeVertex(float x, float y, float z)
+{
+    fw::Mesh::Vertex vertex{};
+    vertex.position = DirectX::XMFLOAT3(x, y, z);
+    return vertex;
+}
+
+// Grid of quads in the z = 0 plane, the faces point to +z
+void makeGrid(uint32_t quadsX, uint32_t quadsY, TestMesh& grid)
+{
+    for (uint32_t y = 0; y <= quadsY; ++y)
+    {
+        for (uint32_t x = 0; x <= quadsX; ++x)
+        {
+            grid.vertices.push_back(makeVertex(static_cast<float>(x), static_cast<float>(y), 0.0f));
+        }
+    }
+    for (uint32_t y = 0; y < quadsY; ++y)
+    {
+        for (uint32_t x = 0; x < quadsX; ++x)
+        {
+            const uint32_t corner = y * (quadsX + 1) + x;
+            const uint32_t quad[] = {corner, corner + 1, corner + quadsX + 1, corner + 1, corner + quadsX + 2, corner + quadsX + 1};
+            grid.indices.insert(grid.indices.end(), quad, quad + 6);
+        }
+    }
+    grid.finish();
+}
+
+// Triangles that share no vertices, so the vertex limit ends the meshlets
+void makeTriangleSoup(uint32_t triangleCount, TestMesh& soup)
+{
+    for (uint32_t i = 0; i < triangleCount; ++i)
+    {
+        const float offset = static_cast<float>(i);
+        soup.vertices.push_back(makeVertex(offset, 0.0f, 0.0f));
+        soup.vertices.push_back(makeVertex(offset + 1.0f, 0.0f, 0.0f));
+        soup.vertices.push_back(makeVertex(offset, 1.0f, 0.0f));
+        for (uint32_t corner = 0; corner < 3; ++corner)
+        {
+            soup.indices.push_back(i * 3 + corner);
+        }
+    }
+    soup.finish();
+}
+
+float distance(const DirectX::XMFLOAT3& a, const DirectX::XMFLOAT3& b)
+{
+    const float x = a.x - b.x;
+    const float y = a.y - b.y;
+    const float z = a.z - b.z;
+    return std::sqrt(x * x + y * y + z * z);
+}
+
+// The culling test of MeshletBounds
+bool isBackFacing(const fw::MeshletBounds& bounds, const DirectX::XMFLOAT3& camera)
+{
+    const DirectX::XMFLOAT3 view(bounds.center.x - camera.x, bounds.center.y - camera.y, bounds.center.z - camera.z);
+    const float viewDot = view.x * bounds.coneAxis.x + view.y * bounds.coneAxis.y + view.z * bounds.coneAxis.z;
+    return viewDot >= bounds.coneCutoff * distance(bounds.center, camera) + bounds.radius;
+}
+
+// The meshlets are within the limits and draw the triangles of the mesh in index order
+void expectValidMeshlets(const fw::Mesh& mesh, const fw::MeshletData& data)
+{
+    EXPECT(data.bounds.size() == data.meshlets.size());
+
+    size_t index = 0;
+    for (const fw::Meshlet& meshlet : data.meshlets)
+    {
+        EXPECT(meshlet.vertexCount <= c_maxVertices);
+        EXPECT(meshlet.triangleCount <= c_maxTriangles);
+        EXPECT(meshlet.triangleCount > 0);
+        for (uint32_t i = 0; i < meshlet.triangleCount * 3; ++i, ++index)
+        {
+            const uint8_t localIndex = data.triangles[meshlet.triangleOffset + i];
+            EXPECT(localIndex < meshlet.vertexCount);
+            EXPECT(data.vertices[meshlet.vertexOffset + localIndex] == mesh.getIndex(index));
+        }
+    }
+    EXPECT(index == mesh.getIndexCount());
+}
+
+void testVertexLimit()
+{
+    // 21 triangles fill 63 vertices, the 22nd does not fit
+    TestMesh soup;
+    makeTriangleSoup(100, soup);
+    fw::MeshletData data;
+    fw::MeshletBuilder::build(soup.mesh, data);
+
+    expectValidMeshlets(soup.mesh, data);
+    EXPECT(data.meshlets.size() == 5);
+    EXPECT(data.meshlets[0].vertexCount == 63);
+    EXPECT(data.meshlets[0].triangleCount == 21);
+}
+
+void testTriangleLimit()
+{
+    // The triangles of a grid with exactly the vertex limit drawn four times over, so the triangle limit is reached
+    // first
+    TestMesh grid;
+    makeGrid(7, 7, grid);
+    const std::vector<uint32_t> indices = grid.indices;
+    for (int i = 0; i < 3; ++i)
+    {
+        grid.indices.insert(grid.indices.end(), indices.begin(), indices.end());
+    }
+    grid.finish();
+    fw::MeshletData data;
+    fw::MeshletBuilder::build(grid.mesh, data);
+
+    expectValidMeshlets(grid.mesh, data);
+    EXPECT(data.meshlets.size() == 4);
+    EXPECT(data.meshlets[0].triangleCount == c_maxTriangles);
+    EXPECT(data.meshlets[0].vertexCount == c_maxVertices);
+    EXPECT(data.meshlets[3].triangleCount == 98 * 4 - c_maxTriangles * 3);
+}
+
+void testBoundingSphere()
+{
+    TestMesh grid;
+    makeGrid(20, 20, grid);
+    fw::MeshletData data;
+    fw::MeshletBuilder::build(grid.mesh, data);
+
+    expectValidMeshlets(grid.mesh, data);
+    for (size_t i = 0; i < data.meshlets.size(); ++i)
+    {
+        const fw::Meshlet& meshlet = data.meshlets[i];
+        const fw::MeshletBounds& bounds = data.bounds[i];
+        for (uint32_t j = 0; j < meshlet.vertexCount; ++j)
+        {
+            const DirectX::XMFLOAT3& position = grid.mesh.positions[data.vertices[meshlet.vertexOffset + j]];
+            EXPECT(distance(position, bounds.center) <= bounds.radius * 1.0001f);
+        }
+    }
+}
+
+void testConeCulling()
+{
+    TestMesh grid;
+    makeGrid(20, 20, grid);
+    fw::MeshletData data;
+    fw::MeshletBuilder::build(grid.mesh, data);
+
+    for (const fw::MeshletBounds& bounds : data.bounds)
+    {
+        // All the faces point to +z, so the cone is the axis itself
+        EXPECT(std::fabs(bounds.coneAxis.z - 1.0f) < 1e-5f);
+        EXPECT(bounds.coneCutoff < 1e-3f);
+
+        const DirectX::XMFLOAT3 front(bounds.center.x, bounds.center.y, bounds.center.z + 100.0f);
+        const DirectX::XMFLOAT3 behind(bounds.center.x, bounds.center.y, bounds.center.z - 100.0f);
+        EXPECT(!isBackFacing(bounds, front));
+        EXPECT(isBackFacing(bounds, behind));
+    }
+
+    // A meshlet with faces in opposite directions is never culled
+    TestMesh twoSided;
+    twoSided.vertices = {makeVertex(0.0f, 0.0f, 0.0f), makeVertex(1.0f, 0.0f, 0.0f), makeVertex(0.0f, 1.0f, 0.0f)};
+    twoSided.indices = {0, 1, 2, 0, 2, 1};
+    twoSided.finish();
+    fw::MeshletBuilder::build(twoSided.mesh, data);
+    EXPECT(data.bounds.size() == 1);
+    EXPECT(data.bounds[0].coneCutoff == 1.0f);
+    EXPECT(!isBackFacing(data.bounds[0], DirectX::XMFLOAT3(0.0f, 0.0f, -100.0f)));
+    EXPECT(!isBackFacing(data.bounds[0], DirectX::XMFLOAT3(0.0f, 0.0f, 100.0f)));
+}
+
+template<typename T>
+bool isSame(fw::Span<const T> span, const std::vector<T>& expected)
+{
+    return span.size() == expected.size() && std::memcmp(span.data(), expected.data(), span.sizeInBytes()) == 0;
+}
+
+void testCacheRoundTrip()
+{
+    TestMesh grid;
+    makeGrid(30, 10, grid);
+    fw::MeshletData data;
+    fw::MeshletBuilder::build(grid.mesh, data);
+
+    // The meshlets follow other data in the image, so their offsets are not zero
+    uint64_t imageSize = 40;
+    fw::ModelCache::MeshEntry entry{};
+    fw::ModelCache::reserveMeshlets(data, imageSize, entry);
+    std::vector<unsigned char> image(static_cast<size_t>(fw::ModelCache::align(imageSize)), 0);
+    fw::ModelCache::writeMeshlets(data, entry, image);
+
+    const std::string path = (std::filesystem::temp_directory_path() / "MeshletTests.d12mesh").string();
+    EXPECT(fw::ModelCache::write(path, image));
+    {
+        fw::MappedFile file;
+        EXPECT(file.open(path));
+        EXPECT(file.getSize() == image.size());
+
+        fw::Mesh mesh;
+        EXPECT(fw::ModelCache::readMeshlets(file.getData(), file.getSize(), entry, mesh));
+        EXPECT(reinterpret_cast<uintptr_t>(mesh.meshlets.data()) % alignof(fw::Meshlet) == 0);
+        EXPECT(reinterpret_cast<uintptr_t>(mesh.meshletBounds.data()) % alignof(fw::MeshletBounds) == 0);
+        EXPECT(isSame(mesh.meshlets, data.meshlets));
+        EXPECT(isSame(mesh.meshletBounds, data.bounds));
+        EXPECT(isSame(mesh.meshletVertices, data.vertices));
+        EXPECT(isSame(mesh.meshletTriangles, data.triangles));
+
+        // Ranges past the end of the image and meshlets over the limits are rejected
+        fw::ModelCache::MeshEntry truncated = entry;
+        ++truncated.meshletTriangleIndexCount;
+        truncated.meshletTrianglesOffset = file.getSize() - entry.meshletTriangleIndexCount;
+        EXPECT(!fw::ModelCache::readMeshlets(file.getData(), file.getSize(), truncated, mesh));
+    }
+    std::remove(path.c_str());
+
+    fw::Meshlet* meshlets = reinterpret_cast<fw::Meshlet*>(image.data() + entry.meshletsOffset);
+    meshlets[0].vertexCount = c_maxVertices + 1;
+    fw::Mesh mesh;
+    EXPECT(!fw::ModelCache::readMeshlets(image.data(), image.size(), entry, mesh));
+}
+} // namespace
+
+int main()
+{
+    testVertexLimit();
+    testTriangleLimit();
+    testBoundingSphere();
+    testConeCulling();
+    testCacheRoundTrip();
+    return test::getResult();
+}
@@ -0,0 +1,130 @@
+#include "Test.h"
+
+#include "MipGenerator.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace
+{
+using InstructionSet = fw::MipGenerator::InstructionSet;
+
+std::vector<unsigned char> makeImage(uint32_t width, uint32_t height, uint32_t seed)
+{
+    std::mt19937 random(seed);
+    std::vector<unsigned char> pixels(size_t(width) * height * fw::MipGenerator::c_pixelSize);
+    for (unsigned char& value : pixels)
+    {
+        value = static_cast<unsigned char>(random() % 256);
+    }
+    return pixels;
+}
+
+// Channels may differ by one, the float sums can round to either side of a half
+bool isClose(const unsigned char* a, const unsigned char* b, size_t size)
+{
+    for (size_t i = 0; i < size; ++i)
+    {
+        if (std::abs(static_cast<int>(a[i]) - static_cast<int>(b[i])) > 1)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Scalar box filter of a level whose every pixel covers a whole block of the image
+std::vector<unsigned char> boxReference(const std::vector<unsigned char>& pixels, uint32_t width, uint32_t height, uint32_t levelWidth, uint32_t levelHeight)
+{
+    const uint32_t blockWidth = width / levelWidth;
+    const uint32_t blockHeight = height / levelHeight;
+    std::vector<unsigned char> level(size_t(levelWidth) * levelHeight * fw::MipGenerator::c_pixelSize);
+    for (uint32_t y = 0; y < levelHeight; ++y)
+    {
+        for (uint32_t x = 0; x < levelWidth; ++x)
+        {
+            for (uint32_t c = 0; c < fw::MipGenerator::c_pixelSize; ++c)
+            {
+                uint32_t sum = 0;
+                for (uint32_t by = 0; by < blockHeight; ++by)
+                {
+                    for (uint32_t bx = 0; bx < blockWidth; ++bx)
+                    {
+                        sum += pixels[((size_t(y) * blockHeight + by) * width + x * blockWidth + bx) * fw::MipGenerator::c_pixelSize + c];
+                    }
+                }
+                const uint32_t count = blockWidth * blockHeight;
+                level[(size_t(y) * levelWidth + x) * fw::MipGenerator::c_pixelSize + c] = static_cast<unsigned char>((sum + count / 2) / count);
+            }
+        }
+    }
+    return level;
+}
+
+void testBoxReference(InstructionSet instructionSet)
+{
+    EXPECT(fw::MipGenerator::setInstructionSet(instructionSet));
+
+    // Every level of a power of two image is the average of whole blocks
+    const uint32_t width = 64;
+    const uint32_t height = 32;
+    const std::vector<unsigned char> pixels = makeImage(width, height, 1);
+    fw::MipGenerator::Chain chain;
+    fw::MipGenerator::generate(pixels.data(), width, height, fw::MipGenerator::ColorSpace::Linear, fw::MipGenerator::Filter::Box, chain);
+    EXPECT(chain.levels.size() == 7);
+    for (size_t i = 1; i < chain.levels.size(); ++i)
+    {
+        const fw::MipGenerator::Level& level = chain.levels[i];
+        const std::vector<unsigned char> reference = boxReference(pixels, width, height, level.width, level.height);
+        EXPECT(isClose(chain.getLevelData(i).data(), reference.data(), reference.size()));
+    }
+
+    // Rows whose length is not a multiple of the vector width end with narrower vectors
+    const std::vector<unsigned char> oddPixels = makeImage(26, 10, 2);
+    std::vector<unsigned char> resized;
+    fw::MipGenerator::resize(oddPixels.data(), 26, 10, 13, 5, fw::MipGenerator::ColorSpace::Linear, fw::MipGenerator::Filter::Box, resized);
+    const std::vector<unsigned char> reference = boxReference(oddPixels, 26, 10, 13, 5);
+    EXPECT(resized.size() == reference.size());
+    EXPECT(isClose(resized.data(), reference.data(), reference.size()));
+}
+
+void testInstructionSetsMatch()
+{
+    const uint32_t sizes[][2] = {{256, 128}, {100, 60}, {37, 3}};
+    for (const auto& size : sizes)
+    {
+        const std::vector<unsigned char> pixels = makeImage(size[0], size[1], size[0]);
+        for (fw::MipGenerator::ColorSpace colorSpace : {fw::MipGenerator::ColorSpace::Linear, fw::MipGenerator::ColorSpace::Srgb})
+        {
+            fw::MipGenerator::Chain sse2Chain;
+            fw::MipGenerator::setInstructionSet(InstructionSet::Sse2);
+            fw::MipGenerator::generate(pixels.data(), size[0], size[1], colorSpace, fw::MipGenerator::Filter::Kaiser, sse2Chain);
+
+            fw::MipGenerator::Chain avx2Chain;
+            fw::MipGenerator::setInstructionSet(InstructionSet::Avx2);
+            fw::MipGenerator::generate(pixels.data(), size[0], size[1], colorSpace, fw::MipGenerator::Filter::Kaiser, avx2Chain);
+
+            EXPECT(sse2Chain.pixels.size() == avx2Chain.pixels.size());
+            EXPECT(isClose(sse2Chain.pixels.data(), avx2Chain.pixels.data(), sse2Chain.pixels.size()));
+        }
+    }
+}
+} // namespace
+
+int main()
+{
+    testBoxReference(InstructionSet::Sse2);
+    if (fw::MipGenerator::setInstructionSet(InstructionSet::Avx2))
+    {
+        testBoxReference(InstructionSet::Avx2);
+        testInstructionSetsMatch();
+    }
+    else
+    {
+        std::cout << "The CPU does not support AVX2, only the SSE2 filters are tested\n";
+    }
+    return test::getResult();
+}
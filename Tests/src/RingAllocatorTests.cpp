@@ -0,0 +1,145 @@
+#include "Test.h"
+
+#include "RingAllocator.h"
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace
+{
+const uint64_t c_invalidOffset = fw::RingAllocator::c_invalidOffset;
+
+void testWrap()
+{
+    fw::RingAllocator allocator;
+    allocator.initialize(256);
+
+    EXPECT(allocator.allocate(100, 1) == 0);
+    allocator.submit(1);
+    EXPECT(allocator.allocate(100, 1) == 100);
+    allocator.submit(2);
+    allocator.release(1);
+
+    // 80 bytes do not fit after the head, the end of the ring is skipped and counted as used
+    EXPECT(allocator.allocate(80, 1) == 0);
+    EXPECT(allocator.getUsedSize() == 100 + 56 + 80);
+    // The head must not run into the batch of fence 2
+    EXPECT(allocator.allocate(30, 1) == c_invalidOffset);
+
+    allocator.release(2);
+    EXPECT(allocator.allocate(30, 16) == 80);
+    EXPECT(allocator.allocate(10, 64) == 128);
+    allocator.submit(3);
+    allocator.release(3);
+    EXPECT(allocator.getUsedSize() == 0);
+    EXPECT(!allocator.hasSubmittedBatches());
+
+    // An idle ring hands out its whole size
+    EXPECT(allocator.allocate(256, 1) == 0);
+    EXPECT(allocator.allocate(1, 1) == c_invalidOffset);
+}
+
+void testOldestFenceWait()
+{
+    fw::RingAllocator allocator;
+    allocator.initialize(1024);
+    for (uint64_t fenceValue = 1; fenceValue <= 3; ++fenceValue)
+    {
+        EXPECT(allocator.allocate(300, 1) != c_invalidOffset);
+        allocator.submit(fenceValue);
+    }
+
+    // The loop of UploadRing::allocate, the fence completes the value that is waited for
+    std::vector<uint64_t> waitedFenceValues;
+    uint64_t offset = allocator.allocate(500, 1);
+    while (offset == c_invalidOffset && allocator.hasSubmittedBatches())
+    {
+        waitedFenceValues.push_back(allocator.getOldestFenceValue());
+        allocator.release(waitedFenceValues.back());
+        offset = allocator.allocate(500, 1);
+    }
+
+    // Only as many batches are waited for as are needed to free the range, oldest first
+    EXPECT(offset == 0);
+    EXPECT(waitedFenceValues == std::vector<uint64_t>({1, 2}));
+    EXPECT(allocator.hasSubmittedBatches());
+    EXPECT(allocator.getOldestFenceValue() == 3);
+}
+
+void testRandomAllocations()
+{
+    struct Range
+    {
+        uint64_t begin;
+        uint64_t end;
+        uint64_t fenceValue;
+    };
+
+    std::mt19937 random(1);
+    for (int ring = 0; ring < 50; ++ring)
+    {
+        const uint64_t size = 64 + random() % 5000;
+        fw::RingAllocator allocator;
+        allocator.initialize(size);
+
+        // Allocations that have not been released, the fence value is 0 until they are submitted
+        std::vector<Range> ranges;
+        uint64_t fenceValue = 0;
+        uint64_t completedFenceValue = 0;
+        for (int operation = 0; operation < 2000; ++operation)
+        {
+            const uint32_t choice = random() % 10;
+            if (choice < 6)
+            {
+                const uint64_t allocationSize = 1 + random() % (size / 3 + 1);
+                const uint64_t alignment = 1ull << (random() % 9);
+                const uint64_t offset = allocator.allocate(allocationSize, alignment);
+                if (offset == c_invalidOffset)
+                {
+                    continue;
+                }
+                EXPECT(offset % alignment == 0);
+                EXPECT(offset + allocationSize <= size);
+                for (const Range& range : ranges)
+                {
+                    EXPECT(offset + allocationSize <= range.begin || offset >= range.end);
+                }
+                ranges.push_back(Range{offset, offset + allocationSize, 0});
+            }
+            else if (choice < 8)
+            {
+                allocator.submit(++fenceValue);
+                for (Range& range : ranges)
+                {
+                    range.fenceValue = range.fenceValue == 0 ? fenceValue : range.fenceValue;
+                }
+            }
+            else if (completedFenceValue < fenceValue)
+            {
+                completedFenceValue += 1 + random() % (fenceValue - completedFenceValue);
+                allocator.release(completedFenceValue);
+                std::vector<Range> remaining;
+                for (const Range& range : ranges)
+                {
+                    if (range.fenceValue == 0 || range.fenceValue > completedFenceValue)
+                    {
+                        remaining.push_back(range);
+                    }
+                }
+                ranges = remaining;
+            }
+            EXPECT(allocator.getUsedSize() <= size);
+            EXPECT(!ranges.empty() || allocator.getUsedSize() == 0);
+        }
+    }
+}
+} // namespace
+
+int main()
+{
+    testWrap();
+    testOldestFenceWait();
+    testRandomAllocations();
+    return test::getResult();
+}
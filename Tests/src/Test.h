@@ -0,0 +1,27 @@
+#pragma once
+
+#include <iostream>
+
+namespace test
+{
+inline int& getFailureCount()
+{
+    static int s_failureCount = 0;
+    return s_failureCount;
+}
+
+inline void fail(const char* expression, const char* file, int line)
+{
+    std::cerr << file << "(" << line << "): Expected " << expression << "\n";
+    ++getFailureCount();
+}
+
+// Exit code of the test executable
+inline int getResult()
+{
+    return getFailureCount() == 0 ? 0 : 1;
+}
+} // namespace test
+
+// Checks the condition and lets the test continue when it fails so that every broken expectation is reported
+#define EXPECT(condition) ((condition) ? (void)0 : test::fail(#condition, __FILE__, __LINE__))